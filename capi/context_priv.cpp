@@ -30,6 +30,8 @@
 #include <ocl/cl_image_warp_handler.h>
 #include <ocl/cl_fisheye_handler.h>
 #include <ocl/cl_image_360_stitch.h>
+#include <soft/soft_image_360_stitch.h>
+#include <host_mem_buffer.h>
 
 using namespace XCam;
 
@@ -56,12 +58,8 @@ ContextBase::ContextBase (HandleType type)
     , _image_width (0)
     , _image_height (0)
     , _alloc_out_buf (false)
+    , _need_soft (false)
 {
-    if (!_inbuf_pool.ptr()) {
-        SmartPtr<DrmDisplay> display = DrmDisplay::instance ();
-        _inbuf_pool = new DrmBoBufferPool (display);
-        XCAM_ASSERT (_inbuf_pool.ptr ());
-    }
 }
 
 ContextBase::~ContextBase ()
@@ -106,6 +104,18 @@ ContextBase::set_parameters (ContextParams &param_list)
         return XCAM_RETURN_ERROR_PARAM;
     }
 
+    const char *soft = find_value (param_list, "soft");
+    _need_soft = (soft && !strncasecmp (soft, "true", strlen("true")));
+
+    // CPU handlers run on hosts without GPU, keep input off DRM
+    if (_need_soft) {
+        _inbuf_pool = new HostMemBufferPool;
+    } else {
+        SmartPtr<DrmDisplay> display = DrmDisplay::instance ();
+        _inbuf_pool = new DrmBoBufferPool (display);
+    }
+    XCAM_ASSERT (_inbuf_pool.ptr ());
+
     buf_info.init (image_format, _image_width, _image_height);
     _inbuf_pool->set_video_info (buf_info);
     if (!_inbuf_pool->reserve (DEFAULT_INPUT_BUFFER_POOL_COUNT)) {
@@ -125,6 +135,17 @@ ContextBase::set_parameters (ContextParams &param_list)
 XCamReturn
 ContextBase::init_handler ()
 {
+    if (_need_soft) {
+        SmartPtr<SoftImageHandler> soft_handler = create_soft_handler ();
+        XCAM_FAIL_RETURN (
+            ERROR, soft_handler.ptr (), XCAM_RETURN_ERROR_UNKNOWN,
+            "ContextBase::init_handler(%s) create soft handler failed", get_type_name ());
+
+        soft_handler->disable_buf_pool (!_alloc_out_buf);
+        _soft_handler = soft_handler;
+        return XCAM_RETURN_NO_ERROR;
+    }
+
     SmartPtr<CLContext> cl_context = CLDevice::instance()->get_context ();
     XCAM_FAIL_RETURN (
         ERROR, cl_context.ptr (), XCAM_RETURN_ERROR_UNKNOWN,
@@ -144,6 +165,11 @@ ContextBase::init_handler ()
 XCamReturn
 ContextBase::uinit_handler ()
 {
+    if (_soft_handler.ptr ()) {
+        _soft_handler->emit_stop ();
+        _soft_handler.release ();
+    }
+
     if (!_handler.ptr ())
         return XCAM_RETURN_NO_ERROR;
 
@@ -153,7 +179,7 @@ ContextBase::uinit_handler ()
 }
 
 XCamReturn
-ContextBase::execute (SmartPtr<DrmBoBuffer> &buf_in, SmartPtr<DrmBoBuffer> &buf_out)
+ContextBase::execute (SmartPtr<VideoBuffer> &buf_in, SmartPtr<VideoBuffer> &buf_out)
 {
     if (!_alloc_out_buf) {
         XCAM_FAIL_RETURN (
@@ -165,7 +191,18 @@ ContextBase::execute (SmartPtr<DrmBoBuffer> &buf_in, SmartPtr<DrmBoBuffer> &buf_
             "context (%s) execute failed, buf_out need NULL.", get_type_name ());
     }
 
-    return _handler->execute (buf_in, buf_out);
+    if (_soft_handler.ptr ())
+        return _soft_handler->execute (buf_in, buf_out);
+
+    SmartPtr<DrmBoBuffer> drm_in = buf_in.dynamic_cast_ptr<DrmBoBuffer> ();
+    SmartPtr<DrmBoBuffer> drm_out = buf_out.dynamic_cast_ptr<DrmBoBuffer> ();
+    XCAM_FAIL_RETURN (
+        ERROR, drm_in.ptr () && (drm_out.ptr () || !buf_out.ptr ()), XCAM_RETURN_ERROR_PARAM,
+        "context (%s) execute failed, buffers are not DRM buffers.", get_type_name ());
+
+    XCamReturn ret = _handler->execute (drm_in, drm_out);
+    buf_out = drm_out;
+    return ret;
 }
 
 SmartPtr<CLImageHandler>
@@ -220,3 +257,22 @@ StitchContext::create_handler (SmartPtr<CLContext> &context)
     return image_360;
 }
 
+SmartPtr<SoftImageHandler>
+StitchContext::create_soft_handler ()
+{
+    uint32_t sttch_width = _image_width;
+    uint32_t sttch_height = XCAM_ALIGN_UP (sttch_width / 2, 16);
+    if (sttch_width != sttch_height * 2) {
+        XCAM_LOG_ERROR ("incorrect stitch size width:%d height:%d", sttch_width, sttch_height);
+        return NULL;
+    }
+
+    SmartPtr<SoftImage360Stitch> image_360 =
+        create_soft_image_360_stitch (_need_seam).dynamic_cast_ptr<SoftImage360Stitch> ();
+    XCAM_FAIL_RETURN (ERROR, image_360.ptr (), NULL, "create soft image stitch handler failed");
+    image_360->set_output_size (sttch_width, sttch_height);
+    XCAM_LOG_INFO ("soft stitch output size width:%d height:%d", sttch_width, sttch_height);
+
+    return image_360;
+}
+
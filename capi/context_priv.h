@@ -26,6 +26,7 @@
 #include <ocl/cl_image_handler.h>
 #include <ocl/cl_context.h>
 #include <ocl/cl_blender.h>
+#include <soft/soft_image_handler.h>
 
 using namespace XCam;
 
@@ -64,12 +65,22 @@ public:
     XCamReturn init_handler ();
     XCamReturn uinit_handler ();
 
-    XCamReturn execute (SmartPtr<DrmBoBuffer> &buf_in, SmartPtr<DrmBoBuffer> &buf_out);
+    XCamReturn execute (SmartPtr<VideoBuffer> &buf_in, SmartPtr<VideoBuffer> &buf_out);
 
     SmartPtr<CLImageHandler> get_handler() const {
         return  _handler;
     }
-    SmartPtr<DrmBoBufferPool> get_input_buffer_pool() const {
+    SmartPtr<SoftImageHandler> get_soft_handler() const {
+        return  _soft_handler;
+    }
+    bool is_handler_inited () const {
+        return _handler.ptr () || _soft_handler.ptr ();
+    }
+    // parameter "soft", handler runs on CPU and never touches GPU
+    bool need_soft () const {
+        return _need_soft;
+    }
+    SmartPtr<BufferPool> get_input_buffer_pool() const {
         return  _inbuf_pool;
     }
     HandleType get_type () const {
@@ -84,6 +95,10 @@ protected:
     }
 
     virtual SmartPtr<CLImageHandler> create_handler (SmartPtr<CLContext> &context) = 0;
+    // NULL if the context has no CPU handler
+    virtual SmartPtr<SoftImageHandler> create_soft_handler () {
+        return NULL;
+    }
 
 private:
     XCAM_DEAD_COPY (ContextBase);
@@ -92,12 +107,14 @@ protected:
     HandleType                       _type;
     char                            *_usage;
     SmartPtr<CLImageHandler>         _handler;
-    SmartPtr<DrmBoBufferPool>        _inbuf_pool;
+    SmartPtr<SoftImageHandler>       _soft_handler;
+    SmartPtr<BufferPool>             _inbuf_pool;
 
     //parameters
     uint32_t                         _image_width;
     uint32_t                         _image_height;
     bool                             _alloc_out_buf;
+    bool                             _need_soft;
 };
 
 class NR3DContext
@@ -167,6 +184,7 @@ public:
     {}
 
     virtual SmartPtr<CLImageHandler> create_handler (SmartPtr<CLContext> &context);
+    virtual SmartPtr<SoftImageHandler> create_soft_handler ();
 
 private:
     bool                  _need_seam;
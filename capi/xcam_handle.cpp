@@ -25,6 +25,43 @@
 
 using namespace XCam;
 
+// CPU memory of an external buffer, referenced while in use
+class ExternalVideoBuffer
+    : public VideoBuffer
+{
+public:
+    explicit ExternalVideoBuffer (XCamVideoBuffer *buf)
+        : VideoBuffer (buf->timestamp)
+        , _external_buf (buf)
+    {
+        VideoBufferInfo info;
+        XCamVideoBufferInfo &base = info;
+        base = buf->info;
+        set_video_info (info);
+        xcam_video_buffer_ref (_external_buf);
+    }
+    virtual ~ExternalVideoBuffer () {
+        xcam_video_buffer_unref (_external_buf);
+    }
+
+    virtual uint8_t *map () {
+        return xcam_video_buffer_map (_external_buf);
+    }
+    virtual bool unmap () {
+        xcam_video_buffer_unmap (_external_buf);
+        return true;
+    }
+    virtual int get_fd () {
+        return _external_buf->get_fd ? xcam_video_buffer_get_fd (_external_buf) : -1;
+    }
+
+private:
+    XCAM_DEAD_COPY (ExternalVideoBuffer);
+
+private:
+    XCamVideoBuffer *_external_buf;
+};
+
 XCamHandle *
 xcam_create_handle (const char *name)
 {
@@ -155,8 +192,8 @@ external_buf_to_drm_buf (XCamVideoBuffer *buf)
     return drm_buf;
 }
 
-SmartPtr<DrmBoBuffer>
-copy_external_buf_to_drm_buf (XCamHandle *handle, XCamVideoBuffer *buf)
+SmartPtr<BufferProxy>
+copy_external_buf_to_pool_buf (XCamHandle *handle, XCamVideoBuffer *buf)
 {
     if (!handle || !buf) {
         XCAM_LOG_WARNING ("xcam handle can NOT be NULL");
@@ -178,13 +215,12 @@ copy_external_buf_to_drm_buf (XCamHandle *handle, XCamVideoBuffer *buf)
     }
     uint32_t height = src_info.height;
 
-    SmartPtr<DrmBoBufferPool> buf_pool = context->get_input_buffer_pool();
+    SmartPtr<BufferPool> buf_pool = context->get_input_buffer_pool();
     XCAM_ASSERT (buf_pool.ptr ());
 
-    SmartPtr<BufferProxy> tmp_buf = buf_pool->get_buffer (buf_pool);
-    XCAM_ASSERT (tmp_buf.ptr ());
-    SmartPtr<DrmBoBuffer> drm_buf = tmp_buf.dynamic_cast_ptr<DrmBoBuffer> ();
-    SmartPtr<VideoBuffer> video_buf = drm_buf;
+    SmartPtr<BufferProxy> pool_buf = buf_pool->get_buffer (buf_pool);
+    XCAM_ASSERT (pool_buf.ptr ());
+    SmartPtr<VideoBuffer> video_buf = pool_buf;
     const XCamVideoBufferInfo dest_info = video_buf->get_video_info ();
 
     uint8_t* dest = video_buf->map ();
@@ -209,35 +245,49 @@ copy_external_buf_to_drm_buf (XCamHandle *handle, XCamVideoBuffer *buf)
     buf->unmap (buf);
     video_buf->unmap ();
 
-    return drm_buf;
+    return pool_buf;
 }
 
 XCamReturn
 xcam_handle_execute (XCamHandle *handle, XCamVideoBuffer *buf_in, XCamVideoBuffer **buf_out)
 {
     ContextBase *context = CONTEXT_BASE_CAST (handle);
-    SmartPtr<DrmBoBuffer> input, output;
+    SmartPtr<VideoBuffer> input, output;
 
     XCAM_FAIL_RETURN (
         ERROR, context && buf_in && buf_out, XCAM_RETURN_ERROR_PARAM,
         "xcam_handle_execute failed, either of handle/buf_in/buf_out can NOT be NULL");
 
     XCAM_FAIL_RETURN (
-        ERROR, context->get_handler().ptr (), XCAM_RETURN_ERROR_PARAM,
+        ERROR, context->is_handler_inited (), XCAM_RETURN_ERROR_PARAM,
         "context (%s) failed, handler was not initialized", context->get_type_name ());
 
-    if (buf_in->mem_type == XCAM_MEM_TYPE_GPU) {
+    if (context->need_soft ()) {
+        // CPU handlers read and write external CPU memory in place
+        if (buf_in->mem_type == XCAM_MEM_TYPE_CPU)
+            input = new ExternalVideoBuffer (buf_in);
+        else
+            input = copy_external_buf_to_pool_buf (handle, buf_in);
+    } else if (buf_in->mem_type == XCAM_MEM_TYPE_GPU) {
         input = external_buf_to_drm_buf (buf_in);
     } else {
-        input = copy_external_buf_to_drm_buf (handle, buf_in);
+        input = copy_external_buf_to_pool_buf (handle, buf_in);
     }
     XCAM_FAIL_RETURN (
         ERROR, input.ptr (), XCAM_RETURN_ERROR_MEM,
-        "xcam_handle(%s) execute failed, buf_in convert to DRM buffer failed.",
-        context->get_type_name ());
+        "xcam_handle(%s) execute failed, buf_in convert to %s buffer failed.",
+        context->get_type_name (), context->need_soft () ? "CPU" : "DRM");
 
     if (*buf_out) {
-        output = external_buf_to_drm_buf (*buf_out);
+        if (context->need_soft ()) {
+            XCAM_FAIL_RETURN (
+                ERROR, (*buf_out)->mem_type == XCAM_MEM_TYPE_CPU, XCAM_RETURN_ERROR_PARAM,
+                "xcam_handle(%s) execute failed, soft handler only writes CPU buf_out.",
+                context->get_type_name ());
+            output = new ExternalVideoBuffer (*buf_out);
+        } else {
+            output = external_buf_to_drm_buf (*buf_out);
+        }
         XCAM_FAIL_RETURN (
             ERROR, output.ptr (), XCAM_RETURN_ERROR_MEM,
             "xcam_handle(%s) execute failed, buf_out set but convert to DRM buffer failed.",
@@ -252,7 +302,8 @@ xcam_handle_execute (XCamHandle *handle, XCamVideoBuffer *buf_in, XCamVideoBuffe
         "context (%s) failed, handler execute failed", context->get_type_name ());
 
     if (*buf_out == NULL && output.ptr ()) {
-        SmartPtr<BufferProxy> tmp_buf = output;
+        SmartPtr<BufferProxy> tmp_buf = output.dynamic_cast_ptr<BufferProxy> ();
+        XCAM_ASSERT (tmp_buf.ptr ());
         XCamVideoBuffer *new_buf = convert_to_external_buffer (tmp_buf);
         XCAM_FAIL_RETURN (
             ERROR, new_buf, XCAM_RETURN_ERROR_MEM,
@@ -55,6 +55,7 @@ XCamReturn xcam_handle_get_usage (XCamHandle *handle, char *usage_buf, int *usag
  *
  * \params[in]    handle       xcam handle
  * \params[in]    field0, value0, field1, value1, ..., fieldN, valueN    field and value in pairs
+ *                "soft" "true" runs the handler on CPU without GPU, only "Stitch" supports it
  * \return        XCamReturn   XCAM_RETURN_NO_ERROR on sucess; others on errors.
  */
 XCamReturn xcam_handle_set_parameters (
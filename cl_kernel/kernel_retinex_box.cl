@@ -0,0 +1,55 @@
+/*
+ * function: kernel_retinex_box
+ *     one box filter pass of the stacked box gaussian of retinex.
+ *     a work item filters one line of input with a running sum and
+ *     writes it as a column of output, so consecutive passes run along
+ *     rows and columns in turn. window clipped at borders.
+ * input:    line of @length elements every @in_pitch, from @in_offset
+ * output:   element i of line l at output[@out_offset + i * @out_pitch + l]
+ * BOX_INPUT_U8 / BOX_OUTPUT_U8 select uchar input / output, float otherwise.
+ */
+
+#ifdef BOX_INPUT_U8
+#define BOX_INPUT_TYPE uchar
+#define BOX_READ(value) convert_float (value)
+#else
+#define BOX_INPUT_TYPE float
+#define BOX_READ(value) (value)
+#endif
+
+#ifdef BOX_OUTPUT_U8
+#define BOX_OUTPUT_TYPE uchar
+#define BOX_WRITE(value) convert_uchar_sat_rte (value)
+#else
+#define BOX_OUTPUT_TYPE float
+#define BOX_WRITE(value) (value)
+#endif
+
+__kernel void kernel_retinex_box (
+    __global const BOX_INPUT_TYPE *input, uint in_offset, uint in_pitch,
+    __global BOX_OUTPUT_TYPE *output, uint out_offset, uint out_pitch,
+    uint length, uint lines, uint radius)
+{
+    uint line = get_global_id (0);
+    if (line >= lines)
+        return;
+
+    __global const BOX_INPUT_TYPE *src = input + in_offset + line * in_pitch;
+    __global BOX_OUTPUT_TYPE *dst = output + out_offset + line;
+    uint r = min (radius, length - 1);
+    float sum = 0.0f;
+    uint i;
+
+    for (i = 0; i < r; ++i)
+        sum += BOX_READ (src[i]);
+
+    for (i = 0; i < length; ++i) {
+        uint first = (i > r) ? i - r : 0;
+        uint last = min (i + r, length - 1);
+        if (i + r < length)
+            sum += BOX_READ (src[i + r]);
+        if (i > r)
+            sum -= BOX_READ (src[i - r - 1]);
+        dst[i * out_pitch] = BOX_WRITE (sum / (float)(last - first + 1));
+    }
+}
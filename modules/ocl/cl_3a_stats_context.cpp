@@ -31,6 +31,7 @@ CL3AStatsCalculatorContext::CL3AStatsCalculatorContext (const SmartPtr<CLContext
     , _data_allocated (false)
 {
     _stats_pool = new X3aStatsPool ();
+    _stats_pool->set_name ("cl_3a_stats");
 }
 
 CL3AStatsCalculatorContext::~CL3AStatsCalculatorContext ()
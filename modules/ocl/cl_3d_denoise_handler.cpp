@@ -96,7 +96,7 @@ CL3DDenoiseImageKernel::prepare_arguments (
     _thr_y = 2.0f * _handler->get_denoise_config ().threshold[0];
     _thr_uv = 2.0f * _handler->get_denoise_config ().threshold[1];
 
-    _image_in = new CLVaImage (context, input, cl_desc_in, video_info_in.offsets[info_index]);
+    _image_in = get_cached_va_image (context, input, cl_desc_in, video_info_in.offsets[info_index]);
     if (_image_in_list.size () < _ref_count) {
         while (_image_in_list.size () < _ref_count) {
             _image_in_list.push_back (_image_in);
@@ -105,7 +105,7 @@ CL3DDenoiseImageKernel::prepare_arguments (
         _image_in_list.pop_front ();
         _image_in_list.push_back (_image_in);
     }
-    _image_out = new CLVaImage (context, output, cl_desc_out, video_info_out.offsets[info_index]);
+    _image_out = get_cached_va_image (context, output, cl_desc_out, video_info_out.offsets[info_index]);
 
     if (!_image_out_prev.ptr ()) {
         _image_out_prev = _image_in;
@@ -37,6 +37,7 @@ namespace XCam {
 struct BayerPostData {
     SmartPtr<DrmBoBuffer> image_buffer;
     SmartPtr<CLBuffer>    stats_cl_buf;
+    SmartPtr<CLEvent>     done_event;
 };
 
 class CLBayer3AStatsThread
@@ -50,7 +51,8 @@ public:
     ~CLBayer3AStatsThread () {}
 
     virtual bool emit_stop ();
-    bool queue_stats (SmartPtr<DrmBoBuffer> &buf, SmartPtr<CLBuffer> &stats);
+    bool queue_stats (
+        SmartPtr<DrmBoBuffer> &buf, SmartPtr<CLBuffer> &stats, SmartPtr<CLEvent> &done_event);
     SmartPtr<DrmBoBuffer> pop_buf ();
 protected:
     virtual bool loop ();
@@ -75,7 +77,8 @@ CLBayer3AStatsThread::emit_stop ()
 }
 
 bool
-CLBayer3AStatsThread::queue_stats (SmartPtr<DrmBoBuffer> &buf, SmartPtr<CLBuffer> &stats)
+CLBayer3AStatsThread::queue_stats (
+    SmartPtr<DrmBoBuffer> &buf, SmartPtr<CLBuffer> &stats, SmartPtr<CLEvent> &done_event)
 {
     XCAM_FAIL_RETURN (
         WARNING,
@@ -87,6 +90,7 @@ CLBayer3AStatsThread::queue_stats (SmartPtr<DrmBoBuffer> &buf, SmartPtr<CLBuffer
     XCAM_ASSERT (data.ptr ());
     data->image_buffer = buf;
     data->stats_cl_buf = stats;
+    data->done_event = done_event;
 
     return _stats_process_list.push (data);
 }
@@ -119,7 +123,7 @@ CLBayer3AStatsThread::loop ()
     XCAM_ASSERT (data->stats_cl_buf.ptr ());
     XCAM_ASSERT (_kernel);
 
-    ret = _kernel->process_stats_buffer (data->image_buffer, data->stats_cl_buf);
+    ret = _kernel->process_stats_buffer (data->image_buffer, data->stats_cl_buf, data->done_event);
     XCAM_FAIL_RETURN (
         WARNING,
         ret == XCAM_RETURN_NO_ERROR,
@@ -249,12 +253,12 @@ CLBayerBasicImageKernel::prepare_arguments (
     out_image_info.row_pitch = out_video_info.strides[0];
 
 #if ENABLE_IMAGE_2D_INPUT
-    _image_in = new CLVaImage (context, input, in_image_info);
+    _image_in = get_cached_va_image (context, input, in_image_info);
 #else
-    _buffer_in = new CLVaBuffer (context, input);
+    _buffer_in = get_cached_va_buffer (context, input);
 #endif
     _input_aligned_width = in_video_info.strides[0] / (2 * 8); // ushort8
-    _image_out = new CLVaImage (context, output, out_image_info);
+    _image_out = get_cached_va_image (context, output, out_image_info);
 
     _out_aligned_height = out_video_info.aligned_height;
     _blc_config.color_bits = in_video_info.color_bits;
@@ -338,7 +342,7 @@ CLBayerBasicImageKernel::post_execute (SmartPtr<DrmBoBuffer> &output)
 
     XCAM_FAIL_RETURN (
         ERROR,
-        _3a_stats_thread->queue_stats (output, _stats_cl_buffer),
+        _3a_stats_thread->queue_stats (output, _stats_cl_buffer, get_execute_event ()),
         XCAM_RETURN_ERROR_UNKNOWN,
         "cl bayer basic kernel(%s) process 3a stats failed", get_kernel_name ());
 
@@ -359,14 +363,19 @@ CLBayerBasicImageKernel::post_execute (SmartPtr<DrmBoBuffer> &output)
 }
 
 XCamReturn
-CLBayerBasicImageKernel::process_stats_buffer (SmartPtr<DrmBoBuffer> &buffer, SmartPtr<CLBuffer> &cl_stats)
+CLBayerBasicImageKernel::process_stats_buffer (
+    SmartPtr<DrmBoBuffer> &buffer, SmartPtr<CLBuffer> &cl_stats, SmartPtr<CLEvent> &done_event)
 {
     SmartPtr<X3aStats> stats_3a;
     SmartPtr<CLContext> context = get_context ();
 
     XCAM_OBJ_PROFILING_START;
 
-    context->finish ();
+    // only wait for this kernel, later frames may be queued already
+    if (done_event.ptr ())
+        done_event->wait ();
+    else
+        context->finish ();
     stats_3a = _3a_stats_context->copy_stats_out (cl_stats);
     if (!stats_3a.ptr ()) {
         XCAM_LOG_DEBUG ("copy 3a stats failed, maybe handler stopped");
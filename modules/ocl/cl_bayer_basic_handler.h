@@ -73,7 +73,8 @@ protected:
         CLWorkSize &work_size);
 
 private:
-    XCamReturn process_stats_buffer (SmartPtr<DrmBoBuffer> &buffer, SmartPtr<CLBuffer> &cl_stats);
+    XCamReturn process_stats_buffer (
+        SmartPtr<DrmBoBuffer> &buffer, SmartPtr<CLBuffer> &cl_stats, SmartPtr<CLEvent> &done_event);
 
     XCAM_DEAD_COPY (CLBayerBasicImageKernel);
 
@@ -96,8 +96,8 @@ CLBayerPipeImageKernel::prepare_arguments (
     in_image_info.height = in_video_info.aligned_height * 4;  //540
     in_image_info.row_pitch = in_video_info.strides[0];
 
-    _image_in = new CLVaImage (context, input, in_image_info);
-    _image_out = new CLVaImage (context, output);
+    _image_in = get_cached_va_image (context, input, in_image_info);
+    _image_out = get_cached_va_image (context, output);
     _input_height = in_video_info.aligned_height;
     _output_height = out_video_info.aligned_height;
 
@@ -66,8 +66,8 @@ CLBilateralKernel::prepare_arguments (
     //sigma_r = 0.1*100
     _sigma_r = 10.0;
 
-    _image_in = new CLVaImage (context, input);
-    _image_out = new CLVaImage (context, output);
+    _image_in = get_cached_va_image (context, input);
+    _image_out = get_cached_va_image (context, output);
 
     XCAM_ASSERT (_image_in->is_valid () && _image_out->is_valid ());
     XCAM_FAIL_RETURN (
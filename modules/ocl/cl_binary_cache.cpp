@@ -0,0 +1,280 @@
+/*
+ * cl_binary_cache.cpp - CL program binary cache on disk
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "cl_binary_cache.h"
+#include "cl_device.h"
+#include "xcam_mutex.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define XCAM_CL_BINARY_CACHE_MAGIC "XCAMCLB"
+#define XCAM_CL_BINARY_CACHE_MAX_SIZE (256 * 1024 * 1024)
+
+namespace XCam {
+
+struct CLBinaryCacheHeader {
+    char      magic [8];
+    uint32_t  version;
+    uint32_t  key_size;
+    uint64_t  binary_size;
+    uint64_t  binary_hash;
+};
+
+static uint64_t
+fnv1a_hash (const uint8_t *data, size_t len, uint64_t hash = 0xcbf29ce484222325ULL)
+{
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static bool
+make_dirs (const std::string &path)
+{
+    struct stat st;
+    for (size_t pos = 1; pos <= path.size (); ++pos) {
+        if (pos != path.size () && path[pos] != '/')
+            continue;
+        std::string sub = path.substr (0, pos);
+        if (stat (sub.c_str (), &st) == 0) {
+            if (!S_ISDIR (st.st_mode))
+                return false;
+            continue;
+        }
+        if (mkdir (sub.c_str (), 0755) != 0 && errno != EEXIST)
+            return false;
+    }
+    return true;
+}
+
+static bool
+read_all (int fd, void *buf, size_t size)
+{
+    uint8_t *ptr = (uint8_t *)buf;
+    while (size) {
+        ssize_t ret = read (fd, ptr, size);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return false;
+        ptr += ret;
+        size -= ret;
+    }
+    return true;
+}
+
+static bool
+write_all (int fd, const void *buf, size_t size)
+{
+    const uint8_t *ptr = (const uint8_t *)buf;
+    while (size) {
+        ssize_t ret = write (fd, ptr, size);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return false;
+        ptr += ret;
+        size -= ret;
+    }
+    return true;
+}
+
+const char *
+CLBinaryCache::get_cache_dir ()
+{
+    static Mutex dir_mutex;
+    static bool dir_checked = false;
+    static std::string cache_dir;
+
+    SmartLock locker (dir_mutex);
+    if (dir_checked)
+        return cache_dir.empty () ? NULL : cache_dir.c_str ();
+    dir_checked = true;
+
+    const char *env = getenv ("XCAM_CL_CACHE_DIR");
+    if (env) {
+        cache_dir = env;
+    } else if ((env = getenv ("XDG_CACHE_HOME")) && env[0]) {
+        cache_dir = std::string (env) + "/libxcam/cl";
+    } else if ((env = getenv ("HOME")) && env[0]) {
+        cache_dir = std::string (env) + "/.cache/libxcam/cl";
+    }
+
+    if (cache_dir.empty ()) {
+        XCAM_LOG_DEBUG ("CL binary cache disabled");
+        return NULL;
+    }
+
+    if (!make_dirs (cache_dir)) {
+        XCAM_LOG_WARNING ("CL binary cache disabled, create dir(%s) failed", cache_dir.c_str ());
+        cache_dir.clear ();
+        return NULL;
+    }
+
+    XCAM_LOG_DEBUG ("CL binary cache dir:%s", cache_dir.c_str ());
+    return cache_dir.c_str ();
+}
+
+CLBinaryCache::CLBinaryCache (
+    const char *kernel_name, const char *body, size_t body_len, const char *options)
+    : _loaded_dev (0)
+    , _loaded_ino (0)
+{
+    SmartPtr<CLDevice> device = CLDevice::instance ();
+    const char *dir = get_cache_dir ();
+    char str[64];
+
+    XCAM_ASSERT (kernel_name && body);
+    if (!dir || !device->is_inited ())
+        return;
+
+    if (!body_len)
+        body_len = strlen (body);
+
+    const CLDevieInfo &dev_info = device->get_device_info ();
+    snprintf (
+        str, sizeof (str), "%" PRIuS ":%016" PRIx64,
+        body_len, fnv1a_hash ((const uint8_t *)body, body_len));
+
+    _key = std::string ("name=") + kernel_name +
+           "\noptions=" + XCAM_STR (options) +
+           "\nplatform=" + XCAM_STR (device->get_platform_name ()) +
+           "\ndevice=" + dev_info.device_name +
+           "\ndevice_version=" + dev_info.device_version +
+           "\ndriver_version=" + dev_info.driver_version +
+           "\nbody=" + str + "\n";
+
+    snprintf (
+        str, sizeof (str), "-%016" PRIx64 ".bin",
+        fnv1a_hash ((const uint8_t *)_key.c_str (), _key.size ()));
+    _file_path = std::string (dir) + "/" + kernel_name + str;
+}
+
+XCamReturn
+CLBinaryCache::load (uint8_t **binary, size_t *size)
+{
+    CLBinaryCacheHeader header;
+    struct stat st;
+    uint8_t *data = NULL;
+    int fd = -1;
+
+    XCAM_ASSERT (binary && size);
+    if (!is_enabled ())
+        return XCAM_RETURN_BYPASS;
+
+    fd = open (_file_path.c_str (), O_RDONLY);
+    if (fd < 0)
+        return XCAM_RETURN_BYPASS;
+
+    if (fstat (fd, &st) == 0) {
+        _loaded_dev = st.st_dev;
+        _loaded_ino = st.st_ino;
+    }
+
+    std::string key (_key.size (), '\0');
+    bool valid =
+        read_all (fd, &header, sizeof (header)) &&
+        memcmp (header.magic, XCAM_CL_BINARY_CACHE_MAGIC, sizeof (header.magic)) == 0 &&
+        header.version == XCAM_CL_BINARY_CACHE_VERSION &&
+        header.key_size == _key.size () &&
+        header.binary_size > 0 && header.binary_size <= XCAM_CL_BINARY_CACHE_MAX_SIZE &&
+        read_all (fd, &key[0], key.size ()) &&
+        key == _key;
+
+    if (valid) {
+        data = (uint8_t *) xcam_malloc0 (header.binary_size);
+        valid = data && read_all (fd, data, header.binary_size) &&
+                fnv1a_hash (data, header.binary_size) == header.binary_hash;
+    }
+    close (fd);
+
+    if (!valid) {
+        XCAM_LOG_WARNING ("CL binary cache(%s) invalid, remove it", _file_path.c_str ());
+        xcam_free (data);
+        invalidate ();
+        return XCAM_RETURN_ERROR_FILE;
+    }
+
+    *binary = data;
+    *size = header.binary_size;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+CLBinaryCache::store (const uint8_t *binary, size_t size)
+{
+    CLBinaryCacheHeader header;
+
+    XCAM_ASSERT (binary && size);
+    if (!is_enabled ())
+        return XCAM_RETURN_BYPASS;
+
+    xcam_mem_clear (header);
+    memcpy (header.magic, XCAM_CL_BINARY_CACHE_MAGIC, sizeof (header.magic));
+    header.version = XCAM_CL_BINARY_CACHE_VERSION;
+    header.key_size = _key.size ();
+    header.binary_size = size;
+    header.binary_hash = fnv1a_hash (binary, size);
+
+    // unique temp file per writer, rename is atomic within same dir
+    std::string tmp_path = _file_path + ".XXXXXX";
+    int fd = mkstemp (&tmp_path[0]);
+    XCAM_FAIL_RETURN (
+        WARNING, fd >= 0, XCAM_RETURN_ERROR_FILE,
+        "CL binary cache create temp file(%s) failed", tmp_path.c_str ());
+
+    bool ret =
+        write_all (fd, &header, sizeof (header)) &&
+        write_all (fd, _key.c_str (), _key.size ()) &&
+        write_all (fd, binary, size);
+    ret = (close (fd) == 0) && ret;
+
+    if (!ret || rename (tmp_path.c_str (), _file_path.c_str ()) != 0) {
+        unlink (tmp_path.c_str ());
+        XCAM_LOG_WARNING ("CL binary cache write file(%s) failed", _file_path.c_str ());
+        return XCAM_RETURN_ERROR_FILE;
+    }
+
+    XCAM_LOG_DEBUG ("CL binary cache saved %s", _file_path.c_str ());
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+CLBinaryCache::invalidate ()
+{
+    struct stat st;
+
+    if (!is_enabled () || !_loaded_ino)
+        return;
+
+    // another process may have renamed a valid file into place after load
+    if (stat (_file_path.c_str (), &st) == 0 &&
+            st.st_dev == _loaded_dev && st.st_ino == _loaded_ino)
+        unlink (_file_path.c_str ());
+    _loaded_dev = 0;
+    _loaded_ino = 0;
+}
+
+};
@@ -0,0 +1,81 @@
+/*
+ * cl_binary_cache.h - CL program binary cache on disk
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_CL_BINARY_CACHE_H
+#define XCAM_CL_BINARY_CACHE_H
+
+#include "xcam_utils.h"
+#include <string>
+#include <sys/types.h>
+
+// bump it when cache file layout changes, old files are then ignored
+#define XCAM_CL_BINARY_CACHE_VERSION 1
+
+namespace XCam {
+
+/*
+ * Cache of built CL program binaries, one file per kernel build.
+ * Key covers kernel name, kernel body, build options, platform,
+ * device and driver version; any change picks a different file and
+ * the full key is verified again when the file is loaded.
+ *
+ * Cache directory:
+ *   $XCAM_CL_CACHE_DIR, cache disabled if it is set to empty;
+ *   otherwise $XDG_CACHE_HOME/libxcam/cl or $HOME/.cache/libxcam/cl.
+ *
+ * Writers save into a unique temp file and rename it into place, so
+ * concurrent processes never read a partial file. invalidate only
+ * removes the file last loaded, never one renamed into place since.
+ */
+class CLBinaryCache {
+public:
+    explicit CLBinaryCache (
+        const char *kernel_name, const char *body, size_t body_len, const char *options);
+    ~CLBinaryCache () {}
+
+    bool is_enabled () const {
+        return !_file_path.empty ();
+    }
+    const char *get_file_path () const {
+        return _file_path.c_str ();
+    }
+
+    // @binary need xcam_free by caller
+    XCamReturn load (uint8_t **binary, size_t *size);
+    XCamReturn store (const uint8_t *binary, size_t size);
+    // remove file of last load if it is still in place
+    void invalidate ();
+
+    static const char *get_cache_dir ();
+
+private:
+    XCAM_DEAD_COPY (CLBinaryCache);
+
+private:
+    std::string        _key;
+    std::string        _file_path;
+    // identity of the file last opened by load
+    dev_t              _loaded_dev;
+    ino_t              _loaded_ino;
+};
+
+};
+
+#endif //XCAM_CL_BINARY_CACHE_H
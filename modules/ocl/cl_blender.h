@@ -41,13 +41,6 @@ enum {
     CLBlenderPlaneMax,
 };
 
-struct Rect {
-    int32_t pos_x, pos_y;
-    int32_t width, height;
-
-    Rect () : pos_x (0), pos_y (0), width (0), height (0) {}
-};
-
 class CLBlenderScaleKernel
     : public CLImageKernel
 {
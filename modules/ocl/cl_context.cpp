@@ -154,6 +154,35 @@ CLContext::finish ()
     return XCAM_RETURN_NO_ERROR;
 }
 
+XCamReturn
+CLContext::enqueue_marker (
+    CLEventList &events_wait,
+    SmartPtr<CLEvent> &event_out)
+{
+    cl_int error_code = CL_SUCCESS;
+    cl_command_queue cmd_queue_id = NULL;
+    cl_event events_id_wait[XCAM_CL_MAX_EVENT_SIZE];
+    uint32_t num_of_events_wait = 0;
+    SmartPtr<CLCommandQueue> cmd_queue = get_default_cmd_queue ();
+
+    XCAM_ASSERT (cmd_queue.ptr () && event_out.ptr ());
+    cmd_queue_id = cmd_queue->get_cmd_queue_id ();
+    num_of_events_wait = event_list_2_id_array (events_wait, events_id_wait, XCAM_CL_MAX_EVENT_SIZE);
+
+    error_code = clEnqueueMarkerWithWaitList (
+                     cmd_queue_id,
+                     num_of_events_wait, (num_of_events_wait ? events_id_wait : NULL),
+                     &event_out->get_event_id ());
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        error_code == CL_SUCCESS,
+        XCAM_RETURN_ERROR_CL,
+        "CL enqueue marker failed with error_code:%d", error_code);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
 bool
 CLContext::init_context ()
 {
@@ -353,16 +382,22 @@ CLContext::generate_kernel_id (
     }
 
     if (gen_binary != NULL && binary_size != NULL) {
+        *gen_binary = NULL;
+        *binary_size = 0;
         error_code = clGetProgramInfo (program.id, CL_PROGRAM_BINARY_SIZES, sizeof (size_t) * 1, binary_size, NULL);
-        if (error_code != CL_SUCCESS) {
+        if (error_code != CL_SUCCESS || !*binary_size) {
             XCAM_LOG_WARNING ("CL query binary sizes failed on %s", name);
-        }
-
-        *gen_binary = (uint8_t *) xcam_malloc0 (sizeof (uint8_t) * (*binary_size));
-
-        error_code = clGetProgramInfo (program.id, CL_PROGRAM_BINARIES, sizeof (uint8_t *) * 1, gen_binary, NULL);
-        if (error_code != CL_SUCCESS) {
-            XCAM_LOG_WARNING ("CL query program binaries failed on %s", name);
+            *binary_size = 0;
+        } else {
+            *gen_binary = (uint8_t *) xcam_malloc0 (sizeof (uint8_t) * (*binary_size));
+
+            error_code = clGetProgramInfo (program.id, CL_PROGRAM_BINARIES, sizeof (uint8_t *) * 1, gen_binary, NULL);
+            if (error_code != CL_SUCCESS) {
+                XCAM_LOG_WARNING ("CL query program binaries failed on %s", name);
+                xcam_free (*gen_binary);
+                *gen_binary = NULL;
+                *binary_size = 0;
+            }
         }
     }
 
@@ -67,6 +67,11 @@ public:
     XCamReturn flush ();
     XCamReturn finish ();
 
+    // marker completes after @events_wait, or after all queued commands if list is empty
+    XCamReturn enqueue_marker (
+        CLEventList &events_wait,
+        SmartPtr<CLEvent> &event_out);
+
     void terminate ();
 
 private:
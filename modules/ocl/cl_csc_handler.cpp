@@ -64,8 +64,8 @@ CLCscImageKernel::prepare_arguments (
         out_single_plane = true;
     }
 
-    _image_in = new CLVaImage (context, input, in_video_info.offsets[0], in_single_plane);
-    _image_out = new CLVaImage (context, output, out_video_info.offsets[0], out_single_plane);
+    _image_in = get_cached_va_image (context, input, in_video_info.offsets[0], in_single_plane);
+    _image_out = get_cached_va_image (context, output, out_video_info.offsets[0], out_single_plane);
     _matrix_buffer = new CLBuffer (
         context, sizeof(float)*XCAM_COLOR_MATRIX_SIZE,
         CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR , &_rgbtoyuv_matrix);
@@ -101,7 +101,7 @@ CLCscImageKernel::prepare_arguments (
         }
 
         if(_kernel_csc_type == CL_CSC_TYPE_NV12TORGBA) {
-            _image_uv = new CLVaImage (context, input, in_video_info.offsets[1], true);
+            _image_uv = get_cached_va_image (context, input, in_video_info.offsets[1], true);
             args[arg_count].arg_adress = &_image_uv->get_mem_id();
             args[arg_count].arg_size = sizeof (cl_mem);
             ++arg_count;
@@ -112,7 +112,7 @@ CLCscImageKernel::prepare_arguments (
         }
 
         if (_kernel_csc_type == CL_CSC_TYPE_RGBATONV12) {
-            _image_uv = new CLVaImage (context, output, out_video_info.offsets[1], true);
+            _image_uv = get_cached_va_image (context, output, out_video_info.offsets[1], true);
             args[arg_count].arg_adress = &_image_uv->get_mem_id();
             args[arg_count].arg_size = sizeof (cl_mem);
             ++arg_count;
@@ -82,11 +82,11 @@ CLDarkChannelKernel::prepare_arguments (
     cl_desc_in.width = video_info_in.width / 8;
     cl_desc_in.height = video_info_in.height;
     cl_desc_in.row_pitch = video_info_in.strides[0];
-    _image_in_y = new CLVaImage (context, input, cl_desc_in, video_info_in.offsets[0]);
+    _image_in_y = get_cached_va_image (context, input, cl_desc_in, video_info_in.offsets[0]);
 
     cl_desc_in.height = video_info_in.height / 2;
     cl_desc_in.row_pitch = video_info_in.strides[1];
-    _image_in_uv = new CLVaImage (context, input, cl_desc_in, video_info_in.offsets[1]);
+    _image_in_uv = get_cached_va_image (context, input, cl_desc_in, video_info_in.offsets[1]);
 
     arg_count = 0;
     args[arg_count].arg_adress = &_image_in_y->get_mem_id ();
@@ -201,7 +201,7 @@ CLBiFilterKernel::prepare_arguments (
     cl_desc_in.width = video_info_in.width / 8;
     cl_desc_in.height = video_info_in.height;
     cl_desc_in.row_pitch = video_info_in.strides[0];
-    _image_in_y = new CLVaImage (context, input, cl_desc_in, video_info_in.offsets[0]);
+    _image_in_y = get_cached_va_image (context, input, cl_desc_in, video_info_in.offsets[0]);
 
     SmartPtr<CLImage> &dark_channel_in = _defog_handler->get_dark_map (XCAM_DEFOG_DC_ORIGINAL);
     SmartPtr<CLImage> &dark_channel_out = _defog_handler->get_dark_map (XCAM_DEFOG_DC_BI_FILTER);
@@ -328,11 +328,11 @@ CLDefogRecoverKernel::prepare_arguments (
     cl_desc_out.width = video_info_out.width / 8;
     cl_desc_out.height = video_info_out.height;
     cl_desc_out.row_pitch = video_info_out.strides[0];
-    _image_out_y = new CLVaImage (context, output, cl_desc_out, video_info_out.offsets[0]);
+    _image_out_y = get_cached_va_image (context, output, cl_desc_out, video_info_out.offsets[0]);
 
     cl_desc_out.height = video_info_out.height / 2;
     cl_desc_out.row_pitch = video_info_out.strides[1];
-    _image_out_uv = new CLVaImage (context, output, cl_desc_out, video_info_out.offsets[1]);
+    _image_out_uv = get_cached_va_image (context, output, cl_desc_out, video_info_out.offsets[1]);
 
     args[arg_count].arg_adress = &_image_out_y->get_mem_id ();
     args[arg_count].arg_size = sizeof (cl_mem);
@@ -35,8 +35,8 @@ CLDemoImageKernel::prepare_arguments (
 {
     SmartPtr<CLContext> context = get_context ();
 
-    _image_in = new CLVaImage (context, input);
-    _image_out = new CLVaImage (context, output);
+    _image_in = get_cached_va_image (context, input);
+    _image_out = get_cached_va_image (context, output);
 
     XCAM_ASSERT (_image_in->is_valid () && _image_out->is_valid ());
     XCAM_FAIL_RETURN (
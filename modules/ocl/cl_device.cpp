@@ -172,6 +172,12 @@ CLDevice::query_device_info (cl_device_id device_id, CLDevieInfo &info)
     XCAM_CL_GET_DEVICE_INFO (CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS, info.max_work_item_dims);
     XCAM_CL_GET_DEVICE_INFO (CL_DEVICE_MAX_WORK_ITEM_SIZES, info.max_work_item_sizes);
     XCAM_CL_GET_DEVICE_INFO (CL_DEVICE_MAX_WORK_GROUP_SIZE, info.max_work_group_size);
+    XCAM_CL_GET_DEVICE_INFO (CL_DEVICE_NAME, info.device_name);
+    XCAM_CL_GET_DEVICE_INFO (CL_DEVICE_VERSION, info.device_version);
+    XCAM_CL_GET_DEVICE_INFO (CL_DRIVER_VERSION, info.driver_version);
+    info.device_name [XCAM_CL_MAX_STR_SIZE - 1] = '\0';
+    info.device_version [XCAM_CL_MAX_STR_SIZE - 1] = '\0';
+    info.driver_version [XCAM_CL_MAX_STR_SIZE - 1] = '\0';
     return true;
 }
 
@@ -35,6 +35,9 @@ struct CLDevieInfo {
     uint32_t  max_work_item_dims;
     size_t    max_work_item_sizes [3];
     size_t    max_work_group_size;
+    char      device_name [XCAM_CL_MAX_STR_SIZE];
+    char      device_version [XCAM_CL_MAX_STR_SIZE];
+    char      driver_version [XCAM_CL_MAX_STR_SIZE];
 
     CLDevieInfo ()
         : max_compute_unit (0)
@@ -42,6 +45,9 @@ struct CLDevieInfo {
         , max_work_group_size (0)
     {
         xcam_mem_clear (max_work_item_sizes);
+        xcam_mem_clear (device_name);
+        xcam_mem_clear (device_version);
+        xcam_mem_clear (driver_version);
     }
 };
 
@@ -44,21 +44,6 @@ const XCamKernelInfo kernel_fisheye_info[] = {
     },
 };
 
-CLFisheyeInfo::CLFisheyeInfo ()
-    : center_x (0.0f)
-    , center_y (0.0f)
-    , wide_angle (0.0f)
-    , radius (0.0f)
-    , rotate_angle (0.0f)
-{
-}
-
-bool
-CLFisheyeInfo::is_valid () const
-{
-    return wide_angle >= 1.0f && radius >= 1.0f;
-}
-
 CLFisheye2GPSKernel::CLFisheye2GPSKernel (
     SmartPtr<CLContext> &context, SmartPtr<CLFisheyeHandler> &handler)
     : CLImageKernel (context)
@@ -238,14 +223,14 @@ CLFisheyeHandler::prepare_parameters (SmartPtr<DrmBoBuffer> &input, SmartPtr<Drm
     cl_desc.width = input_image_w;
     cl_desc.height = input_image_h;
     cl_desc.row_pitch = in_info.strides[CLNV12PlaneY];
-    _input[CLNV12PlaneY] = new CLVaImage (context, input, cl_desc, in_info.offsets[CLNV12PlaneY]);
+    _input[CLNV12PlaneY] = get_cached_va_image (context, input, cl_desc, in_info.offsets[CLNV12PlaneY]);
 
     cl_desc.format.image_channel_data_type = CL_UNORM_INT8;
     cl_desc.format.image_channel_order = CL_RG;
     cl_desc.width = input_image_w / 2;
     cl_desc.height = input_image_h / 2;
     cl_desc.row_pitch = in_info.strides[CLNV12PlaneUV];
-    _input[CLNV12PlaneUV] = new CLVaImage (context, input, cl_desc, in_info.offsets[CLNV12PlaneUV]);
+    _input[CLNV12PlaneUV] = get_cached_va_image (context, input, cl_desc, in_info.offsets[CLNV12PlaneUV]);
 
     if (_use_map) {
         cl_desc.format.image_channel_data_type = CL_UNSIGNED_INT16;
@@ -253,20 +238,20 @@ CLFisheyeHandler::prepare_parameters (SmartPtr<DrmBoBuffer> &input, SmartPtr<Drm
         cl_desc.width = XCAM_ALIGN_DOWN (out_info.width, 8) / 8; //CL_RGBA * CL_UNSIGNED_INT16 = 8
         cl_desc.height = XCAM_ALIGN_DOWN (out_info.height, 2);
         cl_desc.row_pitch = out_info.strides[CLNV12PlaneY];
-        _output[CLNV12PlaneY] = new CLVaImage (context, output, cl_desc, out_info.offsets[CLNV12PlaneY]);
+        _output[CLNV12PlaneY] = get_cached_va_image (context, output, cl_desc, out_info.offsets[CLNV12PlaneY]);
         cl_desc.height /= 2;
         cl_desc.row_pitch = out_info.strides[CLNV12PlaneUV];
-        _output[CLNV12PlaneUV] = new CLVaImage (context, output, cl_desc, out_info.offsets[CLNV12PlaneUV]);
+        _output[CLNV12PlaneUV] = get_cached_va_image (context, output, cl_desc, out_info.offsets[CLNV12PlaneUV]);
     } else {
         cl_desc.format.image_channel_data_type = CL_UNSIGNED_INT8;
         cl_desc.format.image_channel_order = CL_RGBA;
         cl_desc.width = XCAM_ALIGN_DOWN (out_info.width, 4) / 4; //CL_RGBA * CL_UNSIGNED_INT8 = 4
         cl_desc.height = XCAM_ALIGN_DOWN (out_info.height, 2);
         cl_desc.row_pitch = out_info.strides[CLNV12PlaneY];
-        _output[CLNV12PlaneY] = new CLVaImage (context, output, cl_desc, out_info.offsets[CLNV12PlaneY]);
+        _output[CLNV12PlaneY] = get_cached_va_image (context, output, cl_desc, out_info.offsets[CLNV12PlaneY]);
         cl_desc.height /= 2;
         cl_desc.row_pitch = out_info.strides[CLNV12PlaneUV];
-        _output[CLNV12PlaneUV] = new CLVaImage (context, output, cl_desc, out_info.offsets[CLNV12PlaneUV]);
+        _output[CLNV12PlaneUV] = get_cached_va_image (context, output, cl_desc, out_info.offsets[CLNV12PlaneUV]);
     }
 
     XCAM_ASSERT (
@@ -27,16 +27,7 @@
 
 namespace XCam {
 
-struct CLFisheyeInfo {
-    float    center_x;
-    float    center_y;
-    float    wide_angle;
-    float    radius;
-    float    rotate_angle; // clockwise
-
-    CLFisheyeInfo ();
-    bool is_valid () const;
-};
+typedef FisheyeInfo CLFisheyeInfo;
 
 class CLFisheyeHandler;
 class CLFisheye2GPSKernel
@@ -106,14 +106,14 @@ CLGaussImageKernel::prepare_arguments (
     cl_desc_in.width = video_info_in.width;
     cl_desc_in.height = video_info_in.height;
     cl_desc_in.row_pitch = video_info_in.strides[0];
-    _image_in = new CLVaImage (context, input_buf, cl_desc_in, video_info_in.offsets[0]);
+    _image_in = get_cached_va_image (context, input_buf, cl_desc_in, video_info_in.offsets[0]);
 
     cl_desc_out.format.image_channel_data_type = CL_UNORM_INT8;
     cl_desc_out.format.image_channel_order = CL_RGBA;
     cl_desc_out.width = video_info_out.width / 4;
     cl_desc_out.height = video_info_out.height;
     cl_desc_out.row_pitch = video_info_out.strides[0];
-    _image_out = new CLVaImage (context, output_buf, cl_desc_out, video_info_out.offsets[0]);
+    _image_out = get_cached_va_image (context, output_buf, cl_desc_out, video_info_out.offsets[0]);
 
     if (!_g_table_buffer.ptr ()) {
         _g_table_buffer = new CLBuffer(
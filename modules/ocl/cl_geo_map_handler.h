@@ -26,13 +26,6 @@
 
 namespace XCam {
 
-struct GeoPos {
-    double x;
-    double y;
-
-    GeoPos () : x(0), y(0) {}
-};
-
 class CLGeoMapKernel;
 class GeoKernelParamCallback
 {
@@ -52,13 +52,13 @@ CLBlenderGlobalScaleKernel::get_input_image (SmartPtr<DrmBoBuffer> &input) {
         cl_desc.width = buf_info.width / 2;
         cl_desc.height = buf_info.height / 2;
         cl_desc.row_pitch = buf_info.strides[1];
-        cl_image = new CLVaImage (context, input, cl_desc, buf_info.offsets[1]);
+        cl_image = get_cached_va_image (context, input, cl_desc, buf_info.offsets[1]);
     } else {
         cl_desc.format.image_channel_order = CL_R;
         cl_desc.width = buf_info.width;
         cl_desc.height = buf_info.height;
         cl_desc.row_pitch = buf_info.strides[0];
-        cl_image = new CLVaImage (context, input, cl_desc, buf_info.offsets[0]);
+        cl_image = get_cached_va_image (context, input, cl_desc, buf_info.offsets[0]);
     }
 
     return cl_image;
@@ -78,12 +78,12 @@ CLBlenderGlobalScaleKernel::get_output_image (SmartPtr<DrmBoBuffer> &output) {
         cl_desc.width = buf_info.width / 8;
         cl_desc.height = buf_info.height / 2;
         cl_desc.row_pitch = buf_info.strides[1];
-        cl_image = new CLVaImage (context, output, cl_desc, buf_info.offsets[1]);
+        cl_image = get_cached_va_image (context, output, cl_desc, buf_info.offsets[1]);
     } else {
         cl_desc.width = buf_info.width / 8;
         cl_desc.height = buf_info.height;
         cl_desc.row_pitch = buf_info.strides[0];
-        cl_image = new CLVaImage (context, output, cl_desc, buf_info.offsets[0]);
+        cl_image = get_cached_va_image (context, output, cl_desc, buf_info.offsets[0]);
     }
 
     return cl_image;
@@ -487,6 +487,7 @@ CLImage360Stitch::create_bo_buffer (uint32_t width, uint32_t height)
     SmartPtr<DrmDisplay> display = DrmDisplay::instance ();
     SmartPtr<BufferPool> buf_pool = new DrmBoBufferPool (display);
     XCAM_ASSERT (buf_pool.ptr ());
+    buf_pool->set_name ("cl_stitch_overlap");
     buf_pool->set_video_info (buf_info);
     if (!buf_pool->reserve (1)) {
         XCAM_LOG_ERROR ("init buffer pool failed");
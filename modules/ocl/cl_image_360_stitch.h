@@ -28,31 +28,7 @@
 
 namespace XCam {
 
-enum ImageIdx {
-    ImageIdxMain,
-    ImageIdxSecondary,
-    ImageIdxCount,
-};
-
-struct ImageCropInfo {
-    uint32_t left;
-    uint32_t right;
-    uint32_t top;
-    uint32_t bottom;
-
-    ImageCropInfo () : left (0), right (0), top (0), bottom (0) {}
-};
-
-struct CLStitchInfo {
-    uint32_t merge_width[ImageIdxCount];
-
-    ImageCropInfo crop[ImageIdxCount];
-    CLFisheyeInfo fisheye_info[ImageIdxCount];
-
-    CLStitchInfo () {
-        xcam_mem_clear (merge_width);
-    }
-};
+typedef StitchInfo CLStitchInfo;
 
 typedef struct {
     Rect merge_left;
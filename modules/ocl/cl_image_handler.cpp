@@ -23,6 +23,7 @@
 #include "cl_device.h"
 #include "cl_image_bo_buffer.h"
 #include "swapped_buffer.h"
+#include "xcam_trace.h"
 
 namespace XCam {
 
@@ -98,6 +99,16 @@ CLImageKernel::pre_execute (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer>
     return XCAM_RETURN_NO_ERROR;
 }
 
+XCamReturn
+CLImageKernel::execute_after (CLEventList &events_wait)
+{
+    _execute_event = new CLEvent;
+    XCamReturn ret = execute (events_wait, _execute_event);
+    if (ret != XCAM_RETURN_NO_ERROR || !_execute_event->get_event_id ())
+        _execute_event.release ();
+    return ret;
+}
+
 XCamReturn
 CLImageKernel::prepare_arguments (
     SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output,
@@ -105,8 +116,8 @@ CLImageKernel::prepare_arguments (
 {
     SmartPtr<CLContext> context = get_context ();
 
-    _image_in = new CLVaImage (context, input);
-    _image_out = new CLVaImage (context, output);
+    _image_in = get_cached_va_image (context, input);
+    _image_out = get_cached_va_image (context, output);
 
     XCAM_ASSERT (_image_in->is_valid () && _image_out->is_valid ());
     XCAM_FAIL_RETURN (
@@ -158,15 +169,37 @@ CLImageHandler::CLImageHandler (const char *name)
     if (name)
         _name = strndup (name, XCAM_MAX_STR_SIZE);
 
+    _metrics = MetricsRegistry::instance ()->register_group ("cl_handler", _name);
+    _execute_latency = _metrics->get_histogram ("execute");
+    _frames_counter = _metrics->get_counter ("frames");
+    _bypassed_counter = _metrics->get_counter ("bypassed");
+    _errors_counter = _metrics->get_counter ("errors");
+
     XCAM_OBJ_PROFILING_INIT;
 }
 
 CLImageHandler::~CLImageHandler ()
 {
+    MetricsRegistry::instance ()->unregister_group (_metrics);
     if (_name)
         xcam_free (_name);
 }
 
+void
+CLImageHandler::update_execute_metrics (int64_t duration_us, XCamReturn ret)
+{
+    if (!MetricsRegistry::is_enabled ())
+        return;
+
+    _execute_latency->record (duration_us);
+    if (ret == XCAM_RETURN_NO_ERROR)
+        _frames_counter->add ();
+    else if (ret == XCAM_RETURN_BYPASS)
+        _bypassed_counter->add ();
+    else
+        _errors_counter->add ();
+}
+
 bool
 CLImageHandler::enable_buf_pool_swap_flags (
     uint32_t flags,
@@ -236,6 +269,7 @@ CLImageHandler::create_buffer_pool (const VideoBufferInfo &video_info)
         XCAM_RETURN_ERROR_CL,
         "CLImageHandler(%s) create buffer pool failed, pool_type:%d",
         XCAM_STR (_name), (int32_t)_buf_pool_type);
+    buffer_pool->set_name (XCAM_STR (_name));
 
     XCAM_ASSERT (buffer_pool.ptr ());
     buffer_pool->set_swap_flags (_buf_swap_flags, _buf_swap_init_order);
@@ -343,6 +377,11 @@ CLImageHandler::execute (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &ou
         XCAM_RETURN_ERROR_PARAM,
         "cl_image_handler(%s) no image kernel set", XCAM_STR (_name));
 
+    // events only chain one execute, never leak into the next buffer
+    CLEventList events_wait;
+    events_wait.swap (_wait_events);
+    _done_event.release ();
+
     if (!is_handler_enabled ()) {
         output = input;
         return XCAM_RETURN_NO_ERROR;
@@ -365,6 +404,7 @@ CLImageHandler::execute (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &ou
         return ret;
 
     XCAM_OBJ_PROFILING_START;
+    TraceSpan span ("cl_handler", _name);
 
     for (KernelList::iterator i_kernel = _kernels.begin ();
             i_kernel != _kernels.end (); ++i_kernel) {
@@ -388,7 +428,7 @@ CLImageHandler::execute (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &ou
 
         XCAM_FAIL_RETURN (
             WARNING,
-            (ret = kernel->execute ()) == XCAM_RETURN_NO_ERROR,
+            (ret = execute_kernel (kernel, events_wait)) == XCAM_RETURN_NO_ERROR,
             ret,
             "cl_image_handler(%s) execute kernel(%s) failed",
             XCAM_STR (_name), kernel->get_kernel_name ());
@@ -419,6 +459,27 @@ CLImageHandler::execute (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &ou
     return ret;
 }
 
+/*
+ * kernels are chained by events instead of blocking on each one,
+ * @events_wait is replaced by the event of this kernel for the next one.
+ */
+XCamReturn
+CLImageHandler::execute_kernel (SmartPtr<CLImageKernel> &kernel, CLEventList &events_wait)
+{
+    TraceSpan span ("cl_kernel", kernel->get_kernel_name ());
+    XCamReturn ret = kernel->execute_after (events_wait);
+    if (ret != XCAM_RETURN_NO_ERROR)
+        return ret;
+
+    SmartPtr<CLEvent> &event = kernel->get_execute_event ();
+    events_wait.clear ();
+    if (event.ptr ()) {
+        events_wait.push_back (event);
+        _done_event = event;
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
 XCamReturn
 CLImageHandler::execute_done (SmartPtr<DrmBoBuffer> &output)
 {
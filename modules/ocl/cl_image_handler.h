@@ -26,6 +26,8 @@
 #include "drm_bo_buffer.h"
 #include "cl_memory.h"
 #include "x3a_result.h"
+#include "xcam_mutex.h"
+#include "xcam_metrics.h"
 
 namespace XCam {
 
@@ -61,7 +63,14 @@ public:
         return _enable;
     }
 
+    // completion event of last execute_after, kept until next one
+    SmartPtr<CLEvent> &get_execute_event () {
+        return _execute_event;
+    }
+
     XCamReturn pre_execute (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output);
+    // enqueue kernel after @events_wait, no host blocking
+    XCamReturn execute_after (CLEventList &events_wait);
     virtual XCamReturn post_execute (SmartPtr<DrmBoBuffer> &output);
     virtual void pre_stop () {}
 
@@ -80,6 +89,7 @@ protected:
 
 private:
     bool                _enable;
+    SmartPtr<CLEvent>   _execute_event;
 };
 
 class CLMultiImageHandler;
@@ -132,6 +142,29 @@ public:
     bool enable_handler (bool enable);
     bool is_handler_enabled () const;
 
+    /*
+     * events which the first kernel of next execute waits for,
+     * usually the done event of previous handler on the same buffer.
+     */
+    void set_wait_events (const CLEventList &events) {
+        _wait_events = events;
+    }
+    // event of the last kernel enqueued by execute, NULL if nothing enqueued
+    SmartPtr<CLEvent> &get_done_event () {
+        return _done_event;
+    }
+
+    // held by processor around execute, lets frames run in different handlers at once
+    Mutex &get_execute_mutex () {
+        return _execute_mutex;
+    }
+
+    // group "cl_handler/<name>", updated by the processor around execute
+    SmartPtr<MetricsGroup> &get_metrics () {
+        return _metrics;
+    }
+    void update_execute_metrics (int64_t duration_us, XCamReturn ret);
+
     virtual bool is_ready ();
     virtual XCamReturn execute (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output);
     virtual void emit_stop ();
@@ -151,6 +184,7 @@ protected:
     }
 
     bool append_kernels (SmartPtr<CLImageHandler> handler);
+    XCamReturn execute_kernel (SmartPtr<CLImageKernel> &kernel, CLEventList &events_wait);
 
 private:
     XCAM_DEAD_COPY (CLImageHandler);
@@ -167,6 +201,15 @@ private:
     uint32_t                   _buf_swap_init_order;
     X3aResultList              _3a_results;
     int64_t                    _result_timestamp;
+    CLEventList                _wait_events;
+    SmartPtr<CLEvent>          _done_event;
+    Mutex                      _execute_mutex;
+
+    SmartPtr<MetricsGroup>     _metrics;
+    SmartPtr<MetricHistogram>  _execute_latency;
+    SmartPtr<MetricCounter>    _frames_counter;
+    SmartPtr<MetricCounter>    _bypassed_counter;
+    SmartPtr<MetricCounter>    _errors_counter;
 
     XCAM_OBJ_PROFILING_DEFINES;
 };
@@ -24,6 +24,7 @@
 #include "drm_display.h"
 #include "cl_demo_handler.h"
 #include "xcam_thread.h"
+#include "xcam_trace.h"
 
 namespace XCam {
 
@@ -34,7 +35,10 @@ public:
     CLHandlerThread (CLImageProcessor *processor)
         : Thread ("CLHandlerThread")
         , _processor (processor)
-    {}
+    {
+        // loop waits at most 5ms on the buffer queue, fine to share pool workers
+        set_pool_mode (true, PoolTaskPriorityHigh);
+    }
     ~CLHandlerThread () {}
 
     virtual bool loop ();
@@ -80,16 +84,18 @@ CLImageProcessor::CLImageProcessor (const char* name)
     : ImageProcessor (name ? name : "CLImageProcessor")
     , _seq_num (0)
     , _keep_attached_buffer (false)
+    , _async_mode (true)
+    , _in_flight_depth (XCAM_CL_IMAGE_PROCESSOR_DEFAULT_IN_FLIGHT)
+    , _next_done_seq (0)
 {
     _context = CLDevice::instance ()->get_context ();
     XCAM_ASSERT (_context.ptr());
 
-    _handler_thread = new CLHandlerThread (this);
-    XCAM_ASSERT (_handler_thread.ptr ());
-
     _done_buf_thread = new CLBufferNotifyThread (this);
     XCAM_ASSERT (_done_buf_thread.ptr ());
 
+    _done_queue_depth = _metrics->get_gauge ("done_queue");
+
     XCAM_LOG_DEBUG ("CLImageProcessor constructed");
     XCAM_OBJ_PROFILING_INIT;
 }
@@ -105,6 +111,38 @@ CLImageProcessor::keep_attached_buf(bool flag)
     _keep_attached_buffer = flag;
 }
 
+bool
+CLImageProcessor::set_in_flight_depth (uint32_t depth)
+{
+    XCAM_FAIL_RETURN (
+        WARNING,
+        depth > 0 && _handler_threads.empty (),
+        false,
+        "CLImageProcessor set in-flight depth(%d) failed, must be set before start", depth);
+
+    _in_flight_depth = depth;
+    return true;
+}
+
+CLImageProcessor::StreamLock::StreamLock (CLImageProcessor *processor)
+    : _stream_mutex (processor->_stream_mutex)
+{
+    // waits for frames running in handlers, shows up as a gap in trace
+    TraceSpan span ("lock", "stream_lock_wait");
+
+    _stream_mutex.lock ();
+    _handlers = processor->_handlers;
+    for (ImageHandlerList::iterator i = _handlers.begin (); i != _handlers.end (); ++i)
+        (*i)->get_execute_mutex ().lock ();
+}
+
+CLImageProcessor::StreamLock::~StreamLock ()
+{
+    for (ImageHandlerList::reverse_iterator i = _handlers.rbegin (); i != _handlers.rend (); ++i)
+        (*i)->get_execute_mutex ().unlock ();
+    _stream_mutex.unlock ();
+}
+
 bool
 CLImageProcessor::add_handler (SmartPtr<CLImageHandler> &handler)
 {
@@ -169,7 +207,8 @@ CLImageProcessor::process_buffer (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBu
     // Always set to NULL,  output buf should be handled in CLBufferNotifyThread
     output = NULL;
 
-    STREAM_LOCK;
+    // only guard handler creation, never wait for running handlers
+    SmartLock stream_lock (_stream_mutex);
 
     if (_handlers.empty()) {
         ret = create_handlers ();
@@ -186,11 +225,11 @@ CLImageProcessor::process_buffer (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBu
     p_buf->data = drm_bo_in;
     p_buf->handler = *(_handlers.begin ());
 
-    XCAM_FAIL_RETURN (
-        WARNING,
-        _process_buffer_queue.push_priority_buf (p_buf),
-        XCAM_RETURN_ERROR_UNKNOWN,
-        "CLImageProcessor push priority buffer failed");
+    if (!_process_buffer_queue.push_priority_buf (p_buf)) {
+        XCAM_LOG_WARNING ("CLImageProcessor push priority buffer failed");
+        retire_buffer (p_buf, true);
+        return XCAM_RETURN_ERROR_UNKNOWN;
+    }
 
     return XCAM_RETURN_BYPASS;
 }
@@ -198,80 +237,181 @@ CLImageProcessor::process_buffer (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBu
 XCamReturn
 CLImageProcessor::process_done_buffer ()
 {
-    SmartPtr<DrmBoBuffer> done_buf = _done_buffer_queue.pop (-1);
+    SmartPtr<PriorityBuffer> done_buf = _done_buffer_queue.pop (-1);
     if (!done_buf.ptr ())
         return XCAM_RETURN_ERROR_THREAD;
 
+    XCAM_ASSERT (done_buf->data.ptr ());
+    if (done_buf->event.ptr ()) {
+        XCAM_OBJ_PROFILING_START;
+        if (done_buf->event->wait () != XCAM_RETURN_NO_ERROR) {
+            XCAM_LOG_WARNING ("CLImageProcessor wait buf:%d done event failed", done_buf->seq_num);
+        }
+        XCAM_OBJ_PROFILING_END (get_name (), XCAM_OBJ_DUR_FRAME_NUM);
+        done_buf->event.release ();
+    }
+
     //notify buffer done, only in this thread
-    notify_process_buffer_done (done_buf);
+    notify_process_buffer_done (done_buf->data);
     return XCAM_RETURN_NO_ERROR;
 }
 
+// call with _stream_mutex held
+bool
+CLImageProcessor::is_buffer_ready (const SmartPtr<PriorityBuffer> &buf)
+{
+    CLImageHandler *handler = buf->handler.ptr ();
+    XCAM_ASSERT (handler);
+
+    // one frame per handler at a time
+    if (_busy_handlers.find (handler) != _busy_handlers.end ())
+        return false;
+
+    // keep seq order inside handler, an earlier frame is still waiting
+    for (UnsafePriorityBufferList::iterator i = _not_ready_buffers.begin ();
+            i != _not_ready_buffers.end (); ++i) {
+        if ((*i)->handler.ptr () == handler && (int32_t)((*i)->seq_num - buf->seq_num) < 0)
+            return false;
+    }
+
+    return !handler->is_handler_enabled () || handler->is_ready ();
+}
+
+// call with _stream_mutex held
 uint32_t
 CLImageProcessor::check_ready_buffers ()
 {
     uint32_t ready_count = 0;
-    bool is_ready_or_disabled = false;
     UnsafePriorityBufferList::iterator i = _not_ready_buffers.begin ();
 
     while (i != _not_ready_buffers.end()) {
         SmartPtr<PriorityBuffer> buf = *i;
         XCAM_ASSERT (buf.ptr () && buf->handler.ptr ());
-        {
-            is_ready_or_disabled = (!buf->handler->is_handler_enabled () || buf->handler->is_ready ());
-        }
-        if (is_ready_or_disabled) {
+        _not_ready_buffers.erase (i++);
+
+        if (is_buffer_ready (buf)) {
             ready_count ++;
             _process_buffer_queue.push_priority_buf (buf);
-            _not_ready_buffers.erase (i++);
-        } else
-            ++i;
+        } else {
+            _not_ready_buffers.insert (i, buf);
+        }
     }
     return ready_count;
 }
 
+void
+CLImageProcessor::retire_buffer (const SmartPtr<PriorityBuffer> &buf, bool dropped)
+{
+    std::list<SmartPtr<DrmBoBuffer> > failed_buffers;
+
+    {
+        SmartLock locker (_reorder_mutex);
+
+        XCAM_ASSERT (buf.ptr ());
+        _reorder_buffers[buf->seq_num] = (dropped ? NULL : buf);
+        if (dropped && MetricsRegistry::is_enabled ())
+            _frames_dropped->add ();
+
+        ReorderBufferMap::iterator i = _reorder_buffers.find (_next_done_seq);
+        while (i != _reorder_buffers.end ()) {
+            if (i->second.ptr () && !_done_buffer_queue.push (i->second)) {
+                XCAM_LOG_WARNING ("cl image processor done queue full, frame(seq:%d) dropped", i->first);
+                if (MetricsRegistry::is_enabled ())
+                    _frames_dropped->add ();
+                failed_buffers.push_back (i->second->data);
+            }
+            _reorder_buffers.erase (i);
+            i = _reorder_buffers.find (++_next_done_seq);
+        }
+        if (MetricsRegistry::is_enabled ())
+            _done_queue_depth->set (_done_buffer_queue.size ());
+    }
+
+    // callbacks run without the reorder lock, as done buffers do
+    for (std::list<SmartPtr<DrmBoBuffer> >::iterator i = failed_buffers.begin ();
+            i != failed_buffers.end (); ++i)
+        notify_process_buffer_failed (*i);
+}
+
 XCamReturn
 CLImageProcessor::process_cl_buffer_queue ()
 {
     XCamReturn ret = XCAM_RETURN_NO_ERROR;
     SmartPtr<PriorityBuffer> p_buf;
+    SmartPtr<CLImageHandler> handler;
     const int32_t timeout = 5000; // 5ms
-    uint32_t ready_count = 0;
 
     {
-        STREAM_LOCK;  // make sure handler APIs are protected
-        check_ready_buffers ();
-    }
-
-    p_buf = _process_buffer_queue.pop (timeout);
+        // pop and claim handler in one step, so frames enter each handler in seq order
+        SmartLock dispatch_lock (_dispatch_mutex);
+        {
+            SmartLock stream_lock (_stream_mutex);
+            check_ready_buffers ();
+        }
 
-    if (!p_buf.ptr ()) {
-        //XCAM_LOG_DEBUG ("cl buffer queue stopped");
-        return XCAM_RETURN_BYPASS;
-    }
+        p_buf = _process_buffer_queue.pop (timeout);
 
-    SmartPtr<DrmBoBuffer> data = p_buf->data;
-    SmartPtr<CLImageHandler> handler = p_buf->handler;
-    SmartPtr <DrmBoBuffer> out_data;
+        if (!p_buf.ptr ()) {
+            //XCAM_LOG_DEBUG ("cl buffer queue stopped");
+            return XCAM_RETURN_BYPASS;
+        }
 
-    XCAM_ASSERT (data.ptr () && handler.ptr ());
+        handler = p_buf->handler;
+        XCAM_ASSERT (p_buf->data.ptr () && handler.ptr ());
 
-    XCAM_LOG_DEBUG ("buf:%d, rank:%d\n", p_buf->seq_num, p_buf->rank);
+        XCAM_LOG_DEBUG ("buf:%d, rank:%d\n", p_buf->seq_num, p_buf->rank);
 
-    {
-        STREAM_LOCK;
-        if (handler->is_handler_enabled () && !handler->is_ready ()) {
+        SmartLock stream_lock (_stream_mutex);
+        if (!is_buffer_ready (p_buf)) {
             _not_ready_buffers.push_back (p_buf);
             return XCAM_RETURN_NO_ERROR;
         }
 
-        ready_count = check_ready_buffers ();
-        if (ready_count) {
+        if (check_ready_buffers ()) {
             _process_buffer_queue.push_priority_buf (p_buf);
             return XCAM_RETURN_BYPASS;
         }
 
-        ret = handler->execute (data, out_data);
+        _busy_handlers.insert (handler.ptr ());
+    }
+
+    ret = execute_handler (p_buf);
+    if (ret != XCAM_RETURN_NO_ERROR)
+        retire_buffer (p_buf, true);
+
+    {
+        // handler free again, wake up frames waiting on it
+        SmartLock stream_lock (_stream_mutex);
+        _busy_handlers.erase (handler.ptr ());
+        check_ready_buffers ();
+    }
+
+    return ret;
+}
+
+/*
+ * run with handler marked busy, next handler of the same frame is
+ * queued before the mark is cleared to keep seq order along the chain.
+ */
+XCamReturn
+CLImageProcessor::execute_handler (SmartPtr<PriorityBuffer> &p_buf)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    SmartPtr<CLImageHandler> handler = p_buf->handler;
+    SmartPtr <DrmBoBuffer> out_data;
+    TraceFrameScope trace_frame (p_buf->data->get_timestamp (), p_buf->seq_num);
+
+    {
+        SmartLock handler_lock (handler->get_execute_mutex ());
+        if (p_buf->event.ptr ()) {
+            CLEventList events_wait;
+            events_wait.push_back (p_buf->event);
+            handler->set_wait_events (events_wait);
+        }
+        int64_t start_us = MetricsRegistry::is_enabled () ? xcam_metrics_now_us () : 0;
+        ret = handler->execute (p_buf->data, out_data);
+        if (start_us)
+            handler->update_execute_metrics (xcam_metrics_now_us () - start_us, ret);
         XCAM_FAIL_RETURN (
             WARNING,
             (ret == XCAM_RETURN_NO_ERROR || ret == XCAM_RETURN_BYPASS),
@@ -281,6 +421,17 @@ CLImageProcessor::process_cl_buffer_queue ()
         if (ret == XCAM_RETURN_BYPASS)
             return ret;
 
+        if (handler->get_done_event ().ptr ())
+            p_buf->event = handler->get_done_event ();
+
+        // handlers with own output buffers may skip copy_attaches
+        if (out_data.ptr () != p_buf->data.ptr ())
+            out_data->copy_stage_times (*p_buf->data.ptr ());
+    }
+
+    {
+        SmartLock stream_lock (_stream_mutex);
+
         // for loop in handler, find next handler
         ImageHandlerList::iterator i_handler = _handlers.begin ();
         while (i_handler != _handlers.end ())
@@ -307,12 +458,26 @@ CLImageProcessor::process_cl_buffer_queue ()
         if (!_keep_attached_buffer && out_data.ptr ())
             out_data->clear_attached_buffers ();
 
-        XCAM_OBJ_PROFILING_START;
-        CLDevice::instance()->get_context ()->finish ();
-        XCAM_OBJ_PROFILING_END (get_name (), XCAM_OBJ_DUR_FRAME_NUM);
+        p_buf->data = out_data;
+        p_buf->event.release ();
+
+        if (_async_mode) {
+            // marker with empty wait list also covers copy/map commands of handlers
+            SmartPtr<CLEvent> marker = new CLEvent;
+            if (_context->enqueue_marker (CLEvent::EmptyList, marker) == XCAM_RETURN_NO_ERROR) {
+                p_buf->event = marker;
+                _context->flush ();
+            }
+        }
+
+        if (!p_buf->event.ptr ()) {
+            // handler threads run concurrently, _obj_profiling belongs to notify thread
+            TraceSpan span ("cl", "finish");
+            _context->finish ();
+        }
 
-        // buffer done, push back
-        _done_buffer_queue.push (out_data);
+        // buffer done, push back in seq order
+        retire_buffer (p_buf, false);
         return XCAM_RETURN_NO_ERROR;
     }
 
@@ -334,11 +499,24 @@ CLImageProcessor::emit_start ()
     _done_buffer_queue.resume_pop ();
     _process_buffer_queue.resume_pop ();
 
+    {
+        // frames dropped by last stop never come back
+        SmartLock locker (_reorder_mutex);
+        _reorder_buffers.clear ();
+        _next_done_seq = _seq_num;
+    }
+
     if (!_done_buf_thread->start ())
         return XCAM_RETURN_ERROR_THREAD;
 
-    if (!_handler_thread->start ())
-        return XCAM_RETURN_ERROR_THREAD;
+    while (_handler_threads.size () < _in_flight_depth)
+        _handler_threads.push_back (new CLHandlerThread (this));
+
+    for (HandlerThreadList::iterator i = _handler_threads.begin ();
+            i != _handler_threads.end (); ++i) {
+        if (!(*i)->start ())
+            return XCAM_RETURN_ERROR_THREAD;
+    }
 
     return XCAM_RETURN_NO_ERROR;
 }
@@ -355,11 +533,19 @@ CLImageProcessor::emit_stop ()
         (*i_handler)->emit_stop ();
     }
 
-    _handler_thread->stop ();
+    for (HandlerThreadList::iterator i = _handler_threads.begin ();
+            i != _handler_threads.end (); ++i) {
+        (*i)->stop ();
+    }
     _done_buf_thread->stop ();
     _not_ready_buffers.clear ();
+    _busy_handlers.clear ();
     _process_buffer_queue.clear ();
     _done_buffer_queue.clear ();
+    {
+        SmartLock locker (_reorder_mutex);
+        _reorder_buffers.clear ();
+    }
 }
 
 XCamReturn
@@ -25,6 +25,10 @@
 #include "image_processor.h"
 #include "priority_buffer_queue.h"
 #include <list>
+#include <map>
+#include <set>
+
+#define XCAM_CL_IMAGE_PROCESSOR_DEFAULT_IN_FLIGHT 1
 
 namespace XCam {
 
@@ -39,6 +43,8 @@ class CLImageProcessor
 public:
     typedef std::list<SmartPtr<CLImageHandler>>  ImageHandlerList;
     typedef std::list<SmartPtr<PriorityBuffer>>  UnsafePriorityBufferList;
+    typedef std::list<SmartPtr<CLHandlerThread>> HandlerThreadList;
+    typedef std::map<uint32_t, SmartPtr<PriorityBuffer>> ReorderBufferMap;
     friend class CLHandlerThread;
     friend class CLBufferNotifyThread;
 
@@ -48,6 +54,29 @@ public:
 
     void keep_attached_buf (bool flag);
 
+    /*
+     * async mode (default), handler thread never blocks on CL queue,
+     * each done buffer carries an event which notify thread waits on.
+     * sync mode, clFinish on each done buffer in handler thread.
+     */
+    void set_async_mode (bool async) {
+        _async_mode = async;
+    }
+    bool is_async_mode () const {
+        return _async_mode;
+    }
+
+    /*
+     * max frames executed at the same time, each in a different handler;
+     * one handler still runs frames one by one in seq order and done
+     * buffers are always notified in seq order.
+     * **** MUST be set before start ****
+     */
+    bool set_in_flight_depth (uint32_t depth);
+    uint32_t get_in_flight_depth () const {
+        return _in_flight_depth;
+    }
+
     bool add_handler (SmartPtr<CLImageHandler> &handler);
     ImageHandlerList::iterator handlers_begin ();
     ImageHandlerList::iterator handlers_end ();
@@ -68,28 +97,53 @@ private:
     virtual XCamReturn create_handlers ();
 
     XCamReturn process_cl_buffer_queue ();
+    XCamReturn execute_handler (SmartPtr<PriorityBuffer> &p_buf);
     XCamReturn process_done_buffer ();
+    bool is_buffer_ready (const SmartPtr<PriorityBuffer> &buf);
     uint32_t check_ready_buffers ();
+    void retire_buffer (const SmartPtr<PriorityBuffer> &buf, bool dropped);
 
     XCAM_DEAD_COPY (CLImageProcessor);
 
 protected:
 
+    // stream lock, also waits for running handlers and holds them back
+    class StreamLock {
+    public:
+        explicit StreamLock (CLImageProcessor *processor);
+        ~StreamLock ();
+
+    private:
+        XCAM_DEAD_COPY (StreamLock);
+
+    private:
+        Mutex                     &_stream_mutex;
+        ImageHandlerList           _handlers;
+    };
+
 // STREAM_LOCK only used in class derived from CLImageProcessor
-#define STREAM_LOCK SmartLock stream_lock (this->_stream_mutex)
+#define STREAM_LOCK CLImageProcessor::StreamLock stream_lock (this)
     // stream lock
     Mutex                          _stream_mutex;
 
 private:
     SmartPtr<CLContext>            _context;
     ImageHandlerList               _handlers;
-    SmartPtr<CLHandlerThread>      _handler_thread;
+    HandlerThreadList              _handler_threads;
     PriorityBufferQueue            _process_buffer_queue;
     UnsafePriorityBufferList       _not_ready_buffers;
+    std::set<CLImageHandler *>     _busy_handlers;
+    Mutex                          _dispatch_mutex;
     SmartPtr<CLBufferNotifyThread> _done_buf_thread;
-    SafeList<DrmBoBuffer>          _done_buffer_queue;
+    SafeList<PriorityBuffer>       _done_buffer_queue;
     uint32_t                       _seq_num;
     bool                           _keep_attached_buffer;  //default false
+    bool                           _async_mode;            //default true
+    uint32_t                       _in_flight_depth;
+    Mutex                          _reorder_mutex;
+    ReorderBufferMap               _reorder_buffers;
+    uint32_t                       _next_done_seq;
+    SmartPtr<MetricGauge>          _done_queue_depth;
     XCAM_OBJ_PROFILING_DEFINES;
 };
 
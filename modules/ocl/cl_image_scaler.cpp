@@ -20,9 +20,100 @@
 
 #include "xcam_utils.h"
 #include "cl_image_scaler.h"
+#include "xcam_thread.h"
+#include "safe_list.h"
 
 namespace XCam {
 
+struct ScalerPostData {
+    SmartPtr<DrmBoBuffer> buffer;
+    SmartPtr<CLEvent>     done_event;
+};
+
+/*
+ * waits for scaled buffers in submission order and posts them to the
+ * scaler callback, so the handler thread never blocks on the queue.
+ */
+class CLImageScalerPostThread
+    : public Thread
+{
+public:
+    CLImageScalerPostThread (CLImageScaler *scaler)
+        : Thread ("CLImageScalerPostThread")
+        , _scaler (scaler)
+    {}
+    ~CLImageScalerPostThread () {}
+
+    virtual bool emit_stop ();
+    bool queue_buffer (const SmartPtr<DrmBoBuffer> &buffer, const SmartPtr<CLEvent> &done_event);
+
+protected:
+    virtual bool started ();
+    virtual bool loop ();
+    virtual void stopped ();
+
+private:
+    CLImageScaler              *_scaler;
+    SafeList<ScalerPostData>    _post_list;
+};
+
+bool
+CLImageScalerPostThread::emit_stop ()
+{
+    _post_list.pause_pop ();
+    _post_list.wakeup ();
+
+    return Thread::emit_stop ();
+}
+
+bool
+CLImageScalerPostThread::queue_buffer (
+    const SmartPtr<DrmBoBuffer> &buffer, const SmartPtr<CLEvent> &done_event)
+{
+    SmartPtr<ScalerPostData> data = new ScalerPostData;
+    XCAM_ASSERT (data.ptr ());
+    data->buffer = buffer;
+    data->done_event = done_event;
+
+    return _post_list.push (data);
+}
+
+bool
+CLImageScalerPostThread::started ()
+{
+    _post_list.resume_pop ();
+    return true;
+}
+
+void
+CLImageScalerPostThread::stopped ()
+{
+    _post_list.clear ();
+}
+
+bool
+CLImageScalerPostThread::loop ()
+{
+    SmartPtr<ScalerPostData> data = _post_list.pop ();
+    if (!data.ptr ()) {
+        XCAM_LOG_INFO ("cl image scaler post thread is going to stop, processing data empty");
+        return false;
+    }
+
+    XCAM_ASSERT (data->buffer.ptr ());
+    XCAM_ASSERT (_scaler);
+
+    // only wait for this frame, later frames may be queued already
+    if (data->done_event.ptr () && data->done_event->wait () != XCAM_RETURN_NO_ERROR) {
+        XCAM_LOG_WARNING ("cl image scaler wait done event failed, drop scaled buffer");
+        return true;
+    }
+
+    if (_scaler->notify_buffer (data->buffer) != XCAM_RETURN_NO_ERROR)
+        XCAM_LOG_WARNING ("cl image scaler post scaled buffer failed");
+    return true;
+}
+
 CLScalerKernel::CLScalerKernel (
     SmartPtr<CLContext> &context,
     CLImageScalerMemoryLayout mem_layout
@@ -87,7 +178,7 @@ CLScalerKernel::prepare_arguments (
         output_imageDesc.height = output_info.height / 2;
         output_imageDesc.row_pitch = output_info.strides[1];
 
-        _image_out = new CLVaImage (context, output_buf, output_imageDesc, output_info.offsets[1]);
+        _image_out = get_cached_va_image (context, output_buf, output_imageDesc, output_info.offsets[1]);
         _output_width = output_info.width / 2;
         _output_height = output_info.height / 2;
     } else {
@@ -96,7 +187,7 @@ CLScalerKernel::prepare_arguments (
         output_imageDesc.height = output_info.height;
         output_imageDesc.row_pitch = output_info.strides[0];
 
-        _image_out = new CLVaImage (context, output_buf, output_imageDesc, output_info.offsets[0]);
+        _image_out = get_cached_va_image (context, output_buf, output_imageDesc, output_info.offsets[0]);
         _output_width = output_info.width;
         _output_height = output_info.height;
     }
@@ -114,14 +205,14 @@ CLScalerKernel::prepare_arguments (
         input_imageDesc.height = input_info.height / 2;
         input_imageDesc.row_pitch = input_info.strides[1];
 
-        _image_in = new CLVaImage (context, input_buf, input_imageDesc, input_info.offsets[1]);
+        _image_in = get_cached_va_image (context, input_buf, input_imageDesc, input_info.offsets[1]);
     } else {
         input_imageDesc.format.image_channel_order = CL_R;
         input_imageDesc.width = input_info.width;
         input_imageDesc.height = input_info.height;
         input_imageDesc.row_pitch = input_info.strides[0];
 
-        _image_in = new CLVaImage (context, input_buf, input_imageDesc, input_info.offsets[0]);
+        _image_in = get_cached_va_image (context, input_buf, input_imageDesc, input_info.offsets[0]);
     }
 
     //set args;
@@ -172,15 +263,14 @@ CLImageScalerKernel::post_execute (SmartPtr<DrmBoBuffer> &output)
     if ((V4L2_PIX_FMT_NV12 != get_pixel_format ()) ||
             ((CL_IMAGE_SCALER_NV12_UV == get_mem_layout ()) && (V4L2_PIX_FMT_NV12 == get_pixel_format ()))) {
         SmartPtr<DrmBoBuffer> buffer;
-        get_context ()->finish();
 
         _image_in.release ();
 
         buffer = _scaler->get_scaler_buf ();
         XCAM_ASSERT (buffer.ptr ());
 
-        //post buffer out
-        ret = _scaler->post_buffer (buffer);
+        //post buffer out once the scaler kernel completes
+        ret = _scaler->post_buffer (buffer, get_execute_event ());
     }
 
     CLScalerKernel::post_execute (output);
@@ -199,11 +289,19 @@ CLImageScaler::CLImageScaler ()
     , _h_scaler_factor (0.5)
     , _v_scaler_factor (0.5)
 {
+    _post_thread = new CLImageScalerPostThread (this);
+    XCAM_ASSERT (_post_thread.ptr ());
+}
+
+CLImageScaler::~CLImageScaler ()
+{
+    _post_thread->stop ();
 }
 
 void
 CLImageScaler::pre_stop ()
 {
+    _post_thread->emit_stop ();
     if (_scaler_buf_pool.ptr ())
         _scaler_buf_pool->stop ();
 }
@@ -280,6 +378,7 @@ CLImageScaler::prepare_scaler_buf (const VideoBufferInfo &video_info, SmartPtr<D
         display = DrmDisplay::instance ();
         XCAM_ASSERT (display.ptr ());
         _scaler_buf_pool = new DrmBoBufferPool (display);
+        _scaler_buf_pool->set_name ("CLImageScaler");
         _scaler_buf_pool->set_video_info (scaler_video_info);
         _scaler_buf_pool->reserve (6);
     }
@@ -293,7 +392,29 @@ CLImageScaler::prepare_scaler_buf (const VideoBufferInfo &video_info, SmartPtr<D
 }
 
 XCamReturn
-CLImageScaler::post_buffer (const SmartPtr<DrmBoBuffer> &buffer)
+CLImageScaler::post_buffer (const SmartPtr<DrmBoBuffer> &buffer, const SmartPtr<CLEvent> &done_event)
+{
+    if (!_scaler_callback.ptr ())
+        return XCAM_RETURN_NO_ERROR;
+
+    if (!_post_thread->is_running ()) {
+        XCAM_FAIL_RETURN (
+            WARNING,
+            _post_thread->start (),
+            XCAM_RETURN_ERROR_THREAD,
+            "CLImageScaler start post thread failed");
+    }
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        _post_thread->queue_buffer (buffer, done_event),
+        XCAM_RETURN_ERROR_THREAD,
+        "CLImageScaler queue scaled buffer failed");
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+CLImageScaler::notify_buffer (const SmartPtr<DrmBoBuffer> &buffer)
 {
     if (_scaler_callback.ptr ())
         return _scaler_callback->scaled_image_ready (buffer);
@@ -38,6 +38,7 @@ enum CLImageScalerMemoryLayout {
 #define XCAM_CL_IMAGE_SCALER_KERNEL_LOCAL_WORK_SIZE1 4
 
 class CLImageScaler;
+class CLImageScalerPostThread;
 
 class CLScalerKernel
     : public CLImageKernel
@@ -101,8 +102,10 @@ class CLImageScaler
     : public CLImageHandler
 {
     friend class CLImageScalerKernel;
+    friend class CLImageScalerPostThread;
 public:
     explicit CLImageScaler ();
+    ~CLImageScaler ();
     void set_buffer_callback (SmartPtr<StatsCallback> &callback) {
         _scaler_callback = callback;
     }
@@ -122,7 +125,9 @@ protected:
     XCamReturn prepare_scaler_buf (const VideoBufferInfo &video_info, SmartPtr<DrmBoBuffer> &output);
 
 private:
-    XCamReturn post_buffer (const SmartPtr<DrmBoBuffer> &buffer);
+    // hand @buffer to callback once @done_event completes
+    XCamReturn post_buffer (const SmartPtr<DrmBoBuffer> &buffer, const SmartPtr<CLEvent> &done_event);
+    XCamReturn notify_buffer (const SmartPtr<DrmBoBuffer> &buffer);
     XCAM_DEAD_COPY (CLImageScaler);
 
 private:
@@ -131,6 +136,7 @@ private:
     SmartPtr<DrmBoBufferPool> _scaler_buf_pool;
     SmartPtr<DrmBoBuffer>   _scaler_buf;
     SmartPtr<StatsCallback> _scaler_callback;
+    SmartPtr<CLImageScalerPostThread> _post_thread;
 };
 
 SmartPtr<CLImageHandler>
@@ -98,7 +98,7 @@ CLImageWarpKernel::prepare_arguments (
 #endif
 
     cl_desc_out.row_pitch = video_info_out.strides[info_index];
-    _image_in = new CLVaImage (context, input, cl_desc_in, video_info_in.offsets[info_index]);
+    _image_in = get_cached_va_image (context, input, cl_desc_in, video_info_in.offsets[info_index]);
 
     _warp_config = _handler->get_warp_config ();
     if ((_warp_config.trim_ratio > 0.5f) || (_warp_config.trim_ratio < 0.0f)) {
@@ -156,7 +156,7 @@ CLImageWarpKernel::prepare_arguments (
                     _warp_config.proj_mat[3], _warp_config.proj_mat[4], _warp_config.proj_mat[5],
                     _warp_config.proj_mat[6], _warp_config.proj_mat[7], _warp_config.proj_mat[8]);
 
-    _image_out = new CLVaImage (context, output, cl_desc_out, video_info_out.offsets[info_index]);
+    _image_out = get_cached_va_image (context, output, cl_desc_out, video_info_out.offsets[info_index]);
     XCAM_ASSERT (_image_in->is_valid () && _image_out->is_valid ());
     XCAM_FAIL_RETURN (
         WARNING,
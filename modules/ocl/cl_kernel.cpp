@@ -21,6 +21,7 @@
 #include "cl_kernel.h"
 #include "cl_context.h"
 #include "cl_device.h"
+#include "cl_binary_cache.h"
 
 #define ENABLE_DEBUG_KERNEL 1
 
@@ -120,7 +121,7 @@ CLKernel::build_kernel (const XCamKernelInfo& info, const char* options)
             SmartPtr<CLContext>  context = get_context ();
             single_kernel = new CLKernel (context, info.kernel_name);
             XCAM_ASSERT (single_kernel.ptr ());
-            ret = single_kernel->load_from_source (info.kernel_body, strlen (info.kernel_body), NULL, NULL, options);
+            ret = single_kernel->load_from_cache_or_source (info, options);
             XCAM_FAIL_RETURN (
                 ERROR, ret == XCAM_RETURN_NO_ERROR, ret,
                 "build kernel(%s) from source failed", key_str);
@@ -141,6 +142,40 @@ CLKernel::build_kernel (const XCamKernelInfo& info, const char* options)
     return ret;
 }
 
+XCamReturn
+CLKernel::load_from_cache_or_source (const XCamKernelInfo& info, const char* options)
+{
+    size_t body_len = strlen (info.kernel_body);
+    CLBinaryCache cache (info.kernel_name, info.kernel_body, body_len, options);
+    uint8_t *binary = NULL;
+    size_t binary_size = 0;
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    if (cache.load (&binary, &binary_size) == XCAM_RETURN_NO_ERROR) {
+        ret = load_from_binary (binary, binary_size);
+        xcam_free (binary);
+        if (ret == XCAM_RETURN_NO_ERROR) {
+            XCAM_LOG_DEBUG ("kernel(%s) loaded from cache:%s", XCAM_STR (_name), cache.get_file_path ());
+            return ret;
+        }
+        XCAM_LOG_WARNING ("kernel(%s) load from cache failed, rebuild from source", XCAM_STR (_name));
+        cache.invalidate ();
+        binary = NULL;
+        binary_size = 0;
+    }
+
+    ret = load_from_source (
+        info.kernel_body, body_len,
+        (cache.is_enabled () ? &binary : NULL), &binary_size, options);
+    if (ret != XCAM_RETURN_NO_ERROR)
+        return ret;
+
+    if (binary && binary_size)
+        cache.store (binary, binary_size);
+    xcam_free (binary);
+    return ret;
+}
+
 XCamReturn
 CLKernel::load_from_source (
     const char *source, size_t length,
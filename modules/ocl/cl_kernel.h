@@ -108,6 +108,7 @@ public:
         SmartPtr<CLEvent> &event_out = CLEvent::NullEvent);
 
 private:
+    XCamReturn load_from_cache_or_source (const XCamKernelInfo& info, const char* options);
     void set_default_work_size ();
     void destroy ();
     XCAM_DEAD_COPY (CLKernel);
@@ -506,7 +506,8 @@ CLImage::enqueue_map (
     size_t *row_pitch, size_t *slice_pitch,
     cl_map_flags map_flags,
     CLEventList &event_waits,
-    SmartPtr<CLEvent> &event_out)
+    SmartPtr<CLEvent> &event_out,
+    bool block)
 {
     SmartPtr<CLContext> context = get_context ();
     cl_mem mem_id = get_mem_id ();
@@ -515,8 +516,9 @@ CLImage::enqueue_map (
     XCAM_ASSERT (is_valid ());
     if (!is_valid ())
         return XCAM_RETURN_ERROR_PARAM;
+    XCAM_ASSERT (block || event_out.ptr ());
 
-    ret = context->enqueue_map_image (mem_id, ptr, origin, region, row_pitch, slice_pitch, true, map_flags, event_waits, event_out);
+    ret = context->enqueue_map_image (mem_id, ptr, origin, region, row_pitch, slice_pitch, block, map_flags, event_waits, event_out);
     XCAM_FAIL_RETURN (
         WARNING,
         ret == XCAM_RETURN_NO_ERROR,
@@ -537,18 +539,8 @@ CLVaImage::CLVaImage (
 {
     CLImageDesc cl_desc;
 
-    const VideoBufferInfo & video_info = bo->get_video_info ();
-    if (!video_info_2_cl_image_desc (video_info, cl_desc)) {
-        XCAM_LOG_WARNING ("CLVaImage create va image failed on default videoinfo");
-        return;
-    }
-    if (single_plane) {
-        cl_desc.array_size = 0;
-        cl_desc.slice_pitch = 0;
-    } else if (!merge_multi_plane (video_info, cl_desc)) {
-        XCAM_LOG_WARNING ("CLVaImage create va image failed on merging planes");
+    if (!get_default_desc (bo->get_video_info (), single_plane, cl_desc))
         return;
-    }
 
     init_va_image (context, bo, cl_desc, offset);
 }
@@ -564,6 +556,25 @@ CLVaImage::CLVaImage (
     init_va_image (context, bo, image_info, offset);
 }
 
+bool
+CLVaImage::get_default_desc (
+    const VideoBufferInfo &video_info, bool single_plane,
+    CLImageDesc &cl_desc)
+{
+    if (!video_info_2_cl_image_desc (video_info, cl_desc)) {
+        XCAM_LOG_WARNING ("CLVaImage create va image failed on default videoinfo");
+        return false;
+    }
+    if (single_plane) {
+        cl_desc.array_size = 0;
+        cl_desc.slice_pitch = 0;
+    } else if (!merge_multi_plane (video_info, cl_desc)) {
+        XCAM_LOG_WARNING ("CLVaImage create va image failed on merging planes");
+        return false;
+    }
+    return true;
+}
+
 bool
 CLVaImage::merge_multi_plane (
     const VideoBufferInfo &video_info,
@@ -656,6 +667,137 @@ CLVaImage::init_va_image (
     return true;
 }
 
+SmartPtr<CLMemoryCache>
+CLMemoryCache::get_cache (SmartPtr<DrmBoBuffer> &bo)
+{
+    // data of other bos may go away with the bo, cached objects would dangle
+    if (!bo->is_pool_buffer ())
+        return NULL;
+
+    SmartPtr<BufferDataCache> cache = bo->get_data_cache ();
+    if (!cache.ptr ())
+        cache = bo->bind_data_cache (new CLMemoryCache);
+    return cache.dynamic_cast_ptr<CLMemoryCache> ();
+}
+
+SmartPtr<CLMemory>
+CLMemoryCache::find_unsafe (
+    CLContext *context, bool is_image, uint32_t offset, const CLImageDesc &desc)
+{
+    for (std::list<Entry>::iterator i = _entries.begin (); i != _entries.end (); ++i) {
+        if (i->context == context && i->is_image == is_image &&
+                i->offset == offset && (!is_image || i->desc == desc))
+            return i->memory;
+    }
+    return NULL;
+}
+
+SmartPtr<CLMemory>
+CLMemoryCache::find (
+    CLContext *context, bool is_image, uint32_t offset, const CLImageDesc &desc)
+{
+    SmartLock lock (_mutex);
+    return find_unsafe (context, is_image, offset, desc);
+}
+
+// an entry of the same key added meanwhile by another thread wins
+SmartPtr<CLMemory>
+CLMemoryCache::insert (const Entry &entry)
+{
+    SmartLock lock (_mutex);
+    SmartPtr<CLMemory> found = find_unsafe (entry.context, entry.is_image, entry.offset, entry.desc);
+    if (found.ptr ())
+        return found;
+
+    _entries.push_back (entry);
+    return entry.memory;
+}
+
+SmartPtr<CLVaImage>
+CLMemoryCache::get_va_image (
+    SmartPtr<CLContext> &context, SmartPtr<DrmBoBuffer> &bo,
+    const CLImageDesc &cl_desc, uint32_t offset)
+{
+    XCAM_ASSERT (bo.ptr ());
+    SmartPtr<CLMemoryCache> cache = get_cache (bo);
+    if (!cache.ptr ()) {
+        XCAM_LOG_DEBUG ("CLMemoryCache bo not from pool or data holds another cache, image not cached");
+        return new CLVaImage (context, bo, cl_desc, offset);
+    }
+
+    SmartPtr<CLMemory> memory = cache->find (context.ptr (), true, offset, cl_desc);
+    if (memory.ptr ())
+        return memory.dynamic_cast_ptr<CLVaImage> ();
+
+    SmartPtr<CLVaImage> image = new CLVaImage (context, bo, cl_desc, offset);
+    if (!image->is_valid ())
+        return image;
+    image->_bo.release ();
+
+    Entry entry;
+    entry.context = context.ptr ();
+    entry.is_image = true;
+    entry.offset = offset;
+    entry.desc = cl_desc;
+    entry.memory = image;
+    return cache->insert (entry).dynamic_cast_ptr<CLVaImage> ();
+}
+
+SmartPtr<CLVaBuffer>
+CLMemoryCache::get_va_buffer (SmartPtr<CLContext> &context, SmartPtr<DrmBoBuffer> &bo)
+{
+    XCAM_ASSERT (bo.ptr ());
+    SmartPtr<CLMemoryCache> cache = get_cache (bo);
+    if (!cache.ptr ()) {
+        XCAM_LOG_DEBUG ("CLMemoryCache bo not from pool or data holds another cache, buffer not cached");
+        return new CLVaBuffer (context, bo);
+    }
+
+    CLImageDesc no_desc;
+    SmartPtr<CLMemory> memory = cache->find (context.ptr (), false, 0, no_desc);
+    if (memory.ptr ())
+        return memory.dynamic_cast_ptr<CLVaBuffer> ();
+
+    SmartPtr<CLVaBuffer> buffer = new CLVaBuffer (context, bo);
+    if (!buffer->is_valid ())
+        return buffer;
+    buffer->_bo.release ();
+
+    Entry entry;
+    entry.context = context.ptr ();
+    entry.is_image = false;
+    entry.offset = 0;
+    entry.desc = no_desc;
+    entry.memory = buffer;
+    return cache->insert (entry).dynamic_cast_ptr<CLVaBuffer> ();
+}
+
+SmartPtr<CLVaImage>
+get_cached_va_image (
+    SmartPtr<CLContext> &context, SmartPtr<DrmBoBuffer> &bo,
+    uint32_t offset, bool single_plane)
+{
+    CLImageDesc cl_desc;
+
+    if (!CLVaImage::get_default_desc (bo->get_video_info (), single_plane, cl_desc))
+        return new CLVaImage (context, bo, offset, single_plane);
+    return CLMemoryCache::get_va_image (context, bo, cl_desc, offset);
+}
+
+SmartPtr<CLVaImage>
+get_cached_va_image (
+    SmartPtr<CLContext> &context, SmartPtr<DrmBoBuffer> &bo,
+    const CLImageDesc &image_info, uint32_t offset)
+{
+    return CLMemoryCache::get_va_image (context, bo, image_info, offset);
+}
+
+SmartPtr<CLVaBuffer>
+get_cached_va_buffer (SmartPtr<CLContext> &context, SmartPtr<DrmBoBuffer> &bo)
+{
+    return CLMemoryCache::get_va_buffer (context, bo);
+}
+
 
 CLImage2D::CLImage2D (
     SmartPtr<CLContext> &context,
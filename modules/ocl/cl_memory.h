@@ -25,6 +25,7 @@
 #include "cl_context.h"
 #include "cl_event.h"
 #include "drm_bo_buffer.h"
+#include <list>
 
 namespace XCam {
 
@@ -131,6 +132,8 @@ private:
 class CLVaBuffer
     : public CLBuffer
 {
+    friend class CLMemoryCache;
+
 public:
     explicit CLVaBuffer (
         SmartPtr<CLContext> &context,
@@ -162,13 +165,15 @@ public:
         const VideoBufferInfo & video_info,
         CLImageDesc &cl_desc);
 
+    // non-blocking map needs @event_out, wait it before using @ptr
     XCamReturn enqueue_map (
         void *&ptr,
         size_t *origin, size_t *region,
         size_t *row_pitch, size_t *slice_pitch,
         cl_map_flags map_flags = CL_MEM_READ_WRITE,
         CLEventList &event_waits = CLEvent::EmptyList,
-        SmartPtr<CLEvent> &event_out = CLEvent::NullEvent);
+        SmartPtr<CLEvent> &event_out = CLEvent::NullEvent,
+        bool block = true);
 
 protected:
     explicit CLImage (SmartPtr<CLContext> &context);
@@ -186,6 +191,8 @@ private:
 class CLVaImage
     : public CLImage
 {
+    friend class CLMemoryCache;
+
 public:
     explicit CLVaImage (
         SmartPtr<CLContext> &context,
@@ -199,11 +206,16 @@ public:
         uint32_t offset = 0);
     ~CLVaImage () {}
 
+    // desc of the first constructor
+    static bool get_default_desc (
+        const VideoBufferInfo &video_info, bool single_plane,
+        CLImageDesc &cl_desc);
+
 private:
     bool init_va_image (
         SmartPtr<CLContext> &context, SmartPtr<DrmBoBuffer> &bo,
         const CLImageDesc &cl_desc, uint32_t offset);
-    bool merge_multi_plane (
+    static bool merge_multi_plane (
         const VideoBufferInfo &video_info,
         CLImageDesc &cl_desc);
 
@@ -214,6 +226,65 @@ private:
     cl_libva_image          _va_image_info;
 };
 
+/*
+ * CL memory imported from one bo, bound to the bo's buffer data so a
+ * pool buffer is imported once instead of on every frame. entries are
+ * keyed by context, plane offset and image desc, and dropped with the
+ * data cache when the pool stops or changes video info.
+ * only bos from a pool are cached, the pool keeps their data alive,
+ * so cached objects do not hold the bo. other bos get a new object
+ * holding the bo, as the CLVaImage and CLVaBuffer constructors do.
+ */
+class CLMemoryCache
+    : public BufferDataCache
+{
+public:
+    explicit CLMemoryCache () {}
+
+    static SmartPtr<CLVaImage> get_va_image (
+        SmartPtr<CLContext> &context, SmartPtr<DrmBoBuffer> &bo,
+        const CLImageDesc &cl_desc, uint32_t offset);
+    static SmartPtr<CLVaBuffer> get_va_buffer (
+        SmartPtr<CLContext> &context, SmartPtr<DrmBoBuffer> &bo);
+
+private:
+    struct Entry {
+        CLContext            *context;
+        bool                  is_image;
+        uint32_t              offset;
+        CLImageDesc           desc;
+        SmartPtr<CLMemory>    memory;
+    };
+
+    static SmartPtr<CLMemoryCache> get_cache (SmartPtr<DrmBoBuffer> &bo);
+    SmartPtr<CLMemory> find (
+        CLContext *context, bool is_image, uint32_t offset, const CLImageDesc &desc);
+    SmartPtr<CLMemory> find_unsafe (
+        CLContext *context, bool is_image, uint32_t offset, const CLImageDesc &desc);
+    SmartPtr<CLMemory> insert (const Entry &entry);
+
+    XCAM_DEAD_COPY (CLMemoryCache);
+
+private:
+    Mutex                     _mutex;
+    std::list<Entry>          _entries;
+};
+
+/*
+ * same arguments as CLVaImage and CLVaBuffer constructors, objects
+ * come from CLMemoryCache of @bo if it is a pool buffer.
+ */
+SmartPtr<CLVaImage>
+get_cached_va_image (
+    SmartPtr<CLContext> &context, SmartPtr<DrmBoBuffer> &bo,
+    uint32_t offset = 0, bool single_plane = false);
+SmartPtr<CLVaImage>
+get_cached_va_image (
+    SmartPtr<CLContext> &context, SmartPtr<DrmBoBuffer> &bo,
+    const CLImageDesc &image_info, uint32_t offset = 0);
+SmartPtr<CLVaBuffer>
+get_cached_va_buffer (SmartPtr<CLContext> &context, SmartPtr<DrmBoBuffer> &bo);
+
 class CLImage2D
     : public CLImage
 {
@@ -19,6 +19,7 @@
  */
 
 #include "cl_multi_image_handler.h"
+#include "xcam_trace.h"
 #if ENABLE_PROFILING
 #include "cl_device.h"
 #endif
@@ -48,6 +49,10 @@ CLMultiImageHandler::execute (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer
         XCAM_RETURN_ERROR_PARAM,
         "cl_image_handler(%s) no image kernel set", XCAM_STR (_name));
 
+    CLEventList events_wait;
+    events_wait.swap (_wait_events);
+    _done_event.release ();
+
     if (!is_handler_enabled ()) {
         output = input;
         return XCAM_RETURN_NO_ERROR;
@@ -70,6 +75,7 @@ CLMultiImageHandler::execute (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer
         return ret;
 
     XCAM_OBJ_PROFILING_START;
+    TraceSpan span ("cl_handler", get_name ());
 
     for (KernelList::iterator i_kernel = _kernels.begin ();
             i_kernel != _kernels.end (); ++i_kernel) {
@@ -88,7 +94,7 @@ CLMultiImageHandler::execute (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer
 
         XCAM_FAIL_RETURN (
             WARNING,
-            (ret = kernel->execute ()) == XCAM_RETURN_NO_ERROR,
+            (ret = execute_kernel (kernel, events_wait)) == XCAM_RETURN_NO_ERROR,
             ret,
             "cl_image_handler(%s) execute kernel(%s) failed",
             XCAM_STR (_name), kernel->get_kernel_name ());
@@ -19,29 +19,16 @@
  */
 #include "xcam_utils.h"
 #include "cl_newtonemapping_handler.h"
+#include <algorithm>
 
 namespace XCam {
 
-CLNewTonemappingImageKernel::CLNewTonemappingImageKernel (SmartPtr<CLContext> &context,
-        const char *name)
-    : CLImageKernel (context, name)
-    , _image_width (960)
-    , _image_height (540)
-    , _block_factor (4)
-{
-    for(int i = 0; i < 65536; i++)
-    {
-        _map_hist[i] = i;
-    }
-
-    for(int i = 0; i < 4 * 4; i++)
-    {
-        _y_max[i] = 0.0f;
-        _y_avg[i] = 0.0f;
-    }
-}
-
-void Haleq(int *y, int *hist, int *hist_leq, int left, int right, int level, int index_left, int index_right)
+/*
+ * @hist is cumulative, the median of bins [left, right] is found in it
+ * directly instead of in a sorted copy of all pixels.
+ */
+static void
+haleq (const int *hist, int hist_bin_count, int *hist_leq, int left, int right, int level, int index_left, int index_right)
 {
     int l;
     float e, le;
@@ -49,7 +36,7 @@ void Haleq(int *y, int *hist, int *hist_leq, int left, int right, int level, int
     l = (left + right) / 2;
     int num_left = left > 0 ? hist[left - 1] : 0;
     int pixel_num = hist[right] - num_left;
-    e = y[num_left + pixel_num / 2];
+    e = std::lower_bound (hist, hist + hist_bin_count, num_left + pixel_num / 2) - hist;
 
     if(e != 0)
     {
@@ -65,40 +52,171 @@ void Haleq(int *y, int *hist, int *hist_leq, int left, int right, int level, int
 
     if(level > 5) return;
 
-    Haleq(y, hist, hist_leq, left, (int)(le + 0.5f), level + 1, index_left, index);
-    Haleq(y, hist, hist_leq, (int)(le + 0.5f) + 1, right, level + 1, index + 1, index_right);
+    haleq(hist, hist_bin_count, hist_leq, left, (int)(le + 0.5f), level + 1, index_left, index);
+    haleq(hist, hist_bin_count, hist_leq, (int)(le + 0.5f) + 1, right, level + 1, index + 1, index_right);
+}
+
+CLTonemappingCurveEngine::CLTonemappingCurveEngine ()
+    : _update_ratio (XCAM_CL_TONEMAPPING_CURVE_UPDATE_RATIO)
+    , _hist_bin_count (0)
+    , _stats (NULL)
+{
+    xcam_mem_clear (_info);
+    xcam_mem_clear (_y_max);
+    xcam_mem_clear (_y_avg);
+    for (uint32_t i = 0; i < XCAM_CL_TONEMAPPING_BLOCK_COUNT; ++i) {
+        _blocks[i].y_max = 0.0f;
+        _blocks[i].y_avg = 0.0f;
+        _blocks[i].valid = false;
+        _blocks[i].changed = false;
+    }
+}
+
+void
+CLTonemappingCurveEngine::init_blocks (const XCam3AStatsInfo &info)
+{
+    _info = info;
+    _hist_bin_count = 1 << info.bit_depth;
+
+    for (uint32_t i = 0; i < XCAM_CL_TONEMAPPING_BLOCK_COUNT; ++i) {
+        Block &block = _blocks[i];
+        block.hist.assign (_hist_bin_count, 0);
+        block.ref_hist.assign (_hist_bin_count, 0);
+        block.hist_log.assign (_hist_bin_count, 0);
+        block.map_index_log.assign (_hist_bin_count, 0);
+        block.map_index_leq.assign (_hist_bin_count, 0);
+        block.map.assign (_hist_bin_count, 0.0f);
+        block.valid = false;
+    }
+    _map_hist.assign (_hist_bin_count * XCAM_CL_TONEMAPPING_BLOCK_COUNT, 0.0f);
+}
+
+XCamReturn
+CLTonemappingCurveEngine::update (const XCam3AStats *stats, bool &changed)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    changed = false;
+    XCAM_FAIL_RETURN (
+        WARNING,
+        stats && stats->info.bit_depth && stats->info.bit_depth <= 16 &&
+        stats->info.width >= XCAM_CL_TONEMAPPING_BLOCK_FACTOR &&
+        stats->info.height >= XCAM_CL_TONEMAPPING_BLOCK_FACTOR,
+        XCAM_RETURN_ERROR_PARAM,
+        "tonemapping curve engine got invalid stats");
+
+    if (stats->info.width != _info.width || stats->info.height != _info.height ||
+            stats->info.bit_depth != _info.bit_depth)
+        init_blocks (stats->info);
+
+    _stats = stats;
+    ret = ThreadPool::instance ()->parallel_for (XCAM_CL_TONEMAPPING_BLOCK_COUNT, *this);
+    _stats = NULL;
+    XCAM_FAIL_RETURN (
+        WARNING,
+        ret == XCAM_RETURN_NO_ERROR,
+        ret,
+        "tonemapping curve engine update blocks failed");
+
+    for (uint32_t i = 0; i < XCAM_CL_TONEMAPPING_BLOCK_COUNT; ++i)
+        changed = changed || _blocks[i].changed;
+    if (!changed)
+        return XCAM_RETURN_NO_ERROR;
+
+    for (uint32_t i = 0; i < XCAM_CL_TONEMAPPING_BLOCK_COUNT; ++i) {
+        const Block &block = _blocks[i];
+        memcpy (&_map_hist[i * _hist_bin_count], block.map.data (), _hist_bin_count * sizeof (float));
+        _y_max[i] = block.y_max;
+        _y_avg[i] = block.y_avg;
+    }
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+CLTonemappingCurveEngine::work_range (uint32_t begin, uint32_t end)
+{
+    for (uint32_t i = begin; i < end; ++i)
+        update_block (i);
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+CLTonemappingCurveEngine::update_block (uint32_t index)
+{
+    Block &block = _blocks[index];
+    uint32_t block_row = index / XCAM_CL_TONEMAPPING_BLOCK_FACTOR;
+    uint32_t block_col = index % XCAM_CL_TONEMAPPING_BLOCK_FACTOR;
+    uint32_t width_per_block = _info.width / XCAM_CL_TONEMAPPING_BLOCK_FACTOR;
+    uint32_t height_per_block = _info.height / XCAM_CL_TONEMAPPING_BLOCK_FACTOR;
+    const XCamGridStat *grid =
+        _stats->stats + block_row * height_per_block * _info.width + block_col * width_per_block;
+
+    if (block_row == XCAM_CL_TONEMAPPING_BLOCK_FACTOR - 1)
+        height_per_block += _info.height % XCAM_CL_TONEMAPPING_BLOCK_FACTOR;
+
+    std::fill (block.hist.begin (), block.hist.end (), 0);
+    for (uint32_t i = 0; i < height_per_block; ++i) {
+        const XCamGridStat *line = grid + i * _info.width;
+        for (uint32_t j = 0; j < width_per_block; ++j) {
+            XCAM_ASSERT (line[j].avg_y < _hist_bin_count);
+            block.hist[line[j].avg_y]++;
+        }
+    }
+
+    int pixel_num = width_per_block * height_per_block;
+    if (block.valid && _update_ratio > 0.0f) {
+        int moved = 0;
+        for (uint32_t i = 0; i < _hist_bin_count; ++i)
+            moved += abs (block.hist[i] - block.ref_hist[i]);
+        // each moved pixel counts in two bins
+        if (moved <= 2 * _update_ratio * pixel_num) {
+            block.changed = false;
+            return;
+        }
+    }
+
+    build_curve (block, pixel_num);
+    block.ref_hist.swap (block.hist);
+    block.valid = true;
+    block.changed = true;
 }
 
-void Block_split_haleq(int* hist, int hist_bin_count, int pixel_num, int block_start_index, float* y_max, float* y_avg, float* map_hist)
+void
+CLTonemappingCurveEngine::build_curve (Block &block, int pixel_num)
 {
-    int block_id = block_start_index / hist_bin_count;
+    int hist_bin_count = _hist_bin_count;
+    const int *hist = block.hist.data ();
+    int *hist_log = block.hist_log.data ();
+    int *map_index_log = block.map_index_log.data ();
+    int *map_index_leq = block.map_index_leq.data ();
+    float y_max = 0.0f;
+    float y_avg = 0.0f;
 
     for(int i = hist_bin_count - 1; i >= 0; i--)
     {
         if(hist[i] > 0)
         {
-            y_max[block_id] = i;
+            y_max = i;
             break;
         }
     }
 
     for(int i = 0; i < hist_bin_count; i++)
     {
-        y_avg[block_id] += i * hist[i];
+        y_avg += i * hist[i];
     }
 
-    y_max[block_id] = y_max[block_id] + 1;
-    y_avg[block_id] = y_avg[block_id] / pixel_num;
+    y_max = y_max + 1;
+    y_avg = y_avg / pixel_num;
 
-    int *hist_log = (int *) xcam_malloc0 (hist_bin_count * sizeof (int));
-    int *sort_y = (int *) xcam_malloc0 ((pixel_num + 1) * sizeof (int));
-    int *map_index_leq = (int *) xcam_malloc0 (hist_bin_count * sizeof (int));
-    int *map_index_log = (int *) xcam_malloc0 (hist_bin_count * sizeof (int));
-    XCAM_ASSERT (hist_log && sort_y && map_index_leq && map_index_log);
+    std::fill (block.hist_log.begin (), block.hist_log.end (), 0);
+    std::fill (block.map_index_log.begin (), block.map_index_log.end (), 0);
+    std::fill (block.map_index_leq.begin (), block.map_index_leq.end (), 0);
 
-    int thres = (int)(1500 * 1500 / (y_avg[block_id] * y_avg[block_id] + 1) * 600);
-    int y_max0 = (y_max[block_id] > thres) ? thres : y_max[block_id];
-    int y_max1 = (y_max[block_id] - thres) > 0 ? (y_max[block_id] - thres) : 0;
+    int thres = (int)(1500 * 1500 / (y_avg * y_avg + 1) * 600);
+    int y_max0 = (y_max > thres) ? thres : y_max;
+    int y_max1 = (y_max - thres) > 0 ? (y_max - thres) : 0;
 
     float t0 = 0.01f * y_max0 + 0.001f;
     float t1 = 0.001f * y_max1 + 0.001f;
@@ -108,7 +226,7 @@ void Block_split_haleq(int* hist, int hist_bin_count, int pixel_num, int block_s
     float t1_log = log(t1);
     float factor0;
 
-    if(y_max[block_id] < thres)
+    if(y_max < thres)
     {
         factor0 = (hist_bin_count - 1) / (max0_log - t0_log + 0.001f);
     }
@@ -117,9 +235,9 @@ void Block_split_haleq(int* hist, int hist_bin_count, int pixel_num, int block_s
 
     float factor1 = y_max1 / (max1_log - t1_log + 0.001f);
 
-    if(y_max[block_id] < thres)
+    if(y_max < thres)
     {
-        for(int i = 0; i < y_max[block_id]; i++)
+        for(int i = 0; i < y_max; i++)
         {
             int index = (int)((log(i + t0) - t0_log) * factor0 + 0.5f);
             hist_log[index] += hist[i];
@@ -135,32 +253,21 @@ void Block_split_haleq(int* hist, int hist_bin_count, int pixel_num, int block_s
             map_index_log[i] = index;
         }
 
-        for(int i = y_max0; i < y_max[block_id]; i++)
+        for(int i = y_max0; i < y_max; i++)
         {
-            int r = y_max[block_id] - i;
+            int r = y_max - i;
             int index = (int)((log(r + t1) - t1_log) * factor1 + 0.5f);
-            index = y_max[block_id] - index;
+            index = y_max - index;
             hist_log[index] += hist[i];
             map_index_log[i] = index;
         }
     }
 
-    for(int i = y_max[block_id]; i < hist_bin_count; i++)
-    {
-        hist_log[map_index_log[(int)y_max[block_id] - 1]] += hist[i];
-        map_index_log[i] = map_index_log[(int)y_max[block_id] - 1];
-    }
-
-    int sort_index = 1;
-    for(int i = 0; i < hist_bin_count; i++)
+    for(int i = y_max; i < hist_bin_count; i++)
     {
-        for(int l = 0; l < hist_log[i]; l++)
-        {
-            sort_y[sort_index] = i;
-            sort_index++;
-        }
+        hist_log[map_index_log[(int)y_max - 1]] += hist[i];
+        map_index_log[i] = map_index_log[(int)y_max - 1];
     }
-    sort_y[0] = 0;
 
     for(int i = 1; i < hist_bin_count; i++)
     {
@@ -169,7 +276,7 @@ void Block_split_haleq(int* hist, int hist_bin_count, int pixel_num, int block_s
 
     int map_leq_index[256];
 
-    Haleq(sort_y, hist_log, map_leq_index, 0, hist_bin_count - 1, 0, 0, 255);
+    haleq(hist_log, hist_bin_count, map_leq_index, 0, hist_bin_count - 1, 0, 0, 255);
 
     map_leq_index[255] = hist_bin_count;
     map_leq_index[0] = 0;
@@ -185,26 +292,26 @@ void Block_split_haleq(int* hist, int hist_bin_count, int pixel_num, int block_s
     {
         for(int k = map_leq_index[i]; k < map_leq_index[i + 1]; k++)
         {
-            map_index_leq[k] = (float)i;
+            map_index_leq[k] = i;
         }
     }
 
     for(int i = 0; i < hist_bin_count; i++)
     {
-        map_hist[i + block_start_index] = map_index_leq[map_index_log[i]] / 255.0f;
+        block.map[i] = map_index_leq[map_index_log[i]] / 255.0f;
     }
 
-    y_max[block_id] = y_max[block_id] / hist_bin_count;
-    y_avg[block_id] = y_avg[block_id] / hist_bin_count;
-
-    xcam_free (hist_log);
-    hist_log = NULL;
-    xcam_free (map_index_leq);
-    map_index_leq = NULL;
-    xcam_free (map_index_log);
-    map_index_log = NULL;
-    xcam_free (sort_y);
-    sort_y = NULL;
+    block.y_max = y_max / hist_bin_count;
+    block.y_avg = y_avg / hist_bin_count;
+}
+
+CLNewTonemappingImageKernel::CLNewTonemappingImageKernel (SmartPtr<CLContext> &context,
+        const char *name)
+    : CLImageKernel (context, name)
+    , _image_width (960)
+    , _image_height (540)
+    , _buffer_bin_count (0)
+{
 }
 
 XCamReturn
@@ -217,8 +324,8 @@ CLNewTonemappingImageKernel::prepare_arguments (
 
     const VideoBufferInfo & in_video_info = input->get_video_info ();
 
-    _image_in = new CLVaImage (context, input);
-    _image_out = new CLVaImage (context, output);
+    _image_in = get_cached_va_image (context, input);
+    _image_out = get_cached_va_image (context, output);
     _image_width = in_video_info.aligned_width;
     _image_height = in_video_info.aligned_height;
 
@@ -243,61 +350,24 @@ CLNewTonemappingImageKernel::prepare_arguments (
         XCAM_RETURN_ERROR_MEM,
         "prepare_arguments get_stats failed");
 
-    int block_factor = 4;
-    int width_per_block = stats_ptr->info.width / block_factor;
-    int height_per_block = stats_ptr->info.height / block_factor;
-    int height_last_block = height_per_block + stats_ptr->info.height % block_factor;
-    int hist_bin_count = 1 << stats_ptr->info.bit_depth;
-
-    int *hist_per_block = (int *) xcam_malloc0 (hist_bin_count * sizeof (int));
-    XCAM_ASSERT (hist_per_block);
+    bool curve_changed = false;
+    XCamReturn ret = _curve_engine.update (stats_ptr, curve_changed);
+    XCAM_FAIL_RETURN (
+        WARNING,
+        ret == XCAM_RETURN_NO_ERROR,
+        ret,
+        "prepare_arguments update tonemapping curves failed");
 
-    for(int block_row = 0; block_row < block_factor; block_row++)
-    {
-        for(int block_col = 0; block_col < block_factor; block_col++)
-        {
-            int block_start_index = (block_row * block_factor + block_col) * hist_bin_count;
-            int start_index = block_row * height_per_block * stats_ptr->info.width + block_col * width_per_block;
-
-            for(int i = 0; i < hist_bin_count; i++)
-            {
-                hist_per_block[i] = 0;
-            }
-
-            if(block_row == block_factor - 1)
-            {
-                height_per_block = height_last_block;
-            }
-
-            int block_totalnum = width_per_block * height_per_block;
-            for(int i = 0; i < height_per_block; i++)
-            {
-                for(int j = 0; j < width_per_block; j++)
-                {
-                    int y = stats_ptr->stats[start_index + i * stats_ptr->info.width + j].avg_y;
-                    hist_per_block[y]++;
-                }
-            }
-
-            Block_split_haleq(hist_per_block, hist_bin_count, block_totalnum, block_start_index, _y_max, _y_avg, _map_hist);
-        }
+    // unchanged curves keep the buffers of last frame
+    if (curve_changed || !_map_hist_buffer.ptr ()) {
+        ret = upload_curves (context);
+        XCAM_FAIL_RETURN (
+            WARNING,
+            ret == XCAM_RETURN_NO_ERROR,
+            ret,
+            "prepare_arguments upload tonemapping curves failed");
     }
 
-    xcam_free (hist_per_block);
-    hist_per_block = NULL;
-
-    _y_max_buffer = new CLBuffer(
-        context, sizeof(float) * block_factor * block_factor,
-        CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, &_y_max);
-
-    _y_avg_buffer = new CLBuffer(
-        context, sizeof(float) * block_factor * block_factor,
-        CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, &_y_avg);
-
-    _map_hist_buffer = new CLBuffer(
-        context, sizeof(float) * hist_bin_count * block_factor * block_factor,
-        CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, &_map_hist);
-
     //set args;
     args[0].arg_adress = &_image_in->get_mem_id ();
     args[0].arg_size = sizeof (cl_mem);
@@ -326,6 +396,51 @@ CLNewTonemappingImageKernel::prepare_arguments (
     return XCAM_RETURN_NO_ERROR;
 }
 
+/*
+ * kernels of frames still queued read the buffers, host tables would be
+ * overwritten under them by the next update. the write is blocking, tables
+ * are copied before it returns, and in order queue runs it after them.
+ */
+XCamReturn
+CLNewTonemappingImageKernel::upload_curves (SmartPtr<CLContext> &context)
+{
+    uint32_t hist_bin_count = _curve_engine.get_hist_bin_count ();
+    uint32_t map_hist_size = sizeof (float) * hist_bin_count * XCAM_CL_TONEMAPPING_BLOCK_COUNT;
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    if (!_map_hist_buffer.ptr () || _buffer_bin_count != hist_bin_count) {
+        _y_max_buffer = new CLBuffer (
+            context, sizeof (float) * XCAM_CL_TONEMAPPING_BLOCK_COUNT, CL_MEM_READ_ONLY);
+        _y_avg_buffer = new CLBuffer (
+            context, sizeof (float) * XCAM_CL_TONEMAPPING_BLOCK_COUNT, CL_MEM_READ_ONLY);
+        _map_hist_buffer = new CLBuffer (context, map_hist_size, CL_MEM_READ_ONLY);
+        XCAM_FAIL_RETURN (
+            WARNING,
+            _y_max_buffer->is_valid () && _y_avg_buffer->is_valid () && _map_hist_buffer->is_valid (),
+            XCAM_RETURN_ERROR_MEM,
+            "cl image kernel(%s) create curve buffers failed", get_kernel_name ());
+        _buffer_bin_count = hist_bin_count;
+    }
+
+    ret = _y_max_buffer->enqueue_write (
+              _curve_engine.get_y_max (), 0, sizeof (float) * XCAM_CL_TONEMAPPING_BLOCK_COUNT);
+    if (ret == XCAM_RETURN_NO_ERROR)
+        ret = _y_avg_buffer->enqueue_write (
+                  _curve_engine.get_y_avg (), 0, sizeof (float) * XCAM_CL_TONEMAPPING_BLOCK_COUNT);
+    if (ret == XCAM_RETURN_NO_ERROR)
+        ret = _map_hist_buffer->enqueue_write (_curve_engine.get_map_hist (), 0, map_hist_size);
+    // next frame writes again
+    if (ret != XCAM_RETURN_NO_ERROR)
+        _map_hist_buffer.release ();
+    XCAM_FAIL_RETURN (
+        WARNING,
+        ret == XCAM_RETURN_NO_ERROR,
+        ret,
+        "cl image kernel(%s) write curve buffers failed", get_kernel_name ());
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
 CLNewTonemappingImageHandler::CLNewTonemappingImageHandler (const char *name)
     : CLImageHandler (name)
     , _output_format (XCAM_PIX_FMT_SGRBG16_planar)
@@ -24,10 +24,84 @@
 #include "xcam_utils.h"
 #include "cl_image_handler.h"
 #include "x3a_stats_pool.h"
+#include "thread_pool.h"
+#include <vector>
 
+#define XCAM_CL_TONEMAPPING_BLOCK_FACTOR   4
+#define XCAM_CL_TONEMAPPING_BLOCK_COUNT    (XCAM_CL_TONEMAPPING_BLOCK_FACTOR * XCAM_CL_TONEMAPPING_BLOCK_FACTOR)
+// share of block pixels changing bin before its curve is rebuilt
+#define XCAM_CL_TONEMAPPING_CURVE_UPDATE_RATIO  0.01f
 
 namespace XCam {
 
+/*
+ * per block histogram equalization curves of CLNewTonemappingImageKernel
+ * from the 3a grid stats. workspaces are allocated once per stats size,
+ * blocks run on the thread pool, and a block keeps its curve while its
+ * histogram stays within the update ratio of the one it was built from.
+ * tables are rewritten by each update with a changed curve, callers copy
+ * them out before the next one.
+ */
+class CLTonemappingCurveEngine
+    : public ParallelFunc
+{
+public:
+    explicit CLTonemappingCurveEngine ();
+
+    // 0 rebuilds every curve on each update
+    void set_update_ratio (float ratio) {
+        _update_ratio = ratio;
+    }
+
+    // @changed is false if no curve changed, tables stay the same
+    XCamReturn update (const XCam3AStats *stats, bool &changed);
+
+    uint32_t get_hist_bin_count () const {
+        return _hist_bin_count;
+    }
+    float *get_y_max () {
+        return _y_max;
+    }
+    float *get_y_avg () {
+        return _y_avg;
+    }
+    float *get_map_hist () {
+        return _map_hist.data ();
+    }
+
+private:
+    struct Block {
+        std::vector<int>    hist;
+        std::vector<int>    ref_hist;
+        std::vector<int>    hist_log;
+        std::vector<int>    map_index_log;
+        std::vector<int>    map_index_leq;
+        std::vector<float>  map;
+        float               y_max;
+        float               y_avg;
+        bool                valid;
+        bool                changed;
+    };
+
+    virtual XCamReturn work_range (uint32_t begin, uint32_t end);
+    void init_blocks (const XCam3AStatsInfo &info);
+    void update_block (uint32_t index);
+    void build_curve (Block &block, int pixel_num);
+
+    XCAM_DEAD_COPY (CLTonemappingCurveEngine);
+
+private:
+    float                   _update_ratio;
+    XCam3AStatsInfo         _info;
+    uint32_t                _hist_bin_count;
+    const XCam3AStats      *_stats;
+    Block                   _blocks[XCAM_CL_TONEMAPPING_BLOCK_COUNT];
+
+    std::vector<float>      _map_hist;
+    float                   _y_max[XCAM_CL_TONEMAPPING_BLOCK_COUNT];
+    float                   _y_avg[XCAM_CL_TONEMAPPING_BLOCK_COUNT];
+};
+
 class CLNewTonemappingImageKernel
     : public CLImageKernel
 {
@@ -35,6 +109,10 @@ public:
     explicit CLNewTonemappingImageKernel (SmartPtr<CLContext> &context,
                                           const char *name);
 
+    void set_curve_update_ratio (float ratio) {
+        _curve_engine.set_update_ratio (ratio);
+    }
+
 protected:
     virtual XCamReturn prepare_arguments (
         SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output,
@@ -42,16 +120,17 @@ protected:
         CLWorkSize &work_size);
 
 private:
+    XCamReturn upload_curves (SmartPtr<CLContext> &context);
+
     XCAM_DEAD_COPY (CLNewTonemappingImageKernel);
     int                     _image_width;
     int                     _image_height;
-    int                     _block_factor;
-    float                   _map_hist[65536];
-    float                   _y_max[16];
-    float                   _y_avg[16];
+    CLTonemappingCurveEngine _curve_engine;
+    // device owned, curves are copied in on change
     SmartPtr<CLBuffer>      _y_max_buffer;
     SmartPtr<CLBuffer>      _y_avg_buffer;
     SmartPtr<CLBuffer>      _map_hist_buffer;
+    uint32_t                _buffer_bin_count;
 };
 
 class CLNewTonemappingImageHandler
@@ -22,11 +22,83 @@
 #include "cl_context.h"
 #include "cl_device.h"
 #include "cl_newwavelet_denoise_handler.h"
+#include "cl_scratch_arena.h"
 
 #define WAVELET_DECOMPOSITION_LEVELS 4
 
 namespace XCam {
 
+/*
+ * median absolute deviation of 8 bit coefficients, 127/128 are zero.
+ * rows are walked in memory order, each byte lane has its own histogram
+ * so that neighbouring bytes do not stall on the same bin, lanes 0/2
+ * are U and 1/3 are V in UV planes.
+ */
+static void
+estimate_noise_variance (
+    const uint8_t *pixel, size_t row_pitch, uint32_t width, uint32_t height,
+    uint32_t channel, float *noise_var)
+{
+    uint8_t coeff_bin[256];
+    uint32_t hist[4][128];
+    uint32_t sum[128];
+    float median = 0.0f;
+    float noise_std_deviation = 0.0f;
+
+    for (uint32_t i = 0; i < 256; i++)
+        coeff_bin[i] = (i <= 127) ? (127 - i) : (i - 128);
+    xcam_mem_clear (hist);
+
+    XCAM_ASSERT (width % 4 == 0);
+    for (uint32_t j = 0; j < height; j++) {
+        const uint8_t *row = pixel + j * row_pitch;
+        for (uint32_t i = 0; i < width; i += 4) {
+            hist[0][coeff_bin[row[i]]]++;
+            hist[1][coeff_bin[row[i + 1]]]++;
+            hist[2][coeff_bin[row[i + 2]]]++;
+            hist[3][coeff_bin[row[i + 3]]]++;
+        }
+    }
+
+    uint32_t pixel_count = width * height;
+    uint32_t median_thresh = pixel_count >> 1;
+
+    if (channel == CL_IMAGE_CHANNEL_Y) {
+        for (uint32_t i = 0; i < 128; i++)
+            sum[i] = hist[0][i] + hist[1][i] + hist[2][i] + hist[3][i];
+
+        uint32_t pixel_sum = 0;
+        median = 0;
+        for (uint32_t i = 0; i < 128; i++) {
+            pixel_sum += sum[i];
+            if (pixel_sum >= median_thresh) {
+                median = i;
+                break;
+            }
+        }
+        noise_std_deviation = median / 0.6745;
+        noise_var[0] = noise_std_deviation * noise_std_deviation;
+    }
+    if (channel == CL_IMAGE_CHANNEL_UV) {
+        for (uint32_t lane = 0; lane < 2; lane++) {
+            for (uint32_t i = 0; i < 128; i++)
+                sum[i] = hist[lane][i] + hist[lane + 2][i];
+
+            uint32_t pixel_sum = 0;
+            median = 0;
+            for (uint32_t i = 0; i < 128; i++) {
+                pixel_sum += sum[i];
+                if (pixel_sum >= median_thresh >> 1) {
+                    median = i;
+                    break;
+                }
+            }
+            noise_std_deviation = median / 0.6745;
+            noise_var[1 + lane] = noise_std_deviation * noise_std_deviation;
+        }
+    }
+}
+
 CLWaveletNoiseEstimateKernel::CLWaveletNoiseEstimateKernel (
     SmartPtr<CLContext> &context,
     const char *name,
@@ -47,8 +119,8 @@ CLWaveletNoiseEstimateKernel::CLWaveletNoiseEstimateKernel (
 SmartPtr<CLImage>
 CLWaveletNoiseEstimateKernel::get_input_buffer (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output)
 {
+    XCAM_UNUSED (input);
     XCAM_UNUSED (output);
-    const VideoBufferInfo & video_info = input->get_video_info ();
 
     SmartPtr<CLImage> image;
     SmartPtr<CLWaveletDecompBuffer> buffer = _handler->get_decomp_buffer (_channel, _current_layer);
@@ -65,19 +137,12 @@ CLWaveletNoiseEstimateKernel::get_input_buffer (SmartPtr<DrmBoBuffer> &input, Sm
     }
 
     float current_ag = _handler->get_denoise_config ().analog_gain;
-    if ((_analog_gain == -1.0f) ||
-            (fabs(_analog_gain - current_ag) > 0.2)) {
-
-        if ((_current_layer == 1) && (_subband == CL_WAVELET_SUBBAND_HH)) {
-            _analog_gain = current_ag;
-            estimate_noise_variance (video_info, buffer->hh[0], buffer->noise_variance);
-            _handler->set_estimated_noise_variation (buffer->noise_variance);
-        } else {
-            _handler->get_estimated_noise_variation (buffer->noise_variance);
-        }
-    } else {
-        _handler->get_estimated_noise_variation (buffer->noise_variance);
+    if ((_current_layer == 1) && (_subband == CL_WAVELET_SUBBAND_HH) &&
+            ((_analog_gain == -1.0f) || (fabs(_analog_gain - current_ag) > 0.2))) {
+        _analog_gain = current_ag;
+        _handler->start_noise_estimation (_channel, buffer->hh[0]);
     }
+    _handler->get_estimated_noise_variation (buffer->noise_variance);
     return image;
 }
 
@@ -143,126 +208,6 @@ CLWaveletNoiseEstimateKernel::prepare_arguments (
     return XCAM_RETURN_NO_ERROR;
 }
 
-XCamReturn
-CLWaveletNoiseEstimateKernel::estimate_noise_variance (const VideoBufferInfo & video_info, SmartPtr<CLImage> image, float* noise_var)
-{
-    XCamReturn ret = XCAM_RETURN_NO_ERROR;
-
-    SmartPtr<CLEvent> map_event = new CLEvent;
-    void *buf_ptr = NULL;
-
-    CLImageDesc cl_desc = image->get_image_desc ();
-    uint32_t cl_width = XCAM_ALIGN_UP (cl_desc.width, 2);
-    uint32_t cl_height = XCAM_ALIGN_UP (cl_desc.height, 2);
-
-    uint32_t image_width = cl_width << 2;
-    uint32_t image_height = cl_height;
-
-    size_t origin[3] = {0, 0, 0};
-    size_t row_pitch = cl_desc.row_pitch;
-    size_t slice_pitch = 0;
-    size_t region[3] = {cl_width, cl_height, 1};
-
-    ret = image->enqueue_map (buf_ptr,
-                              origin, region,
-                              &row_pitch, &slice_pitch,
-                              CL_MEM_READ_ONLY,
-                              CLEvent::EmptyList,
-                              map_event);
-    if (ret != XCAM_RETURN_NO_ERROR) {
-        XCAM_LOG_ERROR ("wavelet noise variance buffer enqueue map failed");
-    }
-    XCAM_ASSERT (map_event->get_event_id ());
-
-    ret = map_event->wait ();
-    if (ret != XCAM_RETURN_NO_ERROR) {
-        XCAM_LOG_ERROR ("wavelet noise variance buffer enqueue map event wait failed");
-    }
-
-    uint8_t* pixel = (uint8_t*)buf_ptr;
-    uint32_t pixel_count = image_width * image_height;
-    uint32_t pixel_sum = 0;
-
-    uint32_t median_thresh = pixel_count >> 1;
-    float median = 0;
-    float noise_std_deviation = 0;
-
-    uint32_t hist_bin_count = 1 << video_info.color_bits;
-    uint32_t hist_y[128] = {0};
-    uint32_t hist_u[128] = {0};
-    uint32_t hist_v[128] = {0};
-
-    if (_channel == CL_IMAGE_CHANNEL_Y) {
-        for (uint32_t i = 0; i < image_width; i++) {
-            for (uint32_t j = 0; j < image_height; j++) {
-                uint8_t base = (pixel[i + j * row_pitch] <= 127) ? 127 : 128;
-                hist_y[abs(pixel[i + j * row_pitch] - base)]++;
-            }
-        }
-        pixel_sum = 0;
-        median = 0;
-        for (uint32_t i = 0; i < (hist_bin_count - 1); i++) {
-            pixel_sum += hist_y[i];
-            if (pixel_sum >= median_thresh) {
-                median = i;
-                break;
-            }
-        }
-        noise_std_deviation = median / 0.6745;
-        noise_var[0] = noise_std_deviation * noise_std_deviation;
-    }
-    if (_channel == CL_IMAGE_CHANNEL_UV) {
-        for (uint32_t i = 0; i < (image_width / 2); i++) {
-            for (uint32_t j = 0; j < image_height; j++) {
-                uint8_t base = (pixel[2 * i + j * row_pitch] <= 127) ? 127 : 128;
-                hist_u[abs(pixel[2 * i + j * row_pitch] - base)]++;
-                base = (pixel[2 * i + 1 + j * row_pitch] <= 127) ? 127 : 128;
-                hist_v[abs(pixel[2 * i + 1 + j * row_pitch] - base)]++;
-            }
-        }
-        pixel_sum = 0;
-        median = 0;
-        for (uint32_t i = 0; i < (hist_bin_count - 1); i++) {
-            pixel_sum += hist_u[i];
-            if (pixel_sum >= median_thresh >> 1) {
-                median = i;
-                break;
-            }
-        }
-        noise_std_deviation = median / 0.6745;
-        noise_var[1] = noise_std_deviation * noise_std_deviation;
-
-        pixel_sum = 0;
-        median = 0;
-        for (uint32_t i = 0; i < (hist_bin_count - 1); i++) {
-            pixel_sum += hist_v[i];
-            if (pixel_sum >= median_thresh >> 1) {
-                median = i;
-                break;
-            }
-        }
-        noise_std_deviation = median / 0.6745;
-        noise_var[2] = noise_std_deviation * noise_std_deviation;
-    }
-
-    map_event.release ();
-
-    SmartPtr<CLEvent> unmap_event = new CLEvent;
-    ret = image->enqueue_unmap (buf_ptr, CLEvent::EmptyList, unmap_event);
-    if (ret != XCAM_RETURN_NO_ERROR) {
-        XCAM_LOG_ERROR ("wavelet noise variance buffer enqueue unmap failed");
-    }
-    XCAM_ASSERT (unmap_event->get_event_id ());
-
-    ret = unmap_event->wait ();
-    if (ret != XCAM_RETURN_NO_ERROR) {
-        XCAM_LOG_ERROR ("wavelet noise variance buffer enqueue unmap event wait failed");
-    }
-    unmap_event.release ();
-
-    return ret;
-}
-
 CLWaveletThresholdingKernel::CLWaveletThresholdingKernel (
     SmartPtr<CLContext> &context,
     const char *name,
@@ -424,8 +369,8 @@ CLWaveletTransformKernel::prepare_arguments (
     cl_desc_out.height = video_info_out.height;
     cl_desc_out.row_pitch = video_info_out.strides[0];
 
-    _image_in = new CLVaImage (context, input, cl_desc_in, video_info_in.offsets[0]);
-    _image_out = new CLVaImage (context, output, cl_desc_out, video_info_out.offsets[0]);
+    _image_in = get_cached_va_image (context, input, cl_desc_in, video_info_in.offsets[0]);
+    _image_out = get_cached_va_image (context, output, cl_desc_out, video_info_out.offsets[0]);
 
     cl_desc_in.height = XCAM_ALIGN_UP (video_info_in.height, 2) / 2;
     cl_desc_in.row_pitch = video_info_in.strides[1];
@@ -433,8 +378,8 @@ CLWaveletTransformKernel::prepare_arguments (
     cl_desc_out.height = XCAM_ALIGN_UP (video_info_out.height, 2) / 2;
     cl_desc_out.row_pitch = video_info_out.strides[1];
 
-    _image_in_uv = new CLVaImage (context, input, cl_desc_in, video_info_in.offsets[1]);
-    _image_out_uv = new CLVaImage (context, output, cl_desc_out, video_info_out.offsets[1]);
+    _image_in_uv = get_cached_va_image (context, input, cl_desc_in, video_info_in.offsets[1]);
+    _image_out_uv = get_cached_va_image (context, output, cl_desc_out, video_info_out.offsets[1]);
 
     XCAM_ASSERT (_image_in->is_valid () && _image_out->is_valid ());
     XCAM_FAIL_RETURN (
@@ -551,6 +496,27 @@ CLNewWaveletDenoiseImageHandler::CLNewWaveletDenoiseImageHandler (const char *na
     _config.threshold[0] = 0.5;
     _config.threshold[1] = 5.0;
     xcam_mem_clear (_noise_variance);
+    _noise_estimated[0] = false;
+    _noise_estimated[1] = false;
+}
+
+CLNewWaveletDenoiseImageHandler::~CLNewWaveletDenoiseImageHandler ()
+{
+    SmartLock locker (_noise_mutex);
+    release_noise_snapshot_unsafe (0);
+    release_noise_snapshot_unsafe (1);
+}
+
+void
+CLNewWaveletDenoiseImageHandler::emit_stop ()
+{
+    {
+        // snapshot pending at stop must not go back to the arena mapped
+        SmartLock locker (_noise_mutex);
+        release_noise_snapshot_unsafe (0);
+        release_noise_snapshot_unsafe (1);
+    }
+    CLImageHandler::emit_stop ();
 }
 
 XCamReturn
@@ -559,7 +525,14 @@ CLNewWaveletDenoiseImageHandler::prepare_output_buf (SmartPtr<DrmBoBuffer> &inpu
     XCamReturn ret = XCAM_RETURN_NO_ERROR;
     CLImageHandler::prepare_output_buf(input, output);
 
-    SmartPtr<CLContext> context = CLDevice::instance ()->get_context ();
+    {
+        // coefficients of last frame, before this frame's decomposition
+        SmartLock locker (_noise_mutex);
+        finish_noise_estimation_unsafe (0);
+        finish_noise_estimation_unsafe (1);
+    }
+
+    SmartPtr<CLScratchArena> scratch = CLScratchArena::instance ();
     const VideoBufferInfo & video_info = input->get_video_info ();
     CLImageDesc cl_desc;
     SmartPtr<CLWaveletDecompBuffer> decompBuffer;
@@ -587,11 +560,11 @@ CLNewWaveletDenoiseImageHandler::prepare_output_buf (SmartPtr<DrmBoBuffer> &inpu
                 cl_desc.format.image_channel_order = CL_RGBA;
                 cl_desc.format.image_channel_data_type = CL_UNORM_INT8;
 
-                decompBuffer->ll = new CLImage2D (context, cl_desc);
+                decompBuffer->ll = scratch->get_image (cl_desc);
 
-                decompBuffer->hl[0] = new CLImage2D (context, cl_desc);
-                decompBuffer->lh[0] = new CLImage2D (context, cl_desc);
-                decompBuffer->hh[0] = new CLImage2D (context, cl_desc);
+                decompBuffer->hl[0] = scratch->get_image (cl_desc);
+                decompBuffer->lh[0] = scratch->get_image (cl_desc);
+                decompBuffer->hh[0] = scratch->get_image (cl_desc);
                 /*
                                 uint32_t width = decompBuffer->width / 4;
                                 uint32_t height = decompBuffer->height;
@@ -612,14 +585,14 @@ CLNewWaveletDenoiseImageHandler::prepare_output_buf (SmartPtr<DrmBoBuffer> &inpu
                 */
 
                 cl_desc.format.image_channel_data_type = CL_UNORM_INT16;
-                decompBuffer->hl[1] = new CLImage2D (context, cl_desc);
-                decompBuffer->lh[1] = new CLImage2D (context, cl_desc);
-                decompBuffer->hh[1] = new CLImage2D (context, cl_desc);
+                decompBuffer->hl[1] = scratch->get_image (cl_desc);
+                decompBuffer->lh[1] = scratch->get_image (cl_desc);
+                decompBuffer->hh[1] = scratch->get_image (cl_desc);
 
                 cl_desc.format.image_channel_data_type = CL_UNORM_INT8;
-                decompBuffer->hl[2] = new CLImage2D (context, cl_desc);
-                decompBuffer->lh[2] = new CLImage2D (context, cl_desc);
-                decompBuffer->hh[2] = new CLImage2D (context, cl_desc);
+                decompBuffer->hl[2] = scratch->get_image (cl_desc);
+                decompBuffer->lh[2] = scratch->get_image (cl_desc);
+                decompBuffer->hh[2] = scratch->get_image (cl_desc);
 
                 _decompBufferList.push_back (decompBuffer);
             } else {
@@ -649,11 +622,11 @@ CLNewWaveletDenoiseImageHandler::prepare_output_buf (SmartPtr<DrmBoBuffer> &inpu
                 cl_desc.format.image_channel_order = CL_RGBA;
                 cl_desc.format.image_channel_data_type = CL_UNORM_INT8;
 
-                decompBuffer->ll = new CLImage2D (context, cl_desc);
+                decompBuffer->ll = scratch->get_image (cl_desc);
 
-                decompBuffer->hl[0] = new CLImage2D (context, cl_desc);
-                decompBuffer->lh[0] = new CLImage2D (context, cl_desc);
-                decompBuffer->hh[0] = new CLImage2D (context, cl_desc);
+                decompBuffer->hl[0] = scratch->get_image (cl_desc);
+                decompBuffer->lh[0] = scratch->get_image (cl_desc);
+                decompBuffer->hh[0] = scratch->get_image (cl_desc);
                 /*
                                 uint32_t width = decompBuffer->width / 4;
                                 uint32_t height = decompBuffer->height;
@@ -672,14 +645,14 @@ CLNewWaveletDenoiseImageHandler::prepare_output_buf (SmartPtr<DrmBoBuffer> &inpu
                                     context, hh_desc, 0, hh_buffer);
                 */
                 cl_desc.format.image_channel_data_type = CL_UNORM_INT16;
-                decompBuffer->hl[1] = new CLImage2D (context, cl_desc);
-                decompBuffer->lh[1] = new CLImage2D (context, cl_desc);
-                decompBuffer->hh[1] = new CLImage2D (context, cl_desc);
+                decompBuffer->hl[1] = scratch->get_image (cl_desc);
+                decompBuffer->lh[1] = scratch->get_image (cl_desc);
+                decompBuffer->hh[1] = scratch->get_image (cl_desc);
 
                 cl_desc.format.image_channel_data_type = CL_UNORM_INT8;
-                decompBuffer->hl[2] = new CLImage2D (context, cl_desc);
-                decompBuffer->lh[2] = new CLImage2D (context, cl_desc);
-                decompBuffer->hh[2] = new CLImage2D (context, cl_desc);
+                decompBuffer->hl[2] = scratch->get_image (cl_desc);
+                decompBuffer->lh[2] = scratch->get_image (cl_desc);
+                decompBuffer->hh[2] = scratch->get_image (cl_desc);
 
                 _decompBufferList.push_back (decompBuffer);
             } else {
@@ -691,6 +664,15 @@ CLNewWaveletDenoiseImageHandler::prepare_output_buf (SmartPtr<DrmBoBuffer> &inpu
     return ret;
 }
 
+// decomposition images go back to the arena, handlers run next can reuse them
+XCamReturn
+CLNewWaveletDenoiseImageHandler::execute_done (SmartPtr<DrmBoBuffer> &output)
+{
+    XCAM_UNUSED (output);
+    _decompBufferList.clear ();
+    return XCAM_RETURN_NO_ERROR;
+}
+
 bool
 CLNewWaveletDenoiseImageHandler::set_denoise_config (const XCam3aResultWaveletNoiseReduction& config)
 {
@@ -736,6 +718,94 @@ CLNewWaveletDenoiseImageHandler::get_estimated_noise_variation (float* noise_var
     noise_var[2] = _noise_variance[2];
 }
 
+XCamReturn
+CLNewWaveletDenoiseImageHandler::start_noise_estimation (uint32_t channel, SmartPtr<CLImage> &image)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    uint32_t index = (channel == CL_IMAGE_CHANNEL_Y) ? 0 : 1;
+    CLWaveletNoiseSnapshot &snapshot = _noise_snapshot[index];
+    SmartLock locker (_noise_mutex);
+
+    XCAM_ASSERT (image.ptr () && image->is_valid ());
+    if (snapshot.image.ptr ()) {
+        XCAM_LOG_DEBUG ("wavelet noise estimation of channel(%d) is pending", channel);
+        return XCAM_RETURN_BYPASS;
+    }
+
+    const CLImageDesc &cl_desc = image->get_image_desc ();
+    size_t origin[3] = {0, 0, 0};
+    size_t region[3] = {cl_desc.width, cl_desc.height, 1};
+    size_t row_pitch = 0;
+    size_t slice_pitch = 0;
+    void *ptr = NULL;
+    SmartPtr<CLEvent> map_event = new CLEvent;
+
+    // queued after this frame's decomposition, thresholding still reads it
+    ret = image->enqueue_map (ptr,
+                              origin, region,
+                              &row_pitch, &slice_pitch,
+                              CL_MAP_READ,
+                              CLEvent::EmptyList,
+                              map_event,
+                              false);
+    XCAM_FAIL_RETURN (
+        WARNING,
+        ret == XCAM_RETURN_NO_ERROR,
+        ret,
+        "wavelet noise variance buffer enqueue map failed");
+    XCAM_ASSERT (map_event->get_event_id ());
+
+    snapshot.image = image;
+    snapshot.map_event = map_event;
+    snapshot.ptr = ptr;
+    snapshot.row_pitch = row_pitch;
+    snapshot.width = cl_desc.width * image->get_pixel_bytes ();
+    snapshot.height = cl_desc.height;
+
+    if (!_noise_estimated[index])
+        return finish_noise_estimation_unsafe (index);
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+CLNewWaveletDenoiseImageHandler::finish_noise_estimation_unsafe (uint32_t index)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    CLWaveletNoiseSnapshot &snapshot = _noise_snapshot[index];
+
+    if (!snapshot.image.ptr ())
+        return XCAM_RETURN_NO_ERROR;
+
+    ret = snapshot.map_event->wait ();
+    if (ret == XCAM_RETURN_NO_ERROR) {
+        estimate_noise_variance (
+            (const uint8_t *)snapshot.ptr, snapshot.row_pitch, snapshot.width, snapshot.height,
+            (index == 0) ? CL_IMAGE_CHANNEL_Y : CL_IMAGE_CHANNEL_UV, _noise_variance);
+        _noise_estimated[index] = true;
+    } else {
+        XCAM_LOG_ERROR ("wavelet noise variance buffer enqueue map event wait failed");
+    }
+
+    release_noise_snapshot_unsafe (index);
+    return ret;
+}
+
+void
+CLNewWaveletDenoiseImageHandler::release_noise_snapshot_unsafe (uint32_t index)
+{
+    CLWaveletNoiseSnapshot &snapshot = _noise_snapshot[index];
+
+    if (!snapshot.image.ptr ())
+        return;
+
+    XCAM_ASSERT (snapshot.ptr);
+    // in-order queue, the map completes first and later users of the image run after the unmap
+    if (snapshot.image->enqueue_unmap (snapshot.ptr) != XCAM_RETURN_NO_ERROR) {
+        XCAM_LOG_ERROR ("wavelet noise variance buffer enqueue unmap failed");
+    }
+    snapshot = CLWaveletNoiseSnapshot ();
+}
+
 void
 CLNewWaveletDenoiseImageHandler::dump_coeff (SmartPtr<CLImage> image, uint32_t channel, uint32_t layer, uint32_t subband)
 {
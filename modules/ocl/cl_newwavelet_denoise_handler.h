@@ -83,8 +83,6 @@ public:
     SmartPtr<CLImage> get_input_buffer (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output);
     SmartPtr<CLImage> get_output_buffer (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output);
 
-    XCamReturn estimate_noise_variance (const VideoBufferInfo & video_info, SmartPtr<CLImage> image, float* noise_var);
-
 protected:
     virtual XCamReturn prepare_arguments (
         SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output,
@@ -172,6 +170,30 @@ private:
     SmartPtr<CLNewWaveletDenoiseImageHandler> _handler;
 };
 
+/*
+ * HH coefficients of layer 1, mapped CL_MAP_READ without blocking and
+ * left mapped for one frame, the histogram is built when the next frame
+ * starts, by then the map has completed. image is a CLScratchImage, only
+ * this reference keeps it out of the scratch arena, so it must be
+ * unmapped before the reference is dropped, otherwise the arena hands
+ * out a still mapped image.
+ */
+struct CLWaveletNoiseSnapshot {
+    SmartPtr<CLImage>    image;
+    SmartPtr<CLEvent>    map_event;
+    void                *ptr;
+    size_t               row_pitch;
+    uint32_t             width;   // in bytes
+    uint32_t             height;
+
+    CLWaveletNoiseSnapshot ()
+        : ptr (NULL)
+        , row_pitch (0)
+        , width (0)
+        , height (0)
+    {}
+};
+
 class CLNewWaveletDenoiseImageHandler
     : public CLImageHandler
 {
@@ -179,6 +201,7 @@ class CLNewWaveletDenoiseImageHandler
 
 public:
     explicit CLNewWaveletDenoiseImageHandler (const char *name, uint32_t channel);
+    ~CLNewWaveletDenoiseImageHandler ();
 
     bool set_denoise_config (const XCam3aResultWaveletNoiseReduction& config);
     XCam3aResultWaveletNoiseReduction& get_denoise_config () {
@@ -190,12 +213,27 @@ public:
     void set_estimated_noise_variation (float* noise_var);
     void get_estimated_noise_variation (float* noise_var);
 
+    /*
+     * noise variance of @channel from @image (HH of layer 1) is taken
+     * by the thresholds of the next frame, only the first estimation
+     * of a channel waits for the coefficients.
+     */
+    XCamReturn start_noise_estimation (uint32_t channel, SmartPtr<CLImage> &image);
+
     void dump_coeff (SmartPtr<CLImage> image, uint32_t channel, uint32_t layer, uint32_t subband);
 
+    virtual void emit_stop ();
+
 protected:
     virtual XCamReturn prepare_output_buf (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output);
+    virtual XCamReturn execute_done (SmartPtr<DrmBoBuffer> &output);
 
 private:
+    // call with _noise_mutex held
+    XCamReturn finish_noise_estimation_unsafe (uint32_t index);
+    // unmap and drop a pending snapshot without estimating, call with _noise_mutex held
+    void release_noise_snapshot_unsafe (uint32_t index);
+
     XCAM_DEAD_COPY (CLNewWaveletDenoiseImageHandler);
 
 private:
@@ -203,6 +241,11 @@ private:
     XCam3aResultWaveletNoiseReduction _config;
     CLWaveletDecompBufferList _decompBufferList;
     float _noise_variance[3];
+    // snapshots are also released by emit_stop from another thread
+    Mutex _noise_mutex;
+    // indexed by Y, UV
+    CLWaveletNoiseSnapshot _noise_snapshot[2];
+    bool _noise_estimated[2];
 };
 
 SmartPtr<CLImageHandler>
@@ -24,6 +24,7 @@
 #include "cl_device.h"
 #include "cl_image_bo_buffer.h"
 #include "cl_utils.h"
+#include "cl_scratch_arena.h"
 
 #if CL_PYRAMID_ENABLE_DUMP
 #define BLENDER_PROFILING_START(name)  XCAM_STATIC_PROFILING_START(name)
@@ -336,13 +337,13 @@ PyramidLayer::bind_buf_to_layer0 (
         cl_desc.width = in0_info.width / 8;
         cl_desc.height = in0_info.height / divider_vert[i_plane];
         cl_desc.row_pitch = in0_info.strides[i_plane];
-        this->gauss_image[i_plane][0] = new CLVaImage (context, input0, cl_desc, in0_info.offsets[i_plane]);
+        this->gauss_image[i_plane][0] = get_cached_va_image (context, input0, cl_desc, in0_info.offsets[i_plane]);
         this->gauss_offset_x[i_plane][0] = merge0_rect.pos_x; // input0 offset
 
         cl_desc.width = in1_info.width / 8;
         cl_desc.height = in1_info.height / divider_vert[i_plane];
         cl_desc.row_pitch = in1_info.strides[i_plane];
-        this->gauss_image[i_plane][1] = new CLVaImage (context, input1, cl_desc, in1_info.offsets[i_plane]);
+        this->gauss_image[i_plane][1] = get_cached_va_image (context, input1, cl_desc, in1_info.offsets[i_plane]);
         this->gauss_offset_x[i_plane][1] = merge1_rect.pos_x; // input1 offset
 
         cl_desc.width = out_info.width / 8;
@@ -350,20 +351,16 @@ PyramidLayer::bind_buf_to_layer0 (
         cl_desc.row_pitch = out_info.strides[i_plane];
 
         if (scale_mode == CLBlenderScaleLocal) {
-            this->scale_image[i_plane] = new CLVaImage (context, output, cl_desc, out_info.offsets[i_plane]);
+            this->scale_image[i_plane] = get_cached_va_image (context, output, cl_desc, out_info.offsets[i_plane]);
 
             cl_desc.width = XCAM_ALIGN_UP (this->blend_width, XCAM_BLENDER_ALIGNED_WIDTH) / 8;
             cl_desc.height = XCAM_ALIGN_UP (this->blend_height, divider_vert[i_plane]) / divider_vert[i_plane];
-            uint32_t row_pitch = CLImage::calculate_pixel_bytes (cl_desc.format) * cl_desc.width;
-            uint32_t size = row_pitch * cl_desc.height;
-            SmartPtr<CLBuffer> cl_buf = new CLBuffer (context, size);
-            XCAM_ASSERT (cl_buf.ptr () && cl_buf->is_valid ());
-            cl_desc.row_pitch = row_pitch;
-            this->blend_image[i_plane][ReconstructImageIndex] = new CLImage2D (context, cl_desc, 0, cl_buf);
+            cl_desc.row_pitch = CLImage::calculate_pixel_bytes (cl_desc.format) * cl_desc.width;
+            this->blend_image[i_plane][ReconstructImageIndex] = CLScratchArena::instance ()->get_buffer_image (cl_desc);
             XCAM_ASSERT (this->blend_image[i_plane][ReconstructImageIndex].ptr ());
         } else {
             this->blend_image[i_plane][ReconstructImageIndex] =
-                new CLVaImage (context, output, cl_desc, out_info.offsets[i_plane]);
+                get_cached_va_image (context, output, cl_desc, out_info.offsets[i_plane]);
         }
     }
 
@@ -399,15 +396,16 @@ PyramidLayer::init_layer0 (SmartPtr<CLContext> context, bool last_layer, bool ne
     int max_plane = (need_uv ? 2 : 1);
     uint32_t divider_vert[2] = {1, 2};
     CLImageDesc cl_desc;
+    SmartPtr<CLScratchArena> scratch = CLScratchArena::instance ();
     cl_desc.format.image_channel_data_type = CL_UNSIGNED_INT16;
     cl_desc.format.image_channel_order = CL_RGBA;
     for (int i_plane = 0; i_plane < max_plane; ++i_plane) {
         cl_desc.width = this->blend_width / 8;
         cl_desc.height = XCAM_ALIGN_UP (this->blend_height, divider_vert[i_plane]) / divider_vert[i_plane];
 
-        this->blend_image[i_plane][BlendImageIndex] = new CLImage2D (context, cl_desc);
-        this->lap_image[i_plane][0] = new CLImage2D (context, cl_desc);
-        this->lap_image[i_plane][1] = new CLImage2D (context, cl_desc);
+        this->blend_image[i_plane][BlendImageIndex] = scratch->get_image (cl_desc);
+        this->lap_image[i_plane][0] = scratch->get_image (cl_desc);
+        this->lap_image[i_plane][1] = scratch->get_image (cl_desc);
         this->lap_offset_x[i_plane][0] = this->lap_offset_x[i_plane][1] = 0;
 
 #if CL_PYRAMID_ENABLE_DUMP
@@ -422,9 +420,9 @@ PyramidLayer::init_layer0 (SmartPtr<CLContext> context, bool last_layer, bool ne
 void
 PyramidLayer::build_cl_images (SmartPtr<CLContext> context, bool last_layer, bool need_uv)
 {
-    uint32_t size = 0, row_pitch = 0;
+    XCAM_UNUSED (context);
     CLImageDesc cl_desc_set;
-    SmartPtr<CLBuffer> cl_buf;
+    SmartPtr<CLScratchArena> scratch = CLScratchArena::instance ();
     uint32_t divider_vert[2] = {1, 2};
     uint32_t max_plane = (need_uv ? 2 : 1);
 
@@ -438,24 +436,16 @@ PyramidLayer::build_cl_images (SmartPtr<CLContext> context, bool last_layer, boo
             cl_desc_set.height = XCAM_ALIGN_UP (this->blend_height, divider_vert[plane]) / divider_vert[plane];
 
             //gauss y image created by cl buffer
-            row_pitch = CLImage::calculate_pixel_bytes (cl_desc_set.format) * cl_desc_set.width;
-            size = row_pitch * cl_desc_set.height;
-            cl_buf = new CLBuffer (context, size);
-            XCAM_ASSERT (cl_buf.ptr () && cl_buf->is_valid ());
-            cl_desc_set.row_pitch = row_pitch;
-            this->gauss_image[plane][i_image] = new CLImage2D (context, cl_desc_set, 0, cl_buf);
+            cl_desc_set.row_pitch = CLImage::calculate_pixel_bytes (cl_desc_set.format) * cl_desc_set.width;
+            this->gauss_image[plane][i_image] = scratch->get_buffer_image (cl_desc_set);
             XCAM_ASSERT (this->gauss_image[plane][i_image].ptr ());
             this->gauss_offset_x[plane][i_image]  = 0; // offset to 0, need recalculate if for deep multi-band blender
         }
 
         cl_desc_set.width = XCAM_ALIGN_UP (this->blend_width, XCAM_BLENDER_ALIGNED_WIDTH) / 8;
         cl_desc_set.height = XCAM_ALIGN_UP (this->blend_height, divider_vert[plane]) / divider_vert[plane];
-        row_pitch = CLImage::calculate_pixel_bytes (cl_desc_set.format) * cl_desc_set.width;
-        size = row_pitch * cl_desc_set.height;
-        cl_buf = new CLBuffer (context, size);
-        XCAM_ASSERT (cl_buf.ptr () && cl_buf->is_valid ());
-        cl_desc_set.row_pitch = row_pitch;
-        this->blend_image[plane][ReconstructImageIndex] = new CLImage2D (context, cl_desc_set, 0, cl_buf);
+        cl_desc_set.row_pitch = CLImage::calculate_pixel_bytes (cl_desc_set.format) * cl_desc_set.width;
+        this->blend_image[plane][ReconstructImageIndex] = scratch->get_buffer_image (cl_desc_set);
         XCAM_ASSERT (this->blend_image[plane][ReconstructImageIndex].ptr ());
 #if CL_PYRAMID_ENABLE_DUMP
         this->dump_gauss_resize[plane] = new CLImage2D (context, cl_desc_set);
@@ -465,10 +455,10 @@ PyramidLayer::build_cl_images (SmartPtr<CLContext> context, bool last_layer, boo
 #endif
         if (!last_layer) {
             cl_desc_set.row_pitch = 0;
-            this->blend_image[plane][BlendImageIndex] = new CLImage2D (context, cl_desc_set);
+            this->blend_image[plane][BlendImageIndex] = scratch->get_image (cl_desc_set);
             XCAM_ASSERT (this->blend_image[plane][BlendImageIndex].ptr ());
             for (int i_image = 0; i_image < XCAM_CL_BLENDER_IMAGE_NUM; ++i_image) {
-                this->lap_image[plane][i_image] = new CLImage2D (context, cl_desc_set);
+                this->lap_image[plane][i_image] = scratch->get_image (cl_desc_set);
                 XCAM_ASSERT (this->lap_image[plane][i_image].ptr ());
                 this->lap_offset_x[plane][i_image]  = 0; // offset to 0, need calculate from next layer if for deep multi-band blender
             }
@@ -638,8 +628,10 @@ CLPyramidBlender::allocate_cl_buffers (
 XCamReturn
 CLPyramidBlender::init_seam_buffers (SmartPtr<CLContext> context)
 {
+    XCAM_UNUSED (context);
     const PyramidLayer &layer0 = get_pyramid_layer (0);
     CLImageDesc cl_desc;
+    SmartPtr<CLScratchArena> scratch = CLScratchArena::instance ();
 
     _seam_width = layer0.blend_width;
     _seam_height = layer0.blend_height;
@@ -653,18 +645,12 @@ CLPyramidBlender::init_seam_buffers (SmartPtr<CLContext> context)
     XCAM_ASSERT (_seam_pos_offset_x + _seam_pos_valid_width <= _seam_width);
 
     XCAM_ASSERT (layer0.blend_width > 0 && layer0.blend_height > 0);
-    uint32_t image_diff_size = sizeof (uint8_t) * _seam_width * _seam_height;
-    SmartPtr<CLBuffer> cl_diff_buf = new CLBuffer (context, image_diff_size);
-    XCAM_FAIL_RETURN (
-        ERROR,
-        cl_diff_buf.ptr () && cl_diff_buf->is_valid (),
-        XCAM_RETURN_ERROR_CL,
-        "CLPyramidBlender init seam buffer failed to create image_difference buffers");
     cl_desc.format.image_channel_data_type = CL_UNSIGNED_INT16;
     cl_desc.format.image_channel_order = CL_RGBA;
     cl_desc.width = _seam_width / 8;
     cl_desc.height = _seam_height;
-    _image_diff = new CLImage2D (context, cl_desc, 0, cl_diff_buf);
+    cl_desc.row_pitch = sizeof (uint8_t) * _seam_width;
+    _image_diff = scratch->get_buffer_image (cl_desc);
     XCAM_FAIL_RETURN (
         ERROR,
         _image_diff.ptr () && _image_diff->is_valid (),
@@ -673,8 +659,8 @@ CLPyramidBlender::init_seam_buffers (SmartPtr<CLContext> context)
 
     uint32_t pos_buf_size = sizeof (SEAM_POS_TYPE) * _seam_pos_stride * _seam_height;
     uint32_t sum_buf_size = sizeof (SEAM_SUM_TYPE) * _seam_pos_stride * 2; // 2 lines
-    _seam_pos_buf = new CLBuffer (context, pos_buf_size, CL_MEM_READ_WRITE);
-    _seam_sum_buf = new CLBuffer (context, sum_buf_size, CL_MEM_READ_WRITE);
+    _seam_pos_buf = scratch->get_buffer (pos_buf_size);
+    _seam_sum_buf = scratch->get_buffer (sum_buf_size);
     XCAM_FAIL_RETURN (
         ERROR,
         _seam_pos_buf.ptr () && _seam_pos_buf->is_valid () &&
@@ -685,17 +671,13 @@ CLPyramidBlender::init_seam_buffers (SmartPtr<CLContext> context)
     uint32_t mask_width = XCAM_ALIGN_UP(_seam_width, XCAM_BLENDER_ALIGNED_WIDTH);
     uint32_t mask_height = XCAM_ALIGN_UP(_seam_height, 2);
     for (uint32_t i = 0; i < _layers; ++i) {
-        uint32_t mask_size = sizeof (SEAM_MASK_TYPE) * mask_width * mask_height;
-        SmartPtr<CLBuffer> cl_buf0 = new CLBuffer (context, mask_size);
-        SmartPtr<CLBuffer> cl_buf1 = new CLBuffer (context, mask_size);
-        XCAM_ASSERT (cl_buf0.ptr () && cl_buf0->is_valid () && cl_buf1.ptr () && cl_buf1->is_valid ());
         cl_desc.format.image_channel_data_type = CL_UNSIGNED_INT16;
         cl_desc.format.image_channel_order = CL_RGBA;
         cl_desc.width = mask_width / 8;
         cl_desc.height = mask_height;
         cl_desc.row_pitch = sizeof (SEAM_MASK_TYPE) * mask_width;
-        _pyramid_layers[i].seam_mask[CLSeamMaskTmp] = new CLImage2D (context, cl_desc, 0, cl_buf0);
-        _pyramid_layers[i].seam_mask[CLSeamMaskCoeff] = new CLImage2D (context, cl_desc, 0, cl_buf1);
+        _pyramid_layers[i].seam_mask[CLSeamMaskTmp] = scratch->get_buffer_image (cl_desc);
+        _pyramid_layers[i].seam_mask[CLSeamMaskCoeff] = scratch->get_buffer_image (cl_desc);
         XCAM_FAIL_RETURN (
             ERROR,
             _pyramid_layers[i].seam_mask[CLSeamMaskTmp].ptr () && _pyramid_layers[i].seam_mask[CLSeamMaskTmp]->is_valid () &&
@@ -24,9 +24,12 @@
 #include <algorithm>
 #include "cl_device.h"
 #include "cl_image_bo_buffer.h"
+#include "cl_scratch_arena.h"
 
 static uint32_t retinex_gauss_scale [3] = {2, 8, 20}; //{20, 60, 150};
 static float retinex_gauss_sigma [3] = {2.0f, 8.0f, 20.0f}; //{12.0f, 40.0f, 120.0f};
+// CL_RETINEX_GAUSS_BOX, cost does not grow with sigma
+static float retinex_box_sigma [3] = {2.0f, 20.0f, 60.0f};
 static float retinex_config_log_min = -0.12f; // -0.18f
 static float retinex_config_log_max = 0.18f;  //0.2f
 
@@ -84,6 +87,134 @@ CLRetinexGaussImageKernel::get_output_parameter (
     return _retinex->get_gaussian_buf (_index);
 }
 
+CLRetinexBoxImageKernel::CLRetinexBoxImageKernel (
+    SmartPtr<CLContext> &context,
+    SmartPtr<CLRetinexImageHandler> &retinex,
+    uint32_t index, uint32_t pass, uint32_t radius)
+    : CLImageKernel (context, "kernel_retinex_box")
+    , _retinex (retinex)
+    , _index (index)
+    , _pass (pass)
+    , _radius (radius)
+    , _in_offset (0)
+    , _in_pitch (0)
+    , _out_offset (0)
+    , _out_pitch (0)
+    , _length (0)
+    , _lines (0)
+{
+}
+
+/*
+ * even passes filter rows of the reduced luma and write them transposed,
+ * odd passes filter those columns and write them back in place. the
+ * first pass reads the scaled luma or the gaussian of the previous
+ * scale, the last one writes the gaussian of this scale.
+ */
+XCamReturn
+CLRetinexBoxImageKernel::prepare_arguments (
+    SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output,
+    CLArgument args[], uint32_t &arg_count,
+    CLWorkSize &work_size)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    SmartPtr<CLContext> context = get_context ();
+    const uint32_t last_pass = get_pass_count () - 1;
+    const bool column = (_pass % 2);
+    SmartPtr<DrmBoBuffer> &scaler_buf = _retinex->get_scaler_buf1 ();
+    XCAM_ASSERT (scaler_buf.ptr ());
+    const VideoBufferInfo &map_info = scaler_buf->get_video_info ();
+    const uint32_t width = map_info.width, height = map_info.height;
+
+    _length = column ? height : width;
+    _lines = column ? width : height;
+
+    if (_pass == 0) {
+        SmartPtr<DrmBoBuffer> &src = _index ? _retinex->get_gaussian_buf (_index - 1) : scaler_buf;
+        const VideoBufferInfo &src_info = src->get_video_info ();
+        _buf_in = get_cached_va_buffer (context, src);
+        _in_offset = src_info.offsets[0];
+        _in_pitch = src_info.strides[0];
+    } else {
+        _buf_in = _retinex->get_box_buf ((_pass - 1) % 2);
+        _in_offset = 0;
+        _in_pitch = _length;
+    }
+
+    if (_pass == last_pass) {
+        SmartPtr<DrmBoBuffer> &dst = _retinex->get_gaussian_buf (_index);
+        const VideoBufferInfo &dst_info = dst->get_video_info ();
+        _buf_out = get_cached_va_buffer (context, dst);
+        _out_offset = dst_info.offsets[0];
+        _out_pitch = dst_info.strides[0];
+    } else {
+        _buf_out = _retinex->get_box_buf (_pass % 2);
+        _out_offset = 0;
+        _out_pitch = _lines;
+    }
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        _buf_in.ptr () && _buf_in->is_valid () && _buf_out.ptr () && _buf_out->is_valid (),
+        XCAM_RETURN_ERROR_MEM,
+        "cl image kernel(%s) scale(%d) pass(%d) memory not available", get_kernel_name (), _index, _pass);
+
+    //set args;
+    arg_count = 0;
+    args[arg_count].arg_adress = &_buf_in->get_mem_id ();
+    args[arg_count].arg_size = sizeof (cl_mem);
+    ++arg_count;
+
+    args[arg_count].arg_adress = &_in_offset;
+    args[arg_count].arg_size = sizeof (_in_offset);
+    ++arg_count;
+
+    args[arg_count].arg_adress = &_in_pitch;
+    args[arg_count].arg_size = sizeof (_in_pitch);
+    ++arg_count;
+
+    args[arg_count].arg_adress = &_buf_out->get_mem_id ();
+    args[arg_count].arg_size = sizeof (cl_mem);
+    ++arg_count;
+
+    args[arg_count].arg_adress = &_out_offset;
+    args[arg_count].arg_size = sizeof (_out_offset);
+    ++arg_count;
+
+    args[arg_count].arg_adress = &_out_pitch;
+    args[arg_count].arg_size = sizeof (_out_pitch);
+    ++arg_count;
+
+    args[arg_count].arg_adress = &_length;
+    args[arg_count].arg_size = sizeof (_length);
+    ++arg_count;
+
+    args[arg_count].arg_adress = &_lines;
+    args[arg_count].arg_size = sizeof (_lines);
+    ++arg_count;
+
+    args[arg_count].arg_adress = &_radius;
+    args[arg_count].arg_size = sizeof (_radius);
+    ++arg_count;
+
+    work_size.dim = 1;
+    work_size.local[0] = 64;
+    work_size.global[0] = XCAM_ALIGN_UP (_lines, work_size.local[0]);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+CLRetinexBoxImageKernel::post_execute (SmartPtr<DrmBoBuffer> &output)
+{
+    _buf_in.release ();
+    _buf_out.release ();
+
+    return CLImageKernel::post_execute (output);
+}
+
 CLRetinexImageKernel::CLRetinexImageKernel (SmartPtr<CLContext> &context, SmartPtr<CLRetinexImageHandler> &retinex)
     : CLImageKernel (context, "kernel_retinex"),
       _retinex (retinex)
@@ -107,22 +238,22 @@ CLRetinexImageKernel::prepare_arguments (
     cl_desc_in.width = video_info_in.width / 4; // 16;
     cl_desc_in.height = video_info_in.height;
     cl_desc_in.row_pitch = video_info_in.strides[0];
-    _image_in = new CLVaImage (context, input, cl_desc_in, video_info_in.offsets[0]);
+    _image_in = get_cached_va_image (context, input, cl_desc_in, video_info_in.offsets[0]);
 
     cl_desc_in.height = video_info_in.height / 2;
     cl_desc_in.row_pitch = video_info_in.strides[1];
-    _image_in_uv = new CLVaImage (context, input, cl_desc_in, video_info_in.offsets[1]);
+    _image_in_uv = get_cached_va_image (context, input, cl_desc_in, video_info_in.offsets[1]);
 
     cl_desc_out.format.image_channel_data_type = CL_UNORM_INT8; //CL_UNSIGNED_INT32;
     cl_desc_out.format.image_channel_order = CL_RGBA;
     cl_desc_out.width = video_info_out.width / 4; // 16;
     cl_desc_out.height = video_info_out.height;
     cl_desc_out.row_pitch = video_info_out.strides[0];
-    _image_out = new CLVaImage (context, output, cl_desc_out, video_info_out.offsets[0]);
+    _image_out = get_cached_va_image (context, output, cl_desc_out, video_info_out.offsets[0]);
 
     cl_desc_out.height = video_info_out.height / 2;
     cl_desc_out.row_pitch = video_info_out.strides[1];
-    _image_out_uv = new CLVaImage (context, output, cl_desc_out, video_info_out.offsets[1]);
+    _image_out_uv = get_cached_va_image (context, output, cl_desc_out, video_info_out.offsets[1]);
 
     XCAM_FAIL_RETURN (
         WARNING,
@@ -141,7 +272,7 @@ CLRetinexImageKernel::prepare_arguments (
         cl_desc_ga.width = video_info_gauss.width;
         cl_desc_ga.height = video_info_gauss.height;
         cl_desc_ga.row_pitch = video_info_gauss.strides[0];
-        _image_in_ga[i] = new CLVaImage (context, gaussian_buf, cl_desc_ga, video_info_gauss.offsets[0]);
+        _image_in_ga[i] = get_cached_va_image (context, gaussian_buf, cl_desc_ga, video_info_gauss.offsets[0]);
 
         XCAM_FAIL_RETURN (
             WARNING,
@@ -207,8 +338,9 @@ CLRetinexImageKernel::post_execute (SmartPtr<DrmBoBuffer> &output)
     return CLImageKernel::post_execute (output);
 }
 
-CLRetinexImageHandler::CLRetinexImageHandler (const char *name)
+CLRetinexImageHandler::CLRetinexImageHandler (const char *name, CLRetinexGaussType gauss_type)
     : CLImageHandler (name)
+    , _gauss_type (gauss_type)
     , _scaler_factor(XCAM_RETINEX_SCALER_FACTOR)
 {
 }
@@ -232,10 +364,33 @@ CLRetinexImageHandler::prepare_output_buf (SmartPtr<DrmBoBuffer> &input, SmartPt
         ret,
         "CLImageScalerKernel prepare scaled video buf failed");
 
+    if (_gauss_type == CL_RETINEX_GAUSS_BOX) {
+        const VideoBufferInfo &map_info = _scaler_buf1->get_video_info ();
+        SmartPtr<CLScratchArena> scratch = CLScratchArena::instance ();
+        for (uint32_t i = 0; i < 2; ++i) {
+            _box_buf[i] = scratch->get_buffer (map_info.width * map_info.height * sizeof (float));
+            XCAM_FAIL_RETURN (
+                WARNING,
+                _box_buf[i].ptr (),
+                XCAM_RETURN_ERROR_MEM,
+                "CLRetinexImageHandler get box filter buffer failed");
+        }
+    }
+
     return XCAM_RETURN_NO_ERROR;
 
 }
 
+// box filter buffers go back to the arena, handlers run next can reuse them
+XCamReturn
+CLRetinexImageHandler::execute_done (SmartPtr<DrmBoBuffer> &output)
+{
+    XCAM_UNUSED (output);
+    _box_buf[0].release ();
+    _box_buf[1].release ();
+    return XCAM_RETURN_NO_ERROR;
+}
+
 XCamReturn
 CLRetinexImageHandler::prepare_scaler_buf (const VideoBufferInfo &video_info)
 {
@@ -254,6 +409,7 @@ CLRetinexImageHandler::prepare_scaler_buf (const VideoBufferInfo &video_info)
         XCAM_ASSERT (display.ptr ());
         _scaler_buf_pool = new CLBoBufferPool (display, context);
         XCAM_ASSERT (_scaler_buf_pool.ptr ());
+        _scaler_buf_pool->set_name (XCAM_STR (get_name ()));
         _scaler_buf_pool->set_video_info (scaler_video_info);
         _scaler_buf_pool->reserve (XCAM_RETINEX_MAX_SCALE + 1);
 
@@ -340,6 +496,39 @@ create_kernel_retinex_gaussian (
     return kernel;
 }
 
+SmartPtr<CLRetinexBoxImageKernel>
+create_kernel_retinex_box (
+    SmartPtr<CLContext> &context,
+    SmartPtr<CLRetinexImageHandler> handler,
+    uint32_t index, uint32_t pass, uint32_t radius)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    SmartPtr<CLRetinexBoxImageKernel> kernel;
+
+    kernel = new CLRetinexBoxImageKernel (context, handler, index, pass, radius);
+    {
+        char build_options[1024];
+        xcam_mem_clear (build_options);
+        snprintf (
+            build_options, sizeof (build_options), "%s%s",
+            (pass == 0 ? " -DBOX_INPUT_U8 " : ""),
+            (pass == CLRetinexBoxImageKernel::get_pass_count () - 1 ? " -DBOX_OUTPUT_U8 " : ""));
+
+        XCAM_CL_KERNEL_FUNC_SOURCE_BEGIN(kernel_retinex_box)
+#include "kernel_retinex_box.clx"
+        XCAM_CL_KERNEL_FUNC_END;
+        ret = kernel->load_from_source (
+                  kernel_retinex_box_body, strlen (kernel_retinex_box_body),
+                  NULL, NULL, build_options);
+        XCAM_FAIL_RETURN (
+            WARNING,
+            ret == XCAM_RETURN_NO_ERROR,
+            NULL,
+            "CL image handler(%s) load source failed", kernel->get_kernel_name());
+    }
+    return kernel;
+}
+
 SmartPtr<CLRetinexImageKernel>
 create_kernel_retinex (SmartPtr<CLContext> &context, SmartPtr<CLRetinexImageHandler> handler)
 {
@@ -366,14 +555,14 @@ create_kernel_retinex (SmartPtr<CLContext> &context, SmartPtr<CLRetinexImageHand
 }
 
 SmartPtr<CLImageHandler>
-create_cl_retinex_image_handler (SmartPtr<CLContext> &context)
+create_cl_retinex_image_handler (SmartPtr<CLContext> &context, CLRetinexGaussType gauss_type)
 {
     SmartPtr<CLRetinexImageHandler> retinex_handler;
 
     SmartPtr<CLRetinexScalerImageKernel> retinex_scaler_kernel;
     SmartPtr<CLRetinexImageKernel> retinex_kernel;
 
-    retinex_handler = new CLRetinexImageHandler ("cl_handler_retinex");
+    retinex_handler = new CLRetinexImageHandler ("cl_handler_retinex", gauss_type);
     retinex_scaler_kernel = create_kernel_retinex_scaler (context, retinex_handler);
     XCAM_FAIL_RETURN (
         ERROR,
@@ -382,7 +571,7 @@ create_cl_retinex_image_handler (SmartPtr<CLContext> &context)
         "Retinex handler create scaler kernel failed");
     retinex_handler->set_retinex_scaler_kernel (retinex_scaler_kernel);
 
-    for (uint32_t i = 0; i < XCAM_RETINEX_MAX_SCALE; ++i) {
+    for (uint32_t i = 0; i < XCAM_RETINEX_MAX_SCALE && gauss_type == CL_RETINEX_GAUSS_TABLE; ++i) {
         SmartPtr<CLImageKernel> retinex_gauss_kernel;
         retinex_gauss_kernel = create_kernel_retinex_gaussian (
                                    context, retinex_handler, i, retinex_gauss_scale [i], retinex_gauss_sigma [i]);
@@ -394,6 +583,25 @@ create_cl_retinex_image_handler (SmartPtr<CLContext> &context)
         retinex_handler->add_kernel (retinex_gauss_kernel);
     }
 
+    for (uint32_t i = 0; i < XCAM_RETINEX_MAX_SCALE && gauss_type == CL_RETINEX_GAUSS_BOX; ++i) {
+        float prev_sigma = i ? retinex_box_sigma [i - 1] : 0.0f;
+        uint32_t radii[XCAM_RETINEX_BOX_PASSES];
+        box_gauss_radii (
+            sqrtf (retinex_box_sigma [i] * retinex_box_sigma [i] - prev_sigma * prev_sigma),
+            XCAM_RETINEX_BOX_PASSES, radii);
+
+        for (uint32_t pass = 0; pass < CLRetinexBoxImageKernel::get_pass_count (); ++pass) {
+            SmartPtr<CLImageKernel> retinex_box_kernel;
+            retinex_box_kernel = create_kernel_retinex_box (context, retinex_handler, i, pass, radii[pass / 2]);
+            XCAM_FAIL_RETURN (
+                ERROR,
+                retinex_box_kernel.ptr () && retinex_box_kernel->is_valid (),
+                NULL,
+                "Retinex handler create box filter kernel failed");
+            retinex_handler->add_kernel (retinex_box_kernel);
+        }
+    }
+
     retinex_kernel = create_kernel_retinex (context, retinex_handler);
     XCAM_FAIL_RETURN (
         ERROR,
@@ -31,9 +31,18 @@
 
 #define XCAM_RETINEX_MAX_SCALE 2
 #define XCAM_RETINEX_SCALER_FACTOR 0.5
+// box filters stacked per gaussian in CL_RETINEX_GAUSS_BOX
+#define XCAM_RETINEX_BOX_PASSES 3
 
 namespace XCam {
 
+enum CLRetinexGaussType {
+    // 2D gaussian table, cost per pixel grows with radius squared
+    CL_RETINEX_GAUSS_TABLE = 0,
+    // stacked box filters, cost per pixel independent of sigma
+    CL_RETINEX_GAUSS_BOX,
+};
+
 typedef struct {
     float           gain;
     float           threshold;
@@ -87,6 +96,52 @@ private:
 
 };
 
+/*
+ * one row or column pass of a box filter on the reduced luma, passes of
+ * a scale alternate between rows and columns through two float scratch
+ * buffers. scale i starts from the gaussian of scale i - 1 and adds the
+ * remaining sqrt (sigma_i^2 - sigma_(i-1)^2), so bigger scales reuse
+ * the passes of smaller ones.
+ */
+class CLRetinexBoxImageKernel
+    : public CLImageKernel
+{
+public:
+    explicit CLRetinexBoxImageKernel (
+        SmartPtr<CLContext> &context,
+        SmartPtr<CLRetinexImageHandler> &retinex,
+        uint32_t index, uint32_t pass, uint32_t radius);
+
+    static uint32_t get_pass_count () {
+        return XCAM_RETINEX_BOX_PASSES * 2;
+    }
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output,
+        CLArgument args[], uint32_t &arg_count,
+        CLWorkSize &work_size);
+
+    virtual XCamReturn post_execute (SmartPtr<DrmBoBuffer> &output);
+
+private:
+    XCAM_DEAD_COPY (CLRetinexBoxImageKernel);
+
+    SmartPtr<CLRetinexImageHandler> _retinex;
+    uint32_t                        _index;
+    uint32_t                        _pass;
+    uint32_t                        _radius;
+
+    SmartPtr<CLBuffer>              _buf_in;
+    SmartPtr<CLBuffer>              _buf_out;
+    uint32_t                        _in_offset;
+    uint32_t                        _in_pitch;
+    uint32_t                        _out_offset;
+    uint32_t                        _out_pitch;
+    uint32_t                        _length;
+    uint32_t                        _lines;
+};
+
 class CLRetinexImageKernel
     : public CLImageKernel
 {
@@ -115,7 +170,7 @@ class CLRetinexImageHandler
     : public CLImageHandler
 {
 public:
-    explicit CLRetinexImageHandler (const char *name);
+    explicit CLRetinexImageHandler (const char *name, CLRetinexGaussType gauss_type = CL_RETINEX_GAUSS_TABLE);
     bool set_retinex_kernel(SmartPtr<CLRetinexImageKernel> &kernel);
     bool set_retinex_scaler_kernel(SmartPtr<CLRetinexScalerImageKernel> &kernel);
     //bool set_retinex_gauss_kernel(SmartPtr<CLRetinexGaussImageKernel> &kernel);
@@ -126,11 +181,17 @@ public:
         XCAM_ASSERT (index < XCAM_RETINEX_MAX_SCALE);
         return _gaussian_buf[index];
     };
+    // float ping-pong buffers of CL_RETINEX_GAUSS_BOX passes
+    SmartPtr<CLBuffer> &get_box_buf (uint32_t index) {
+        XCAM_ASSERT (index < 2);
+        return _box_buf[index];
+    };
 
     void pre_stop ();
 
 protected:
     virtual XCamReturn prepare_output_buf (SmartPtr<DrmBoBuffer> &input, SmartPtr<DrmBoBuffer> &output);
+    virtual XCamReturn execute_done (SmartPtr<DrmBoBuffer> &output);
     XCamReturn prepare_scaler_buf (const VideoBufferInfo &video_info);
 
 private:
@@ -139,15 +200,18 @@ private:
     SmartPtr<CLRetinexScalerImageKernel>  _retinex_scaler_kernel;
     //SmartPtr<CLRetinexGaussImageKernel>   _retinex_gauss_kernel;
 
+    CLRetinexGaussType                    _gauss_type;
     double                                _scaler_factor;
     SmartPtr<DrmBoBufferPool>             _scaler_buf_pool;
     SmartPtr<DrmBoBuffer>                 _scaler_buf1;
     SmartPtr<DrmBoBuffer>                 _gaussian_buf[XCAM_RETINEX_MAX_SCALE];
+    SmartPtr<CLBuffer>                    _box_buf[2];
 
 };
 
 SmartPtr<CLImageHandler>
-create_cl_retinex_image_handler (SmartPtr<CLContext> &context);
+create_cl_retinex_image_handler (
+    SmartPtr<CLContext> &context, CLRetinexGaussType gauss_type = CL_RETINEX_GAUSS_TABLE);
 
 };
 
@@ -55,8 +55,8 @@ CLRgbPipeImageKernel::prepare_arguments (
     SmartPtr<CLContext> context = get_context ();
     const VideoBufferInfo & video_info = input->get_video_info ();
 
-    _image_in = new CLVaImage (context, input);
-    _image_out = new CLVaImage (context, output);
+    _image_in = get_cached_va_image (context, input);
+    _image_out = get_cached_va_image (context, output);
 
     if (_image_in_list.size () < 4) {
         while (_image_in_list.size () < 4) {
@@ -0,0 +1,341 @@
+/*
+ * cl_scratch_arena.cpp - CL scratch memory arena
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "cl_scratch_arena.h"
+#include "cl_device.h"
+#include "cl_context.h"
+
+namespace XCam {
+
+SmartPtr<CLScratchArena> CLScratchArena::_instance;
+Mutex CLScratchArena::_instance_mutex;
+
+CLScratchImage::CLScratchImage (
+    SmartPtr<CLContext> &context,
+    const SmartPtr<CLImage> &backing,
+    const SmartPtr<CLScratchArena> &arena)
+    : CLImage (context)
+    , _backing (backing)
+    , _arena (arena)
+{
+    XCAM_ASSERT (backing.ptr () && backing->is_valid ());
+    set_mem_id (_backing->get_mem_id (), false);
+    init_desc_by_image ();
+}
+
+CLScratchImage::~CLScratchImage ()
+{
+    _arena->recycle_image (_backing);
+}
+
+CLScratchBuffer::CLScratchBuffer (
+    SmartPtr<CLContext> &context,
+    const SmartPtr<CLBuffer> &backing,
+    uint32_t size,
+    const SmartPtr<CLScratchArena> &arena)
+    : CLBuffer (context)
+    , _backing (backing)
+    , _size (size)
+    , _arena (arena)
+{
+    XCAM_ASSERT (backing.ptr () && backing->is_valid ());
+    set_mem_id (_backing->get_mem_id (), false);
+}
+
+CLScratchBuffer::~CLScratchBuffer ()
+{
+    _arena->recycle_buffer (_backing, _size);
+}
+
+SmartPtr<CLScratchArena>
+CLScratchArena::instance ()
+{
+    SmartLock locker (_instance_mutex);
+    if (_instance.ptr ())
+        return _instance;
+
+    _instance = new CLScratchArena ();
+    return _instance;
+}
+
+CLScratchArena::CLScratchArena ()
+    : _memory_limit (0)
+    , _in_use_bytes (0)
+    , _idle_bytes (0)
+    , _peak_bytes (0)
+{
+    _context = CLDevice::instance ()->get_context ();
+    XCAM_ASSERT (_context.ptr ());
+
+    _metrics = MetricsRegistry::instance ()->register_group ("cl_scratch", "arena");
+    _in_use_gauge = _metrics->get_gauge ("in_use_bytes");
+    _idle_gauge = _metrics->get_gauge ("idle_bytes");
+    _total_gauge = _metrics->get_gauge ("total_bytes");
+    _hit_counter = _metrics->get_counter ("hits");
+    _miss_counter = _metrics->get_counter ("misses");
+    _evict_counter = _metrics->get_counter ("evictions");
+}
+
+CLScratchArena::~CLScratchArena ()
+{
+    XCAM_LOG_DEBUG (
+        "cl scratch arena peak %" PRIu64 " bytes, %" PRIu64 " bytes still in use",
+        _peak_bytes, _in_use_bytes);
+    _idle.clear ();
+    MetricsRegistry::instance ()->unregister_group (_metrics);
+}
+
+SmartPtr<CLImage>
+CLScratchArena::get_image (const CLImageDesc &desc)
+{
+    Entry key;
+    key.is_image = true;
+    key.format = desc.format;
+    key.width = desc.width;
+    key.height = desc.height;
+    key.size = CLImage::calculate_pixel_bytes (desc.format) * desc.width * desc.height;
+
+    SmartPtr<CLImage> backing = acquire (key).dynamic_cast_ptr<CLImage> ();
+    if (!backing.ptr ())
+        return NULL;
+    return new CLScratchImage (_context, backing, _instance);
+}
+
+SmartPtr<CLBuffer>
+CLScratchArena::get_buffer (uint32_t size)
+{
+    Entry key;
+    key.is_image = false;
+    key.format.image_channel_order = 0;
+    key.format.image_channel_data_type = 0;
+    key.width = 0;
+    key.height = 0;
+    key.size = size;
+
+    SmartPtr<CLBuffer> backing = acquire (key).dynamic_cast_ptr<CLBuffer> ();
+    if (!backing.ptr ())
+        return NULL;
+    return new CLScratchBuffer (_context, backing, size, _instance);
+}
+
+SmartPtr<CLImage>
+CLScratchArena::get_buffer_image (const CLImageDesc &desc)
+{
+    CLImageDesc buf_desc = desc;
+    if (!buf_desc.row_pitch)
+        buf_desc.row_pitch = CLImage::calculate_pixel_bytes (desc.format) * desc.width;
+
+    SmartPtr<CLBuffer> buffer = get_buffer (buf_desc.row_pitch * buf_desc.height);
+    XCAM_FAIL_RETURN (
+        WARNING,
+        buffer.ptr (),
+        NULL,
+        "cl scratch arena get buffer of image(%dx%d) failed", desc.width, desc.height);
+
+    SmartPtr<CLImage> image = new CLImage2D (_context, buf_desc, CL_MEM_READ_WRITE, buffer);
+    XCAM_FAIL_RETURN (
+        WARNING,
+        image->is_valid (),
+        NULL,
+        "cl scratch arena create image(%dx%d) on buffer failed", desc.width, desc.height);
+    return image;
+}
+
+SmartPtr<CLMemory>
+CLScratchArena::acquire (const Entry &key)
+{
+    {
+        SmartLock lock (_mutex);
+        for (EntryList::iterator i = _idle.begin (); i != _idle.end (); ++i) {
+            if (i->is_image != key.is_image || i->width != key.width || i->height != key.height ||
+                    i->format.image_channel_order != key.format.image_channel_order ||
+                    i->format.image_channel_data_type != key.format.image_channel_data_type ||
+                    (!key.is_image && i->size != key.size))
+                continue;
+
+            SmartPtr<CLMemory> memory = i->memory;
+            _idle_bytes -= i->size;
+            _in_use_bytes += i->size;
+            _idle.erase (i);
+            update_metrics_unsafe ();
+            if (MetricsRegistry::is_enabled ())
+                _hit_counter->add ();
+            return memory;
+        }
+        evict_unsafe (key.size);
+    }
+
+    // allocated out of the lock
+    SmartPtr<CLMemory> memory;
+    uint64_t bytes = key.size;
+    if (key.is_image) {
+        CLImageDesc desc;
+        desc.format = key.format;
+        desc.width = key.width;
+        desc.height = key.height;
+        SmartPtr<CLImage> image = new CLImage2D (_context, desc);
+        if (image->is_valid () && image->get_image_desc ().size)
+            bytes = image->get_image_desc ().size;
+        memory = image;
+    } else {
+        memory = new CLBuffer (_context, key.size);
+    }
+    XCAM_FAIL_RETURN (
+        WARNING,
+        memory->is_valid (),
+        NULL,
+        "cl scratch arena allocate %s of %d bytes failed",
+        (key.is_image ? "image" : "buffer"), key.size);
+
+    SmartLock lock (_mutex);
+    _in_use_bytes += bytes;
+    update_metrics_unsafe ();
+    if (MetricsRegistry::is_enabled ())
+        _miss_counter->add ();
+    return memory;
+}
+
+void
+CLScratchArena::recycle_image (const SmartPtr<CLImage> &image)
+{
+    const CLImageDesc &desc = image->get_image_desc ();
+    Entry entry;
+    entry.is_image = true;
+    entry.format = desc.format;
+    entry.width = desc.width;
+    entry.height = desc.height;
+    entry.size = desc.size ? desc.size : CLImage::calculate_pixel_bytes (desc.format) * desc.width * desc.height;
+    entry.memory = image;
+    recycle (entry);
+}
+
+void
+CLScratchArena::recycle_buffer (const SmartPtr<CLBuffer> &buffer, uint32_t size)
+{
+    Entry entry;
+    entry.is_image = false;
+    entry.format.image_channel_order = 0;
+    entry.format.image_channel_data_type = 0;
+    entry.width = 0;
+    entry.height = 0;
+    entry.size = size;
+    entry.memory = buffer;
+    recycle (entry);
+}
+
+void
+CLScratchArena::recycle (const Entry &entry)
+{
+    SmartPtr<CLMemory> dropped;
+    {
+        SmartLock lock (_mutex);
+        XCAM_ASSERT (_in_use_bytes >= entry.size);
+        _in_use_bytes -= entry.size;
+
+        if (_memory_limit && _in_use_bytes + _idle_bytes + entry.size > _memory_limit) {
+            dropped = entry.memory;
+            if (MetricsRegistry::is_enabled ())
+                _evict_counter->add ();
+        } else {
+            _idle.push_front (entry);
+            _idle_bytes += entry.size;
+        }
+        update_metrics_unsafe ();
+    }
+    // cl_mem released out of the lock
+    dropped.release ();
+}
+
+void
+CLScratchArena::evict_unsafe (uint64_t incoming)
+{
+    if (!_memory_limit)
+        return;
+
+    while (!_idle.empty () && _in_use_bytes + _idle_bytes + incoming > _memory_limit) {
+        _idle_bytes -= _idle.back ().size;
+        _idle.pop_back ();
+        if (MetricsRegistry::is_enabled ())
+            _evict_counter->add ();
+    }
+    if (_in_use_bytes + _idle_bytes + incoming > _memory_limit) {
+        XCAM_LOG_DEBUG (
+            "cl scratch arena goes over limit %" PRIu64 " bytes, %" PRIu64 " bytes in use",
+            _memory_limit, _in_use_bytes);
+    }
+}
+
+void
+CLScratchArena::set_memory_limit (uint64_t bytes)
+{
+    SmartLock lock (_mutex);
+    _memory_limit = bytes;
+    evict_unsafe (0);
+    update_metrics_unsafe ();
+}
+
+void
+CLScratchArena::trim ()
+{
+    EntryList idle;
+    {
+        SmartLock lock (_mutex);
+        idle.swap (_idle);
+        _idle_bytes = 0;
+        update_metrics_unsafe ();
+    }
+}
+
+uint64_t
+CLScratchArena::get_in_use_bytes ()
+{
+    SmartLock lock (_mutex);
+    return _in_use_bytes;
+}
+
+uint64_t
+CLScratchArena::get_idle_bytes ()
+{
+    SmartLock lock (_mutex);
+    return _idle_bytes;
+}
+
+uint64_t
+CLScratchArena::get_peak_bytes ()
+{
+    SmartLock lock (_mutex);
+    return _peak_bytes;
+}
+
+void
+CLScratchArena::update_metrics_unsafe ()
+{
+    uint64_t total = _in_use_bytes + _idle_bytes;
+    if (total > _peak_bytes)
+        _peak_bytes = total;
+
+    if (!MetricsRegistry::is_enabled ())
+        return;
+    _in_use_gauge->set (_in_use_bytes);
+    _idle_gauge->set (_idle_bytes);
+    _total_gauge->set (total);
+}
+
+};
@@ -0,0 +1,159 @@
+/*
+ * cl_scratch_arena.h - CL scratch memory arena
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_CL_SCRATCH_ARENA_H
+#define XCAM_CL_SCRATCH_ARENA_H
+
+#include "xcam_utils.h"
+#include "xcam_mutex.h"
+#include "xcam_metrics.h"
+#include "cl_memory.h"
+#include <list>
+
+namespace XCam {
+
+class CLScratchArena;
+
+/*
+ * image or buffer handed out by CLScratchArena, shares the cl_mem of a
+ * pooled object which goes back to the arena when this one is released.
+ */
+class CLScratchImage
+    : public CLImage
+{
+public:
+    explicit CLScratchImage (
+        SmartPtr<CLContext> &context,
+        const SmartPtr<CLImage> &backing,
+        const SmartPtr<CLScratchArena> &arena);
+    ~CLScratchImage ();
+
+private:
+    XCAM_DEAD_COPY (CLScratchImage);
+
+private:
+    SmartPtr<CLImage>          _backing;
+    SmartPtr<CLScratchArena>   _arena;
+};
+
+class CLScratchBuffer
+    : public CLBuffer
+{
+public:
+    explicit CLScratchBuffer (
+        SmartPtr<CLContext> &context,
+        const SmartPtr<CLBuffer> &backing,
+        uint32_t size,
+        const SmartPtr<CLScratchArena> &arena);
+    ~CLScratchBuffer ();
+
+private:
+    XCAM_DEAD_COPY (CLScratchBuffer);
+
+private:
+    SmartPtr<CLBuffer>         _backing;
+    uint32_t                   _size;
+    SmartPtr<CLScratchArena>   _arena;
+};
+
+/*
+ * scratch images and buffers of the default context, recycled by
+ * descriptor across handlers. all kernels go to the default in-order
+ * queue, so memory released after its last enqueue can be handed to
+ * the next user right away.
+ *
+ * with a memory limit, idle memory of other descriptors is freed, least
+ * recently used first, before allocating beyond the limit, and released
+ * memory is freed instead of pooled while over the limit.
+ * bytes in use, idle and total with high-water marks are kept in
+ * metrics group "cl_scratch/arena".
+ */
+class CLScratchArena
+{
+    friend class CLScratchImage;
+    friend class CLScratchBuffer;
+
+public:
+    static SmartPtr<CLScratchArena> instance ();
+    ~CLScratchArena ();
+
+    // desc.row_pitch is ignored, the image owns its memory
+    SmartPtr<CLImage> get_image (const CLImageDesc &desc);
+    SmartPtr<CLBuffer> get_buffer (uint32_t size);
+    // 2D image on a scratch buffer, row pitch from desc or packed
+    SmartPtr<CLImage> get_buffer_image (const CLImageDesc &desc);
+
+    // 0, default, means no limit
+    void set_memory_limit (uint64_t bytes);
+    // frees all idle memory
+    void trim ();
+
+    uint64_t get_in_use_bytes ();
+    uint64_t get_idle_bytes ();
+    // high-water mark of in use plus idle
+    uint64_t get_peak_bytes ();
+
+private:
+    struct Entry {
+        bool                  is_image;
+        cl_image_format       format;
+        uint32_t              width;
+        uint32_t              height;
+        uint32_t              size;   // requested size of buffers, bytes of images
+        SmartPtr<CLMemory>    memory;
+    };
+    typedef std::list<Entry> EntryList;
+
+    explicit CLScratchArena ();
+
+    SmartPtr<CLMemory> acquire (const Entry &key);
+    void recycle_image (const SmartPtr<CLImage> &image);
+    void recycle_buffer (const SmartPtr<CLBuffer> &buffer, uint32_t size);
+    void recycle (const Entry &entry);
+    void evict_unsafe (uint64_t incoming);
+    void update_metrics_unsafe ();
+
+    XCAM_DEAD_COPY (CLScratchArena);
+
+private:
+    static SmartPtr<CLScratchArena>  _instance;
+    static Mutex                     _instance_mutex;
+
+    SmartPtr<CLContext>        _context;
+    Mutex                      _mutex;
+    // most recently released at front
+    EntryList                  _idle;
+    uint64_t                   _memory_limit;
+    uint64_t                   _in_use_bytes;
+    uint64_t                   _idle_bytes;
+    uint64_t                   _peak_bytes;
+
+    SmartPtr<MetricsGroup>     _metrics;
+    SmartPtr<MetricGauge>      _in_use_gauge;
+    SmartPtr<MetricGauge>      _idle_gauge;
+    SmartPtr<MetricGauge>      _total_gauge;
+    SmartPtr<MetricCounter>    _hit_counter;
+    SmartPtr<MetricCounter>    _miss_counter;
+    SmartPtr<MetricCounter>    _evict_counter;
+};
+
+};
+
+#endif //XCAM_CL_SCRATCH_ARENA_H
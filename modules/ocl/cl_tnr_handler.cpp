@@ -97,7 +97,7 @@ CLTnrImageKernel::prepare_arguments (
     const VideoBufferInfo & video_info = input->get_video_info ();
     memset(_motion_info, 0, TNR_GRID_HOR_COUNT * TNR_GRID_VER_COUNT * sizeof(CLTnrMotionInfo));
 
-    _image_in = new CLVaImage (context, input);
+    _image_in = get_cached_va_image (context, input);
     if (CL_TNR_TYPE_RGB == _type) {
         // analyze motion between the latest adjacent two frames
         // Todo: enable analyze when utilize motion compensation next step
@@ -112,7 +112,7 @@ CLTnrImageKernel::prepare_arguments (
         }
     }
 
-    _image_out = new CLVaImage (context, output);
+    _image_out = get_cached_va_image (context, output);
 
     if (CL_TNR_TYPE_YUV == _type) {
         if (!_image_out_prev.ptr ()) {
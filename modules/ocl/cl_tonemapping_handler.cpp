@@ -53,8 +53,8 @@ CLTonemappingImageKernel::prepare_arguments (
 {
     SmartPtr<CLContext> context = get_context ();
 
-    _image_in = new CLVaImage (context, input);
-    _image_out = new CLVaImage (context, output);
+    _image_in = get_cached_va_image (context, input);
+    _image_out = get_cached_va_image (context, output);
 
     const VideoBufferInfo & in_video_info = input->get_video_info ();
     _image_height = in_video_info.aligned_height;
@@ -57,8 +57,8 @@ CLWaveletDenoiseImageKernel::prepare_arguments (
     const VideoBufferInfo & video_info_in = input->get_video_info ();
     const VideoBufferInfo & video_info_out = output->get_video_info ();
 
-    _input_image = new CLVaBuffer (context, input);
-    _reconstruct_image = new CLVaBuffer (context, output);
+    _input_image = get_cached_va_buffer (context, input);
+    _reconstruct_image = get_cached_va_buffer (context, output);
 
     _details_image = _handler->get_details_image ();
     _approx_image = _handler->get_approx_image ();
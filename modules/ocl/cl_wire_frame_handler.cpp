@@ -146,11 +146,11 @@ CLWireFrameImageKernel::prepare_arguments (
     cl_desc_out.width = video_info_out.width / 2;
     cl_desc_out.height = video_info_out.height;
     cl_desc_out.row_pitch = video_info_out.strides [0];
-    _image_out = new CLVaImage (context, output, cl_desc_out, video_info_out.offsets [0]);
+    _image_out = get_cached_va_image (context, output, cl_desc_out, video_info_out.offsets [0]);
 
     cl_desc_out.height = video_info_out.height / 2;
     cl_desc_out.row_pitch = video_info_out.strides [1];
-    _image_out_uv = new CLVaImage (context, output, cl_desc_out, video_info_out.offsets [1]);
+    _image_out_uv = get_cached_va_image (context, output, cl_desc_out, video_info_out.offsets [1]);
 
     XCAM_FAIL_RETURN (
         WARNING,
@@ -109,15 +109,15 @@ CLYuvPipeImageKernel::prepare_arguments (
     out_image_info.height = video_info_out.aligned_height;
     out_image_info.row_pitch = video_info_out.strides[0];
 
-    _buffer_in = new CLVaImage (context, input, in_image_info);
-    _buffer_out = new CLVaImage (context, output, out_image_info, video_info_out.offsets[0]);
+    _buffer_in = get_cached_va_image (context, input, in_image_info);
+    _buffer_out = get_cached_va_image (context, output, out_image_info, video_info_out.offsets[0]);
 
     out_image_info.height = video_info_out.aligned_height / 2;
     out_image_info.row_pitch = video_info_out.strides[1];
-    _buffer_out_UV = new CLVaImage (context, output, out_image_info, video_info_out.offsets[1]);
+    _buffer_out_UV = get_cached_va_image (context, output, out_image_info, video_info_out.offsets[1]);
 #else
-    _buffer_in = new CLVaBuffer (context, input);
-    _buffer_out = new CLVaBuffer (context, output);
+    _buffer_in = get_cached_va_buffer (context, input);
+    _buffer_out = get_cached_va_buffer (context, output);
 #endif
     _matrix_buffer = new CLBuffer (
         context, sizeof(float)*XCAM_COLOR_MATRIX_SIZE,
@@ -54,7 +54,7 @@ init_opencv_ocl (SmartPtr<CLContext> context)
 bool
 convert_to_mat (SmartPtr<CLContext> context, SmartPtr<DrmBoBuffer> buffer, cv::Mat &image)
 {
-    SmartPtr<CLBuffer> cl_buffer = new CLVaBuffer (context, buffer);
+    SmartPtr<CLBuffer> cl_buffer = get_cached_va_buffer (context, buffer);
     VideoBufferInfo info = buffer->get_video_info ();
     cl_mem cl_mem_id = cl_buffer->get_mem_id ();
 
@@ -79,7 +79,7 @@ convert_to_mat (SmartPtr<CLContext> context, SmartPtr<DrmBoBuffer> buffer, cv::M
 bool
 convert_to_umat (SmartPtr<CLContext> context, SmartPtr<DrmBoBuffer> buffer, cv::UMat &image)
 {
-    SmartPtr<CLBuffer> cl_buffer = new CLVaBuffer (context, buffer);
+    SmartPtr<CLBuffer> cl_buffer = get_cached_va_buffer (context, buffer);
     VideoBufferInfo info = buffer->get_video_info ();
     cl_mem cl_mem_id = cl_buffer->get_mem_id ();
 
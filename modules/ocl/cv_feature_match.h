@@ -25,6 +25,7 @@
 #include <base/xcam_common.h>
 #include <base/xcam_buffer.h>
 #include <dma_video_buffer.h>
+#include <drm_bo_buffer.h>
 #include <smartptr.h>
 
 #include <cl_context.h>
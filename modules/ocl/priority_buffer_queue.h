@@ -29,9 +29,11 @@
 namespace XCam {
 
 struct PriorityBuffer
+    : public RefObj
 {
     SmartPtr<DrmBoBuffer>     data;
     SmartPtr<CLImageHandler>  handler;
+    SmartPtr<CLEvent>         event;  // last CL work enqueued on data
     uint32_t                  rank;
     uint32_t                  seq_num;
 
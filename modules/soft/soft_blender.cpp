@@ -0,0 +1,323 @@
+/*
+ * soft_blender.cpp - CPU blender
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_blender.h"
+
+namespace XCam {
+
+SoftBlender::SoftBlender (const char *name)
+    : SoftImageHandler (name)
+    , _output_width (0)
+    , _output_height (0)
+    , _swap_input_index (false)
+{
+}
+
+SoftBlender::~SoftBlender ()
+{
+}
+
+bool
+SoftBlender::set_merge_window (const Rect &window)
+{
+    _merge_window = window;
+    _merge_window.pos_x = XCAM_ALIGN_AROUND (_merge_window.pos_x, XCAM_SOFT_BLENDER_ALIGNED_WIDTH);
+    _merge_window.width = XCAM_ALIGN_AROUND (_merge_window.width, XCAM_SOFT_BLENDER_ALIGNED_WIDTH);
+    XCAM_FAIL_RETURN (
+        WARNING, _merge_window.width >= XCAM_SOFT_BLENDER_ALIGNED_WIDTH, false,
+        "SoftBlender(%s) merge window width(%d) is too small", get_name (), window.width);
+
+    XCAM_LOG_DEBUG (
+        "SoftBlender(%s) merge window:(x:%d, width:%d), blend_width:%d",
+        get_name (), _merge_window.pos_x, _merge_window.width, _output_width);
+    return true;
+}
+
+bool
+SoftBlender::set_input_valid_area (const Rect &area, uint32_t index)
+{
+    XCAM_ASSERT (index < XCAM_SOFT_BLENDER_IMAGE_NUM);
+    _input_valid_area[index] = area;
+    _input_valid_area[index].pos_x = XCAM_ALIGN_DOWN (area.pos_x, XCAM_SOFT_BLENDER_ALIGNED_WIDTH);
+    _input_valid_area[index].width = XCAM_ALIGN_UP (area.width, XCAM_SOFT_BLENDER_ALIGNED_WIDTH);
+
+    XCAM_LOG_DEBUG (
+        "SoftBlender(%s) buf(%d) valid area:(x:%d, width:%d)",
+        get_name (), index, _input_valid_area[index].pos_x, _input_valid_area[index].width);
+    return true;
+}
+
+bool
+SoftBlender::set_input_merge_area (const Rect &area, uint32_t index)
+{
+    XCAM_ASSERT (index < XCAM_SOFT_BLENDER_IMAGE_NUM);
+    XCAM_FAIL_RETURN (
+        WARNING, is_merge_window_set (), false,
+        "SoftBlender(%s) set_input_merge_area(idx:%d) failed, need set merge window first",
+        get_name (), index);
+
+    _input_merge_area[index] = area;
+    _input_merge_area[index].pos_x = XCAM_ALIGN_AROUND (area.pos_x, XCAM_SOFT_BLENDER_ALIGNED_WIDTH);
+    _input_merge_area[index].width = _merge_window.width;
+
+    XCAM_LOG_DEBUG (
+        "SoftBlender(%s) buf(%d) merge area:(x:%d, width:%d)",
+        get_name (), index, _input_merge_area[index].pos_x, _input_merge_area[index].width);
+    return true;
+}
+
+XCamReturn
+SoftBlender::prepare_buffer_pool_video_info (
+    const VideoBufferInfo &input,
+    VideoBufferInfo &output)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, input.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "SoftBlender(%s) input buffer format(%s) is not supported, try NV12",
+        get_name (), xcam_fourcc_to_string (input.format));
+    XCAM_FAIL_RETURN (
+        WARNING, _output_width && !(_output_width % 2), XCAM_RETURN_ERROR_PARAM,
+        "SoftBlender(%s) output width(%d) should be even and > 0", get_name (), _output_width);
+
+    output.init (
+        input.format, _output_width, input.height,
+        XCAM_ALIGN_UP (_output_width, 16), XCAM_ALIGN_UP (input.height, 16));
+    return XCAM_RETURN_NO_ERROR;
+}
+
+bool
+SoftBlender::calculate_merge_window (
+    uint32_t width0, uint32_t width1, uint32_t blend_width,
+    Rect &out_window)
+{
+    out_window.pos_x = blend_width - width1;
+    out_window.width = (width0 + width1 - blend_width) / 2;
+
+    out_window.pos_x = XCAM_ALIGN_AROUND (out_window.pos_x, XCAM_SOFT_BLENDER_ALIGNED_WIDTH);
+    out_window.width = XCAM_ALIGN_AROUND (out_window.width, XCAM_SOFT_BLENDER_ALIGNED_WIDTH);
+    if ((int)blend_width < out_window.pos_x + out_window.width)
+        out_window.width = blend_width - out_window.pos_x;
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        out_window.width > 0 && out_window.pos_x >= 0 && out_window.pos_x <= (int)blend_width,
+        false,
+        "SoftBlender(%s) inputs(%d, %d) do not overlap in output width(%d)",
+        get_name (), width0, width1, blend_width);
+    return true;
+}
+
+XCamReturn
+SoftBlender::prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    XCAM_ASSERT (input.ptr () && output.ptr ());
+    SmartPtr<VideoBuffer> input0, input1;
+
+    SmartPtr<VideoBuffer> next;
+    SmartPtr<BufferProxy> proxy = input.dynamic_cast_ptr<BufferProxy> ();
+    if (proxy.ptr ())
+        next = proxy->find_typed_attach<VideoBuffer> ();
+    XCAM_FAIL_RETURN (
+        WARNING, next.ptr (), XCAM_RETURN_ERROR_PARAM,
+        "SoftBlender(%s) does NOT find second buffer in attachment", get_name ());
+
+    if (_swap_input_index) {
+        input0 = next;
+        input1 = input;
+    } else {
+        input0 = input;
+        input1 = next;
+    }
+
+    const VideoBufferInfo &in0_info = input0->get_video_info ();
+    const VideoBufferInfo &in1_info = input1->get_video_info ();
+    const VideoBufferInfo &out_info = output->get_video_info ();
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in1_info.format == in0_info.format && in0_info.height == out_info.height &&
+        in1_info.height == out_info.height,
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftBlender(%s) inputs(%s %dx%d, %s %dx%d) do not match output height(%d)",
+        get_name (),
+        xcam_fourcc_to_string (in0_info.format), in0_info.width, in0_info.height,
+        xcam_fourcc_to_string (in1_info.format), in1_info.width, in1_info.height,
+        out_info.height);
+
+    if (!_input_valid_area[0].width) {
+        Rect area;
+        area.width = in0_info.width;
+        area.height = in0_info.height;
+        set_input_valid_area (area, 0);
+    }
+    if (!_input_valid_area[1].width) {
+        Rect area;
+        area.width = in1_info.width;
+        area.height = in1_info.height;
+        set_input_valid_area (area, 1);
+    }
+
+    if (!is_merge_window_set ()) {
+        Rect merge_window;
+        XCAM_FAIL_RETURN (
+            WARNING,
+            calculate_merge_window (
+                get_input_valid_area (0).width, get_input_valid_area (1).width, out_info.width, merge_window),
+            XCAM_RETURN_ERROR_PARAM,
+            "SoftBlender(%s) auto calculate merge window failed", get_name ());
+
+        merge_window.pos_y = 0;
+        merge_window.height = out_info.height;
+        XCAM_FAIL_RETURN (
+            WARNING, set_merge_window (merge_window), XCAM_RETURN_ERROR_PARAM,
+            "SoftBlender(%s) set merge window failed", get_name ());
+
+        Rect area;
+        area.width = merge_window.width;
+        area.height = merge_window.height;
+        area.pos_x = merge_window.pos_x;
+        set_input_merge_area (area, 0);
+        area.pos_x = 0;
+        set_input_merge_area (area, 1);
+    }
+
+    const Rect *areas = _input_merge_area;
+    XCAM_FAIL_RETURN (
+        WARNING,
+        _merge_window.pos_x + _merge_window.width <= (int32_t)out_info.width &&
+        areas[0].pos_x >= 0 && areas[0].pos_x + areas[0].width <= (int32_t)in0_info.width &&
+        areas[1].pos_x >= 0 && areas[1].pos_x + areas[1].width <= (int32_t)in1_info.width,
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftBlender(%s) merge window(x:%d, width:%d) or merge areas(x:%d, x:%d) out of images",
+        get_name (), _merge_window.pos_x, _merge_window.width, areas[0].pos_x, areas[1].pos_x);
+
+    if ((ret = _input_frames[0].map (input0)) != XCAM_RETURN_NO_ERROR ||
+            (ret = _input_frames[1].map (input1)) != XCAM_RETURN_NO_ERROR ||
+            (ret = _output_frame.map (output)) != XCAM_RETURN_NO_ERROR) {
+        unmap_frames ();
+        XCAM_LOG_WARNING ("SoftBlender(%s) map buffers failed", get_name ());
+        return ret;
+    }
+
+    ret = allocate_soft_buffers ();
+    if (ret != XCAM_RETURN_NO_ERROR)
+        unmap_frames ();
+    return ret;
+}
+
+XCamReturn
+SoftBlender::execute_done (SmartPtr<VideoBuffer> &output)
+{
+    XCAM_UNUSED (output);
+    unmap_frames ();
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftBlender::unmap_frames ()
+{
+    for (uint32_t i = 0; i < XCAM_SOFT_BLENDER_IMAGE_NUM; ++i)
+        _input_frames[i].unmap ();
+    _output_frame.unmap ();
+}
+
+void
+SoftBlender::emit_stop ()
+{
+    unmap_frames ();
+    SoftImageHandler::emit_stop ();
+}
+
+SoftBlenderCopyKernel::SoftBlenderCopyKernel (SoftBlender *blender)
+    : SoftImageKernel ("soft_blender_copy")
+    , _blender (blender)
+{
+    XCAM_ASSERT (blender);
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, 16);
+    xcam_mem_clear (_in_offset_x);
+    xcam_mem_clear (_out_offset_x);
+    xcam_mem_clear (_copy_width);
+}
+
+XCamReturn
+SoftBlenderCopyKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    const Rect &window = _blender->get_merge_window ();
+    const SoftImagePlane &out_plane = _blender->get_output_frame ().get_plane (0);
+
+    for (uint32_t i = 0; i < XCAM_SOFT_BLENDER_IMAGE_NUM; ++i) {
+        const Rect &valid_area = _blender->get_input_valid_area (i);
+        const Rect &merge_area = _blender->get_input_merge_area (i);
+        const SoftImagePlane &in_plane = _blender->get_input_frame (i).get_plane (0);
+        int32_t in_end = XCAM_MIN (valid_area.pos_x + valid_area.width, (int32_t)in_plane.width);
+
+        if (i == 0) {
+            _in_offset_x[i] = valid_area.pos_x;
+            _copy_width[i] = merge_area.pos_x - valid_area.pos_x;
+            _out_offset_x[i] = window.pos_x - _copy_width[i];
+        } else {
+            _in_offset_x[i] = merge_area.pos_x + merge_area.width;
+            _out_offset_x[i] = window.pos_x + window.width;
+            _copy_width[i] = in_end - _in_offset_x[i];
+        }
+
+        // keep inside of output, nothing to copy if the merge area starts the valid area
+        if (_out_offset_x[i] < 0) {
+            _in_offset_x[i] -= _out_offset_x[i];
+            _copy_width[i] += _out_offset_x[i];
+            _out_offset_x[i] = 0;
+        }
+        _copy_width[i] = XCAM_MIN (_copy_width[i], (int32_t)out_plane.width - _out_offset_x[i]);
+        _copy_width[i] = XCAM_MAX (_copy_width[i], 0);
+    }
+
+    work_width = out_plane.width;
+    work_height = out_plane.height;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftBlenderCopyKernel::work_tile (const ImageTile &tile)
+{
+    const SoftImageFrame &out = _blender->get_output_frame ();
+
+    // tiles are even rows high, chroma rows of a tile are y / 2
+    for (uint32_t plane = 0; plane < SoftBlenderPlaneMax; ++plane) {
+        const SoftImagePlane &dst = out.get_plane (plane);
+        uint32_t y_begin = tile.y >> plane;
+        uint32_t y_end = XCAM_MIN ((tile.y + tile.height) >> plane, dst.height);
+
+        for (uint32_t i = 0; i < XCAM_SOFT_BLENDER_IMAGE_NUM; ++i) {
+            if (!_copy_width[i])
+                continue;
+            const SoftImagePlane &src = _blender->get_input_frame (i).get_plane (plane);
+            for (uint32_t y = y_begin; y < y_end; ++y)
+                memcpy (dst.row (y) + _out_offset_x[i], src.row (y) + _in_offset_x[i], _copy_width[i]);
+        }
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+};
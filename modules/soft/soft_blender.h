@@ -0,0 +1,143 @@
+/*
+ * soft_blender.h - CPU blender
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_BLENDER_H
+#define XCAM_SOFT_BLENDER_H
+
+#include "xcam_utils.h"
+#include "soft_image_handler.h"
+
+#define XCAM_SOFT_BLENDER_IMAGE_NUM      2
+#define XCAM_SOFT_BLENDER_ALIGNED_WIDTH  8
+
+namespace XCam {
+
+enum {
+    SoftBlenderPlaneY = 0,
+    SoftBlenderPlaneUV,
+    SoftBlenderPlaneMax,
+};
+
+/*
+ * CPU counterpart of CLBlender, NV12 only.
+ * second input is attached to the first one, output keeps input height.
+ * areas and merge window follow CLBlender with scale mode global,
+ * merge areas of both inputs are as wide as the merge window.
+ * inputs and output stay mapped from prepare_parameters to execute_done.
+ */
+class SoftBlender
+    : public SoftImageHandler
+{
+public:
+    explicit SoftBlender (const char *name);
+    virtual ~SoftBlender ();
+
+    void set_output_size (uint32_t width, uint32_t height) {
+        _output_width = width;
+        _output_height = height;
+    }
+
+    bool set_input_valid_area (const Rect &area, uint32_t index);
+    bool set_merge_window (const Rect &window);
+    bool set_input_merge_area (const Rect &area, uint32_t index);
+
+    const Rect &get_merge_window () const {
+        return _merge_window;
+    }
+    const Rect &get_input_merge_area (uint32_t index) const {
+        return _input_merge_area[index];
+    }
+    const Rect &get_input_valid_area (uint32_t index) const {
+        return _input_valid_area[index];
+    }
+    bool is_merge_window_set () const {
+        return _merge_window.pos_x || _merge_window.width;
+    }
+
+    void swap_input_idx (bool flag) {
+        _swap_input_index = flag;
+    }
+
+    const SoftImageFrame &get_input_frame (uint32_t index) const {
+        XCAM_ASSERT (index < XCAM_SOFT_BLENDER_IMAGE_NUM);
+        return _input_frames[index];
+    }
+    const SoftImageFrame &get_output_frame () const {
+        return _output_frame;
+    }
+
+    virtual void emit_stop ();
+
+protected:
+    virtual XCamReturn prepare_buffer_pool_video_info (
+        const VideoBufferInfo &input,
+        VideoBufferInfo &output);
+    virtual XCamReturn prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+    virtual XCamReturn execute_done (SmartPtr<VideoBuffer> &output);
+
+    bool calculate_merge_window (uint32_t width0, uint32_t width1, uint32_t blend_width, Rect &out_window);
+    void unmap_frames ();
+
+    // called with mapped frames before kernels run
+    virtual XCamReturn allocate_soft_buffers () = 0;
+
+private:
+    XCAM_DEAD_COPY (SoftBlender);
+
+private:
+    uint32_t                         _output_width;
+    uint32_t                         _output_height;
+    Rect                             _input_valid_area[XCAM_SOFT_BLENDER_IMAGE_NUM];
+    Rect                             _input_merge_area[XCAM_SOFT_BLENDER_IMAGE_NUM];
+    Rect                             _merge_window;  // for output buffer
+    bool                             _swap_input_index;
+    SoftImageFrame                   _input_frames[XCAM_SOFT_BLENDER_IMAGE_NUM];
+    SoftImageFrame                   _output_frame;
+};
+
+/*
+ * copies the parts of both inputs outside of the merge window,
+ * same as CLPyramidCopyKernel for both buffers and planes.
+ */
+class SoftBlenderCopyKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftBlenderCopyKernel (SoftBlender *blender);
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCAM_DEAD_COPY (SoftBlenderCopyKernel);
+
+private:
+    SoftBlender                     *_blender;
+    int32_t                          _in_offset_x[XCAM_SOFT_BLENDER_IMAGE_NUM];
+    int32_t                          _out_offset_x[XCAM_SOFT_BLENDER_IMAGE_NUM];
+    int32_t                          _copy_width[XCAM_SOFT_BLENDER_IMAGE_NUM];
+};
+
+};
+
+#endif //XCAM_SOFT_BLENDER_H
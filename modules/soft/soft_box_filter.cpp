@@ -0,0 +1,136 @@
+/*
+ * soft_box_filter.cpp - separable passes over single channel maps
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_box_filter.h"
+
+#define XCAM_SOFT_BOX_GAUSS_MAX_PASSES  8
+
+namespace XCam {
+
+SoftBoxFilter::SoftBoxFilter (
+    const float *src, float *dst, uint32_t width, uint32_t height, bool column, uint32_t radius)
+    : SoftMapPass<float> (src, dst, width, height, column, radius)
+{
+    uint32_t length = column ? height : width;
+    _inv_counts.resize (length);
+    for (uint32_t i = 0; i < length; ++i) {
+        uint32_t first = (i > _radius) ? i - _radius : 0;
+        uint32_t last = XCAM_MIN (i + _radius, length - 1);
+        _inv_counts[i] = 1.0f / (last - first + 1);
+    }
+}
+
+XCamReturn
+SoftBoxFilter::work_range (uint32_t begin, uint32_t end)
+{
+    for (uint32_t i = begin; i < end; ++i) {
+        if (_column)
+            filter_columns (i * XCAM_SOFT_MAP_COLUMN_LANES, get_lanes (i));
+        else
+            filter_row (i);
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftBoxFilter::filter_row (uint32_t y)
+{
+    const float *src = _src + (size_t)y * _width;
+    float *dst = _dst + (size_t)y * _width;
+    const float *inv_counts = &_inv_counts[0];
+    const uint32_t radius = _radius;
+    float sum = 0.0f;
+    uint32_t i = 0;
+
+    for (i = 0; i < radius; ++i)
+        sum += src[i];
+    for (i = 0; i <= radius && i < _width; ++i) {
+        if (i + radius < _width)
+            sum += src[i + radius];
+        dst[i] = sum * inv_counts[i];
+    }
+    for (; i + radius < _width; ++i) {
+        sum += src[i + radius] - src[i - radius - 1];
+        dst[i] = sum * inv_counts[i];
+    }
+    for (; i < _width; ++i) {
+        sum -= src[i - radius - 1];
+        dst[i] = sum * inv_counts[i];
+    }
+}
+
+void
+SoftBoxFilter::filter_columns (uint32_t x, uint32_t lanes)
+{
+    const uint32_t radius = _radius;
+    float sums[XCAM_SOFT_MAP_COLUMN_LANES];
+
+    for (uint32_t k = 0; k < lanes; ++k)
+        sums[k] = 0.0f;
+    for (uint32_t y = 0; y < radius; ++y) {
+        const float *src = _src + (size_t)y * _width + x;
+        for (uint32_t k = 0; k < lanes; ++k)
+            sums[k] += src[k];
+    }
+
+    for (uint32_t y = 0; y < _height; ++y) {
+        float *dst = _dst + (size_t)y * _width + x;
+        float inv_count = _inv_counts[y];
+
+        if (y + radius < _height) {
+            const float *in = _src + (size_t)(y + radius) * _width + x;
+            for (uint32_t k = 0; k < lanes; ++k)
+                sums[k] += in[k];
+        }
+        if (y > radius) {
+            const float *out = _src + (size_t)(y - radius - 1) * _width + x;
+            for (uint32_t k = 0; k < lanes; ++k)
+                sums[k] -= out[k];
+        }
+        for (uint32_t k = 0; k < lanes; ++k)
+            dst[k] = sums[k] * inv_count;
+    }
+}
+
+XCamReturn
+soft_box_gauss_map (float *map, float *tmp, uint32_t width, uint32_t height, float sigma, uint32_t count)
+{
+    uint32_t radii[XCAM_SOFT_BOX_GAUSS_MAX_PASSES];
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        count > 0 && count <= XCAM_SOFT_BOX_GAUSS_MAX_PASSES && sigma >= 0.0f,
+        XCAM_RETURN_ERROR_PARAM,
+        "soft box gauss got invalid sigma(%f) or pass count(%d)", sigma, count);
+
+    box_gauss_radii (sigma, count, radii);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!radii[i])
+            continue;
+        ret = soft_filter_map<SoftBoxFilter> (map, tmp, width, height, radii[i]);
+        XCAM_FAIL_RETURN (
+            WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+            "soft box gauss pass(%d) failed", i);
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+};
@@ -0,0 +1,117 @@
+/*
+ * soft_box_filter.h - separable passes over single channel maps
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_BOX_FILTER_H
+#define XCAM_SOFT_BOX_FILTER_H
+
+#include "xcam_utils.h"
+#include "thread_pool.h"
+#include <vector>
+
+// rows of a map per pool chunk, and columns filtered together
+#define XCAM_SOFT_MAP_ROW_GRAIN       8
+#define XCAM_SOFT_MAP_COLUMN_LANES    64
+
+namespace XCam {
+
+/*
+ * one pass of a separable filter over a map. a row pass filters one
+ * row per work item, a column pass XCAM_SOFT_MAP_COLUMN_LANES adjacent
+ * columns, walking down rows so memory is read in order.
+ */
+template <typename T>
+class SoftMapPass
+    : public ParallelFunc
+{
+public:
+    SoftMapPass (
+        const T *src, T *dst, uint32_t width, uint32_t height, bool column, uint32_t radius)
+        : _src (src), _dst (dst), _width (width), _height (height), _column (column)
+        , _radius (XCAM_MIN (radius, (column ? height : width) - 1))
+    {}
+
+    // rows or column groups
+    uint32_t get_items () const {
+        return _column ?
+               (_width + XCAM_SOFT_MAP_COLUMN_LANES - 1) / XCAM_SOFT_MAP_COLUMN_LANES : _height;
+    }
+
+protected:
+    uint32_t get_lanes (uint32_t item) const {
+        return XCAM_MIN (_width - item * XCAM_SOFT_MAP_COLUMN_LANES, (uint32_t)XCAM_SOFT_MAP_COLUMN_LANES);
+    }
+
+protected:
+    const T           *_src;
+    T                 *_dst;
+    uint32_t           _width;
+    uint32_t           _height;
+    bool               _column;
+    uint32_t           _radius;
+};
+
+/*
+ * running sum mean over [i - radius, i + radius], window clipped at
+ * borders. row then column pass gives the box mean of the clipped
+ * rectangle.
+ */
+class SoftBoxFilter
+    : public SoftMapPass<float>
+{
+public:
+    SoftBoxFilter (
+        const float *src, float *dst, uint32_t width, uint32_t height, bool column, uint32_t radius);
+
+    virtual XCamReturn work_range (uint32_t begin, uint32_t end);
+
+private:
+    void filter_row (uint32_t y);
+    void filter_columns (uint32_t x, uint32_t lanes);
+
+private:
+    std::vector<float>     _inv_counts;
+};
+
+// row pass from @map to @tmp, column pass back to @map
+template <typename Filter, typename T>
+XCamReturn
+soft_filter_map (T *map, T *tmp, uint32_t width, uint32_t height, uint32_t radius)
+{
+    SmartPtr<ThreadPool> pool = ThreadPool::instance ();
+
+    Filter rows (map, tmp, width, height, false, radius);
+    XCamReturn ret = pool->parallel_for (rows.get_items (), rows, XCAM_SOFT_MAP_ROW_GRAIN);
+    if (ret != XCAM_RETURN_NO_ERROR)
+        return ret;
+
+    Filter columns (tmp, map, width, height, true, radius);
+    return pool->parallel_for (columns.get_items (), columns);
+}
+
+/*
+ * gaussian approximated in place by @count stacked box filters of
+ * box_gauss_radii (), cost per pixel does not depend on @sigma.
+ */
+XCamReturn
+soft_box_gauss_map (float *map, float *tmp, uint32_t width, uint32_t height, float sigma, uint32_t count);
+
+};
+
+#endif //XCAM_SOFT_BOX_FILTER_H
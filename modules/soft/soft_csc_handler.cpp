@@ -0,0 +1,438 @@
+/*
+ * soft_csc_handler.cpp - CPU color space conversion handler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_csc_handler.h"
+#include <math.h>
+
+#define SOFT_LAB_TABLE_BITS  12
+#define SOFT_LAB_TABLE_SIZE  (1 << SOFT_LAB_TABLE_BITS)
+
+namespace XCam {
+
+static const float default_soft_rgbtoyuv_matrix[XCAM_COLOR_MATRIX_SIZE] = {
+    0.299f, 0.587f, 0.114f,
+    -0.14713f, -0.28886f, 0.436f,
+    0.615f, -0.51499f, -0.10001f
+};
+
+// same rgb to XYZ as kernel_csc_rgbatolab, white normalized
+static const float soft_rgb_to_xyz_matrix[XCAM_COLOR_MATRIX_SIZE] = {
+    0.433910f, 0.376220f, 0.189860f,
+    0.212649f, 0.715169f, 0.072182f,
+    0.017756f, 0.109478f, 0.872915f
+};
+
+/*
+ * f(t) of CIE Lab over [0, 1] in SOFT_LAB_TABLE_SIZE steps,
+ * indexed straight from 8-bit RGB by Q8 coefficients.
+ */
+struct SoftLabTable {
+    float      f[SOFT_LAB_TABLE_SIZE];
+    int32_t    coeffs[XCAM_COLOR_MATRIX_SIZE];
+
+    SoftLabTable () {
+        for (int i = 0; i < SOFT_LAB_TABLE_SIZE; ++i) {
+            float t = i / (float)(SOFT_LAB_TABLE_SIZE - 1);
+            f[i] = (t > 0.008856f) ? cbrtf (t) : (7.787f * t + 16.0f / 116.0f);
+        }
+        for (int i = 0; i < XCAM_COLOR_MATRIX_SIZE; ++i)
+            coeffs[i] = (int32_t)(soft_rgb_to_xyz_matrix[i] * (SOFT_LAB_TABLE_SIZE - 1) * 256.0f / 255.0f + 0.5f);
+    }
+
+    float lookup (const int32_t *c, const uint8_t *rgba) const {
+        int32_t index = (c[0] * rgba[0] + c[1] * rgba[1] + c[2] * rgba[2] + 128) >> 8;
+        return f[XCAM_MIN (index, SOFT_LAB_TABLE_SIZE - 1)];
+    }
+};
+
+static const SoftLabTable &
+get_soft_lab_table ()
+{
+    static const SoftLabTable table;
+    return table;
+}
+
+static inline int16_t
+to_csc_coeff (double value)
+{
+    double fixed = value * (1 << XCAM_SOFT_CSC_COEFF_BITS);
+    fixed = XCAM_MAX (XCAM_MIN (fixed, 32767.0), -32768.0);
+    return (int16_t)(fixed >= 0.0 ? fixed + 0.5 : fixed - 0.5);
+}
+
+static inline uint8_t
+lab_to_u8 (float value)
+{
+    value += 0.5f;
+    return (uint8_t)(value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value));
+}
+
+SoftCscImageKernel::SoftCscImageKernel (const char *name, SoftCscType type)
+    : SoftImageKernel (name)
+    , _csc_type (type)
+    , _funcs (NULL)
+    , _stream (false)
+{
+    xcam_mem_clear (_coeffs);
+    set_matrix (default_soft_rgbtoyuv_matrix);
+    // row bands, simd runs along whole rows
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, 0);
+}
+
+/*
+ * @matrix is rgb to yuv as CLCscImageKernel, the yuv to rgb
+ * direction uses its inverse.
+ */
+bool
+SoftCscImageKernel::set_matrix (const float *matrix)
+{
+    const float *m = matrix;
+    double det =
+        m[0] * ((double)m[4] * m[8] - (double)m[5] * m[7]) -
+        m[1] * ((double)m[3] * m[8] - (double)m[5] * m[6]) +
+        m[2] * ((double)m[3] * m[7] - (double)m[4] * m[6]);
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        fabs (det) > 1e-6,
+        false,
+        "soft csc kernel(%s) rgb to yuv matrix is singular, keep previous one",
+        XCAM_STR (get_kernel_name ()));
+
+    double inv[XCAM_COLOR_MATRIX_SIZE] = {
+        ((double)m[4] * m[8] - (double)m[5] * m[7]) / det,
+        ((double)m[2] * m[7] - (double)m[1] * m[8]) / det,
+        ((double)m[1] * m[5] - (double)m[2] * m[4]) / det,
+        ((double)m[5] * m[6] - (double)m[3] * m[8]) / det,
+        ((double)m[0] * m[8] - (double)m[2] * m[6]) / det,
+        ((double)m[2] * m[3] - (double)m[0] * m[5]) / det,
+        ((double)m[3] * m[7] - (double)m[4] * m[6]) / det,
+        ((double)m[1] * m[6] - (double)m[0] * m[7]) / det,
+        ((double)m[0] * m[4] - (double)m[1] * m[3]) / det
+    };
+
+    memcpy (_rgbtoyuv_matrix, matrix, sizeof (float) * XCAM_COLOR_MATRIX_SIZE);
+    for (int i = 0; i < XCAM_COLOR_MATRIX_SIZE; ++i) {
+        _coeffs.rgb2yuv[i] = to_csc_coeff (_rgbtoyuv_matrix[i]);
+        _coeffs.yuv2rgb[i] = to_csc_coeff (inv[i]);
+    }
+    return true;
+}
+
+XCamReturn
+SoftCscImageKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    const VideoBufferInfo &in_info = _in.get_video_info ();
+    const VideoBufferInfo &out_info = _out.get_video_info ();
+    uint32_t in_format = 0, out_format = 0;
+
+    switch (_csc_type) {
+    case SOFT_CSC_TYPE_RGBATONV12:
+        in_format = V4L2_PIX_FMT_RGBA32;
+        out_format = V4L2_PIX_FMT_NV12;
+        break;
+    case SOFT_CSC_TYPE_RGBATOLAB:
+        in_format = V4L2_PIX_FMT_RGBA32;
+        out_format = XCAM_PIX_FMT_LAB;
+        break;
+    case SOFT_CSC_TYPE_RGBA64TORGBA:
+        in_format = XCAM_PIX_FMT_RGBA64;
+        out_format = V4L2_PIX_FMT_RGBA32;
+        break;
+    case SOFT_CSC_TYPE_YUYVTORGBA:
+        in_format = V4L2_PIX_FMT_YUYV;
+        out_format = V4L2_PIX_FMT_RGBA32;
+        break;
+    case SOFT_CSC_TYPE_NV12TORGBA:
+        in_format = V4L2_PIX_FMT_NV12;
+        out_format = V4L2_PIX_FMT_RGBA32;
+        break;
+    default:
+        break;
+    }
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in_info.format == in_format && out_info.format == out_format,
+        XCAM_RETURN_ERROR_PARAM,
+        "soft csc kernel(%s) unsupported conversion %s to %s",
+        XCAM_STR (get_kernel_name ()),
+        xcam_fourcc_to_string (in_info.format), xcam_fourcc_to_string (out_info.format));
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in_info.width == out_info.width && in_info.height == out_info.height,
+        XCAM_RETURN_ERROR_PARAM,
+        "soft csc kernel(%s) input(%dx%d) and output(%dx%d) size differ",
+        XCAM_STR (get_kernel_name ()),
+        in_info.width, in_info.height, out_info.width, out_info.height);
+
+    work_width = out_info.width;
+    work_height = out_info.height;
+    if (in_format == V4L2_PIX_FMT_NV12 || out_format == V4L2_PIX_FMT_NV12 ||
+            in_format == V4L2_PIX_FMT_YUYV) {
+        XCAM_FAIL_RETURN (
+            WARNING,
+            !(work_width % 2) && !(work_height % 2),
+            XCAM_RETURN_ERROR_PARAM,
+            "soft csc kernel(%s) subsampled size(%dx%d) must be even",
+            XCAM_STR (get_kernel_name ()), work_width, work_height);
+    }
+    // 4:2:0 works on pairs of rows sharing one chroma row
+    if (in_format == V4L2_PIX_FMT_NV12 || out_format == V4L2_PIX_FMT_NV12)
+        work_height /= 2;
+
+    _funcs = &get_soft_csc_funcs (soft_simd_level ());
+    _stream = (out_info.size >= XCAM_SOFT_STREAM_STORE_MIN_BYTES);
+    return XCAM_RETURN_NO_ERROR;
+}
+
+uint32_t
+SoftCscImageKernel::get_bytes_per_pixel () const
+{
+    switch (_csc_type) {
+    case SOFT_CSC_TYPE_RGBATONV12:
+    case SOFT_CSC_TYPE_NV12TORGBA:
+        // two rows of 4 bytes RGBA and 1.5 bytes NV12
+        return 11;
+    case SOFT_CSC_TYPE_RGBATOLAB:
+        return 4 + 3;
+    case SOFT_CSC_TYPE_RGBA64TORGBA:
+        return 8 + 4;
+    case SOFT_CSC_TYPE_YUYVTORGBA:
+        return 2 + 4;
+    default:
+        break;
+    }
+    return SoftImageKernel::get_bytes_per_pixel ();
+}
+
+void
+SoftCscImageKernel::convert_lab_row (const uint8_t *rgba, uint8_t *lab, uint32_t width) const
+{
+    const SoftLabTable &table = get_soft_lab_table ();
+
+    for (uint32_t x = 0; x < width; ++x, rgba += 4, lab += 3) {
+        float fx = table.lookup (table.coeffs, rgba);
+        float fy = table.lookup (table.coeffs + 3, rgba);
+        float fz = table.lookup (table.coeffs + 6, rgba);
+
+        // L in [0, 100] scaled to 8 bits, a and b offset by 128
+        lab[0] = lab_to_u8 ((116.0f * fy - 16.0f) * 2.55f);
+        lab[1] = lab_to_u8 (500.0f * (fx - fy) + 128.0f);
+        lab[2] = lab_to_u8 (200.0f * (fy - fz) + 128.0f);
+    }
+}
+
+XCamReturn
+SoftCscImageKernel::work_tile (const ImageTile &tile)
+{
+    XCAM_ASSERT (_funcs);
+    const SoftImagePlane &in = _in.get_plane (0);
+    const SoftImagePlane &out = _out.get_plane (0);
+    uint32_t x = tile.x, width = tile.width;
+    uint32_t y_end = tile.y + tile.height;
+
+    switch (_csc_type) {
+    case SOFT_CSC_TYPE_NV12TORGBA: {
+        const SoftImagePlane &in_uv = _in.get_plane (1);
+        XCAM_ASSERT (!(x % 2));
+        for (uint32_t y = tile.y; y < y_end; ++y) {
+            const uint8_t *uv = in_uv.row (y) + x;
+            _funcs->nv12_to_rgba (in.row (y * 2) + x, uv, out.pixel (x, y * 2), width, _coeffs, _stream);
+            _funcs->nv12_to_rgba (in.row (y * 2 + 1) + x, uv, out.pixel (x, y * 2 + 1), width, _coeffs, _stream);
+        }
+        break;
+    }
+    case SOFT_CSC_TYPE_RGBATONV12: {
+        const SoftImagePlane &out_uv = _out.get_plane (1);
+        XCAM_ASSERT (!(x % 2));
+        for (uint32_t y = tile.y; y < y_end; ++y) {
+            _funcs->rgba_to_nv12 (
+                in.pixel (x, y * 2), in.pixel (x, y * 2 + 1),
+                out.row (y * 2) + x, out.row (y * 2 + 1) + x, out_uv.row (y) + x,
+                width, _coeffs, _stream);
+        }
+        break;
+    }
+    case SOFT_CSC_TYPE_YUYVTORGBA:
+        XCAM_ASSERT (!(x % 2));
+        for (uint32_t y = tile.y; y < y_end; ++y)
+            _funcs->yuyv_to_rgba (in.row (y) + x * 2, out.pixel (x, y), width, _coeffs, _stream);
+        break;
+    case SOFT_CSC_TYPE_RGBA64TORGBA:
+        for (uint32_t y = tile.y; y < y_end; ++y)
+            _funcs->rgba64_to_rgba ((const uint16_t *)in.pixel (x, y), out.pixel (x, y), width, _stream);
+        break;
+    case SOFT_CSC_TYPE_RGBATOLAB:
+        for (uint32_t y = tile.y; y < y_end; ++y)
+            convert_lab_row (in.pixel (x, y), out.pixel (x, y), width);
+        break;
+    default:
+        return XCAM_RETURN_ERROR_PARAM;
+    }
+
+    if (_stream)
+        _funcs->store_fence ();
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SoftCscImageHandler::SoftCscImageHandler (const char *name, SoftCscType type)
+    : SoftImageHandler (name)
+    , _output_format (V4L2_PIX_FMT_NV12)
+    , _csc_type (type)
+{
+    switch (type) {
+    case SOFT_CSC_TYPE_RGBATONV12:
+        _output_format = V4L2_PIX_FMT_NV12;
+        break;
+    case SOFT_CSC_TYPE_RGBATOLAB:
+        _output_format = XCAM_PIX_FMT_LAB;
+        break;
+    case SOFT_CSC_TYPE_RGBA64TORGBA:
+    case SOFT_CSC_TYPE_YUYVTORGBA:
+    case SOFT_CSC_TYPE_NV12TORGBA:
+        _output_format = V4L2_PIX_FMT_RGBA32;
+        break;
+    default:
+        break;
+    }
+}
+
+bool
+SoftCscImageHandler::set_csc_kernel (SmartPtr<SoftCscImageKernel> &kernel)
+{
+    SmartPtr<SoftImageKernel> image_kernel = kernel;
+    add_kernel (image_kernel);
+    _csc_kernel = kernel;
+    return true;
+}
+
+bool
+SoftCscImageHandler::set_rgbtoyuv_matrix (const XCam3aResultColorMatrix &matrix)
+{
+    float matrix_table[XCAM_COLOR_MATRIX_SIZE];
+    for (int i = 0; i < XCAM_COLOR_MATRIX_SIZE; i++)
+        matrix_table[i] = (float)matrix.matrix[i];
+
+    XCAM_ASSERT (_csc_kernel.ptr ());
+    return _csc_kernel->set_matrix (matrix_table);
+}
+
+bool
+SoftCscImageHandler::set_output_format (uint32_t fourcc)
+{
+    XCAM_FAIL_RETURN (
+        WARNING,
+        V4L2_PIX_FMT_RGBA32 == fourcc || V4L2_PIX_FMT_NV12 == fourcc || XCAM_PIX_FMT_LAB == fourcc,
+        false,
+        "soft csc handler doesn't support format: (%s)",
+        xcam_fourcc_to_string (fourcc));
+
+    _output_format = fourcc;
+    return true;
+}
+
+XCamReturn
+SoftCscImageHandler::prepare_buffer_pool_video_info (
+    const VideoBufferInfo &input,
+    VideoBufferInfo &output)
+{
+    bool format_inited = output.init (_output_format, input.width, input.height);
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        format_inited,
+        XCAM_RETURN_ERROR_PARAM,
+        "soft image handler(%s) output format(%s) unsupported",
+        get_name (), xcam_fourcc_to_string (_output_format));
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftCscImageHandler::prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    SmartPtr<X3aResult> result = get_3a_result (XCAM_3A_RESULT_RGB2YUV_MATRIX);
+    if (!result.ptr ())
+        return XCAM_RETURN_NO_ERROR;
+
+    SmartPtr<X3aColorMatrixResult> matrix = result.dynamic_cast_ptr<X3aColorMatrixResult> ();
+    XCAM_FAIL_RETURN (
+        WARNING,
+        matrix.ptr (),
+        XCAM_RETURN_ERROR_PARAM,
+        "soft image handler(%s) rgb2yuv result is not a color matrix", get_name ());
+
+    set_rgbtoyuv_matrix (matrix->get_standard_result ());
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SmartPtr<SoftImageHandler>
+create_soft_csc_image_handler (SoftCscType type)
+{
+    SmartPtr<SoftCscImageHandler> csc_handler;
+    SmartPtr<SoftCscImageKernel> csc_kernel;
+    const char *kernel_name = NULL;
+
+    switch (type) {
+    case SOFT_CSC_TYPE_RGBATONV12:
+        kernel_name = "soft_csc_rgbatonv12";
+        break;
+    case SOFT_CSC_TYPE_RGBATOLAB:
+        kernel_name = "soft_csc_rgbatolab";
+        break;
+    case SOFT_CSC_TYPE_RGBA64TORGBA:
+        kernel_name = "soft_csc_rgba64torgba";
+        break;
+    case SOFT_CSC_TYPE_YUYVTORGBA:
+        kernel_name = "soft_csc_yuyvtorgba";
+        break;
+    case SOFT_CSC_TYPE_NV12TORGBA:
+        kernel_name = "soft_csc_nv12torgba";
+        break;
+    default:
+        break;
+    }
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        kernel_name,
+        NULL,
+        "soft csc handler unsupported csc type(%d)", (int)type);
+
+    XCAM_LOG_DEBUG ("soft csc(%s) uses simd level %s", kernel_name, soft_simd_level_name (soft_simd_level ()));
+
+    csc_kernel = new SoftCscImageKernel (kernel_name, type);
+    csc_handler = new SoftCscImageHandler ("soft_handler_csc", type);
+    csc_handler->set_csc_kernel (csc_kernel);
+
+    return csc_handler;
+}
+
+};
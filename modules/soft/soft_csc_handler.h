@@ -0,0 +1,107 @@
+/*
+ * soft_csc_handler.h - CPU color space conversion handler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_CSC_HANDLER_H
+#define XCAM_SOFT_CSC_HANDLER_H
+
+#include "xcam_utils.h"
+#include "soft_image_handler.h"
+#include "soft_csc_simd.h"
+#include "base/xcam_3a_result.h"
+
+// frames from this output size on bypass caches with non-temporal stores
+#define XCAM_SOFT_STREAM_STORE_MIN_BYTES  (4 * 1024 * 1024)
+
+namespace XCam {
+
+enum SoftCscType {
+    SOFT_CSC_TYPE_NONE = 0,
+    SOFT_CSC_TYPE_RGBATONV12,
+    SOFT_CSC_TYPE_RGBATOLAB,
+    SOFT_CSC_TYPE_RGBA64TORGBA,
+    SOFT_CSC_TYPE_YUYVTORGBA,
+    SOFT_CSC_TYPE_NV12TORGBA,
+};
+
+/*
+ * CPU counterpart of CLCscImageKernel, same types and matrix.
+ * rows are split in full-width bands, each row runs the simd
+ * functions of soft_simd_level ().
+ */
+class SoftCscImageKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftCscImageKernel (const char *name, SoftCscType type);
+    bool set_matrix (const float *matrix);
+    SoftCscType get_csc_type () const {
+        return _csc_type;
+    }
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual uint32_t get_bytes_per_pixel () const;
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    void convert_lab_row (const uint8_t *rgba, uint8_t *lab, uint32_t width) const;
+
+    XCAM_DEAD_COPY (SoftCscImageKernel);
+
+private:
+    SoftCscType              _csc_type;
+    float                    _rgbtoyuv_matrix[XCAM_COLOR_MATRIX_SIZE];
+    SoftCscCoeffs            _coeffs;
+    const SoftCscFuncs      *_funcs;
+    bool                     _stream;
+};
+
+class SoftCscImageHandler
+    : public SoftImageHandler
+{
+public:
+    explicit SoftCscImageHandler (const char *name, SoftCscType type);
+    bool set_csc_kernel (SmartPtr<SoftCscImageKernel> &kernel);
+    bool set_rgbtoyuv_matrix (const XCam3aResultColorMatrix &matrix);
+    bool set_output_format (uint32_t fourcc);
+
+protected:
+    virtual XCamReturn prepare_buffer_pool_video_info (
+        const VideoBufferInfo &input,
+        VideoBufferInfo &output);
+    virtual XCamReturn prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+
+private:
+    XCAM_DEAD_COPY (SoftCscImageHandler);
+
+private:
+    uint32_t                       _output_format;
+    SoftCscType                    _csc_type;
+    SmartPtr<SoftCscImageKernel>   _csc_kernel;
+};
+
+SmartPtr<SoftImageHandler>
+create_soft_csc_image_handler (SoftCscType type);
+
+};
+
+#endif //XCAM_SOFT_CSC_HANDLER_H
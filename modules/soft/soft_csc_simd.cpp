@@ -0,0 +1,835 @@
+/*
+ * soft_csc_simd.cpp - row functions of CPU color space conversion
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_csc_simd.h"
+
+#if XCAM_SOFT_SIMD_X86
+#include <immintrin.h>
+#endif
+#if XCAM_SOFT_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#define CSC_BITS       XCAM_SOFT_CSC_COEFF_BITS
+#define CSC_ROUND      (1 << (CSC_BITS - 1))
+// chroma of 4:2:0 is the sum of 2x2 pixels, two more fraction bits
+#define CSC_SUM_BITS   (CSC_BITS + 2)
+#define CSC_SUM_OFFSET ((128 << CSC_SUM_BITS) + (1 << (CSC_SUM_BITS - 1)))
+
+namespace XCam {
+
+/*
+ * scalar rows, reference for all simd paths and their tails.
+ * @x is the first pixel to convert, even for subsampled formats.
+ */
+static inline uint8_t
+clamp_to_u8 (int32_t value)
+{
+    return (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+static inline void
+yuv_to_rgba_pixel (int32_t y, int32_t u, int32_t v, const int16_t *m, uint8_t *rgba)
+{
+    rgba[0] = clamp_to_u8 ((m[0] * y + m[1] * u + m[2] * v + CSC_ROUND) >> CSC_BITS);
+    rgba[1] = clamp_to_u8 ((m[3] * y + m[4] * u + m[5] * v + CSC_ROUND) >> CSC_BITS);
+    rgba[2] = clamp_to_u8 ((m[6] * y + m[7] * u + m[8] * v + CSC_ROUND) >> CSC_BITS);
+    // same as cl kernels, alpha cleared
+    rgba[3] = 0;
+}
+
+static inline uint8_t
+rgb_to_y_pixel (const uint8_t *rgba, const int16_t *m)
+{
+    return clamp_to_u8 ((m[0] * rgba[0] + m[1] * rgba[1] + m[2] * rgba[2] + CSC_ROUND) >> CSC_BITS);
+}
+
+static inline uint8_t
+rgb_sum_to_chroma (int32_t r, int32_t g, int32_t b, const int16_t *m)
+{
+    return clamp_to_u8 ((m[0] * r + m[1] * g + m[2] * b + CSC_SUM_OFFSET) >> CSC_SUM_BITS);
+}
+
+static inline uint8_t
+rgba64_to_rgba_channel (uint16_t value)
+{
+    // round (value * 255 / 65535)
+    return (uint8_t)((value * 255u + 32895u) >> 16);
+}
+
+static void
+nv12_to_rgba_row_c (
+    const uint8_t *y, const uint8_t *uv, uint8_t *rgba,
+    uint32_t x, uint32_t width, const SoftCscCoeffs &coeffs)
+{
+    for (; x < width; x += 2) {
+        int32_t u = uv[x] - 128;
+        int32_t v = uv[x + 1] - 128;
+        yuv_to_rgba_pixel (y[x], u, v, coeffs.yuv2rgb, rgba + x * 4);
+        yuv_to_rgba_pixel (y[x + 1], u, v, coeffs.yuv2rgb, rgba + x * 4 + 4);
+    }
+}
+
+static void
+yuyv_to_rgba_row_c (
+    const uint8_t *yuyv, uint8_t *rgba,
+    uint32_t x, uint32_t width, const SoftCscCoeffs &coeffs)
+{
+    for (; x < width; x += 2) {
+        const uint8_t *p = yuyv + x * 2;
+        int32_t u = p[1] - 128;
+        int32_t v = p[3] - 128;
+        yuv_to_rgba_pixel (p[0], u, v, coeffs.yuv2rgb, rgba + x * 4);
+        yuv_to_rgba_pixel (p[2], u, v, coeffs.yuv2rgb, rgba + x * 4 + 4);
+    }
+}
+
+static void
+rgba_to_nv12_row_c (
+    const uint8_t *rgba0, const uint8_t *rgba1,
+    uint8_t *y0, uint8_t *y1, uint8_t *uv,
+    uint32_t x, uint32_t width, const SoftCscCoeffs &coeffs)
+{
+    const int16_t *m = coeffs.rgb2yuv;
+    for (; x < width; x += 2) {
+        const uint8_t *p0 = rgba0 + x * 4;
+        const uint8_t *p1 = rgba1 + x * 4;
+        y0[x] = rgb_to_y_pixel (p0, m);
+        y0[x + 1] = rgb_to_y_pixel (p0 + 4, m);
+        y1[x] = rgb_to_y_pixel (p1, m);
+        y1[x + 1] = rgb_to_y_pixel (p1 + 4, m);
+
+        int32_t r = p0[0] + p0[4] + p1[0] + p1[4];
+        int32_t g = p0[1] + p0[5] + p1[1] + p1[5];
+        int32_t b = p0[2] + p0[6] + p1[2] + p1[6];
+        uv[x] = rgb_sum_to_chroma (r, g, b, m + 3);
+        uv[x + 1] = rgb_sum_to_chroma (r, g, b, m + 6);
+    }
+}
+
+static void
+rgba64_to_rgba_row_c (const uint16_t *rgba64, uint8_t *rgba, uint32_t x, uint32_t width)
+{
+    for (x *= 4; x < width * 4; ++x)
+        rgba[x] = rgba64_to_rgba_channel (rgba64[x]);
+}
+
+static void
+nv12_to_rgba_c (
+    const uint8_t *y, const uint8_t *uv, uint8_t *rgba,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    XCAM_UNUSED (stream);
+    nv12_to_rgba_row_c (y, uv, rgba, 0, width, coeffs);
+}
+
+static void
+yuyv_to_rgba_c (
+    const uint8_t *yuyv, uint8_t *rgba,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    XCAM_UNUSED (stream);
+    yuyv_to_rgba_row_c (yuyv, rgba, 0, width, coeffs);
+}
+
+static void
+rgba_to_nv12_c (
+    const uint8_t *rgba0, const uint8_t *rgba1,
+    uint8_t *y0, uint8_t *y1, uint8_t *uv,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    XCAM_UNUSED (stream);
+    rgba_to_nv12_row_c (rgba0, rgba1, y0, y1, uv, 0, width, coeffs);
+}
+
+static void
+rgba64_to_rgba_c (const uint16_t *rgba64, uint8_t *rgba, uint32_t width, bool stream)
+{
+    XCAM_UNUSED (stream);
+    rgba64_to_rgba_row_c (rgba64, rgba, 0, width);
+}
+
+static void
+store_fence_none ()
+{
+}
+
+static const SoftCscFuncs csc_funcs_c = {
+    nv12_to_rgba_c,
+    yuyv_to_rgba_c,
+    rgba_to_nv12_c,
+    rgba64_to_rgba_c,
+    store_fence_none,
+};
+
+#if XCAM_SOFT_SIMD_X86
+
+static void
+store_fence_sse ()
+{
+    _mm_sfence ();
+}
+
+/*
+ * SSE4.1, 8 pixels in int16 lanes.
+ * a*ca + b*cb + c*cc + round in int32 by madd on (a,b) and (c,1) pairs
+ */
+struct CscDotSse {
+    __m128i ab;
+    __m128i c1;
+};
+
+XCAM_SOFT_TARGET_SSE41 static inline CscDotSse
+csc_dot_sse (const int16_t *m, int32_t round)
+{
+    CscDotSse dot;
+    dot.ab = _mm_set1_epi32 ((uint16_t)m[0] | ((uint32_t)(uint16_t)m[1] << 16));
+    dot.c1 = _mm_set1_epi32 ((uint16_t)m[2] | ((uint32_t)(uint16_t)round << 16));
+    return dot;
+}
+
+XCAM_SOFT_TARGET_SSE41 static inline __m128i
+dot3_sse (__m128i a, __m128i b, __m128i c, const CscDotSse &dot)
+{
+    const __m128i one = _mm_set1_epi16 (1);
+    __m128i lo = _mm_add_epi32 (
+                     _mm_madd_epi16 (_mm_unpacklo_epi16 (a, b), dot.ab),
+                     _mm_madd_epi16 (_mm_unpacklo_epi16 (c, one), dot.c1));
+    __m128i hi = _mm_add_epi32 (
+                     _mm_madd_epi16 (_mm_unpackhi_epi16 (a, b), dot.ab),
+                     _mm_madd_epi16 (_mm_unpackhi_epi16 (c, one), dot.c1));
+    lo = _mm_srai_epi32 (lo, CSC_BITS);
+    hi = _mm_srai_epi32 (hi, CSC_BITS);
+    return _mm_packs_epi32 (lo, hi);
+}
+
+XCAM_SOFT_TARGET_SSE41 static inline void
+store_sse (uint8_t *dst, __m128i value, bool stream)
+{
+    if (stream)
+        _mm_stream_si128 ((__m128i *)dst, value);
+    else
+        _mm_storeu_si128 ((__m128i *)dst, value);
+}
+
+// 8 pixels of y, u-128, v-128 to 32 bytes of RGBA
+XCAM_SOFT_TARGET_SSE41 static inline void
+yuv_to_rgba8_sse (
+    __m128i y, __m128i u, __m128i v, const CscDotSse dot[3],
+    uint8_t *rgba, bool stream)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    __m128i r = dot3_sse (y, u, v, dot[0]);
+    __m128i g = dot3_sse (y, u, v, dot[1]);
+    __m128i b = dot3_sse (y, u, v, dot[2]);
+
+    __m128i rg = _mm_packus_epi16 (r, g);
+    __m128i ba = _mm_packus_epi16 (b, zero);
+    rg = _mm_unpacklo_epi8 (rg, _mm_srli_si128 (rg, 8));
+    ba = _mm_unpacklo_epi8 (ba, zero);
+    store_sse (rgba, _mm_unpacklo_epi16 (rg, ba), stream);
+    store_sse (rgba + 16, _mm_unpackhi_epi16 (rg, ba), stream);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+nv12_to_rgba_sse (
+    const uint8_t *y, const uint8_t *uv, uint8_t *rgba,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    const __m128i u_mask = _mm_setr_epi8 (0, 0, 2, 2, 4, 4, 6, 6, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i v_mask = _mm_setr_epi8 (1, 1, 3, 3, 5, 5, 7, 7, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i offset = _mm_set1_epi16 (128);
+    const CscDotSse dot[3] = {
+        csc_dot_sse (coeffs.yuv2rgb, CSC_ROUND),
+        csc_dot_sse (coeffs.yuv2rgb + 3, CSC_ROUND),
+        csc_dot_sse (coeffs.yuv2rgb + 6, CSC_ROUND)
+    };
+    bool nt = stream && !((uintptr_t)rgba & 15);
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        __m128i y16 = _mm_cvtepu8_epi16 (_mm_loadl_epi64 ((const __m128i *)(y + x)));
+        __m128i uv8 = _mm_loadl_epi64 ((const __m128i *)(uv + x));
+        __m128i u16 = _mm_sub_epi16 (_mm_cvtepu8_epi16 (_mm_shuffle_epi8 (uv8, u_mask)), offset);
+        __m128i v16 = _mm_sub_epi16 (_mm_cvtepu8_epi16 (_mm_shuffle_epi8 (uv8, v_mask)), offset);
+        yuv_to_rgba8_sse (y16, u16, v16, dot, rgba + x * 4, nt);
+    }
+    nv12_to_rgba_row_c (y, uv, rgba, x, width, coeffs);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+yuyv_to_rgba_sse (
+    const uint8_t *yuyv, uint8_t *rgba,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    const __m128i y_mask = _mm_setr_epi8 (0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i u_mask = _mm_setr_epi8 (1, 1, 5, 5, 9, 9, 13, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i v_mask = _mm_setr_epi8 (3, 3, 7, 7, 11, 11, 15, 15, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i offset = _mm_set1_epi16 (128);
+    const CscDotSse dot[3] = {
+        csc_dot_sse (coeffs.yuv2rgb, CSC_ROUND),
+        csc_dot_sse (coeffs.yuv2rgb + 3, CSC_ROUND),
+        csc_dot_sse (coeffs.yuv2rgb + 6, CSC_ROUND)
+    };
+    bool nt = stream && !((uintptr_t)rgba & 15);
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        __m128i in = _mm_loadu_si128 ((const __m128i *)(yuyv + x * 2));
+        __m128i y16 = _mm_cvtepu8_epi16 (_mm_shuffle_epi8 (in, y_mask));
+        __m128i u16 = _mm_sub_epi16 (_mm_cvtepu8_epi16 (_mm_shuffle_epi8 (in, u_mask)), offset);
+        __m128i v16 = _mm_sub_epi16 (_mm_cvtepu8_epi16 (_mm_shuffle_epi8 (in, v_mask)), offset);
+        yuv_to_rgba8_sse (y16, u16, v16, dot, rgba + x * 4, nt);
+    }
+    yuyv_to_rgba_row_c (yuyv, rgba, x, width, coeffs);
+}
+
+// 8 RGBA pixels to R,G,B in int16 lanes
+XCAM_SOFT_TARGET_SSE41 static inline void
+rgba8_to_planes_sse (const uint8_t *rgba, __m128i &r, __m128i &g, __m128i &b)
+{
+    const __m128i mask = _mm_setr_epi8 (0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    __m128i p0 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)rgba), mask);
+    __m128i p1 = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)(rgba + 16)), mask);
+    __m128i rg = _mm_unpacklo_epi32 (p0, p1);
+    __m128i ba = _mm_unpackhi_epi32 (p0, p1);
+    r = _mm_cvtepu8_epi16 (rg);
+    g = _mm_cvtepu8_epi16 (_mm_srli_si128 (rg, 8));
+    b = _mm_cvtepu8_epi16 (ba);
+}
+
+// 2x2 sums of 8 pixels in two rows, 4 int32 lanes
+XCAM_SOFT_TARGET_SSE41 static inline __m128i
+sum2x2_sse (__m128i row0, __m128i row1)
+{
+    return _mm_madd_epi16 (_mm_add_epi16 (row0, row1), _mm_set1_epi16 (1));
+}
+
+XCAM_SOFT_TARGET_SSE41 static inline __m128i
+chroma_sse (__m128i r, __m128i g, __m128i b, const int16_t *m)
+{
+    __m128i sum = _mm_add_epi32 (
+                      _mm_mullo_epi32 (r, _mm_set1_epi32 (m[0])),
+                      _mm_mullo_epi32 (g, _mm_set1_epi32 (m[1])));
+    sum = _mm_add_epi32 (sum, _mm_mullo_epi32 (b, _mm_set1_epi32 (m[2])));
+    sum = _mm_add_epi32 (sum, _mm_set1_epi32 (CSC_SUM_OFFSET));
+    return _mm_srai_epi32 (sum, CSC_SUM_BITS);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+rgba_to_nv12_sse (
+    const uint8_t *rgba0, const uint8_t *rgba1,
+    uint8_t *y0, uint8_t *y1, uint8_t *uv,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    const int16_t *m = coeffs.rgb2yuv;
+    const CscDotSse dot_y = csc_dot_sse (m, CSC_ROUND);
+    bool nt = stream && !(((uintptr_t)y0 | (uintptr_t)y1 | (uintptr_t)uv) & 15);
+    uint32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        __m128i r[4], g[4], b[4];
+        // [0], [1] row0 pixels 0-7, 8-15; [2], [3] row1
+        rgba8_to_planes_sse (rgba0 + x * 4, r[0], g[0], b[0]);
+        rgba8_to_planes_sse (rgba0 + x * 4 + 32, r[1], g[1], b[1]);
+        rgba8_to_planes_sse (rgba1 + x * 4, r[2], g[2], b[2]);
+        rgba8_to_planes_sse (rgba1 + x * 4 + 32, r[3], g[3], b[3]);
+
+        __m128i luma[4];
+        for (int i = 0; i < 4; ++i)
+            luma[i] = dot3_sse (r[i], g[i], b[i], dot_y);
+        store_sse (y0 + x, _mm_packus_epi16 (luma[0], luma[1]), nt);
+        store_sse (y1 + x, _mm_packus_epi16 (luma[2], luma[3]), nt);
+
+        __m128i rs0 = sum2x2_sse (r[0], r[2]), rs1 = sum2x2_sse (r[1], r[3]);
+        __m128i gs0 = sum2x2_sse (g[0], g[2]), gs1 = sum2x2_sse (g[1], g[3]);
+        __m128i bs0 = sum2x2_sse (b[0], b[2]), bs1 = sum2x2_sse (b[1], b[3]);
+        __m128i u = _mm_packs_epi32 (chroma_sse (rs0, gs0, bs0, m + 3), chroma_sse (rs1, gs1, bs1, m + 3));
+        __m128i v = _mm_packs_epi32 (chroma_sse (rs0, gs0, bs0, m + 6), chroma_sse (rs1, gs1, bs1, m + 6));
+        __m128i uv8 = _mm_packus_epi16 (u, v);
+        store_sse (uv + x, _mm_unpacklo_epi8 (uv8, _mm_srli_si128 (uv8, 8)), nt);
+    }
+    rgba_to_nv12_row_c (rgba0, rgba1, y0, y1, uv, x, width, coeffs);
+}
+
+XCAM_SOFT_TARGET_SSE41 static inline __m128i
+rgba64_to_rgba_channels_sse (__m128i value)
+{
+    // round (value / 257) == ((value * 0xFF01) >> 16 + 128) >> 8
+    __m128i t = _mm_mulhi_epu16 (value, _mm_set1_epi16 ((int16_t)0xFF01));
+    return _mm_srli_epi16 (_mm_add_epi16 (t, _mm_set1_epi16 (128)), 8);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+rgba64_to_rgba_sse (const uint16_t *rgba64, uint8_t *rgba, uint32_t width, bool stream)
+{
+    bool nt = stream && !((uintptr_t)rgba & 15);
+    uint32_t x = 0;
+
+    for (; x + 4 <= width; x += 4) {
+        __m128i p0 = _mm_loadu_si128 ((const __m128i *)(rgba64 + x * 4));
+        __m128i p1 = _mm_loadu_si128 ((const __m128i *)(rgba64 + x * 4 + 8));
+        store_sse (
+            rgba + x * 4,
+            _mm_packus_epi16 (rgba64_to_rgba_channels_sse (p0), rgba64_to_rgba_channels_sse (p1)),
+            nt);
+    }
+    rgba64_to_rgba_row_c (rgba64, rgba, x, width);
+}
+
+static const SoftCscFuncs csc_funcs_sse41 = {
+    nv12_to_rgba_sse,
+    yuyv_to_rgba_sse,
+    rgba_to_nv12_sse,
+    rgba64_to_rgba_sse,
+    store_fence_sse,
+};
+
+/*
+ * AVX2, 16 pixels in int16 lanes.
+ * unpack/madd/packs all stay inside 128-bit lanes, so pixel order
+ * survives dot3; only interleaving to RGBA crosses lanes.
+ */
+struct CscDotAvx2 {
+    __m256i ab;
+    __m256i c1;
+};
+
+XCAM_SOFT_TARGET_AVX2 static inline CscDotAvx2
+csc_dot_avx2 (const int16_t *m, int32_t round)
+{
+    CscDotAvx2 dot;
+    dot.ab = _mm256_set1_epi32 ((uint16_t)m[0] | ((uint32_t)(uint16_t)m[1] << 16));
+    dot.c1 = _mm256_set1_epi32 ((uint16_t)m[2] | ((uint32_t)(uint16_t)round << 16));
+    return dot;
+}
+
+XCAM_SOFT_TARGET_AVX2 static inline __m256i
+dot3_avx2 (__m256i a, __m256i b, __m256i c, const CscDotAvx2 &dot)
+{
+    const __m256i one = _mm256_set1_epi16 (1);
+    __m256i lo = _mm256_add_epi32 (
+                     _mm256_madd_epi16 (_mm256_unpacklo_epi16 (a, b), dot.ab),
+                     _mm256_madd_epi16 (_mm256_unpacklo_epi16 (c, one), dot.c1));
+    __m256i hi = _mm256_add_epi32 (
+                     _mm256_madd_epi16 (_mm256_unpackhi_epi16 (a, b), dot.ab),
+                     _mm256_madd_epi16 (_mm256_unpackhi_epi16 (c, one), dot.c1));
+    lo = _mm256_srai_epi32 (lo, CSC_BITS);
+    hi = _mm256_srai_epi32 (hi, CSC_BITS);
+    return _mm256_packs_epi32 (lo, hi);
+}
+
+XCAM_SOFT_TARGET_AVX2 static inline void
+store_avx2 (uint8_t *dst, __m256i value, bool stream)
+{
+    if (stream)
+        _mm256_stream_si256 ((__m256i *)dst, value);
+    else
+        _mm256_storeu_si256 ((__m256i *)dst, value);
+}
+
+XCAM_SOFT_TARGET_AVX2 static inline void
+store_128_avx2 (uint8_t *dst, __m128i value, bool stream)
+{
+    if (stream)
+        _mm_stream_si128 ((__m128i *)dst, value);
+    else
+        _mm_storeu_si128 ((__m128i *)dst, value);
+}
+
+// 16 pixels of y, u-128, v-128 to 64 bytes of RGBA
+XCAM_SOFT_TARGET_AVX2 static inline void
+yuv_to_rgba16_avx2 (
+    __m256i y, __m256i u, __m256i v, const CscDotAvx2 dot[3],
+    uint8_t *rgba, bool stream)
+{
+    const __m256i zero = _mm256_setzero_si256 ();
+    __m256i r = dot3_avx2 (y, u, v, dot[0]);
+    __m256i g = dot3_avx2 (y, u, v, dot[1]);
+    __m256i b = dot3_avx2 (y, u, v, dot[2]);
+
+    __m256i rg = _mm256_packus_epi16 (r, g);
+    __m256i ba = _mm256_packus_epi16 (b, zero);
+    rg = _mm256_unpacklo_epi8 (rg, _mm256_srli_si256 (rg, 8));
+    ba = _mm256_unpacklo_epi8 (ba, zero);
+    __m256i lo = _mm256_unpacklo_epi16 (rg, ba);
+    __m256i hi = _mm256_unpackhi_epi16 (rg, ba);
+    store_avx2 (rgba, _mm256_permute2x128_si256 (lo, hi, 0x20), stream);
+    store_avx2 (rgba + 32, _mm256_permute2x128_si256 (lo, hi, 0x31), stream);
+}
+
+XCAM_SOFT_TARGET_AVX2 static void
+nv12_to_rgba_avx2 (
+    const uint8_t *y, const uint8_t *uv, uint8_t *rgba,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    const __m128i u_mask = _mm_setr_epi8 (0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14);
+    const __m128i v_mask = _mm_setr_epi8 (1, 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15);
+    const __m256i offset = _mm256_set1_epi16 (128);
+    const CscDotAvx2 dot[3] = {
+        csc_dot_avx2 (coeffs.yuv2rgb, CSC_ROUND),
+        csc_dot_avx2 (coeffs.yuv2rgb + 3, CSC_ROUND),
+        csc_dot_avx2 (coeffs.yuv2rgb + 6, CSC_ROUND)
+    };
+    bool nt = stream && !((uintptr_t)rgba & 31);
+    uint32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        __m256i y16 = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *)(y + x)));
+        __m128i uv8 = _mm_loadu_si128 ((const __m128i *)(uv + x));
+        __m256i u16 = _mm256_sub_epi16 (_mm256_cvtepu8_epi16 (_mm_shuffle_epi8 (uv8, u_mask)), offset);
+        __m256i v16 = _mm256_sub_epi16 (_mm256_cvtepu8_epi16 (_mm_shuffle_epi8 (uv8, v_mask)), offset);
+        yuv_to_rgba16_avx2 (y16, u16, v16, dot, rgba + x * 4, nt);
+    }
+    nv12_to_rgba_row_c (y, uv, rgba, x, width, coeffs);
+}
+
+XCAM_SOFT_TARGET_AVX2 static void
+yuyv_to_rgba_avx2 (
+    const uint8_t *yuyv, uint8_t *rgba,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    const __m128i y_mask = _mm_setr_epi8 (0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i u_mask = _mm_setr_epi8 (1, 1, 5, 5, 9, 9, 13, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i v_mask = _mm_setr_epi8 (3, 3, 7, 7, 11, 11, 15, 15, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i offset = _mm256_set1_epi16 (128);
+    const CscDotAvx2 dot[3] = {
+        csc_dot_avx2 (coeffs.yuv2rgb, CSC_ROUND),
+        csc_dot_avx2 (coeffs.yuv2rgb + 3, CSC_ROUND),
+        csc_dot_avx2 (coeffs.yuv2rgb + 6, CSC_ROUND)
+    };
+    bool nt = stream && !((uintptr_t)rgba & 31);
+    uint32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        __m128i in0 = _mm_loadu_si128 ((const __m128i *)(yuyv + x * 2));
+        __m128i in1 = _mm_loadu_si128 ((const __m128i *)(yuyv + x * 2 + 16));
+        __m128i y8 = _mm_unpacklo_epi64 (_mm_shuffle_epi8 (in0, y_mask), _mm_shuffle_epi8 (in1, y_mask));
+        __m128i u8 = _mm_unpacklo_epi64 (_mm_shuffle_epi8 (in0, u_mask), _mm_shuffle_epi8 (in1, u_mask));
+        __m128i v8 = _mm_unpacklo_epi64 (_mm_shuffle_epi8 (in0, v_mask), _mm_shuffle_epi8 (in1, v_mask));
+        yuv_to_rgba16_avx2 (
+            _mm256_cvtepu8_epi16 (y8),
+            _mm256_sub_epi16 (_mm256_cvtepu8_epi16 (u8), offset),
+            _mm256_sub_epi16 (_mm256_cvtepu8_epi16 (v8), offset),
+            dot, rgba + x * 4, nt);
+    }
+    yuyv_to_rgba_row_c (yuyv, rgba, x, width, coeffs);
+}
+
+// 16 RGBA pixels to R,G,B in int16 lanes
+XCAM_SOFT_TARGET_AVX2 static inline void
+rgba16_to_planes_avx2 (const uint8_t *rgba, __m256i &r, __m256i &g, __m256i &b)
+{
+    const __m256i mask = _mm256_setr_epi8 (
+                             0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+                             0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m256i order = _mm256_setr_epi32 (0, 4, 1, 5, 2, 6, 3, 7);
+    // each to 64-bit R0-7, G0-7, B0-7, A0-7
+    __m256i p0 = _mm256_loadu_si256 ((const __m256i *)rgba);
+    __m256i p1 = _mm256_loadu_si256 ((const __m256i *)(rgba + 32));
+    p0 = _mm256_permutevar8x32_epi32 (_mm256_shuffle_epi8 (p0, mask), order);
+    p1 = _mm256_permutevar8x32_epi32 (_mm256_shuffle_epi8 (p1, mask), order);
+
+    __m256i rb = _mm256_unpacklo_epi64 (p0, p1);
+    __m256i ga = _mm256_unpackhi_epi64 (p0, p1);
+    r = _mm256_cvtepu8_epi16 (_mm256_castsi256_si128 (rb));
+    g = _mm256_cvtepu8_epi16 (_mm256_castsi256_si128 (ga));
+    b = _mm256_cvtepu8_epi16 (_mm256_extracti128_si256 (rb, 1));
+}
+
+XCAM_SOFT_TARGET_AVX2 static inline __m256i
+chroma_avx2 (__m256i r, __m256i g, __m256i b, const int16_t *m)
+{
+    __m256i sum = _mm256_add_epi32 (
+                      _mm256_mullo_epi32 (r, _mm256_set1_epi32 (m[0])),
+                      _mm256_mullo_epi32 (g, _mm256_set1_epi32 (m[1])));
+    sum = _mm256_add_epi32 (sum, _mm256_mullo_epi32 (b, _mm256_set1_epi32 (m[2])));
+    sum = _mm256_add_epi32 (sum, _mm256_set1_epi32 (CSC_SUM_OFFSET));
+    return _mm256_srai_epi32 (sum, CSC_SUM_BITS);
+}
+
+XCAM_SOFT_TARGET_AVX2 static void
+rgba_to_nv12_avx2 (
+    const uint8_t *rgba0, const uint8_t *rgba1,
+    uint8_t *y0, uint8_t *y1, uint8_t *uv,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    const int16_t *m = coeffs.rgb2yuv;
+    const CscDotAvx2 dot_y = csc_dot_avx2 (m, CSC_ROUND);
+    const __m256i one = _mm256_set1_epi16 (1);
+    bool nt = stream && !(((uintptr_t)y0 | (uintptr_t)y1 | (uintptr_t)uv) & 15);
+    uint32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        __m256i r0, g0, b0, r1, g1, b1;
+        rgba16_to_planes_avx2 (rgba0 + x * 4, r0, g0, b0);
+        rgba16_to_planes_avx2 (rgba1 + x * 4, r1, g1, b1);
+
+        // lanes: row0 0-7, row1 0-7 | row0 8-15, row1 8-15
+        __m256i luma = _mm256_packus_epi16 (dot3_avx2 (r0, g0, b0, dot_y), dot3_avx2 (r1, g1, b1, dot_y));
+        luma = _mm256_permute4x64_epi64 (luma, 0xD8);
+        store_128_avx2 (y0 + x, _mm256_castsi256_si128 (luma), nt);
+        store_128_avx2 (y1 + x, _mm256_extracti128_si256 (luma, 1), nt);
+
+        __m256i rs = _mm256_madd_epi16 (_mm256_add_epi16 (r0, r1), one);
+        __m256i gs = _mm256_madd_epi16 (_mm256_add_epi16 (g0, g1), one);
+        __m256i bs = _mm256_madd_epi16 (_mm256_add_epi16 (b0, b1), one);
+        __m256i uv16 = _mm256_packs_epi32 (chroma_avx2 (rs, gs, bs, m + 3), chroma_avx2 (rs, gs, bs, m + 6));
+        uv16 = _mm256_permute4x64_epi64 (uv16, 0xD8);
+        __m128i uv8 = _mm_packus_epi16 (_mm256_castsi256_si128 (uv16), _mm256_extracti128_si256 (uv16, 1));
+        store_128_avx2 (uv + x, _mm_unpacklo_epi8 (uv8, _mm_srli_si128 (uv8, 8)), nt);
+    }
+    rgba_to_nv12_row_c (rgba0, rgba1, y0, y1, uv, x, width, coeffs);
+}
+
+XCAM_SOFT_TARGET_AVX2 static inline __m256i
+rgba64_to_rgba_channels_avx2 (__m256i value)
+{
+    __m256i t = _mm256_mulhi_epu16 (value, _mm256_set1_epi16 ((int16_t)0xFF01));
+    return _mm256_srli_epi16 (_mm256_add_epi16 (t, _mm256_set1_epi16 (128)), 8);
+}
+
+XCAM_SOFT_TARGET_AVX2 static void
+rgba64_to_rgba_avx2 (const uint16_t *rgba64, uint8_t *rgba, uint32_t width, bool stream)
+{
+    bool nt = stream && !((uintptr_t)rgba & 31);
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        __m256i p0 = _mm256_loadu_si256 ((const __m256i *)(rgba64 + x * 4));
+        __m256i p1 = _mm256_loadu_si256 ((const __m256i *)(rgba64 + x * 4 + 16));
+        __m256i out = _mm256_packus_epi16 (
+                          rgba64_to_rgba_channels_avx2 (p0), rgba64_to_rgba_channels_avx2 (p1));
+        store_avx2 (rgba + x * 4, _mm256_permute4x64_epi64 (out, 0xD8), nt);
+    }
+    rgba64_to_rgba_row_c (rgba64, rgba, x, width);
+}
+
+static const SoftCscFuncs csc_funcs_avx2 = {
+    nv12_to_rgba_avx2,
+    yuyv_to_rgba_avx2,
+    rgba_to_nv12_avx2,
+    rgba64_to_rgba_avx2,
+    store_fence_sse,
+};
+
+#endif //XCAM_SOFT_SIMD_X86
+
+#if XCAM_SOFT_SIMD_NEON
+
+/*
+ * NEON, 16 pixels per step; vld/vst 2/4 do all (de)interleaving.
+ * no non-temporal store intrinsics, @stream is ignored.
+ */
+static inline int16x8_t
+dot3_neon (int16x8_t a, int16x8_t b, int16x8_t c, const int16_t *m)
+{
+    int32x4_t lo = vmull_n_s16 (vget_low_s16 (a), m[0]);
+    int32x4_t hi = vmull_n_s16 (vget_high_s16 (a), m[0]);
+    lo = vmlal_n_s16 (lo, vget_low_s16 (b), m[1]);
+    hi = vmlal_n_s16 (hi, vget_high_s16 (b), m[1]);
+    lo = vmlal_n_s16 (lo, vget_low_s16 (c), m[2]);
+    hi = vmlal_n_s16 (hi, vget_high_s16 (c), m[2]);
+    return vcombine_s16 (vqrshrn_n_s32 (lo, CSC_BITS), vqrshrn_n_s32 (hi, CSC_BITS));
+}
+
+static inline int16x8_t
+u8_to_s16_neon (uint8x8_t value)
+{
+    return vreinterpretq_s16_u16 (vmovl_u8 (value));
+}
+
+static inline int16x8_t
+chroma_to_s16_neon (uint8x8_t value)
+{
+    return vsubq_s16 (u8_to_s16_neon (value), vdupq_n_s16 (128));
+}
+
+static inline void
+yuv_to_rgba16_neon (
+    uint8x16_t y, uint8x16_t u, uint8x16_t v, const int16_t *m, uint8_t *rgba)
+{
+    uint8x16x4_t out;
+    int16x8_t ys[2] = {u8_to_s16_neon (vget_low_u8 (y)), u8_to_s16_neon (vget_high_u8 (y))};
+    int16x8_t us[2] = {chroma_to_s16_neon (vget_low_u8 (u)), chroma_to_s16_neon (vget_high_u8 (u))};
+    int16x8_t vs[2] = {chroma_to_s16_neon (vget_low_u8 (v)), chroma_to_s16_neon (vget_high_u8 (v))};
+
+    for (int c = 0; c < 3; ++c) {
+        out.val[c] = vcombine_u8 (
+                         vqmovun_s16 (dot3_neon (ys[0], us[0], vs[0], m + c * 3)),
+                         vqmovun_s16 (dot3_neon (ys[1], us[1], vs[1], m + c * 3)));
+    }
+    out.val[3] = vdupq_n_u8 (0);
+    vst4q_u8 (rgba, out);
+}
+
+static void
+nv12_to_rgba_neon (
+    const uint8_t *y, const uint8_t *uv, uint8_t *rgba,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    uint32_t x = 0;
+    XCAM_UNUSED (stream);
+
+    for (; x + 16 <= width; x += 16) {
+        uint8x8x2_t uv8 = vld2_u8 (uv + x);
+        uint8x8x2_t u = vzip_u8 (uv8.val[0], uv8.val[0]);
+        uint8x8x2_t v = vzip_u8 (uv8.val[1], uv8.val[1]);
+        yuv_to_rgba16_neon (
+            vld1q_u8 (y + x),
+            vcombine_u8 (u.val[0], u.val[1]),
+            vcombine_u8 (v.val[0], v.val[1]),
+            coeffs.yuv2rgb, rgba + x * 4);
+    }
+    nv12_to_rgba_row_c (y, uv, rgba, x, width, coeffs);
+}
+
+static void
+yuyv_to_rgba_neon (
+    const uint8_t *yuyv, uint8_t *rgba,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    uint32_t x = 0;
+    XCAM_UNUSED (stream);
+
+    for (; x + 16 <= width; x += 16) {
+        // val: y0, u, y1, v of 8 pixel pairs
+        uint8x8x4_t in = vld4_u8 (yuyv + x * 2);
+        uint8x8x2_t y = vzip_u8 (in.val[0], in.val[2]);
+        uint8x8x2_t u = vzip_u8 (in.val[1], in.val[1]);
+        uint8x8x2_t v = vzip_u8 (in.val[3], in.val[3]);
+        yuv_to_rgba16_neon (
+            vcombine_u8 (y.val[0], y.val[1]),
+            vcombine_u8 (u.val[0], u.val[1]),
+            vcombine_u8 (v.val[0], v.val[1]),
+            coeffs.yuv2rgb, rgba + x * 4);
+    }
+    yuyv_to_rgba_row_c (yuyv, rgba, x, width, coeffs);
+}
+
+static inline uint8x16_t
+rgb_to_y16_neon (const uint8x16x4_t &p, const int16_t *m)
+{
+    int16x8_t lo = dot3_neon (
+                       u8_to_s16_neon (vget_low_u8 (p.val[0])),
+                       u8_to_s16_neon (vget_low_u8 (p.val[1])),
+                       u8_to_s16_neon (vget_low_u8 (p.val[2])), m);
+    int16x8_t hi = dot3_neon (
+                       u8_to_s16_neon (vget_high_u8 (p.val[0])),
+                       u8_to_s16_neon (vget_high_u8 (p.val[1])),
+                       u8_to_s16_neon (vget_high_u8 (p.val[2])), m);
+    return vcombine_u8 (vqmovun_s16 (lo), vqmovun_s16 (hi));
+}
+
+static inline uint8x8_t
+chroma_neon (int16x8_t r, int16x8_t g, int16x8_t b, const int16_t *m)
+{
+    int32x4_t offset = vdupq_n_s32 (128 << CSC_SUM_BITS);
+    int32x4_t lo = vmlal_n_s16 (offset, vget_low_s16 (r), m[0]);
+    int32x4_t hi = vmlal_n_s16 (offset, vget_high_s16 (r), m[0]);
+    lo = vmlal_n_s16 (lo, vget_low_s16 (g), m[1]);
+    hi = vmlal_n_s16 (hi, vget_high_s16 (g), m[1]);
+    lo = vmlal_n_s16 (lo, vget_low_s16 (b), m[2]);
+    hi = vmlal_n_s16 (hi, vget_high_s16 (b), m[2]);
+    int16x8_t sum = vcombine_s16 (vqrshrn_n_s32 (lo, CSC_SUM_BITS), vqrshrn_n_s32 (hi, CSC_SUM_BITS));
+    return vqmovun_s16 (sum);
+}
+
+static void
+rgba_to_nv12_neon (
+    const uint8_t *rgba0, const uint8_t *rgba1,
+    uint8_t *y0, uint8_t *y1, uint8_t *uv,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream)
+{
+    const int16_t *m = coeffs.rgb2yuv;
+    uint32_t x = 0;
+    XCAM_UNUSED (stream);
+
+    for (; x + 16 <= width; x += 16) {
+        uint8x16x4_t p0 = vld4q_u8 (rgba0 + x * 4);
+        uint8x16x4_t p1 = vld4q_u8 (rgba1 + x * 4);
+        vst1q_u8 (y0 + x, rgb_to_y16_neon (p0, m));
+        vst1q_u8 (y1 + x, rgb_to_y16_neon (p1, m));
+
+        // pairwise adds of both rows, 2x2 sums of 8 blocks
+        int16x8_t r = vreinterpretq_s16_u16 (vpadalq_u8 (vpaddlq_u8 (p0.val[0]), p1.val[0]));
+        int16x8_t g = vreinterpretq_s16_u16 (vpadalq_u8 (vpaddlq_u8 (p0.val[1]), p1.val[1]));
+        int16x8_t b = vreinterpretq_s16_u16 (vpadalq_u8 (vpaddlq_u8 (p0.val[2]), p1.val[2]));
+        uint8x8x2_t out;
+        out.val[0] = chroma_neon (r, g, b, m + 3);
+        out.val[1] = chroma_neon (r, g, b, m + 6);
+        vst2_u8 (uv + x, out);
+    }
+    rgba_to_nv12_row_c (rgba0, rgba1, y0, y1, uv, x, width, coeffs);
+}
+
+static inline uint8x8_t
+rgba64_to_rgba_channels_neon (uint16x8_t value)
+{
+    uint32x4_t lo = vmlal_n_u16 (vdupq_n_u32 (32895), vget_low_u16 (value), 255);
+    uint32x4_t hi = vmlal_n_u16 (vdupq_n_u32 (32895), vget_high_u16 (value), 255);
+    return vmovn_u16 (vcombine_u16 (vshrn_n_u32 (lo, 16), vshrn_n_u32 (hi, 16)));
+}
+
+static void
+rgba64_to_rgba_neon (const uint16_t *rgba64, uint8_t *rgba, uint32_t width, bool stream)
+{
+    uint32_t x = 0;
+    XCAM_UNUSED (stream);
+
+    for (; x + 4 <= width; x += 4) {
+        uint8x8_t lo = rgba64_to_rgba_channels_neon (vld1q_u16 (rgba64 + x * 4));
+        uint8x8_t hi = rgba64_to_rgba_channels_neon (vld1q_u16 (rgba64 + x * 4 + 8));
+        vst1q_u8 (rgba + x * 4, vcombine_u8 (lo, hi));
+    }
+    rgba64_to_rgba_row_c (rgba64, rgba, x, width);
+}
+
+static const SoftCscFuncs csc_funcs_neon = {
+    nv12_to_rgba_neon,
+    yuyv_to_rgba_neon,
+    rgba_to_nv12_neon,
+    rgba64_to_rgba_neon,
+    store_fence_none,
+};
+
+#endif //XCAM_SOFT_SIMD_NEON
+
+const SoftCscFuncs &
+get_soft_csc_funcs (SoftSimdLevel level)
+{
+    switch (level) {
+#if XCAM_SOFT_SIMD_X86
+    case SoftSimdAVX2:
+        return csc_funcs_avx2;
+    case SoftSimdSSE41:
+        return csc_funcs_sse41;
+#endif
+#if XCAM_SOFT_SIMD_NEON
+    case SoftSimdNEON:
+        return csc_funcs_neon;
+#endif
+    default:
+        break;
+    }
+    return csc_funcs_c;
+}
+
+};
@@ -0,0 +1,72 @@
+/*
+ * soft_csc_simd.h - row functions of CPU color space conversion
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_CSC_SIMD_H
+#define XCAM_SOFT_CSC_SIMD_H
+
+#include "xcam_utils.h"
+#include "soft_simd.h"
+
+#define XCAM_SOFT_CSC_COEFF_BITS  13
+
+namespace XCam {
+
+/*
+ * fixed-point coefficients, Q13, row-major 3x3.
+ * yuv2rgb: rows R,G,B; columns Y, U-128, V-128
+ * rgb2yuv: rows Y,U,V; columns R,G,B; U and V get +128
+ */
+struct SoftCscCoeffs {
+    int16_t yuv2rgb [9];
+    int16_t rgb2yuv [9];
+};
+
+/*
+ * one row (two rows for 4:2:0) of @width pixels; @stream uses
+ * non-temporal stores where rows are aligned, caller fences.
+ */
+typedef void (*SoftNv12ToRgbaFunc) (
+    const uint8_t *y, const uint8_t *uv, uint8_t *rgba,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream);
+typedef void (*SoftYuyvToRgbaFunc) (
+    const uint8_t *yuyv, uint8_t *rgba,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream);
+typedef void (*SoftRgbaToNv12Func) (
+    const uint8_t *rgba0, const uint8_t *rgba1,
+    uint8_t *y0, uint8_t *y1, uint8_t *uv,
+    uint32_t width, const SoftCscCoeffs &coeffs, bool stream);
+typedef void (*SoftRgba64ToRgbaFunc) (
+    const uint16_t *rgba64, uint8_t *rgba,
+    uint32_t width, bool stream);
+
+struct SoftCscFuncs {
+    SoftNv12ToRgbaFunc      nv12_to_rgba;
+    SoftYuyvToRgbaFunc      yuyv_to_rgba;
+    SoftRgbaToNv12Func      rgba_to_nv12;
+    SoftRgba64ToRgbaFunc    rgba64_to_rgba;
+    // make stores visible to other threads after non-temporal stores
+    void                  (*store_fence) ();
+};
+
+const SoftCscFuncs &get_soft_csc_funcs (SoftSimdLevel level);
+
+};
+
+#endif //XCAM_SOFT_CSC_SIMD_H
@@ -0,0 +1,602 @@
+/*
+ * soft_defog_dcp_handler.cpp - CPU defog handler by dark channel prior
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_defog_dcp_handler.h"
+#include "soft_box_filter.h"
+
+// same transmit coefficient as kernel_defog_recover
+#define SOFT_DEFOG_TRANSMIT_COEFF     0.95f
+// airlight from the haziest 0.1% of the dark channel, smoothed over frames
+#define SOFT_DEFOG_AIRLIGHT_PERCENT   0.1f
+#define SOFT_DEFOG_AIRLIGHT_WEIGHT    0.125f
+#define SOFT_DEFOG_AIRLIGHT_MIN       128.0f
+// rows of the reduced map per pool chunk
+#define SOFT_DEFOG_ROW_GRAIN          XCAM_SOFT_MAP_ROW_GRAIN
+
+namespace XCam {
+
+/*
+ * van Herk/Gil-Werman min over [i - radius, i + radius], borders padded
+ * with 255. a line is split into blocks of the window size,
+ * out[i] = min (suffix min of i's block, prefix min up to i + 2 * radius),
+ * about 3 compares per pixel for any radius.
+ */
+class SoftDefogMinFilter
+    : public SoftMapPass<uint8_t>
+{
+public:
+    SoftDefogMinFilter (
+        const uint8_t *src, uint8_t *dst, uint32_t width, uint32_t height, bool column, uint32_t radius)
+        : SoftMapPass<uint8_t> (src, dst, width, height, column, radius)
+    {
+        uint32_t window = _radius * 2 + 1;
+        _padded = ((column ? height : width) + _radius * 2 + window - 1) / window * window;
+    }
+
+    virtual XCamReturn work_range (uint32_t begin, uint32_t end);
+
+private:
+    // lines of @padded elements, interleaved by lanes of a column pass
+    void filter_row (uint32_t y, uint8_t *line, uint8_t *prefix, uint8_t *suffix);
+    void filter_columns (uint32_t x, uint32_t lanes, uint8_t *line, uint8_t *prefix, uint8_t *suffix);
+
+private:
+    uint32_t                _padded;
+};
+
+XCamReturn
+SoftDefogMinFilter::work_range (uint32_t begin, uint32_t end)
+{
+    size_t size = (size_t)_padded * (_column ? XCAM_SOFT_MAP_COLUMN_LANES : 1);
+    // padding is never written, stays 255
+    std::vector<uint8_t> line (size, 255), prefix (size), suffix (size);
+
+    for (uint32_t i = begin; i < end; ++i) {
+        if (_column)
+            filter_columns (i * XCAM_SOFT_MAP_COLUMN_LANES, get_lanes (i), &line[0], &prefix[0], &suffix[0]);
+        else
+            filter_row (i, &line[0], &prefix[0], &suffix[0]);
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftDefogMinFilter::filter_row (uint32_t y, uint8_t *line, uint8_t *prefix, uint8_t *suffix)
+{
+    const uint32_t window = _radius * 2 + 1;
+
+    memcpy (line + _radius, _src + (size_t)y * _width, _width);
+
+    for (uint32_t start = 0; start < _padded; start += window) {
+        uint32_t last = start + window - 1;
+        prefix[start] = line[start];
+        for (uint32_t i = start + 1; i <= last; ++i)
+            prefix[i] = XCAM_MIN (prefix[i - 1], line[i]);
+        suffix[last] = line[last];
+        for (uint32_t i = last; i > start; --i)
+            suffix[i - 1] = XCAM_MIN (suffix[i], line[i - 1]);
+    }
+
+    uint8_t *dst = _dst + (size_t)y * _width;
+    for (uint32_t i = 0; i < _width; ++i)
+        dst[i] = XCAM_MIN (suffix[i], prefix[i + _radius * 2]);
+}
+
+void
+SoftDefogMinFilter::filter_columns (
+    uint32_t x, uint32_t lanes, uint8_t *line, uint8_t *prefix, uint8_t *suffix)
+{
+    const uint32_t window = _radius * 2 + 1;
+    const uint32_t step = XCAM_SOFT_MAP_COLUMN_LANES;
+
+    for (uint32_t y = 0; y < _height; ++y)
+        memcpy (line + (size_t)(_radius + y) * step, _src + (size_t)y * _width + x, lanes);
+
+    for (uint32_t start = 0; start < _padded; start += window) {
+        uint32_t last = start + window - 1;
+        memcpy (prefix + (size_t)start * step, line + (size_t)start * step, lanes);
+        for (uint32_t i = start + 1; i <= last; ++i) {
+            uint8_t *cur = prefix + (size_t)i * step;
+            const uint8_t *prev = cur - step, *in = line + (size_t)i * step;
+            for (uint32_t k = 0; k < lanes; ++k)
+                cur[k] = XCAM_MIN (prev[k], in[k]);
+        }
+        memcpy (suffix + (size_t)last * step, line + (size_t)last * step, lanes);
+        for (uint32_t i = last; i > start; --i) {
+            uint8_t *cur = suffix + (size_t)(i - 1) * step;
+            const uint8_t *next = cur + step, *in = line + (size_t)(i - 1) * step;
+            for (uint32_t k = 0; k < lanes; ++k)
+                cur[k] = XCAM_MIN (next[k], in[k]);
+        }
+    }
+
+    for (uint32_t y = 0; y < _height; ++y) {
+        const uint8_t *left = suffix + (size_t)y * step;
+        const uint8_t *right = prefix + (size_t)(y + _radius * 2) * step;
+        uint8_t *dst = _dst + (size_t)y * _width + x;
+        for (uint32_t k = 0; k < lanes; ++k)
+            dst[k] = XCAM_MIN (left[k], right[k]);
+    }
+}
+
+/*
+ * per pixel rows of the guided filter, pass inputs or coefficients:
+ *   inputs: p = 1 - coeff * dark / airlight, I * p, I * I
+ *   coeffs: a = cov (I, p) / (var (I) + eps), b = mean (p) - a * mean (I)
+ */
+class SoftDefogGuidedRows
+    : public ParallelFunc
+{
+public:
+    enum Pass {
+        PassInputs,
+        PassCoeffs,
+    };
+
+    SoftDefogGuidedRows (Pass pass, uint32_t width, float airlight, float eps)
+        : _pass (pass), _width (width), _airlight (airlight), _eps (eps)
+        , dark (NULL), guide (NULL), transmit (NULL)
+        , guide_transmit (NULL), guide_square (NULL), coeff_a (NULL), coeff_b (NULL)
+    {}
+
+    virtual XCamReturn work_range (uint32_t begin, uint32_t end);
+
+private:
+    Pass               _pass;
+    uint32_t           _width;
+    float              _airlight;
+    float              _eps;
+
+public:
+    const uint8_t     *dark;
+    float             *guide;
+    float             *transmit;
+    float             *guide_transmit;
+    float             *guide_square;
+    float             *coeff_a;
+    float             *coeff_b;
+};
+
+XCamReturn
+SoftDefogGuidedRows::work_range (uint32_t begin, uint32_t end)
+{
+    const float dark_scale = SOFT_DEFOG_TRANSMIT_COEFF / _airlight;
+
+    for (size_t i = (size_t)begin * _width; i < (size_t)end * _width; ++i) {
+        if (_pass == PassInputs) {
+            float p = 1.0f - dark[i] * dark_scale;
+            transmit[i] = p;
+            guide_transmit[i] = guide[i] * p;
+            guide_square[i] = guide[i] * guide[i];
+        } else {
+            float mean_i = guide[i], mean_p = transmit[i];
+            float a = (guide_transmit[i] - mean_i * mean_p) / (guide_square[i] - mean_i * mean_i + _eps);
+            coeff_a[i] = a;
+            coeff_b[i] = mean_p - a * mean_i;
+        }
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SoftDarkChannelKernel::SoftDarkChannelKernel (SoftDefogDcpImageHandler *handler)
+    : SoftImageKernel ("soft_defog_dark_channel")
+    , _handler (handler)
+{
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, 0);
+}
+
+XCamReturn
+SoftDarkChannelKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    work_width = _handler->_map_width;
+    work_height = _handler->_map_height;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+uint32_t
+SoftDarkChannelKernel::get_bytes_per_pixel () const
+{
+    // scale x scale block of NV12 in, dark and guide out
+    uint32_t scale = _handler->_scale;
+    return scale * scale * 3 / 2 + 5;
+}
+
+XCamReturn
+SoftDarkChannelKernel::work_tile (const ImageTile &tile)
+{
+    const SoftImagePlane &in_y = _in.get_plane (0);
+    const SoftImagePlane &in_uv = _in.get_plane (1);
+    const uint32_t scale = _handler->_scale;
+    const uint32_t map_width = _handler->_map_width;
+    const uint32_t width = in_y.width, height = in_y.height;
+    std::vector<uint32_t> block_min (tile.width), block_sum (tile.width);
+
+    XCAM_ASSERT (tile.x == 0 && tile.width == map_width);
+
+    for (uint32_t my = tile.y; my < tile.y + tile.height; ++my) {
+        uint32_t y_begin = my * scale, y_end = XCAM_MIN (y_begin + scale, height);
+
+        for (uint32_t mx = 0; mx < map_width; ++mx) {
+            block_min[mx] = 255;
+            block_sum[mx] = 0;
+        }
+
+        for (uint32_t y = y_begin; y < y_end; y += 2) {
+            const uint8_t *y0 = in_y.row (y), *y1 = in_y.row (y + 1);
+            const uint8_t *uv = in_uv.row (y / 2);
+
+            for (uint32_t x = 0; x < width; x += 2) {
+                int32_t u = uv[x] - 128, v = uv[x + 1] - 128;
+                // min (r, g, b) - y of the 2x2 block, BT.601 in 10-bit fixed point
+                int32_t cr = 1436 * v;
+                int32_t cg = -352 * u - 731 * v;
+                int32_t cb = 1815 * u;
+                int32_t chroma_min = (XCAM_MIN (XCAM_MIN (cr, cg), cb) + 512) >> 10;
+                uint32_t luma_min = XCAM_MIN (XCAM_MIN (y0[x], y0[x + 1]), XCAM_MIN (y1[x], y1[x + 1]));
+                int32_t dark = XCAM_MAX (XCAM_MIN ((int32_t)luma_min + chroma_min, 255), 0);
+                uint32_t mx = x / scale;
+
+                block_min[mx] = XCAM_MIN (block_min[mx], (uint32_t)dark);
+                block_sum[mx] += y0[x] + y0[x + 1] + y1[x] + y1[x + 1];
+            }
+        }
+
+        uint8_t *dark = &_handler->_dark[(size_t)my * map_width];
+        float *guide = &_handler->_guide[(size_t)my * map_width];
+        for (uint32_t mx = 0; mx < map_width; ++mx) {
+            uint32_t block_width = XCAM_MIN (mx * scale + scale, width) - mx * scale;
+            dark[mx] = (uint8_t)block_min[mx];
+            guide[mx] = block_sum[mx] / (255.0f * block_width * (y_end - y_begin));
+        }
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SoftDefogTransmitKernel::SoftDefogTransmitKernel (SoftDefogDcpImageHandler *handler)
+    : SoftImageKernel ("soft_defog_transmit")
+    , _handler (handler)
+{
+    // whole map in one tile, passes inside are parallel
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, XCAM_SOFT_TILE_FULL_WIDTH);
+}
+
+XCamReturn
+SoftDefogTransmitKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    work_width = _handler->_map_width;
+    work_height = _handler->_map_height;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftDefogTransmitKernel::work_tile (const ImageTile &tile)
+{
+    SoftDefogDcpImageHandler *handler = _handler;
+    SmartPtr<ThreadPool> pool = ThreadPool::instance ();
+    const uint32_t width = tile.width, height = tile.height;
+    const uint32_t scale = handler->_scale;
+    const uint32_t patch_radius = XCAM_MAX ((handler->_patch_radius + scale / 2) / scale, 1u);
+    const uint32_t guide_radius = XCAM_MAX ((handler->_guide_radius + scale / 2) / scale, 1u);
+    float *tmp = &handler->_box_tmp[0];
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    XCAM_ASSERT (width == handler->_map_width && height == handler->_map_height);
+
+    ret = soft_filter_map<SoftDefogMinFilter> (&handler->_dark[0], &handler->_dark_tmp[0], width, height, patch_radius);
+    XCAM_FAIL_RETURN (
+        WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+        "soft defog min filter failed");
+
+    handler->update_airlight ();
+
+    SoftDefogGuidedRows inputs (
+        SoftDefogGuidedRows::PassInputs, width, handler->_airlight, handler->_guide_eps);
+    inputs.dark = &handler->_dark[0];
+    inputs.guide = &handler->_guide[0];
+    inputs.transmit = &handler->_transmit[0];
+    inputs.guide_transmit = &handler->_guide_transmit[0];
+    inputs.guide_square = &handler->_guide_square[0];
+    ret = pool->parallel_for (height, inputs, SOFT_DEFOG_ROW_GRAIN);
+    XCAM_FAIL_RETURN (
+        WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+        "soft defog guided filter inputs failed");
+
+    float *means[] = {inputs.guide, inputs.transmit, inputs.guide_transmit, inputs.guide_square};
+    for (uint32_t i = 0; i < sizeof (means) / sizeof (means[0]); ++i) {
+        ret = soft_filter_map<SoftBoxFilter> (means[i], tmp, width, height, guide_radius);
+        XCAM_FAIL_RETURN (
+            WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+            "soft defog box filter failed");
+    }
+
+    SoftDefogGuidedRows coeffs (
+        SoftDefogGuidedRows::PassCoeffs, width, handler->_airlight, handler->_guide_eps);
+    coeffs.guide = inputs.guide;
+    coeffs.transmit = inputs.transmit;
+    coeffs.guide_transmit = inputs.guide_transmit;
+    coeffs.guide_square = inputs.guide_square;
+    coeffs.coeff_a = &handler->_coeff_a[0];
+    coeffs.coeff_b = &handler->_coeff_b[0];
+    ret = pool->parallel_for (height, coeffs, SOFT_DEFOG_ROW_GRAIN);
+    XCAM_FAIL_RETURN (
+        WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+        "soft defog guided filter coeffs failed");
+
+    ret = soft_filter_map<SoftBoxFilter> (coeffs.coeff_a, tmp, width, height, guide_radius);
+    if (ret == XCAM_RETURN_NO_ERROR)
+        ret = soft_filter_map<SoftBoxFilter> (coeffs.coeff_b, tmp, width, height, guide_radius);
+    XCAM_FAIL_RETURN (
+        WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+        "soft defog box filter failed");
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SoftDefogRecoverKernel::SoftDefogRecoverKernel (SoftDefogDcpImageHandler *handler)
+    : SoftImageKernel ("soft_defog_recover")
+    , _handler (handler)
+    , _funcs (NULL)
+{
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, 0);
+}
+
+XCamReturn
+SoftDefogRecoverKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    // pairs of luma rows sharing one chroma row
+    work_width = _handler->_width;
+    work_height = _handler->_height / 2;
+    _funcs = &get_soft_defog_funcs (soft_simd_level ());
+    return XCAM_RETURN_NO_ERROR;
+}
+
+uint32_t
+SoftDefogRecoverKernel::get_bytes_per_pixel () const
+{
+    // two luma rows and a chroma row of input and output
+    return 3 * 2;
+}
+
+XCamReturn
+SoftDefogRecoverKernel::work_tile (const ImageTile &tile)
+{
+    const SoftDefogDcpImageHandler *handler = _handler;
+    XCAM_ASSERT (_funcs);
+    const SoftImagePlane &in_y = _in.get_plane (0);
+    const SoftImagePlane &in_uv = _in.get_plane (1);
+    const SoftImagePlane &out_y = _out.get_plane (0);
+    const SoftImagePlane &out_uv = _out.get_plane (1);
+    const uint32_t map_width = handler->_map_width, map_height = handler->_map_height;
+    const float inv_scale = 1.0f / handler->_scale;
+    const float airlight = handler->_airlight;
+    const uint32_t *map_x = &handler->_map_x[0];
+    const float *map_fx = &handler->_map_fx[0];
+    // one more column so the last map column interpolates with itself
+    std::vector<float> row_a (map_width + 1), row_b (map_width + 1);
+    std::vector<float> full_a (tile.width), full_b (tile.width);
+    std::vector<float> inv_t (tile.width * 2);
+
+    XCAM_ASSERT (tile.x == 0 && tile.width == in_y.width);
+
+    for (uint32_t pair = tile.y; pair < tile.y + tile.height; ++pair) {
+        for (uint32_t k = 0; k < 2; ++k) {
+            uint32_t y = pair * 2 + k;
+            float sy = XCAM_MIN (XCAM_MAX ((y + 0.5f) * inv_scale - 0.5f, 0.0f), (float)(map_height - 1));
+            uint32_t y0 = (uint32_t)sy, y1 = XCAM_MIN (y0 + 1, map_height - 1);
+            float fy = sy - y0;
+            const float *a0 = &handler->_coeff_a[(size_t)y0 * map_width];
+            const float *a1 = &handler->_coeff_a[(size_t)y1 * map_width];
+            const float *b0 = &handler->_coeff_b[(size_t)y0 * map_width];
+            const float *b1 = &handler->_coeff_b[(size_t)y1 * map_width];
+            for (uint32_t mx = 0; mx < map_width; ++mx) {
+                row_a[mx] = a0[mx] + (a1[mx] - a0[mx]) * fy;
+                row_b[mx] = b0[mx] + (b1[mx] - b0[mx]) * fy;
+            }
+            row_a[map_width] = row_a[map_width - 1];
+            row_b[map_width] = row_b[map_width - 1];
+
+            for (uint32_t x = 0; x < tile.width; ++x) {
+                uint32_t mx = map_x[x];
+                float fx = map_fx[x];
+                full_a[x] = row_a[mx] + (row_a[mx + 1] - row_a[mx]) * fx;
+                full_b[x] = row_b[mx] + (row_b[mx + 1] - row_b[mx]) * fx;
+            }
+
+            _funcs->luma (
+                in_y.row (y), &full_a[0], &full_b[0], airlight,
+                &inv_t[k * tile.width], out_y.row (y), tile.width);
+        }
+        _funcs->chroma (in_uv.row (pair), &inv_t[0], &inv_t[tile.width], out_uv.row (pair), tile.width);
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SoftDefogDcpImageHandler::SoftDefogDcpImageHandler (const char *name)
+    : SoftImageHandler (name)
+    , _patch_radius (XCAM_SOFT_DEFOG_PATCH_RADIUS)
+    , _guide_radius (XCAM_SOFT_DEFOG_GUIDE_RADIUS)
+    , _guide_eps (XCAM_SOFT_DEFOG_GUIDE_EPS)
+    , _airlight (-1.0f)
+    , _width (0)
+    , _height (0)
+    , _scale (2)
+    , _map_width (0)
+    , _map_height (0)
+{
+}
+
+bool
+SoftDefogDcpImageHandler::set_patch_radius (uint32_t radius)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, radius > 0, false,
+        "soft defog handler(%s) patch radius must be positive", XCAM_STR (get_name ()));
+    _patch_radius = radius;
+    return true;
+}
+
+bool
+SoftDefogDcpImageHandler::set_guided_filter (uint32_t radius, float eps)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, radius > 0 && eps > 0.0f, false,
+        "soft defog handler(%s) guided filter radius(%d) and eps(%f) must be positive",
+        XCAM_STR (get_name ()), radius, eps);
+    _guide_radius = radius;
+    _guide_eps = eps;
+    return true;
+}
+
+/*
+ * reduce by 4 from 720p up, by 2 below. scale is even so every
+ * block holds whole chroma samples.
+ */
+void
+SoftDefogDcpImageHandler::init_maps (uint32_t width, uint32_t height)
+{
+    _width = width;
+    _height = height;
+    _scale = (width >= 1280) ? 4 : 2;
+    _map_width = (width + _scale - 1) / _scale;
+    _map_height = (height + _scale - 1) / _scale;
+
+    size_t count = (size_t)_map_width * _map_height;
+    _dark.resize (count);
+    _dark_tmp.resize (count);
+    _guide.resize (count);
+    _transmit.resize (count);
+    _guide_transmit.resize (count);
+    _guide_square.resize (count);
+    _coeff_a.resize (count);
+    _coeff_b.resize (count);
+    _box_tmp.resize (count);
+
+    _map_x.resize (width);
+    _map_fx.resize (width);
+    for (uint32_t x = 0; x < width; ++x) {
+        float sx = XCAM_MIN (XCAM_MAX ((x + 0.5f) / _scale - 0.5f, 0.0f), (float)(_map_width - 1));
+        _map_x[x] = (uint32_t)sx;
+        _map_fx[x] = sx - _map_x[x];
+    }
+    _airlight = -1.0f;
+
+    XCAM_LOG_DEBUG (
+        "soft defog handler(%s) %dx%d, transmission map %dx%d",
+        XCAM_STR (get_name ()), width, height, _map_width, _map_height);
+}
+
+/*
+ * mean luma of the haziest SOFT_DEFOG_AIRLIGHT_PERCENT of min filtered
+ * dark channel, as gray airlight. smoothed over frames so the
+ * recovered brightness does not flicker.
+ */
+void
+SoftDefogDcpImageHandler::update_airlight ()
+{
+    const size_t count = _dark.size ();
+    uint32_t hist[256];
+    float sum = 0.0f;
+    uint32_t selected = 0, threshold = 255;
+
+    xcam_mem_clear (hist);
+    for (size_t i = 0; i < count; ++i)
+        ++hist[_dark[i]];
+
+    uint32_t expect = XCAM_MAX ((uint32_t)(count * SOFT_DEFOG_AIRLIGHT_PERCENT / 100.0f), 1u);
+    for (uint32_t top = hist[255]; threshold > 0 && top < expect; top += hist[threshold])
+        --threshold;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (_dark[i] >= threshold) {
+            sum += _guide[i];
+            ++selected;
+        }
+    }
+
+    float airlight = XCAM_MAX (sum * 255.0f / selected, SOFT_DEFOG_AIRLIGHT_MIN);
+    if (_airlight < 0.0f)
+        _airlight = airlight;
+    else
+        _airlight += (airlight - _airlight) * SOFT_DEFOG_AIRLIGHT_WEIGHT;
+}
+
+XCamReturn
+SoftDefogDcpImageHandler::prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    const VideoBufferInfo &in_info = input->get_video_info ();
+    const VideoBufferInfo &out_info = output->get_video_info ();
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in_info.format == V4L2_PIX_FMT_NV12 && out_info.format == V4L2_PIX_FMT_NV12,
+        XCAM_RETURN_ERROR_PARAM,
+        "soft defog handler(%s) only supports NV12, input %s, output %s",
+        XCAM_STR (get_name ()),
+        xcam_fourcc_to_string (in_info.format), xcam_fourcc_to_string (out_info.format));
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in_info.width == out_info.width && in_info.height == out_info.height &&
+        !(in_info.width % 2) && !(in_info.height % 2),
+        XCAM_RETURN_ERROR_PARAM,
+        "soft defog handler(%s) input(%dx%d) and output(%dx%d) must be same even size",
+        XCAM_STR (get_name ()),
+        in_info.width, in_info.height, out_info.width, out_info.height);
+
+    if (in_info.width != _width || in_info.height != _height)
+        init_maps (in_info.width, in_info.height);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SmartPtr<SoftImageHandler>
+create_soft_defog_dcp_image_handler ()
+{
+    SmartPtr<SoftDefogDcpImageHandler> defog_handler;
+    SmartPtr<SoftImageKernel> kernel;
+
+    defog_handler = new SoftDefogDcpImageHandler ("soft_defog_dcp_handler");
+
+    kernel = new SoftDarkChannelKernel (defog_handler.ptr ());
+    defog_handler->add_kernel (kernel);
+    kernel = new SoftDefogTransmitKernel (defog_handler.ptr ());
+    defog_handler->add_kernel (kernel);
+    kernel = new SoftDefogRecoverKernel (defog_handler.ptr ());
+    defog_handler->add_kernel (kernel);
+
+    return defog_handler;
+}
+
+};
@@ -0,0 +1,179 @@
+/*
+ * soft_defog_dcp_handler.h - CPU defog handler by dark channel prior
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_DEFOG_DCP_HANDLER_H
+#define XCAM_SOFT_DEFOG_DCP_HANDLER_H
+
+#include "xcam_utils.h"
+#include "soft_image_handler.h"
+#include "soft_defog_simd.h"
+#include <vector>
+
+// radii in full resolution pixels, same patch as kernel_min_filter
+#define XCAM_SOFT_DEFOG_PATCH_RADIUS   8
+#define XCAM_SOFT_DEFOG_GUIDE_RADIUS   32
+#define XCAM_SOFT_DEFOG_GUIDE_EPS      0.001f
+
+namespace XCam {
+
+class SoftDefogDcpImageHandler;
+
+/*
+ * one pixel per scale x scale block: minimum of min (r, g, b) and
+ * mean luma as guide of the transmission map.
+ */
+class SoftDarkChannelKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftDarkChannelKernel (SoftDefogDcpImageHandler *handler);
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual uint32_t get_bytes_per_pixel () const;
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCAM_DEAD_COPY (SoftDarkChannelKernel);
+
+private:
+    SoftDefogDcpImageHandler     *_handler;
+};
+
+/*
+ * transmission of the reduced map in one tile, each pass inside is
+ * spread over the pool: separable van Herk/Gil-Werman min filter,
+ * atmospheric light and box based guided filter. cost per pixel is
+ * independent of both radii.
+ */
+class SoftDefogTransmitKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftDefogTransmitKernel (SoftDefogDcpImageHandler *handler);
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCAM_DEAD_COPY (SoftDefogTransmitKernel);
+
+private:
+    SoftDefogDcpImageHandler     *_handler;
+};
+
+/*
+ * full resolution pass, transmission t = a * I + b from bilinear
+ * upsampled guided filter coefficients. airlight is gray as in CL,
+ * so recovering in rgb is the same as Y' = A + (Y - A) / t and
+ * UV' = 128 + (UV - 128) / t, no rgb round trip.
+ */
+class SoftDefogRecoverKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftDefogRecoverKernel (SoftDefogDcpImageHandler *handler);
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual uint32_t get_bytes_per_pixel () const;
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCAM_DEAD_COPY (SoftDefogRecoverKernel);
+
+private:
+    SoftDefogDcpImageHandler     *_handler;
+    const SoftDefogFuncs         *_funcs;
+};
+
+/*
+ * CPU counterpart of CLDefogDcpImageHandler, NV12 only.
+ * transmission is estimated on a map reduced by get_scale () and
+ * refined by a guided filter in place of the bilateral filter.
+ */
+class SoftDefogDcpImageHandler
+    : public SoftImageHandler
+{
+    friend class SoftDarkChannelKernel;
+    friend class SoftDefogTransmitKernel;
+    friend class SoftDefogRecoverKernel;
+
+public:
+    explicit SoftDefogDcpImageHandler (const char *name);
+
+    bool set_patch_radius (uint32_t radius);
+    bool set_guided_filter (uint32_t radius, float eps);
+
+    uint32_t get_scale () const {
+        return _scale;
+    }
+    float get_airlight () const {
+        return _airlight;
+    }
+
+protected:
+    virtual XCamReturn prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+
+private:
+    void init_maps (uint32_t width, uint32_t height);
+    void update_airlight ();
+
+    XCAM_DEAD_COPY (SoftDefogDcpImageHandler);
+
+private:
+    uint32_t                    _patch_radius;
+    uint32_t                    _guide_radius;
+    float                       _guide_eps;
+    // averaged over frames, < 0 until first estimation
+    float                       _airlight;
+
+    uint32_t                    _width;
+    uint32_t                    _height;
+    uint32_t                    _scale;
+    uint32_t                    _map_width;
+    uint32_t                    _map_height;
+    std::vector<uint8_t>        _dark;
+    std::vector<uint8_t>        _dark_tmp;
+    std::vector<float>          _guide;
+    std::vector<float>          _transmit;
+    std::vector<float>          _guide_transmit;  // I * p
+    std::vector<float>          _guide_square;    // I * I
+    std::vector<float>          _coeff_a;
+    std::vector<float>          _coeff_b;
+    std::vector<float>          _box_tmp;
+    // bilinear source column and weight of each output column
+    std::vector<uint32_t>       _map_x;
+    std::vector<float>          _map_fx;
+};
+
+SmartPtr<SoftImageHandler>
+create_soft_defog_dcp_image_handler ();
+
+};
+
+#endif //XCAM_SOFT_DEFOG_DCP_HANDLER_H
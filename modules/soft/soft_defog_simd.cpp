@@ -0,0 +1,181 @@
+/*
+ * soft_defog_simd.cpp - row functions of CPU defog recover
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_defog_simd.h"
+
+#if XCAM_SOFT_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace XCam {
+
+// same float steps in every path, so all levels give identical output
+static inline uint8_t
+round_u8 (float value)
+{
+    value = XCAM_MIN (value + 0.5f, 255.0f);
+    return (uint8_t)XCAM_MAX (value, 0.0f);
+}
+
+static void
+luma_row_c (
+    const uint8_t *src, const float *a, const float *b, float airlight,
+    float *inv_t, uint8_t *out, uint32_t x, uint32_t width)
+{
+    for (; x < width; ++x) {
+        float t = a[x] * (float)src[x] * (1.0f / 255.0f) + b[x];
+        t = XCAM_MIN (XCAM_MAX (t, XCAM_SOFT_DEFOG_TRANSMIT_MIN), 1.0f);
+        inv_t[x] = 1.0f / t;
+        out[x] = round_u8 (airlight + ((float)src[x] - airlight) * inv_t[x]);
+    }
+}
+
+static void
+chroma_row_c (
+    const uint8_t *src, const float *inv_t0, const float *inv_t1,
+    uint8_t *out, uint32_t x, uint32_t width)
+{
+    for (; x < width; x += 2) {
+        float inv = ((inv_t0[x] + inv_t0[x + 1]) + (inv_t1[x] + inv_t1[x + 1])) * 0.25f;
+        out[x] = round_u8 (128.0f + ((float)src[x] - 128.0f) * inv);
+        out[x + 1] = round_u8 (128.0f + ((float)src[x + 1] - 128.0f) * inv);
+    }
+}
+
+static void
+luma_c (
+    const uint8_t *src, const float *a, const float *b, float airlight,
+    float *inv_t, uint8_t *out, uint32_t width)
+{
+    luma_row_c (src, a, b, airlight, inv_t, out, 0, width);
+}
+
+static void
+chroma_c (
+    const uint8_t *src, const float *inv_t0, const float *inv_t1,
+    uint8_t *out, uint32_t width)
+{
+    chroma_row_c (src, inv_t0, inv_t1, out, 0, width);
+}
+
+static const SoftDefogFuncs defog_funcs_c = {
+    luma_c,
+    chroma_c,
+};
+
+#if XCAM_SOFT_SIMD_X86
+
+XCAM_SOFT_TARGET_SSE41 static inline __m128
+load_u8x4_sse (const uint8_t *src)
+{
+    int32_t bytes;
+    memcpy (&bytes, src, sizeof (bytes));
+    return _mm_cvtepi32_ps (_mm_cvtepu8_epi32 (_mm_cvtsi32_si128 (bytes)));
+}
+
+// 8 values as round_u8, truncation after clipping to [0, 255]
+XCAM_SOFT_TARGET_SSE41 static inline void
+store_u8x8_sse (uint8_t *out, __m128 lo, __m128 hi)
+{
+    const __m128 half = _mm_set1_ps (0.5f);
+    const __m128 max = _mm_set1_ps (255.0f);
+    const __m128 zero = _mm_setzero_ps ();
+    lo = _mm_max_ps (_mm_min_ps (_mm_add_ps (lo, half), max), zero);
+    hi = _mm_max_ps (_mm_min_ps (_mm_add_ps (hi, half), max), zero);
+    __m128i words = _mm_packs_epi32 (_mm_cvttps_epi32 (lo), _mm_cvttps_epi32 (hi));
+    _mm_storel_epi64 ((__m128i *)out, _mm_packus_epi16 (words, words));
+}
+
+XCAM_SOFT_TARGET_SSE41 static inline __m128
+recover_sse (
+    __m128 y, const float *a, const float *b, __m128 airlight, float *inv_t)
+{
+    const __m128 scale = _mm_set1_ps (1.0f / 255.0f);
+    __m128 t = _mm_add_ps (_mm_mul_ps (_mm_mul_ps (_mm_loadu_ps (a), y), scale), _mm_loadu_ps (b));
+    t = _mm_min_ps (_mm_max_ps (t, _mm_set1_ps (XCAM_SOFT_DEFOG_TRANSMIT_MIN)), _mm_set1_ps (1.0f));
+    __m128 inv = _mm_div_ps (_mm_set1_ps (1.0f), t);
+    _mm_storeu_ps (inv_t, inv);
+    return _mm_add_ps (airlight, _mm_mul_ps (_mm_sub_ps (y, airlight), inv));
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+luma_sse (
+    const uint8_t *src, const float *a, const float *b, float airlight,
+    float *inv_t, uint8_t *out, uint32_t width)
+{
+    const __m128 air = _mm_set1_ps (airlight);
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        __m128 lo = recover_sse (load_u8x4_sse (src + x), a + x, b + x, air, inv_t + x);
+        __m128 hi = recover_sse (load_u8x4_sse (src + x + 4), a + x + 4, b + x + 4, air, inv_t + x + 4);
+        store_u8x8_sse (out + x, lo, hi);
+    }
+    luma_row_c (src, a, b, airlight, inv_t, out, x, width);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+chroma_sse (
+    const uint8_t *src, const float *inv_t0, const float *inv_t1,
+    uint8_t *out, uint32_t width)
+{
+    const __m128 quarter = _mm_set1_ps (0.25f);
+    const __m128 center = _mm_set1_ps (128.0f);
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        // horizontal pairs of each row, then both rows, as chroma_row_c
+        __m128 pair0 = _mm_hadd_ps (_mm_loadu_ps (inv_t0 + x), _mm_loadu_ps (inv_t0 + x + 4));
+        __m128 pair1 = _mm_hadd_ps (_mm_loadu_ps (inv_t1 + x), _mm_loadu_ps (inv_t1 + x + 4));
+        __m128 inv = _mm_mul_ps (_mm_add_ps (pair0, pair1), quarter);
+
+        __m128 uv_lo = _mm_sub_ps (load_u8x4_sse (src + x), center);
+        __m128 uv_hi = _mm_sub_ps (load_u8x4_sse (src + x + 4), center);
+        uv_lo = _mm_add_ps (center, _mm_mul_ps (uv_lo, _mm_unpacklo_ps (inv, inv)));
+        uv_hi = _mm_add_ps (center, _mm_mul_ps (uv_hi, _mm_unpackhi_ps (inv, inv)));
+        store_u8x8_sse (out + x, uv_lo, uv_hi);
+    }
+    chroma_row_c (src, inv_t0, inv_t1, out, x, width);
+}
+
+static const SoftDefogFuncs defog_funcs_sse41 = {
+    luma_sse,
+    chroma_sse,
+};
+
+#endif //XCAM_SOFT_SIMD_X86
+
+const SoftDefogFuncs &
+get_soft_defog_funcs (SoftSimdLevel level)
+{
+    switch (level) {
+#if XCAM_SOFT_SIMD_X86
+    case SoftSimdAVX2:
+    case SoftSimdSSE41:
+        return defog_funcs_sse41;
+#endif
+    default:
+        break;
+    }
+    // no neon rows, armv7 neon has no float division
+    return defog_funcs_c;
+}
+
+};
@@ -0,0 +1,59 @@
+/*
+ * soft_defog_simd.h - row functions of CPU defog recover
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_DEFOG_SIMD_H
+#define XCAM_SOFT_DEFOG_SIMD_H
+
+#include "xcam_utils.h"
+#include "soft_simd.h"
+
+// lower bound of transmission, same as kernel_defog_recover
+#define XCAM_SOFT_DEFOG_TRANSMIT_MIN  0.1f
+
+namespace XCam {
+
+/*
+ * luma row: t = a * y / 255 + b clipped to [TRANSMIT_MIN, 1],
+ * out = airlight + (y - airlight) / t, 1 / t is kept in @inv_t.
+ * @a, @b are upsampled guided filter coefficients, @width in pixels.
+ */
+typedef void (*SoftDefogLumaFunc) (
+    const uint8_t *src, const float *a, const float *b, float airlight,
+    float *inv_t, uint8_t *out, uint32_t width);
+
+/*
+ * interleaved uv row: out = 128 + (uv - 128) * mean of 1 / t over
+ * the 2x2 luma block, from @inv_t0 and @inv_t1 of both luma rows.
+ * @width in bytes.
+ */
+typedef void (*SoftDefogChromaFunc) (
+    const uint8_t *src, const float *inv_t0, const float *inv_t1,
+    uint8_t *out, uint32_t width);
+
+struct SoftDefogFuncs {
+    SoftDefogLumaFunc      luma;
+    SoftDefogChromaFunc    chroma;
+};
+
+const SoftDefogFuncs &get_soft_defog_funcs (SoftSimdLevel level);
+
+};
+
+#endif //XCAM_SOFT_DEFOG_SIMD_H
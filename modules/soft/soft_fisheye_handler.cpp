@@ -0,0 +1,275 @@
+/*
+ * soft_fisheye_handler.cpp - CPU fisheye handler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_fisheye_handler.h"
+#include <math.h>
+#include <vector>
+
+namespace XCam {
+
+// everything the table depends on, compared byte by byte with table files
+struct FisheyeTableKey {
+    float       lens[5];
+    float       range[3];
+    uint32_t    sizes[4];
+    uint32_t    table_scale;
+};
+
+static uint32_t
+hash_key (const void *key, uint32_t size)
+{
+    // FNV-1a
+    const uint8_t *bytes = (const uint8_t *)key;
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// same as calculate_fisheye_pos of kernel_fisheye.cl, angles in radian
+static GeoPos
+calculate_fisheye_pos (double longitude, double latitude, const FisheyeInfo &info)
+{
+    double z = cos (latitude);
+    double x = sin (latitude) * cos (longitude);
+    double y = sin (latitude) * sin (longitude);
+    double r_angle = acos (y);
+    double r = r_angle * (info.radius * 2.0) / degree2radian (info.wide_angle);
+    double xz_size = sqrt (x * x + z * z);
+    double dst_x = -r * x / xz_size;
+    double dst_y = -r * z / xz_size;
+    double rotate = degree2radian (info.rotate_angle);
+
+    GeoPos pos;
+    pos.x = cos (rotate) * dst_x - sin (rotate) * dst_y + info.center_x;
+    pos.y = sin (rotate) * dst_x + cos (rotate) * dst_y + info.center_y;
+    return pos;
+}
+
+SoftFisheyeHandler::SoftFisheyeHandler (const char *name)
+    : SoftImageHandler (name)
+    , _output_width (0)
+    , _output_height (0)
+    , _range_longitude (180.0f)
+    , _range_latitude (180.0f)
+    , _latitude_offset (0.0f)
+    , _table_dir (NULL)
+    , _table_changed (true)
+{
+}
+
+SoftFisheyeHandler::~SoftFisheyeHandler ()
+{
+    if (_table_dir)
+        xcam_free (_table_dir);
+}
+
+bool
+SoftFisheyeHandler::set_geo_map_kernel (SmartPtr<SoftGeoMapKernel> &kernel)
+{
+    SmartPtr<SoftImageKernel> image_kernel = kernel;
+    add_kernel (image_kernel);
+    _geo_kernel = kernel;
+    return true;
+}
+
+void
+SoftFisheyeHandler::set_output_size (uint32_t width, uint32_t height)
+{
+    _output_width = width;
+    _output_height = height;
+    _table_changed = true;
+}
+
+void
+SoftFisheyeHandler::set_dst_range (float longitude, float latitude)
+{
+    _range_longitude = longitude;
+    _range_latitude = latitude;
+    _table_changed = true;
+}
+
+void
+SoftFisheyeHandler::set_dst_latitude_offset (float offset)
+{
+    _latitude_offset = offset;
+    _table_changed = true;
+}
+
+void
+SoftFisheyeHandler::set_fisheye_info (const FisheyeInfo &info)
+{
+    _fisheye_info = info;
+    _table_changed = true;
+}
+
+void
+SoftFisheyeHandler::set_table_dir (const char *dir)
+{
+    if (_table_dir)
+        xcam_free (_table_dir);
+    _table_dir = (dir && dir[0]) ? strndup (dir, XCAM_MAX_STR_SIZE) : NULL;
+}
+
+XCamReturn
+SoftFisheyeHandler::prepare_buffer_pool_video_info (
+    const VideoBufferInfo &input, VideoBufferInfo &output)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, input.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "SoftFisheyeHandler(%s) input buffer format(%s) is not supported, try NV12",
+        get_name (), xcam_fourcc_to_string (input.format));
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        _output_width && _output_height && !(_output_width % 2) && !(_output_height % 2),
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftFisheyeHandler(%s) output size(%d, %d) should be even and > 0",
+        get_name (), _output_width, _output_height);
+
+    output.init (input.format, _output_width, _output_height);
+    return XCAM_RETURN_NO_ERROR;
+}
+
+bool
+SoftFisheyeHandler::generate_table (SoftGeoMapTable &table, uint32_t in_width, uint32_t in_height)
+{
+    uint32_t table_width = XCAM_ALIGN_UP (_output_width / XCAM_SOFT_FISHEYE_TABLE_SCALE, 4);
+    uint32_t table_height = XCAM_ALIGN_UP (_output_height / XCAM_SOFT_FISHEYE_TABLE_SCALE, 2);
+    float unit_x = _output_width / (float)table_width;
+    float unit_y = _output_height / (float)table_height;
+    double radian_x = degree2radian (_range_longitude) / _output_width;
+    double radian_y = degree2radian (_range_latitude) / _output_height;
+    double center_y = PI / 2.0 + degree2radian (_latitude_offset);
+    const FisheyeInfo &info = _fisheye_info;
+    std::vector<GeoPos> map (table_width * table_height);
+
+    // entries sit at the output pixels SoftGeoMapTable samples them for
+    for (uint32_t j = 0; j < table_height; ++j) {
+        double out_y = (j + 0.5 - table_height / 2.0) * unit_y;
+        for (uint32_t i = 0; i < table_width; ++i) {
+            double out_x = (i + 0.5 - table_width / 2.0) * unit_x;
+            GeoPos pos = calculate_fisheye_pos (out_x * radian_x + PI / 2.0, out_y * radian_y + center_y, info);
+            pos.x = XCAM_MAX (XCAM_MIN (pos.x, (double)(info.center_x + info.radius)), (double)(info.center_x - info.radius));
+            pos.y = XCAM_MAX (XCAM_MIN (pos.y, (double)(info.center_y + info.radius)), (double)(info.center_y - info.radius));
+            map[j * table_width + i] = pos;
+        }
+    }
+
+    return table.generate (
+               &map[0], table_width, table_height, unit_x, unit_y,
+               in_width, in_height, _output_width, _output_height);
+}
+
+XCamReturn
+SoftFisheyeHandler::prepare_table (uint32_t in_width, uint32_t in_height)
+{
+    FisheyeTableKey key;
+    xcam_mem_clear (key);
+    key.lens[0] = _fisheye_info.center_x;
+    key.lens[1] = _fisheye_info.center_y;
+    key.lens[2] = _fisheye_info.wide_angle;
+    key.lens[3] = _fisheye_info.radius;
+    key.lens[4] = _fisheye_info.rotate_angle;
+    key.range[0] = _range_longitude;
+    key.range[1] = _range_latitude;
+    key.range[2] = _latitude_offset;
+    key.sizes[0] = in_width;
+    key.sizes[1] = in_height;
+    key.sizes[2] = _output_width;
+    key.sizes[3] = _output_height;
+    key.table_scale = XCAM_SOFT_FISHEYE_TABLE_SCALE;
+
+    char path[XCAM_MAX_STR_SIZE] = {0};
+    if (_table_dir)
+        snprintf (path, sizeof (path), "%s/soft_fisheye_%08x.table", _table_dir, hash_key (&key, sizeof (key)));
+
+    SmartPtr<SoftGeoMapTable> table = new SoftGeoMapTable;
+    if (path[0] && table->load (path, &key, sizeof (key), in_width, in_height, _output_width, _output_height)) {
+        XCAM_LOG_INFO ("SoftFisheyeHandler(%s) loaded table %s", get_name (), path);
+    } else {
+        XCAM_FAIL_RETURN (
+            WARNING, generate_table (*table.ptr (), in_width, in_height), XCAM_RETURN_ERROR_PARAM,
+            "SoftFisheyeHandler(%s) generate table failed", get_name ());
+        if (path[0] && !table->save (path, &key, sizeof (key)))
+            XCAM_LOG_WARNING ("SoftFisheyeHandler(%s) save table %s failed", get_name (), path);
+    }
+
+    XCAM_FAIL_RETURN (
+        WARNING, _geo_kernel->set_map_table (table), XCAM_RETURN_ERROR_PARAM,
+        "SoftFisheyeHandler(%s) set map table failed", get_name ());
+    _table_changed = false;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftFisheyeHandler::prepare_map_table (uint32_t in_width, uint32_t in_height)
+{
+    XCAM_ASSERT (_geo_kernel.ptr ());
+
+    XCAM_FAIL_RETURN (
+        WARNING, _fisheye_info.is_valid (), XCAM_RETURN_ERROR_PARAM,
+        "SoftFisheyeHandler(%s) fisheye info is not valid, please check", get_name ());
+    XCAM_FAIL_RETURN (
+        WARNING, _range_longitude > 0.0f && _range_latitude > 0.0f, XCAM_RETURN_ERROR_PARAM,
+        "SoftFisheyeHandler(%s) dest latitude and longitude were not set", get_name ());
+    XCAM_FAIL_RETURN (
+        WARNING,
+        _output_width && _output_height && !(_output_width % 2) && !(_output_height % 2),
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftFisheyeHandler(%s) output size(%d, %d) should be even and > 0",
+        get_name (), _output_width, _output_height);
+
+    SmartPtr<SoftGeoMapTable> table = _geo_kernel->get_map_table ();
+    if (_table_changed || !table.ptr () ||
+            table->get_in_width () != in_width || table->get_in_height () != in_height)
+        return prepare_table (in_width, in_height);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SmartPtr<SoftGeoMapTable>
+SoftFisheyeHandler::get_map_table () const
+{
+    XCAM_ASSERT (_geo_kernel.ptr ());
+    return _geo_kernel->get_map_table ();
+}
+
+XCamReturn
+SoftFisheyeHandler::prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCAM_UNUSED (output);
+
+    const VideoBufferInfo &in_info = input->get_video_info ();
+    return prepare_map_table (XCAM_ALIGN_DOWN (in_info.width, 2), XCAM_ALIGN_DOWN (in_info.height, 2));
+}
+
+SmartPtr<SoftImageHandler>
+create_soft_fisheye_handler ()
+{
+    SmartPtr<SoftFisheyeHandler> handler = new SoftFisheyeHandler ();
+    SmartPtr<SoftGeoMapKernel> kernel = new SoftGeoMapKernel ("soft_fisheye");
+    handler->set_geo_map_kernel (kernel);
+    return handler;
+}
+
+};
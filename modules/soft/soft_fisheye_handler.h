@@ -0,0 +1,101 @@
+/*
+ * soft_fisheye_handler.h - CPU fisheye handler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_FISHEYE_HANDLER_H
+#define XCAM_SOFT_FISHEYE_HANDLER_H
+
+#include "xcam_utils.h"
+#include "soft_image_handler.h"
+#include "soft_geo_map_handler.h"
+
+// output pixels per fisheye map entry, same as CLFisheyeHandler
+#define XCAM_SOFT_FISHEYE_TABLE_SCALE  8
+
+namespace XCam {
+
+/*
+ * CPU counterpart of CLFisheyeHandler with map.
+ * fisheye NV12 input is unwrapped to equirectangular output of
+ * dst range by SoftGeoMapKernel. the fixed-point table is generated
+ * once per parameters and, if a table directory is set, loaded from
+ * or saved to a file named by a hash of the parameters.
+ */
+class SoftFisheyeHandler
+    : public SoftImageHandler
+{
+public:
+    explicit SoftFisheyeHandler (const char *name = "soft_fisheye");
+    virtual ~SoftFisheyeHandler ();
+
+    bool set_geo_map_kernel (SmartPtr<SoftGeoMapKernel> &kernel);
+
+    void set_output_size (uint32_t width, uint32_t height);
+    void get_output_size (uint32_t &width, uint32_t &height) const {
+        width = _output_width;
+        height = _output_height;
+    }
+    void set_dst_range (float longitude, float latitude);
+    void get_dst_range (float &longitude, float &latitude) const {
+        longitude = _range_longitude;
+        latitude = _range_latitude;
+    }
+    // degrees the latitude range is moved down from the equator, 0 centers it
+    void set_dst_latitude_offset (float offset);
+    void set_fisheye_info (const FisheyeInfo &info);
+    const FisheyeInfo &get_fisheye_info () const {
+        return _fisheye_info;
+    }
+    // NULL disables table files
+    void set_table_dir (const char *dir);
+
+    // (re)generates the table for @in_width x @in_height input if parameters changed
+    XCamReturn prepare_map_table (uint32_t in_width, uint32_t in_height);
+    SmartPtr<SoftGeoMapTable> get_map_table () const;
+
+protected:
+    virtual XCamReturn prepare_buffer_pool_video_info (
+        const VideoBufferInfo &input,
+        VideoBufferInfo &output);
+    virtual XCamReturn prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+
+private:
+    XCamReturn prepare_table (uint32_t in_width, uint32_t in_height);
+    bool generate_table (SoftGeoMapTable &table, uint32_t in_width, uint32_t in_height);
+
+    XCAM_DEAD_COPY (SoftFisheyeHandler);
+
+private:
+    uint32_t                      _output_width;
+    uint32_t                      _output_height;
+    float                         _range_longitude;
+    float                         _range_latitude;
+    float                         _latitude_offset;
+    FisheyeInfo                   _fisheye_info;
+    char                         *_table_dir;
+    bool                          _table_changed;
+    SmartPtr<SoftGeoMapKernel>    _geo_kernel;
+};
+
+SmartPtr<SoftImageHandler>
+create_soft_fisheye_handler ();
+
+};
+
+#endif //XCAM_SOFT_FISHEYE_HANDLER_H
@@ -0,0 +1,532 @@
+/*
+ * soft_geo_map_handler.cpp - CPU geometry map handler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_geo_map_handler.h"
+#include <math.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#define GEO_FRAC_ONE          (1 << XCAM_SOFT_GEO_FRAC_BITS)
+#define GEO_CHROMA_TILE_WIDTH (XCAM_SOFT_GEO_TILE_WIDTH / 2)
+
+#define GEO_TABLE_FILE_MAGIC    0x54474358  // "XCGT"
+#define GEO_TABLE_FILE_VERSION  1
+#define GEO_TABLE_MAX_KEY_SIZE  1024
+
+namespace XCam {
+
+struct GeoTableFileHeader {
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    entry_size;
+    uint32_t    key_size;
+    uint32_t    in_width;
+    uint32_t    in_height;
+    uint32_t    out_width;
+    uint32_t    out_height;
+    uint32_t    tiles_x;
+    uint32_t    tiles_y;
+};
+
+static inline double
+clamp_coord (double value, double max_value)
+{
+    return value < 0.0 ? 0.0 : (value > max_value ? max_value : value);
+}
+
+// bilinear sample of map at texel coordinates, clamp to edge
+static GeoPos
+sample_geo_map (const GeoPos *map, uint32_t map_width, uint32_t map_height, double mx, double my)
+{
+    mx = clamp_coord (mx, map_width - 1);
+    my = clamp_coord (my, map_height - 1);
+    uint32_t x0 = (uint32_t)mx, y0 = (uint32_t)my;
+    uint32_t x1 = XCAM_MIN (x0 + 1, map_width - 1), y1 = XCAM_MIN (y0 + 1, map_height - 1);
+    double fx = mx - x0, fy = my - y0;
+
+    const GeoPos &p00 = map[y0 * map_width + x0];
+    const GeoPos &p01 = map[y0 * map_width + x1];
+    const GeoPos &p10 = map[y1 * map_width + x0];
+    const GeoPos &p11 = map[y1 * map_width + x1];
+
+    GeoPos pos;
+    pos.x = (p00.x * (1.0 - fx) + p01.x * fx) * (1.0 - fy) + (p10.x * (1.0 - fx) + p11.x * fx) * fy;
+    pos.y = (p00.y * (1.0 - fx) + p01.y * fx) * (1.0 - fy) + (p10.y * (1.0 - fx) + p11.y * fx) * fy;
+    return pos;
+}
+
+// (index, fraction) of a source coordinate, index + 1 stays inside @size
+static inline void
+to_fixed_coord (double coord, uint32_t size, int16_t &index, uint8_t &frac)
+{
+    int32_t value = (int32_t)(clamp_coord (coord, size - 1) * GEO_FRAC_ONE + 0.5);
+    int32_t i = value >> XCAM_SOFT_GEO_FRAC_BITS;
+    int32_t f = value & (GEO_FRAC_ONE - 1);
+
+    if (i >= (int32_t)size - 1) {
+        i = size - 2;
+        f = GEO_FRAC_ONE;
+    }
+    index = (int16_t)i;
+    frac = (uint8_t)f;
+}
+
+static inline void
+set_geo_entry (SoftGeoMapEntry &entry, bool valid, double x, double y, uint32_t width, uint32_t height)
+{
+    if (!valid) {
+        entry.x = entry.y = -1;
+        entry.fx = entry.fy = 0;
+        return;
+    }
+    to_fixed_coord (x, width, entry.x, entry.fx);
+    to_fixed_coord (y, height, entry.y, entry.fy);
+}
+
+SoftGeoMapTable::SoftGeoMapTable ()
+    : _in_width (0)
+    , _in_height (0)
+    , _out_width (0)
+    , _out_height (0)
+    , _tiles_x (0)
+{
+}
+
+bool
+SoftGeoMapTable::generate (
+    const GeoPos *map, uint32_t map_width, uint32_t map_height,
+    float unit_x, float unit_y,
+    uint32_t in_width, uint32_t in_height,
+    uint32_t out_width, uint32_t out_height)
+{
+    XCAM_FAIL_RETURN (
+        WARNING,
+        map && map_width && map_height && unit_x > 0.0f && unit_y > 0.0f,
+        false,
+        "SoftGeoMapTable invalid map(%dx%d) unit(%.2f, %.2f)", map_width, map_height, unit_x, unit_y);
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in_width >= 4 && in_height >= 4 && in_width <= INT16_MAX && in_height <= INT16_MAX &&
+        !(in_width % 2) && !(in_height % 2) &&
+        out_width && out_height && !(out_width % 2) && !(out_height % 2),
+        false,
+        "SoftGeoMapTable unsupported size, input(%dx%d) output(%dx%d)",
+        in_width, in_height, out_width, out_height);
+
+    uint32_t tiles_x = XCAM_ALIGN_UP (out_width, XCAM_SOFT_GEO_TILE_WIDTH) / XCAM_SOFT_GEO_TILE_WIDTH;
+    uint32_t tiles_y = XCAM_ALIGN_UP (out_height, XCAM_SOFT_GEO_TILE_HEIGHT) / XCAM_SOFT_GEO_TILE_HEIGHT;
+    _entries.assign ((size_t)tiles_x * tiles_y * tile_entries (), SoftGeoMapEntry ());
+    _tiles_x = tiles_x;
+
+    // table position of output pixels, kernel_geo_map maps both centers together
+    double step_x = 1.0 / (map_width * unit_x), step_y = 1.0 / (map_height * unit_y);
+    for (uint32_t y = 0; y < out_height; ++y) {
+        double ty = (y - out_height / 2.0) * step_y + 0.5;
+        uint32_t tile_y = y / XCAM_SOFT_GEO_TILE_HEIGHT, ly = y % XCAM_SOFT_GEO_TILE_HEIGHT;
+        bool chroma_row = !(y % 2);
+
+        for (uint32_t x = 0; x < out_width; ++x) {
+            double tx = (x - out_width / 2.0) * step_x + 0.5;
+            uint32_t tile_x = x / XCAM_SOFT_GEO_TILE_WIDTH, lx = x % XCAM_SOFT_GEO_TILE_WIDTH;
+            bool valid = XCAM_MIN (tx, ty) >= 0.0 && XCAM_MAX (tx, ty) <= 1.0;
+            GeoPos pos;
+            if (valid)
+                pos = sample_geo_map (map, map_width, map_height, tx * map_width - 0.5, ty * map_height - 0.5);
+
+            // map values are input pixel positions, pixel centers at +0.5
+            SoftGeoMapEntry *luma = &_entries[(tile_y * tiles_x + tile_x) * tile_entries ()];
+            set_geo_entry (
+                luma[ly * XCAM_SOFT_GEO_TILE_WIDTH + lx], valid,
+                pos.x - 0.5, pos.y - 0.5, in_width, in_height);
+
+            // chroma follows luma of even pixels on even rows
+            if (chroma_row && !(x % 2)) {
+                SoftGeoMapEntry *chroma = luma + XCAM_SOFT_GEO_TILE_WIDTH * XCAM_SOFT_GEO_TILE_HEIGHT;
+                set_geo_entry (
+                    chroma[ly / 2 * GEO_CHROMA_TILE_WIDTH + lx / 2], valid,
+                    pos.x / 2.0 - 0.5, pos.y / 2.0 - 0.5, in_width / 2, in_height / 2);
+            }
+        }
+    }
+
+    _in_width = in_width;
+    _in_height = in_height;
+    _out_width = out_width;
+    _out_height = out_height;
+    return true;
+}
+
+static inline bool
+check_entry (const SoftGeoMapEntry &entry, uint32_t width, uint32_t height)
+{
+    if (entry.x < 0)
+        return true;
+    return entry.x <= (int32_t)width - 2 && entry.y >= 0 && entry.y <= (int32_t)height - 2 &&
+           entry.fx <= GEO_FRAC_ONE && entry.fy <= GEO_FRAC_ONE;
+}
+
+// entries of a loaded file are trusted for memory access only after this
+bool
+SoftGeoMapTable::check_entries () const
+{
+    uint32_t luma_entries = XCAM_SOFT_GEO_TILE_WIDTH * XCAM_SOFT_GEO_TILE_HEIGHT;
+
+    for (size_t i = 0; i < _entries.size (); ++i) {
+        bool is_luma = (i % tile_entries ()) < luma_entries;
+        bool valid = is_luma ?
+                     check_entry (_entries[i], _in_width, _in_height) :
+                     check_entry (_entries[i], _in_width / 2, _in_height / 2);
+        if (!valid)
+            return false;
+    }
+    return true;
+}
+
+bool
+SoftGeoMapTable::save (const char *path, const void *key, uint32_t key_size) const
+{
+    XCAM_FAIL_RETURN (
+        WARNING,
+        path && is_valid () && (key || !key_size) && key_size <= GEO_TABLE_MAX_KEY_SIZE,
+        false,
+        "SoftGeoMapTable save failed, invalid table or key");
+
+    GeoTableFileHeader header;
+    header.magic = GEO_TABLE_FILE_MAGIC;
+    header.version = GEO_TABLE_FILE_VERSION;
+    header.entry_size = sizeof (SoftGeoMapEntry);
+    header.key_size = key_size;
+    header.in_width = _in_width;
+    header.in_height = _in_height;
+    header.out_width = _out_width;
+    header.out_height = _out_height;
+    header.tiles_x = _tiles_x;
+    header.tiles_y = _entries.size () / tile_entries () / _tiles_x;
+
+    // written aside and renamed, readers never see a partial file
+    char temp_path[XCAM_MAX_STR_SIZE];
+    snprintf (temp_path, sizeof (temp_path), "%s.%d.tmp", path, getpid ());
+    FILE *fp = fopen (temp_path, "wb");
+    XCAM_FAIL_RETURN (WARNING, fp, false, "SoftGeoMapTable open %s failed", temp_path);
+
+    bool done =
+        fwrite (&header, sizeof (header), 1, fp) == 1 &&
+        (!key_size || fwrite (key, key_size, 1, fp) == 1) &&
+        fwrite (&_entries[0], sizeof (SoftGeoMapEntry), _entries.size (), fp) == _entries.size ();
+    done = (fclose (fp) == 0) && done;
+
+    if (!done || rename (temp_path, path) != 0) {
+        XCAM_LOG_WARNING ("SoftGeoMapTable write %s failed", path);
+        remove (temp_path);
+        return false;
+    }
+    return true;
+}
+
+bool
+SoftGeoMapTable::load (
+    const char *path, const void *key, uint32_t key_size,
+    uint32_t in_width, uint32_t in_height, uint32_t out_width, uint32_t out_height)
+{
+    XCAM_FAIL_RETURN (
+        WARNING,
+        path && (key || !key_size) && key_size <= GEO_TABLE_MAX_KEY_SIZE,
+        false,
+        "SoftGeoMapTable load failed, invalid key");
+
+    FILE *fp = fopen (path, "rb");
+    if (!fp)
+        return false;
+
+    GeoTableFileHeader header;
+    uint8_t file_key[GEO_TABLE_MAX_KEY_SIZE];
+    bool done =
+        fread (&header, sizeof (header), 1, fp) == 1 &&
+        header.magic == GEO_TABLE_FILE_MAGIC && header.version == GEO_TABLE_FILE_VERSION &&
+        header.entry_size == sizeof (SoftGeoMapEntry) && header.key_size == key_size &&
+        header.in_width == in_width && header.in_height == in_height &&
+        header.out_width == out_width && header.out_height == out_height &&
+        (!key_size || (fread (file_key, key_size, 1, fp) == 1 && !memcmp (file_key, key, key_size))) &&
+        header.tiles_x == XCAM_ALIGN_UP (header.out_width, XCAM_SOFT_GEO_TILE_WIDTH) / XCAM_SOFT_GEO_TILE_WIDTH &&
+        header.tiles_y == XCAM_ALIGN_UP (header.out_height, XCAM_SOFT_GEO_TILE_HEIGHT) / XCAM_SOFT_GEO_TILE_HEIGHT &&
+        header.tiles_x && header.tiles_y &&
+        header.in_width >= 4 && header.in_height >= 4 &&
+        header.in_width <= INT16_MAX && header.in_height <= INT16_MAX &&
+        header.out_width <= INT16_MAX && header.out_height <= INT16_MAX;
+
+    std::vector<SoftGeoMapEntry> entries;
+    if (done) {
+        entries.resize ((size_t)header.tiles_x * header.tiles_y * tile_entries ());
+        done = fread (&entries[0], sizeof (SoftGeoMapEntry), entries.size (), fp) == entries.size ();
+    }
+    fclose (fp);
+    if (!done) {
+        XCAM_LOG_DEBUG ("SoftGeoMapTable %s doesn't match, skipped", path);
+        return false;
+    }
+
+    _in_width = header.in_width;
+    _in_height = header.in_height;
+    _out_width = header.out_width;
+    _out_height = header.out_height;
+    _tiles_x = header.tiles_x;
+    _entries.swap (entries);
+
+    if (!check_entries ()) {
+        XCAM_LOG_WARNING ("SoftGeoMapTable %s has entries out of range, dropped", path);
+        _entries.clear ();
+        return false;
+    }
+    return true;
+}
+
+SoftGeoMapKernel::SoftGeoMapKernel (const char *name)
+    : SoftImageKernel (name)
+    , _map_width (0)
+    , _map_height (0)
+    , _uint_x (0.0f)
+    , _uint_y (0.0f)
+    , _map_changed (false)
+    , _funcs (NULL)
+{
+    // one table tile per work tile
+    set_tile_size (XCAM_SOFT_GEO_TILE_WIDTH, XCAM_SOFT_GEO_TILE_HEIGHT);
+}
+
+bool
+SoftGeoMapKernel::set_map_data (const GeoPos *data, uint32_t width, uint32_t height)
+{
+    XCAM_FAIL_RETURN (
+        WARNING,
+        data && width && height,
+        false,
+        "soft geo map kernel(%s) invalid map data(%dx%d)", XCAM_STR (get_kernel_name ()), width, height);
+
+    SmartLock locker (_map_mutex);
+    _map.assign (data, data + width * height);
+    _map_width = width;
+    _map_height = height;
+    _map_changed = true;
+    return true;
+}
+
+bool
+SoftGeoMapKernel::set_map_uint (float uint_x, float uint_y)
+{
+    SmartLock locker (_map_mutex);
+    _uint_x = uint_x;
+    _uint_y = uint_y;
+    _map_changed = !_map.empty ();
+    return true;
+}
+
+bool
+SoftGeoMapKernel::set_map_table (const SmartPtr<SoftGeoMapTable> &table)
+{
+    XCAM_FAIL_RETURN (
+        WARNING,
+        table.ptr () && table->is_valid (),
+        false,
+        "soft geo map kernel(%s) invalid map table", XCAM_STR (get_kernel_name ()));
+
+    // a ready table replaces map data
+    SmartLock locker (_map_mutex);
+    _map.clear ();
+    _map_width = _map_height = 0;
+    _map_changed = false;
+    _table = table;
+    return true;
+}
+
+SmartPtr<SoftGeoMapTable>
+SoftGeoMapKernel::get_map_table () const
+{
+    SmartLock locker (_map_mutex);
+    return _table;
+}
+
+XCamReturn
+SoftGeoMapKernel::update_table (uint32_t in_width, uint32_t in_height, uint32_t out_width, uint32_t out_height)
+{
+    XCAM_FAIL_RETURN (
+        ERROR,
+        !_map.empty (),
+        XCAM_RETURN_ERROR_PARAM,
+        "soft geo map kernel(%s) map data was not set", XCAM_STR (get_kernel_name ()));
+
+    float uint_x = _uint_x, uint_y = _uint_y;
+    if (uint_x < 1.0f && uint_y < 1.0f) {
+        uint_x = out_width / (float)_map_width;
+        uint_y = out_height / (float)_map_height;
+    }
+
+    SmartPtr<SoftGeoMapTable> table = new SoftGeoMapTable;
+    XCAM_FAIL_RETURN (
+        WARNING,
+        table->generate (
+            &_map[0], _map_width, _map_height, uint_x, uint_y,
+            in_width, in_height, out_width, out_height),
+        XCAM_RETURN_ERROR_PARAM,
+        "soft geo map kernel(%s) generate map table failed", XCAM_STR (get_kernel_name ()));
+
+    _table = table;
+    _map_changed = false;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftGeoMapKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    const VideoBufferInfo &in_info = _in.get_video_info ();
+    const VideoBufferInfo &out_info = _out.get_video_info ();
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in_info.format == V4L2_PIX_FMT_NV12 && out_info.format == V4L2_PIX_FMT_NV12,
+        XCAM_RETURN_ERROR_PARAM,
+        "soft geo map kernel(%s) only supports NV12, input:%s output:%s",
+        XCAM_STR (get_kernel_name ()),
+        xcam_fourcc_to_string (in_info.format), xcam_fourcc_to_string (out_info.format));
+
+    uint32_t in_width = XCAM_ALIGN_DOWN (in_info.width, 2);
+    uint32_t in_height = XCAM_ALIGN_DOWN (in_info.height, 2);
+    uint32_t out_width = XCAM_ALIGN_DOWN (out_info.width, 2);
+    uint32_t out_height = XCAM_ALIGN_DOWN (out_info.height, 2);
+
+    SmartLock locker (_map_mutex);
+    bool size_changed = !_table.ptr () ||
+                        _table->get_in_width () != in_width || _table->get_in_height () != in_height ||
+                        _table->get_out_width () != out_width || _table->get_out_height () != out_height;
+    if (_map_changed || (size_changed && !_map.empty ())) {
+        XCamReturn ret = update_table (in_width, in_height, out_width, out_height);
+        XCAM_FAIL_RETURN (
+            WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+            "soft geo map kernel(%s) update table failed", XCAM_STR (get_kernel_name ()));
+    } else if (size_changed) {
+        XCAM_LOG_ERROR (
+            "soft geo map kernel(%s) neither map data nor a table of input(%dx%d) output(%dx%d) was set",
+            XCAM_STR (get_kernel_name ()), in_width, in_height, out_width, out_height);
+        return XCAM_RETURN_ERROR_PARAM;
+    }
+    _frame_table = _table;
+
+    _funcs = &get_soft_geo_map_funcs (soft_simd_level ());
+    work_width = out_width;
+    work_height = out_height;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftGeoMapKernel::work_tile (const ImageTile &tile)
+{
+    const SoftGeoMapTable &table = *_frame_table.ptr ();
+    const SoftImagePlane &in_y = _in.get_plane (CLNV12PlaneY);
+    const SoftImagePlane &in_uv = _in.get_plane (CLNV12PlaneUV);
+    const SoftImagePlane &out_y = _out.get_plane (CLNV12PlaneY);
+    const SoftImagePlane &out_uv = _out.get_plane (CLNV12PlaneUV);
+    uint32_t tile_x = tile.x / XCAM_SOFT_GEO_TILE_WIDTH;
+    uint32_t tile_y = tile.y / XCAM_SOFT_GEO_TILE_HEIGHT;
+
+    XCAM_ASSERT (_funcs);
+    XCAM_ASSERT (!(tile.x % XCAM_SOFT_GEO_TILE_WIDTH) && !(tile.y % XCAM_SOFT_GEO_TILE_HEIGHT));
+
+    const SoftGeoMapEntry *luma = table.get_luma_tile (tile_x, tile_y);
+    for (uint32_t ly = 0; ly < tile.height; ++ly) {
+        _funcs->remap_luma (
+            luma + ly * XCAM_SOFT_GEO_TILE_WIDTH, in_y.data, in_y.pitch,
+            out_y.row (tile.y + ly) + tile.x, tile.width);
+    }
+
+    const SoftGeoMapEntry *chroma = table.get_chroma_tile (tile_x, tile_y);
+    for (uint32_t ly = 0; ly < tile.height / 2; ++ly) {
+        _funcs->remap_chroma (
+            chroma + ly * GEO_CHROMA_TILE_WIDTH, in_uv.data, in_uv.pitch,
+            out_uv.row (tile.y / 2 + ly) + tile.x, tile.width / 2);
+    }
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SoftGeoMapHandler::SoftGeoMapHandler (const char *name)
+    : SoftImageHandler (name)
+    , _output_width (0)
+    , _output_height (0)
+{
+}
+
+bool
+SoftGeoMapHandler::set_geo_map_kernel (SmartPtr<SoftGeoMapKernel> &kernel)
+{
+    SmartPtr<SoftImageKernel> image_kernel = kernel;
+    add_kernel (image_kernel);
+    _geo_kernel = kernel;
+    return true;
+}
+
+bool
+SoftGeoMapHandler::set_map_data (const GeoPos *data, uint32_t width, uint32_t height)
+{
+    XCAM_ASSERT (_geo_kernel.ptr ());
+    return _geo_kernel->set_map_data (data, width, height);
+}
+
+bool
+SoftGeoMapHandler::set_map_uint (float uint_x, float uint_y)
+{
+    XCAM_ASSERT (_geo_kernel.ptr ());
+    return _geo_kernel->set_map_uint (uint_x, uint_y);
+}
+
+XCamReturn
+SoftGeoMapHandler::prepare_buffer_pool_video_info (
+    const VideoBufferInfo &input, VideoBufferInfo &output)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, input.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "SoftGeoMapHandler(%s) input buffer format(%s) not NV12",
+        get_name (), xcam_fourcc_to_string (input.format));
+
+    if (!_output_width || !_output_height) {
+        _output_width = input.width;
+        _output_height = input.height;
+    }
+    XCAM_FAIL_RETURN (
+        WARNING, !(_output_width % 2) && !(_output_height % 2), XCAM_RETURN_ERROR_PARAM,
+        "SoftGeoMapHandler(%s) output size(%dx%d) must be even",
+        get_name (), _output_width, _output_height);
+
+    output.init (input.format, _output_width, _output_height);
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SmartPtr<SoftImageHandler>
+create_soft_geo_map_handler ()
+{
+    SmartPtr<SoftGeoMapHandler> handler = new SoftGeoMapHandler ();
+    SmartPtr<SoftGeoMapKernel> kernel = new SoftGeoMapKernel ("soft_geo_map");
+    handler->set_geo_map_kernel (kernel);
+    return handler;
+}
+
+};
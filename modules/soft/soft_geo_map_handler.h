@@ -0,0 +1,188 @@
+/*
+ * soft_geo_map_handler.h - CPU geometry map handler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_GEO_MAP_HANDLER_H
+#define XCAM_SOFT_GEO_MAP_HANDLER_H
+
+#include "xcam_utils.h"
+#include "xcam_mutex.h"
+#include "soft_image_handler.h"
+#include "soft_geo_map_simd.h"
+#include <vector>
+
+// output pixels of one table tile, the kernel tile size
+#define XCAM_SOFT_GEO_TILE_WIDTH   64
+#define XCAM_SOFT_GEO_TILE_HEIGHT  32
+
+namespace XCam {
+
+/*
+ * fixed-point remap table of NV12 output, tile-major.
+ * each tile keeps XCAM_SOFT_GEO_TILE_WIDTH x XCAM_SOFT_GEO_TILE_HEIGHT
+ * luma entries followed by its quarter of chroma entries, edge tiles
+ * are padded, so one output tile reads one contiguous block.
+ */
+class SoftGeoMapTable
+{
+public:
+    explicit SoftGeoMapTable ();
+
+    /*
+     * @map, input pixel positions of a @map_width x @map_height grid,
+     * one entry every @unit_x x @unit_y output pixels around output center,
+     * values between entries are bilinear interpolated, same as CLGeoMapHandler.
+     */
+    bool generate (
+        const GeoPos *map, uint32_t map_width, uint32_t map_height,
+        float unit_x, float unit_y,
+        uint32_t in_width, uint32_t in_height,
+        uint32_t out_width, uint32_t out_height);
+
+    /*
+     * table file keeps @key of the parameters which generated the table,
+     * load fails on other key, sizes than the expected ones or out of
+     * range entries, before allocating any entry.
+     */
+    bool save (const char *path, const void *key, uint32_t key_size) const;
+    bool load (
+        const char *path, const void *key, uint32_t key_size,
+        uint32_t in_width, uint32_t in_height, uint32_t out_width, uint32_t out_height);
+
+    bool is_valid () const {
+        return !_entries.empty ();
+    }
+    uint32_t get_out_width () const {
+        return _out_width;
+    }
+    uint32_t get_out_height () const {
+        return _out_height;
+    }
+    uint32_t get_in_width () const {
+        return _in_width;
+    }
+    uint32_t get_in_height () const {
+        return _in_height;
+    }
+    const SoftGeoMapEntry *get_luma_tile (uint32_t tile_x, uint32_t tile_y) const {
+        XCAM_ASSERT (tile_x < _tiles_x);
+        return &_entries[(tile_y * _tiles_x + tile_x) * tile_entries ()];
+    }
+    const SoftGeoMapEntry *get_chroma_tile (uint32_t tile_x, uint32_t tile_y) const {
+        return get_luma_tile (tile_x, tile_y) + XCAM_SOFT_GEO_TILE_WIDTH * XCAM_SOFT_GEO_TILE_HEIGHT;
+    }
+
+    static uint32_t tile_entries () {
+        return XCAM_SOFT_GEO_TILE_WIDTH * XCAM_SOFT_GEO_TILE_HEIGHT * 5 / 4;
+    }
+
+private:
+    bool check_entries () const;
+    XCAM_DEAD_COPY (SoftGeoMapTable);
+
+private:
+    uint32_t                        _in_width;
+    uint32_t                        _in_height;
+    uint32_t                        _out_width;
+    uint32_t                        _out_height;
+    uint32_t                        _tiles_x;
+    std::vector<SoftGeoMapEntry>    _entries;
+};
+
+/*
+ * CPU counterpart of CLGeoMapKernel, NV12 only.
+ * table is rebuilt on next execute when map or any size changes, tiles
+ * read the one taken by prepare_arguments, a table set meanwhile only
+ * applies to the next frame.
+ */
+class SoftGeoMapKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftGeoMapKernel (const char *name);
+
+    bool set_map_data (const GeoPos *data, uint32_t width, uint32_t height);
+    // entry spacing in output pixels, less than 1 fits map to output
+    bool set_map_uint (float uint_x, float uint_y);
+    bool set_map_table (const SmartPtr<SoftGeoMapTable> &table);
+    SmartPtr<SoftGeoMapTable> get_map_table () const;
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCamReturn update_table (uint32_t in_width, uint32_t in_height, uint32_t out_width, uint32_t out_height);
+
+    XCAM_DEAD_COPY (SoftGeoMapKernel);
+
+private:
+    std::vector<GeoPos>          _map;
+    uint32_t                     _map_width;
+    uint32_t                     _map_height;
+    float                        _uint_x;
+    float                        _uint_y;
+    bool                         _map_changed;
+    SmartPtr<SoftGeoMapTable>    _table;
+    SmartPtr<SoftGeoMapTable>    _frame_table;
+    const SoftGeoMapFuncs       *_funcs;
+    mutable Mutex                _map_mutex;
+};
+
+class SoftGeoMapHandler
+    : public SoftImageHandler
+{
+public:
+    explicit SoftGeoMapHandler (const char *name = "soft_geo_map");
+
+    bool set_geo_map_kernel (SmartPtr<SoftGeoMapKernel> &kernel);
+    void set_output_size (uint32_t width, uint32_t height) {
+        _output_width = width;
+        _output_height = height;
+    }
+    void get_output_size (uint32_t &width, uint32_t &height) const {
+        width = _output_width;
+        height = _output_height;
+    }
+
+    bool set_map_data (const GeoPos *data, uint32_t width, uint32_t height);
+    bool set_map_uint (float uint_x, float uint_y);
+
+protected:
+    virtual XCamReturn prepare_buffer_pool_video_info (
+        const VideoBufferInfo &input,
+        VideoBufferInfo &output);
+
+private:
+    XCAM_DEAD_COPY (SoftGeoMapHandler);
+
+private:
+    uint32_t                       _output_width;
+    uint32_t                       _output_height;
+    SmartPtr<SoftGeoMapKernel>     _geo_kernel;
+};
+
+SmartPtr<SoftImageHandler>
+create_soft_geo_map_handler ();
+
+};
+
+#endif //XCAM_SOFT_GEO_MAP_HANDLER_H
@@ -0,0 +1,312 @@
+/*
+ * soft_geo_map_simd.cpp - row functions of CPU geometry map
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_geo_map_simd.h"
+#include <string.h>
+
+#if XCAM_SOFT_SIMD_X86
+#include <immintrin.h>
+#endif
+#if XCAM_SOFT_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#define GEO_FRAC_ONE     (1 << XCAM_SOFT_GEO_FRAC_BITS)
+#define GEO_SHIFT        (XCAM_SOFT_GEO_FRAC_BITS * 2)
+#define GEO_ROUND        (1 << (GEO_SHIFT - 1))
+
+namespace XCam {
+
+static inline uint8_t
+bilinear (const uint8_t *p0, const uint8_t *p1, uint32_t step, int32_t fx, int32_t fy)
+{
+    int32_t top = p0[0] * (GEO_FRAC_ONE - fx) + p0[step] * fx;
+    int32_t bottom = p1[0] * (GEO_FRAC_ONE - fx) + p1[step] * fx;
+    return (uint8_t)((top * (GEO_FRAC_ONE - fy) + bottom * fy + GEO_ROUND) >> GEO_SHIFT);
+}
+
+static void
+remap_luma_row_c (
+    const SoftGeoMapEntry *entries, const uint8_t *src, uint32_t pitch,
+    uint8_t *dst, uint32_t x, uint32_t width)
+{
+    for (; x < width; ++x) {
+        const SoftGeoMapEntry &e = entries[x];
+        if (e.x < 0) {
+            dst[x] = XCAM_SOFT_GEO_CONST_Y;
+            continue;
+        }
+        const uint8_t *p0 = src + (size_t)e.y * pitch + e.x;
+        dst[x] = bilinear (p0, p0 + pitch, 1, e.fx, e.fy);
+    }
+}
+
+static void
+remap_chroma_row_c (
+    const SoftGeoMapEntry *entries, const uint8_t *src, uint32_t pitch,
+    uint8_t *dst, uint32_t x, uint32_t width)
+{
+    for (; x < width; ++x) {
+        const SoftGeoMapEntry &e = entries[x];
+        uint8_t *out = dst + x * 2;
+        if (e.x < 0) {
+            out[0] = out[1] = XCAM_SOFT_GEO_CONST_UV;
+            continue;
+        }
+        const uint8_t *p0 = src + (size_t)e.y * pitch + e.x * 2;
+        out[0] = bilinear (p0, p0 + pitch, 2, e.fx, e.fy);
+        out[1] = bilinear (p0 + 1, p0 + pitch + 1, 2, e.fx, e.fy);
+    }
+}
+
+static void
+remap_luma_c (
+    const SoftGeoMapEntry *entries, const uint8_t *src, uint32_t pitch,
+    uint8_t *dst, uint32_t width)
+{
+    remap_luma_row_c (entries, src, pitch, dst, 0, width);
+}
+
+static void
+remap_chroma_c (
+    const SoftGeoMapEntry *entries, const uint8_t *src, uint32_t pitch,
+    uint8_t *dst, uint32_t width)
+{
+    remap_chroma_row_c (entries, src, pitch, dst, 0, width);
+}
+
+static const SoftGeoMapFuncs geo_map_funcs_c = {
+    remap_luma_c,
+    remap_chroma_c,
+};
+
+// groups touching pixels outside of the map take the scalar path
+static inline bool
+all_inside (const SoftGeoMapEntry *entries, uint32_t count)
+{
+    int16_t x = 0;
+    for (uint32_t i = 0; i < count; ++i)
+        x |= entries[i].x;
+    return x >= 0;
+}
+
+static inline uint16_t
+load_u16 (const uint8_t *p)
+{
+    uint16_t value;
+    memcpy (&value, p, sizeof (value));
+    return value;
+}
+
+static inline uint32_t
+load_u32 (const uint8_t *p)
+{
+    uint32_t value;
+    memcpy (&value, p, sizeof (value));
+    return value;
+}
+
+#if XCAM_SOFT_SIMD_X86
+
+/*
+ * neighbours are gathered by scalar loads, weighting runs on madd:
+ * (p0, p1) x (1 - fx, fx) per row, then (top, bottom) x (1 - fy, fy).
+ * results match the scalar path bit by bit.
+ */
+XCAM_SOFT_TARGET_SSE41 static void
+remap_luma_sse (
+    const SoftGeoMapEntry *entries, const uint8_t *src, uint32_t pitch,
+    uint8_t *dst, uint32_t width)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i one = _mm_set1_epi16 (GEO_FRAC_ONE);
+    const __m128i round = _mm_set1_epi32 (GEO_ROUND);
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        const SoftGeoMapEntry *e = entries + x;
+        if (!all_inside (e, 8)) {
+            remap_luma_row_c (entries, src, pitch, dst, x, x + 8);
+            continue;
+        }
+
+        const uint8_t *p[8];
+        for (uint32_t i = 0; i < 8; ++i)
+            p[i] = src + (size_t)e[i].y * pitch + e[i].x;
+
+        __m128i t = _mm_setr_epi16 (
+                        load_u16 (p[0]), load_u16 (p[1]), load_u16 (p[2]), load_u16 (p[3]),
+                        load_u16 (p[4]), load_u16 (p[5]), load_u16 (p[6]), load_u16 (p[7]));
+        __m128i b = _mm_setr_epi16 (
+                        load_u16 (p[0] + pitch), load_u16 (p[1] + pitch), load_u16 (p[2] + pitch), load_u16 (p[3] + pitch),
+                        load_u16 (p[4] + pitch), load_u16 (p[5] + pitch), load_u16 (p[6] + pitch), load_u16 (p[7] + pitch));
+        __m128i wx = _mm_setr_epi16 (e[0].fx, e[1].fx, e[2].fx, e[3].fx, e[4].fx, e[5].fx, e[6].fx, e[7].fx);
+        __m128i wy = _mm_setr_epi16 (e[0].fy, e[1].fy, e[2].fy, e[3].fy, e[4].fy, e[5].fy, e[6].fy, e[7].fy);
+        __m128i wx_lo = _mm_unpacklo_epi16 (_mm_sub_epi16 (one, wx), wx);
+        __m128i wx_hi = _mm_unpackhi_epi16 (_mm_sub_epi16 (one, wx), wx);
+        __m128i wy_lo = _mm_unpacklo_epi16 (_mm_sub_epi16 (one, wy), wy);
+        __m128i wy_hi = _mm_unpackhi_epi16 (_mm_sub_epi16 (one, wy), wy);
+
+        __m128i top_v = _mm_packs_epi32 (
+                            _mm_madd_epi16 (_mm_unpacklo_epi8 (t, zero), wx_lo),
+                            _mm_madd_epi16 (_mm_unpackhi_epi8 (t, zero), wx_hi));
+        __m128i bottom_v = _mm_packs_epi32 (
+                               _mm_madd_epi16 (_mm_unpacklo_epi8 (b, zero), wx_lo),
+                               _mm_madd_epi16 (_mm_unpackhi_epi8 (b, zero), wx_hi));
+        __m128i lo = _mm_madd_epi16 (_mm_unpacklo_epi16 (top_v, bottom_v), wy_lo);
+        __m128i hi = _mm_madd_epi16 (_mm_unpackhi_epi16 (top_v, bottom_v), wy_hi);
+        lo = _mm_srai_epi32 (_mm_add_epi32 (lo, round), GEO_SHIFT);
+        hi = _mm_srai_epi32 (_mm_add_epi32 (hi, round), GEO_SHIFT);
+
+        __m128i v = _mm_packs_epi32 (lo, hi);
+        _mm_storel_epi64 ((__m128i *)(dst + x), _mm_packus_epi16 (v, v));
+    }
+    remap_luma_row_c (entries, src, pitch, dst, x, width);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+remap_chroma_sse (
+    const SoftGeoMapEntry *entries, const uint8_t *src, uint32_t pitch,
+    uint8_t *dst, uint32_t width)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i one = _mm_set1_epi16 (GEO_FRAC_ONE);
+    const __m128i round = _mm_set1_epi32 (GEO_ROUND);
+    // u0 v0 u1 v1 to u0 u1 v0 v1 in each pixel
+    const __m128i split_uv = _mm_setr_epi8 (0, 2, 1, 3, 4, 6, 5, 7, 8, 10, 9, 11, 12, 14, 13, 15);
+    uint32_t x = 0;
+
+    for (; x + 4 <= width; x += 4) {
+        const SoftGeoMapEntry *e = entries + x;
+        if (!all_inside (e, 4)) {
+            remap_chroma_row_c (entries, src, pitch, dst, x, x + 4);
+            continue;
+        }
+
+        const uint8_t *p[4];
+        for (uint32_t i = 0; i < 4; ++i)
+            p[i] = src + (size_t)e[i].y * pitch + e[i].x * 2;
+
+        __m128i t = _mm_setr_epi32 (load_u32 (p[0]), load_u32 (p[1]), load_u32 (p[2]), load_u32 (p[3]));
+        __m128i b = _mm_setr_epi32 (
+                        load_u32 (p[0] + pitch), load_u32 (p[1] + pitch), load_u32 (p[2] + pitch), load_u32 (p[3] + pitch));
+        t = _mm_shuffle_epi8 (t, split_uv);
+        b = _mm_shuffle_epi8 (b, split_uv);
+        __m128i wx = _mm_setr_epi16 (e[0].fx, e[0].fx, e[1].fx, e[1].fx, e[2].fx, e[2].fx, e[3].fx, e[3].fx);
+        __m128i wy = _mm_setr_epi16 (e[0].fy, e[0].fy, e[1].fy, e[1].fy, e[2].fy, e[2].fy, e[3].fy, e[3].fy);
+        __m128i wx_lo = _mm_unpacklo_epi16 (_mm_sub_epi16 (one, wx), wx);
+        __m128i wx_hi = _mm_unpackhi_epi16 (_mm_sub_epi16 (one, wx), wx);
+        __m128i wy_lo = _mm_unpacklo_epi16 (_mm_sub_epi16 (one, wy), wy);
+        __m128i wy_hi = _mm_unpackhi_epi16 (_mm_sub_epi16 (one, wy), wy);
+
+        // u v of pixel 0 and 1 in lo, 2 and 3 in hi
+        __m128i top_v = _mm_packs_epi32 (
+                            _mm_madd_epi16 (_mm_unpacklo_epi8 (t, zero), wx_lo),
+                            _mm_madd_epi16 (_mm_unpackhi_epi8 (t, zero), wx_hi));
+        __m128i bottom_v = _mm_packs_epi32 (
+                               _mm_madd_epi16 (_mm_unpacklo_epi8 (b, zero), wx_lo),
+                               _mm_madd_epi16 (_mm_unpackhi_epi8 (b, zero), wx_hi));
+        __m128i lo = _mm_madd_epi16 (_mm_unpacklo_epi16 (top_v, bottom_v), wy_lo);
+        __m128i hi = _mm_madd_epi16 (_mm_unpackhi_epi16 (top_v, bottom_v), wy_hi);
+        lo = _mm_srai_epi32 (_mm_add_epi32 (lo, round), GEO_SHIFT);
+        hi = _mm_srai_epi32 (_mm_add_epi32 (hi, round), GEO_SHIFT);
+
+        __m128i v = _mm_packs_epi32 (lo, hi);
+        _mm_storel_epi64 ((__m128i *)(dst + x * 2), _mm_packus_epi16 (v, v));
+    }
+    remap_chroma_row_c (entries, src, pitch, dst, x, width);
+}
+
+// gathers bound the remap, AVX2 keeps the SSE4.1 functions
+static const SoftGeoMapFuncs geo_map_funcs_sse41 = {
+    remap_luma_sse,
+    remap_chroma_sse,
+};
+
+#endif //XCAM_SOFT_SIMD_X86
+
+#if XCAM_SOFT_SIMD_NEON
+
+static void
+remap_luma_neon (
+    const SoftGeoMapEntry *entries, const uint8_t *src, uint32_t pitch,
+    uint8_t *dst, uint32_t width)
+{
+    const uint16x8_t one = vdupq_n_u16 (GEO_FRAC_ONE);
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        const SoftGeoMapEntry *e = entries + x;
+        if (!all_inside (e, 8)) {
+            remap_luma_row_c (entries, src, pitch, dst, x, x + 8);
+            continue;
+        }
+
+        uint8_t p00[8], p01[8], p10[8], p11[8];
+        uint16_t fx[8], fy[8];
+        for (uint32_t i = 0; i < 8; ++i) {
+            const uint8_t *p0 = src + (size_t)e[i].y * pitch + e[i].x;
+            p00[i] = p0[0];
+            p01[i] = p0[1];
+            p10[i] = p0[pitch];
+            p11[i] = p0[pitch + 1];
+            fx[i] = e[i].fx;
+            fy[i] = e[i].fy;
+        }
+
+        uint16x8_t wx = vld1q_u16 (fx), wy = vld1q_u16 (fy);
+        uint16x8_t ax = vsubq_u16 (one, wx), ay = vsubq_u16 (one, wy);
+        uint16x8_t top = vmlaq_u16 (vmulq_u16 (vmovl_u8 (vld1_u8 (p00)), ax), vmovl_u8 (vld1_u8 (p01)), wx);
+        uint16x8_t bottom = vmlaq_u16 (vmulq_u16 (vmovl_u8 (vld1_u8 (p10)), ax), vmovl_u8 (vld1_u8 (p11)), wx);
+        uint32x4_t lo = vmlal_u16 (vmull_u16 (vget_low_u16 (top), vget_low_u16 (ay)), vget_low_u16 (bottom), vget_low_u16 (wy));
+        uint32x4_t hi = vmlal_u16 (vmull_u16 (vget_high_u16 (top), vget_high_u16 (ay)), vget_high_u16 (bottom), vget_high_u16 (wy));
+        uint16x8_t v = vcombine_u16 (vrshrn_n_u32 (lo, GEO_SHIFT), vrshrn_n_u32 (hi, GEO_SHIFT));
+        vst1_u8 (dst + x, vqmovn_u16 (v));
+    }
+    remap_luma_row_c (entries, src, pitch, dst, x, width);
+}
+
+static const SoftGeoMapFuncs geo_map_funcs_neon = {
+    remap_luma_neon,
+    remap_chroma_c,
+};
+
+#endif //XCAM_SOFT_SIMD_NEON
+
+const SoftGeoMapFuncs &
+get_soft_geo_map_funcs (SoftSimdLevel level)
+{
+    switch (level) {
+#if XCAM_SOFT_SIMD_X86
+    case SoftSimdAVX2:
+    case SoftSimdSSE41:
+        return geo_map_funcs_sse41;
+#endif
+#if XCAM_SOFT_SIMD_NEON
+    case SoftSimdNEON:
+        return geo_map_funcs_neon;
+#endif
+    default:
+        break;
+    }
+    return geo_map_funcs_c;
+}
+
+};
@@ -0,0 +1,66 @@
+/*
+ * soft_geo_map_simd.h - row functions of CPU geometry map
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_GEO_MAP_SIMD_H
+#define XCAM_SOFT_GEO_MAP_SIMD_H
+
+#include "xcam_utils.h"
+#include "soft_simd.h"
+
+// fraction bits of source positions, weights up to 1 << bits
+#define XCAM_SOFT_GEO_FRAC_BITS    7
+
+// output of pixels outside of the map, same as kernel_geo_map
+#define XCAM_SOFT_GEO_CONST_Y      0
+#define XCAM_SOFT_GEO_CONST_UV     128
+
+namespace XCam {
+
+/*
+ * source position of one output pixel, already clamped so that
+ * (x, y) and (x + 1, y + 1) are inside the plane.
+ * x < 0 marks output outside of the map.
+ */
+struct SoftGeoMapEntry {
+    int16_t    x;
+    int16_t    y;
+    uint8_t    fx;
+    uint8_t    fy;
+};
+
+/*
+ * bilinear sampling of @width entries into @dst.
+ * luma writes one byte per entry, chroma one UV pair per entry
+ * and reads UV pairs of @src.
+ */
+typedef void (*SoftGeoRemapFunc) (
+    const SoftGeoMapEntry *entries, const uint8_t *src, uint32_t pitch,
+    uint8_t *dst, uint32_t width);
+
+struct SoftGeoMapFuncs {
+    SoftGeoRemapFunc   remap_luma;
+    SoftGeoRemapFunc   remap_chroma;
+};
+
+const SoftGeoMapFuncs &get_soft_geo_map_funcs (SoftSimdLevel level);
+
+};
+
+#endif //XCAM_SOFT_GEO_MAP_SIMD_H
@@ -0,0 +1,504 @@
+/*
+ * soft_image_360_stitch.cpp - CPU 360 stitching
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_image_360_stitch.h"
+#include "soft_pyramid_blender.h"
+#include "host_mem_buffer.h"
+#include "thread_pool.h"
+
+namespace XCam {
+
+// same as CLImage360Stitch
+static StitchInfo
+get_default_stitch_info ()
+{
+    StitchInfo stitch_info;
+
+    stitch_info.merge_width[0] = 56;
+    stitch_info.merge_width[1] = 56;
+
+    stitch_info.crop[0].left = 96;
+    stitch_info.crop[0].right = 96;
+    stitch_info.crop[0].top = 0;
+    stitch_info.crop[0].bottom = 0;
+    stitch_info.crop[1].left = 96;
+    stitch_info.crop[1].right = 96;
+    stitch_info.crop[1].top = 0;
+    stitch_info.crop[1].bottom = 0;
+
+    stitch_info.fisheye_info[0].center_x = 480.0f;
+    stitch_info.fisheye_info[0].center_y = 480.0f;
+    stitch_info.fisheye_info[0].wide_angle = 202.8f;
+    stitch_info.fisheye_info[0].radius = 480.0f;
+    stitch_info.fisheye_info[0].rotate_angle = -90.0f;
+    stitch_info.fisheye_info[1].center_x = 1440.0f;
+    stitch_info.fisheye_info[1].center_y = 480.0f;
+    stitch_info.fisheye_info[1].wide_angle = 202.8f;
+    stitch_info.fisheye_info[1].radius = 480.0f;
+    stitch_info.fisheye_info[1].rotate_angle = 89.4f;
+
+    return stitch_info;
+}
+
+// one blender per index, all blenders write disjoint windows of output
+class StitchBlendFunc
+    : public ParallelFunc
+{
+public:
+    StitchBlendFunc (
+        SmartPtr<SoftBlender> *blenders,
+        SmartPtr<BufferProxy> (*inputs)[XCAM_SOFT_BLENDER_IMAGE_NUM],
+        SmartPtr<VideoBuffer> &output)
+        : _blenders (blenders)
+        , _inputs (inputs)
+        , _output (output)
+    {}
+
+    virtual XCamReturn work_range (uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            SmartPtr<VideoBuffer> input = _inputs[i][0];
+            SmartPtr<VideoBuffer> output = _output;
+            XCamReturn ret = _blenders[i]->execute (input, output);
+            XCAM_FAIL_RETURN (
+                WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+                "soft 360 stitch blender(%s) failed", _blenders[i]->get_name ());
+        }
+        return XCAM_RETURN_NO_ERROR;
+    }
+
+private:
+    SmartPtr<SoftBlender>      *_blenders;
+    SmartPtr<BufferProxy>     (*_inputs)[XCAM_SOFT_BLENDER_IMAGE_NUM];
+    SmartPtr<VideoBuffer>      &_output;
+};
+
+SoftImage360Stitch::SoftImage360Stitch (const char *name)
+    : SoftImageHandler (name)
+    , _output_width (0)
+    , _output_height (0)
+    , _layout_width (0)
+    , _layout_height (0)
+    , _is_stitch_inited (false)
+{
+    xcam_mem_clear (_merge_width);
+}
+
+SoftImage360Stitch::~SoftImage360Stitch ()
+{
+    unmap_overlap_frames ();
+}
+
+bool
+SoftImage360Stitch::set_fisheye_handler (const SmartPtr<SoftFisheyeHandler> &fisheye, uint32_t index)
+{
+    XCAM_ASSERT (index < ImageIdxCount);
+    _fisheye[index] = fisheye;
+    return true;
+}
+
+bool
+SoftImage360Stitch::set_left_blender (const SmartPtr<SoftBlender> &blender)
+{
+    _blender[SoftStitchOverlapLeft] = blender;
+    return true;
+}
+
+bool
+SoftImage360Stitch::set_right_blender (const SmartPtr<SoftBlender> &blender)
+{
+    _blender[SoftStitchOverlapRight] = blender;
+    return true;
+}
+
+bool
+SoftImage360Stitch::init_stitch_info (const StitchInfo &stitch_info)
+{
+    for (int index = 0; index < ImageIdxCount; ++index) {
+        XCAM_ASSERT (_fisheye[index].ptr ());
+        _merge_width[index] = stitch_info.merge_width[index];
+        _fisheye[index]->set_fisheye_info (stitch_info.fisheye_info[index]);
+        _crop_info[index] = stitch_info.crop[index];
+    }
+
+    // layout is redone on next execute
+    _layout_width = _layout_height = 0;
+    _is_stitch_inited = true;
+    return true;
+}
+
+void
+SoftImage360Stitch::set_table_dir (const char *dir)
+{
+    for (int index = 0; index < ImageIdxCount; ++index) {
+        XCAM_ASSERT (_fisheye[index].ptr ());
+        _fisheye[index]->set_table_dir (dir);
+    }
+}
+
+XCamReturn
+SoftImage360Stitch::prepare_buffer_pool_video_info (
+    const VideoBufferInfo &input, VideoBufferInfo &output)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, input.format == V4L2_PIX_FMT_NV12, XCAM_RETURN_ERROR_PARAM,
+        "SoftImage360Stitch(%s) input buffer format(%s) is not supported, try NV12",
+        get_name (), xcam_fourcc_to_string (input.format));
+
+    if (_output_width == 0 || _output_height == 0) {
+        _output_width = input.width;
+        _output_height = XCAM_ALIGN_UP (input.width / 2, 16);
+    }
+    XCAM_FAIL_RETURN (
+        WARNING,
+        _output_width && _output_height && (_output_width == _output_height * 2),
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftImage360Stitch(%s) output size(%dx%d) should be 2:1",
+        get_name (), _output_width, _output_height);
+
+    output.init (
+        input.format, _output_width, _output_height,
+        XCAM_ALIGN_UP (_output_width, 16), XCAM_ALIGN_UP (_output_height, 16));
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImage360Stitch::create_overlap_buffers (uint32_t index, uint32_t width, uint32_t height)
+{
+    VideoBufferInfo info;
+    info.init (V4L2_PIX_FMT_NV12, width, height);
+
+    SmartPtr<BufferPool> pool = new HostMemBufferPool;
+    pool->set_name ("soft_stitch_overlap");
+    XCAM_FAIL_RETURN (
+        WARNING,
+        pool->set_video_info (info) && pool->reserve (XCAM_SOFT_BLENDER_IMAGE_NUM),
+        XCAM_RETURN_ERROR_MEM,
+        "SoftImage360Stitch(%s) allocate overlap buffers(%dx%d) failed", get_name (), width, height);
+
+    // buffers are kept until layout changes, pool only owns the memory
+    for (uint32_t i = 0; i < XCAM_SOFT_BLENDER_IMAGE_NUM; ++i) {
+        _overlap_bufs[index][i] = pool->get_buffer (pool);
+        XCAM_ASSERT (_overlap_bufs[index][i].ptr ());
+    }
+    _overlap_bufs[index][0]->attach_buffer (_overlap_bufs[index][1]);
+    return XCAM_RETURN_NO_ERROR;
+}
+
+/*
+ * unwrapped images are as high as output. as in CLImage360Stitch, both
+ * images share the unwrap scale set by the main image height with its
+ * top/bottom crops, each image's own crops are left out of its dst
+ * latitude range, which then fills output height. usable columns of the main image
+ * are centered in output, secondary image fills the rest from right of
+ * the main image round to left of it. merge areas of both images always
+ * match output scale, so windows are exactly the merge widths.
+ */
+XCamReturn
+SoftImage360Stitch::update_layout (uint32_t out_width, uint32_t out_height)
+{
+    const ImageCropInfo *crop = _crop_info;
+    uint32_t align = XCAM_SOFT_BLENDER_ALIGNED_WIDTH;
+    uint32_t merge0 = XCAM_ALIGN_UP (_merge_width[ImageIdxMain], align);
+    uint32_t merge1 = XCAM_ALIGN_UP (_merge_width[ImageIdxSecondary], align);
+    uint32_t crop_left[ImageIdxCount] = {
+        XCAM_ALIGN_DOWN (crop[ImageIdxMain].left, 2), XCAM_ALIGN_DOWN (crop[ImageIdxSecondary].left, 2)
+    };
+
+    XCAM_FAIL_RETURN (
+        WARNING, !(out_width % align) && !(out_height % 2) && merge0 && merge1,
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftImage360Stitch(%s) output(%dx%d) should be %d pixels aligned and merge widths(%d, %d) > 0",
+        get_name (), out_width, out_height, align, _merge_width[0], _merge_width[1]);
+
+    uint32_t fisheye_width = (out_width + merge0 + merge1
+                              + crop[0].left + crop[0].right + crop[1].left + crop[1].right) / 2;
+    fisheye_width = XCAM_ALIGN_UP (fisheye_width, 2);
+    uint32_t fisheye_height = out_height + crop[ImageIdxMain].top + crop[ImageIdxMain].bottom;
+
+    // columns of each image in output, overlaps counted twice
+    uint32_t main_width = fisheye_width - crop_left[ImageIdxMain] - crop[ImageIdxMain].right;
+    main_width = XCAM_ALIGN_DOWN (main_width, align);
+    uint32_t scnd_width = out_width + merge0 + merge1 - main_width;
+    XCAM_FAIL_RETURN (
+        WARNING,
+        main_width >= merge0 + merge1 && main_width <= out_width &&
+        scnd_width >= merge0 + merge1 && crop_left[ImageIdxSecondary] + scnd_width <= fisheye_width,
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftImage360Stitch(%s) crops and merge widths do not fit output width(%d)",
+        get_name (), out_width);
+
+    uint32_t main_pos = XCAM_ALIGN_DOWN ((out_width - main_width) / 2, align);
+    uint32_t tail_width = out_width - main_pos - main_width;
+    XCAM_LOG_INFO (
+        "SoftImage360Stitch(%s) fisheye unwrap size:%dx%d, main image at output x:%d width:%d",
+        get_name (), fisheye_width, out_height, main_pos, main_width);
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        crop[ImageIdxSecondary].top + crop[ImageIdxSecondary].bottom < fisheye_height,
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftImage360Stitch(%s) secondary image top/bottom crops(%d, %d) do not fit unwrap height(%d)",
+        get_name (), crop[ImageIdxSecondary].top, crop[ImageIdxSecondary].bottom, fisheye_height);
+
+    float range_longitude = 180.0f * fisheye_width / fisheye_height;
+    for (int index = 0; index < ImageIdxCount; ++index) {
+        uint32_t rows = fisheye_height - crop[index].top - crop[index].bottom;
+        float offset = 90.0f * ((int32_t)crop[index].top - (int32_t)crop[index].bottom) / fisheye_height;
+        _fisheye[index]->set_dst_range (range_longitude, 180.0f * rows / fisheye_height);
+        _fisheye[index]->set_dst_latitude_offset (offset);
+        _fisheye[index]->set_output_size (fisheye_width, out_height);
+    }
+
+    unmap_overlap_frames ();
+    Rect window, area;
+    window.height = area.height = out_height;
+    for (int index = 0; index < SoftStitchOverlapCount; ++index) {
+        SmartPtr<SoftBlender> &blender = _blender[index];
+        uint32_t merge_width = (index == SoftStitchOverlapLeft ? merge0 : merge1);
+        XCamReturn ret = create_overlap_buffers (index, merge_width, out_height);
+        XCAM_FAIL_RETURN (
+            WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+            "SoftImage360Stitch(%s) create overlap buffers failed", get_name ());
+
+        window.pos_x = (index == SoftStitchOverlapLeft ? main_pos : main_pos + main_width - merge1);
+        window.width = area.width = merge_width;
+        XCAM_FAIL_RETURN (
+            WARNING, blender->set_merge_window (window), XCAM_RETURN_ERROR_PARAM,
+            "SoftImage360Stitch(%s) set merge window failed", get_name ());
+        for (uint32_t i = 0; i < XCAM_SOFT_BLENDER_IMAGE_NUM; ++i) {
+            blender->set_input_valid_area (area, i);
+            blender->set_input_merge_area (area, i);
+        }
+    }
+
+    SoftImageFrame (&left_frames)[XCAM_SOFT_BLENDER_IMAGE_NUM] = _overlap_frames[SoftStitchOverlapLeft];
+    SoftImageFrame (&right_frames)[XCAM_SOFT_BLENDER_IMAGE_NUM] = _overlap_frames[SoftStitchOverlapRight];
+    uint32_t begin = crop_left[ImageIdxMain];
+    std::vector<SoftStitchSegment> &main = _segments[ImageIdxMain];
+    main.clear ();
+    main.push_back (SoftStitchSegment (begin, begin + merge0, &left_frames[1], 0));
+    main.push_back (SoftStitchSegment (begin + merge0, begin + main_width - merge1, NULL, main_pos + merge0));
+    main.push_back (SoftStitchSegment (begin + main_width - merge1, begin + main_width, &right_frames[0], 0));
+
+    begin = crop_left[ImageIdxSecondary];
+    std::vector<SoftStitchSegment> &scnd = _segments[ImageIdxSecondary];
+    scnd.clear ();
+    scnd.push_back (SoftStitchSegment (begin, begin + merge1, &right_frames[1], 0));
+    begin += merge1;
+    if (tail_width)
+        scnd.push_back (SoftStitchSegment (begin, begin + tail_width, NULL, main_pos + main_width));
+    begin += tail_width;
+    if (main_pos)
+        scnd.push_back (SoftStitchSegment (begin, begin + main_pos, NULL, 0));
+    begin += main_pos;
+    scnd.push_back (SoftStitchSegment (begin, begin + merge0, &left_frames[0], 0));
+    XCAM_ASSERT (begin + merge0 == crop_left[ImageIdxSecondary] + scnd_width);
+
+    _layout_width = out_width;
+    _layout_height = out_height;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImage360Stitch::prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    if (!_is_stitch_inited)
+        init_stitch_info (get_default_stitch_info ());
+
+    const VideoBufferInfo &in_info = input->get_video_info ();
+    const VideoBufferInfo &out_info = output->get_video_info ();
+    XCAM_FAIL_RETURN (
+        WARNING, in_info.format == V4L2_PIX_FMT_NV12 && out_info.format == V4L2_PIX_FMT_NV12,
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftImage360Stitch(%s) only supports NV12, input:%s output:%s", get_name (),
+        xcam_fourcc_to_string (in_info.format), xcam_fourcc_to_string (out_info.format));
+
+    if (out_info.width != _layout_width || out_info.height != _layout_height) {
+        ret = update_layout (out_info.width, out_info.height);
+        XCAM_FAIL_RETURN (
+            WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+            "SoftImage360Stitch(%s) layout of output(%dx%d) failed",
+            get_name (), out_info.width, out_info.height);
+    }
+
+    for (int index = 0; index < ImageIdxCount; ++index) {
+        ret = _fisheye[index]->prepare_map_table (
+                  XCAM_ALIGN_DOWN (in_info.width, 2), XCAM_ALIGN_DOWN (in_info.height, 2));
+        XCAM_FAIL_RETURN (
+            WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+            "SoftImage360Stitch(%s) prepare fisheye(%d) table failed", get_name (), index);
+    }
+
+    for (int index = 0; index < SoftStitchOverlapCount; ++index) {
+        for (uint32_t i = 0; i < XCAM_SOFT_BLENDER_IMAGE_NUM; ++i) {
+            ret = _overlap_frames[index][i].map (_overlap_bufs[index][i]);
+            if (ret != XCAM_RETURN_NO_ERROR) {
+                unmap_overlap_frames ();
+                XCAM_LOG_WARNING ("SoftImage360Stitch(%s) map overlaps failed", get_name ());
+                return ret;
+            }
+        }
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImage360Stitch::execute_done (SmartPtr<VideoBuffer> &output)
+{
+    unmap_overlap_frames ();
+
+    StitchBlendFunc func (_blender, _overlap_bufs, output);
+    return ThreadPool::instance ()->parallel_for (SoftStitchOverlapCount, func);
+}
+
+void
+SoftImage360Stitch::unmap_overlap_frames ()
+{
+    for (int index = 0; index < SoftStitchOverlapCount; ++index)
+        for (uint32_t i = 0; i < XCAM_SOFT_BLENDER_IMAGE_NUM; ++i)
+            _overlap_frames[index][i].unmap ();
+}
+
+void
+SoftImage360Stitch::emit_stop ()
+{
+    unmap_overlap_frames ();
+    for (int index = 0; index < SoftStitchOverlapCount; ++index) {
+        if (_blender[index].ptr ())
+            _blender[index]->emit_stop ();
+    }
+    SoftImageHandler::emit_stop ();
+}
+
+SoftStitchUnwrapKernel::SoftStitchUnwrapKernel (SoftImage360Stitch *stitch)
+    : SoftImageKernel ("soft_stitch_unwrap")
+    , _stitch (stitch)
+    , _funcs (NULL)
+    , _image_rows (0)
+{
+    XCAM_ASSERT (stitch);
+    set_tile_size (XCAM_SOFT_GEO_TILE_WIDTH, XCAM_SOFT_GEO_TILE_HEIGHT);
+}
+
+XCamReturn
+SoftStitchUnwrapKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    for (int index = 0; index < ImageIdxCount; ++index) {
+        SmartPtr<SoftGeoMapTable> table = _stitch->get_map_table (index);
+        XCAM_FAIL_RETURN (
+            WARNING, table.ptr () && table->is_valid (), XCAM_RETURN_ERROR_PARAM,
+            "soft stitch unwrap kernel has no table of fisheye(%d)", index);
+        _tables[index] = table;
+    }
+    XCAM_ASSERT (_tables[0]->get_out_width () == _tables[1]->get_out_width () &&
+                 _tables[0]->get_out_height () == _tables[1]->get_out_height ());
+
+    _funcs = &get_soft_geo_map_funcs (soft_simd_level ());
+    _image_rows = XCAM_ALIGN_UP (_tables[0]->get_out_height (), XCAM_SOFT_GEO_TILE_HEIGHT);
+    work_width = _tables[0]->get_out_width ();
+    work_height = _image_rows * ImageIdxCount;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftStitchUnwrapKernel::work_tile (const ImageTile &tile)
+{
+    uint32_t index = tile.y / _image_rows;
+    uint32_t y = tile.y - index * _image_rows;
+    const SoftGeoMapTable &table = *_tables[index].ptr ();
+    const std::vector<SoftStitchSegment> &segments = _stitch->get_segments (index);
+    const SoftImagePlane &in_y = _in.get_plane (CLNV12PlaneY);
+    const SoftImagePlane &in_uv = _in.get_plane (CLNV12PlaneUV);
+    uint32_t rows = XCAM_MIN (tile.height, table.get_out_height () - y);
+    uint32_t tile_x = tile.x / XCAM_SOFT_GEO_TILE_WIDTH;
+    uint32_t tile_y = y / XCAM_SOFT_GEO_TILE_HEIGHT;
+
+    XCAM_ASSERT (_funcs && index < ImageIdxCount && y < table.get_out_height ());
+    XCAM_ASSERT (!(tile.x % XCAM_SOFT_GEO_TILE_WIDTH) && !(y % XCAM_SOFT_GEO_TILE_HEIGHT));
+
+    const SoftGeoMapEntry *luma = table.get_luma_tile (tile_x, tile_y);
+    const SoftGeoMapEntry *chroma = table.get_chroma_tile (tile_x, tile_y);
+    for (size_t i = 0; i < segments.size (); ++i) {
+        const SoftStitchSegment &seg = segments[i];
+        uint32_t begin = XCAM_MAX (seg.begin, tile.x);
+        uint32_t end = XCAM_MIN (seg.end, tile.x + tile.width);
+        if (begin >= end)
+            continue;
+
+        // segment columns are even, chroma entries of a tile are pairs of luma columns
+        const SoftImageFrame &dst = seg.frame ? *seg.frame : _out;
+        const SoftImagePlane &out_y = dst.get_plane (CLNV12PlaneY);
+        const SoftImagePlane &out_uv = dst.get_plane (CLNV12PlaneUV);
+        uint32_t offset = begin - tile.x;
+        uint32_t dst_x = seg.dst_x + begin - seg.begin;
+
+        for (uint32_t ly = 0; ly < rows; ++ly) {
+            _funcs->remap_luma (
+                luma + ly * XCAM_SOFT_GEO_TILE_WIDTH + offset, in_y.data, in_y.pitch,
+                out_y.row (y + ly) + dst_x, end - begin);
+        }
+        for (uint32_t ly = 0; ly < rows / 2; ++ly) {
+            _funcs->remap_chroma (
+                chroma + ly * (XCAM_SOFT_GEO_TILE_WIDTH / 2) + offset / 2, in_uv.data, in_uv.pitch,
+                out_uv.row (y / 2 + ly) + dst_x, (end - begin) / 2);
+        }
+    }
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SmartPtr<SoftImageHandler>
+create_soft_image_360_stitch (bool need_seam)
+{
+    SmartPtr<SoftImage360Stitch> stitch = new SoftImage360Stitch ();
+    XCAM_ASSERT (stitch.ptr ());
+
+    for (int index = 0; index < ImageIdxCount; ++index) {
+        SmartPtr<SoftFisheyeHandler> fisheye =
+            create_soft_fisheye_handler ().dynamic_cast_ptr<SoftFisheyeHandler> ();
+        XCAM_FAIL_RETURN (ERROR, fisheye.ptr (), NULL, "soft 360 stitch create fisheye handler failed");
+        fisheye->disable_buf_pool (true);
+        stitch->set_fisheye_handler (fisheye, index);
+    }
+
+    SmartPtr<SoftBlender> left_blender =
+        create_soft_pyramid_blender (XCAM_SOFT_STITCH_BLEND_LAYERS, need_seam).dynamic_cast_ptr<SoftBlender> ();
+    XCAM_FAIL_RETURN (ERROR, left_blender.ptr (), NULL, "soft 360 stitch create left blender failed");
+    left_blender->disable_buf_pool (true);
+    stitch->set_left_blender (left_blender);
+
+    SmartPtr<SoftBlender> right_blender =
+        create_soft_pyramid_blender (XCAM_SOFT_STITCH_BLEND_LAYERS, need_seam).dynamic_cast_ptr<SoftBlender> ();
+    XCAM_FAIL_RETURN (ERROR, right_blender.ptr (), NULL, "soft 360 stitch create right blender failed");
+    right_blender->disable_buf_pool (true);
+    stitch->set_right_blender (right_blender);
+
+    SmartPtr<SoftImageKernel> kernel = new SoftStitchUnwrapKernel (stitch.ptr ());
+    stitch->add_kernel (kernel);
+    return stitch;
+}
+
+};
@@ -0,0 +1,158 @@
+/*
+ * soft_image_360_stitch.h - CPU 360 stitching
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_IMAGE_360_STITCH_H
+#define XCAM_SOFT_IMAGE_360_STITCH_H
+
+#include "xcam_utils.h"
+#include "soft_image_handler.h"
+#include "soft_fisheye_handler.h"
+#include "soft_blender.h"
+#include <vector>
+
+// pyramid layers of overlap blenders, same as create_image_360_stitch
+#define XCAM_SOFT_STITCH_BLEND_LAYERS  2
+
+namespace XCam {
+
+enum SoftStitchOverlap {
+    SoftStitchOverlapLeft,   // secondary image on left, main image on right
+    SoftStitchOverlapRight,  // main image on left, secondary image on right
+    SoftStitchOverlapCount,
+};
+
+/*
+ * columns [begin, end) of an unwrapped image go to @frame from @dst_x,
+ * NULL @frame is the stitch output.
+ */
+struct SoftStitchSegment {
+    uint32_t          begin;
+    uint32_t          end;
+    SoftImageFrame   *frame;
+    uint32_t          dst_x;
+
+    SoftStitchSegment (uint32_t begin, uint32_t end, SoftImageFrame *frame, uint32_t dst_x)
+        : begin (begin), end (end), frame (frame), dst_x (dst_x)
+    {}
+};
+
+/*
+ * CPU counterpart of CLImage360Stitch, same StitchInfo.
+ * both fisheye images of the input are unwrapped in one kernel pass,
+ * columns out of overlaps are written straight into output, overlaps
+ * go to small frames which both blenders then blend into output in
+ * parallel. unwrapped images are never stored in full.
+ * main image sits in the middle of output, secondary image wraps
+ * around output edges.
+ */
+class SoftImage360Stitch
+    : public SoftImageHandler
+{
+public:
+    explicit SoftImage360Stitch (const char *name = "soft_360_stitch");
+    virtual ~SoftImage360Stitch ();
+
+    bool init_stitch_info (const StitchInfo &stitch_info);
+    void set_output_size (uint32_t width, uint32_t height) {
+        _output_width = width;
+        _output_height = height;
+    }
+    // fisheye tables are loaded from or saved to @dir, NULL disables table files
+    void set_table_dir (const char *dir);
+
+    bool set_fisheye_handler (const SmartPtr<SoftFisheyeHandler> &fisheye, uint32_t index);
+    bool set_left_blender (const SmartPtr<SoftBlender> &blender);
+    bool set_right_blender (const SmartPtr<SoftBlender> &blender);
+
+    SmartPtr<SoftGeoMapTable> get_map_table (uint32_t index) const {
+        XCAM_ASSERT (index < ImageIdxCount);
+        return _fisheye[index]->get_map_table ();
+    }
+    const std::vector<SoftStitchSegment> &get_segments (uint32_t index) const {
+        XCAM_ASSERT (index < ImageIdxCount);
+        return _segments[index];
+    }
+
+    virtual void emit_stop ();
+
+protected:
+    virtual XCamReturn prepare_buffer_pool_video_info (
+        const VideoBufferInfo &input,
+        VideoBufferInfo &output);
+    virtual XCamReturn prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+    // overlaps are blended once both images are unwrapped
+    virtual XCamReturn execute_done (SmartPtr<VideoBuffer> &output);
+
+private:
+    XCamReturn update_layout (uint32_t out_width, uint32_t out_height);
+    XCamReturn create_overlap_buffers (uint32_t index, uint32_t width, uint32_t height);
+    void unmap_overlap_frames ();
+
+    XCAM_DEAD_COPY (SoftImage360Stitch);
+
+private:
+    SmartPtr<SoftFisheyeHandler>     _fisheye[ImageIdxCount];
+    SmartPtr<SoftBlender>            _blender[SoftStitchOverlapCount];
+    // input 1 of each overlap is attached to input 0
+    SmartPtr<BufferProxy>            _overlap_bufs[SoftStitchOverlapCount][XCAM_SOFT_BLENDER_IMAGE_NUM];
+    SoftImageFrame                   _overlap_frames[SoftStitchOverlapCount][XCAM_SOFT_BLENDER_IMAGE_NUM];
+    std::vector<SoftStitchSegment>   _segments[ImageIdxCount];
+
+    uint32_t                         _output_width;
+    uint32_t                         _output_height;
+    uint32_t                         _layout_width;
+    uint32_t                         _layout_height;
+    uint32_t                         _merge_width[ImageIdxCount];
+    ImageCropInfo                    _crop_info[ImageIdxCount];
+    bool                             _is_stitch_inited;
+};
+
+/*
+ * remaps tiles of both fisheye tables in one work area, image 1 below
+ * image 0, each table column goes to the frame of its segment.
+ */
+class SoftStitchUnwrapKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftStitchUnwrapKernel (SoftImage360Stitch *stitch);
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCAM_DEAD_COPY (SoftStitchUnwrapKernel);
+
+private:
+    SoftImage360Stitch              *_stitch;
+    const SoftGeoMapFuncs           *_funcs;
+    SmartPtr<SoftGeoMapTable>       _tables[ImageIdxCount];
+    uint32_t                         _image_rows;  // tile aligned rows of one image in work area
+};
+
+SmartPtr<SoftImageHandler>
+create_soft_image_360_stitch (bool need_seam = false);
+
+};
+
+#endif //XCAM_SOFT_IMAGE_360_STITCH_H
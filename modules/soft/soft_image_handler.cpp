@@ -0,0 +1,541 @@
+/*
+ * soft_image_handler.cpp - CPU image handler, tiled on thread pool
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_image_handler.h"
+#include "host_mem_buffer.h"
+#include "xcam_trace.h"
+
+namespace XCam {
+
+static uint32_t
+read_tile_cache_bytes ()
+{
+    const char *env = getenv ("XCAM_SOFT_TILE_CACHE_BYTES");
+    int value = env ? atoi (env) : 0;
+    return (value > 0) ? (uint32_t)value : XCAM_SOFT_DEFAULT_TILE_CACHE_BYTES;
+}
+
+static uint32_t
+get_tile_cache_bytes ()
+{
+    static uint32_t cache_bytes = read_tile_cache_bytes ();
+    return cache_bytes;
+}
+
+SoftImagePlane::SoftImagePlane ()
+    : data (NULL)
+    , pitch (0)
+    , width (0)
+    , height (0)
+    , pixel_bytes (0)
+{
+}
+
+SoftImageFrame::SoftImageFrame ()
+    : _mem (NULL)
+    , _plane_count (0)
+{
+}
+
+SoftImageFrame::~SoftImageFrame ()
+{
+    unmap ();
+}
+
+XCamReturn
+SoftImageFrame::map (const SmartPtr<VideoBuffer> &buf)
+{
+    XCAM_ASSERT (buf.ptr ());
+    unmap ();
+
+    _info = buf->get_video_info ();
+    XCAM_FAIL_RETURN (
+        WARNING,
+        _info.components && _info.components <= XCAM_VIDEO_MAX_COMPONENTS,
+        XCAM_RETURN_ERROR_PARAM,
+        "soft frame map failed, format(%s) has %d components",
+        xcam_fourcc_to_string (_info.format), _info.components);
+
+    uint8_t *mem = buf->map ();
+    XCAM_FAIL_RETURN (
+        WARNING, mem, XCAM_RETURN_ERROR_MEM,
+        "soft frame map buffer(%s, %dx%d) failed",
+        xcam_fourcc_to_string (_info.format), _info.width, _info.height);
+
+    for (uint32_t i = 0; i < _info.components; ++i) {
+        VideoBufferPlanarInfo planar;
+        _info.get_planar_info (planar, i);
+        _planes[i].data = mem + _info.offsets[i];
+        _planes[i].pitch = _info.strides[i];
+        _planes[i].width = planar.width;
+        _planes[i].height = planar.height;
+        _planes[i].pixel_bytes = planar.pixel_bytes;
+    }
+
+    _buf = buf;
+    _mem = mem;
+    _plane_count = _info.components;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftImageFrame::unmap ()
+{
+    if (_mem) {
+        XCAM_ASSERT (_buf.ptr ());
+        _buf->unmap ();
+        _mem = NULL;
+    }
+    _buf.release ();
+    _plane_count = 0;
+}
+
+SoftImageKernel::SoftImageKernel (const char *name, bool enable)
+    : _name (NULL)
+    , _enable (enable)
+    , _tile_width (0)
+    , _tile_height (0)
+    , _work_width (0)
+    , _work_height (0)
+{
+    if (name)
+        _name = strndup (name, XCAM_MAX_STR_SIZE);
+}
+
+SoftImageKernel::~SoftImageKernel ()
+{
+    if (_name)
+        xcam_free (_name);
+}
+
+XCamReturn
+SoftImageKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    const SoftImagePlane &plane = _out.get_plane (0);
+    work_width = plane.width;
+    work_height = plane.height;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+uint32_t
+SoftImageKernel::get_bytes_per_pixel () const
+{
+    uint32_t bytes = 0;
+    if (_in.is_mapped ())
+        bytes += _in.get_plane (0).pixel_bytes;
+    if (_out.is_mapped ())
+        bytes += _out.get_plane (0).pixel_bytes;
+    return XCAM_MAX (bytes, 1u);
+}
+
+/*
+ * default tile is XCAM_SOFT_DEFAULT_TILE_WIDTH wide and as high as
+ * the cache budget allows; height kept even for 4:2:0 chroma rows.
+ */
+void
+SoftImageKernel::get_tile_size (uint32_t &tile_width, uint32_t &tile_height) const
+{
+    tile_width = _tile_width ? _tile_width : (uint32_t)XCAM_SOFT_DEFAULT_TILE_WIDTH;
+    tile_width = XCAM_MIN (tile_width, _work_width);
+    tile_height = _tile_height;
+    if (!tile_height) {
+        tile_height = get_tile_cache_bytes () / (tile_width * get_bytes_per_pixel ());
+        tile_height = XCAM_ALIGN_DOWN (tile_height, 2);
+        tile_height = XCAM_MAX (tile_height, 2u);
+    }
+    tile_height = XCAM_MIN (tile_height, _work_height);
+}
+
+XCamReturn
+SoftImageKernel::pre_execute (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    XCAM_ASSERT (input.ptr () && output.ptr ());
+    ret = _in.map (input);
+    XCAM_FAIL_RETURN (
+        WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+        "soft kernel(%s) map input failed", XCAM_STR (_name));
+
+    // in-place output maps the same buffer twice, unmapped twice as well
+    ret = _out.map (output);
+    XCAM_FAIL_RETURN (
+        WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+        "soft kernel(%s) map output failed", XCAM_STR (_name));
+
+    _work_width = _work_height = 0;
+    ret = prepare_arguments (input, output, _work_width, _work_height);
+    XCAM_FAIL_RETURN (
+        WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+        "soft kernel(%s) prepare arguments failed", XCAM_STR (_name));
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImageKernel::execute ()
+{
+    uint32_t tile_width = 0, tile_height = 0;
+
+    if (!_work_width || !_work_height)
+        return XCAM_RETURN_NO_ERROR;
+
+    get_tile_size (tile_width, tile_height);
+    XCAM_LOG_DEBUG (
+        "soft kernel(%s) work:%dx%d tile:%dx%d",
+        XCAM_STR (_name), _work_width, _work_height, tile_width, tile_height);
+
+    // single tile runs on the calling thread, no pool round trip
+    if (tile_width >= _work_width && tile_height >= _work_height) {
+        ImageTile tile = {0, 0, _work_width, _work_height};
+        return work_tile (tile);
+    }
+
+    return ThreadPool::instance ()->parallel_for_tiles (
+               _work_width, _work_height, tile_width, tile_height, *this);
+}
+
+XCamReturn
+SoftImageKernel::post_execute (SmartPtr<VideoBuffer> &output)
+{
+    XCAM_UNUSED (output);
+
+    _in.unmap ();
+    _out.unmap ();
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftImageKernel::pre_stop ()
+{
+    _in.unmap ();
+    _out.unmap ();
+}
+
+SoftImageHandler::SoftImageHandler (const char *name)
+    : _name (NULL)
+    , _enable (true)
+    , _disable_buf_pool (false)
+    , _buf_pool_huge_page (false)
+    , _buf_pool_size (XCAM_SOFT_IMAGE_HANDLER_DEFAULT_BUF_NUM)
+    , _result_timestamp (XCam::InvalidTimestamp)
+{
+    XCAM_ASSERT (name);
+    if (name)
+        _name = strndup (name, XCAM_MAX_STR_SIZE);
+
+    _metrics = MetricsRegistry::instance ()->register_group ("soft_handler", _name);
+    _execute_latency = _metrics->get_histogram ("execute");
+    _frames_counter = _metrics->get_counter ("frames");
+    _bypassed_counter = _metrics->get_counter ("bypassed");
+    _errors_counter = _metrics->get_counter ("errors");
+
+    XCAM_OBJ_PROFILING_INIT;
+}
+
+SoftImageHandler::~SoftImageHandler ()
+{
+    MetricsRegistry::instance ()->unregister_group (_metrics);
+    if (_name)
+        xcam_free (_name);
+}
+
+void
+SoftImageHandler::update_execute_metrics (int64_t duration_us, XCamReturn ret)
+{
+    if (!MetricsRegistry::is_enabled ())
+        return;
+
+    _execute_latency->record (duration_us);
+    if (ret == XCAM_RETURN_NO_ERROR)
+        _frames_counter->add ();
+    else if (ret == XCAM_RETURN_BYPASS)
+        _bypassed_counter->add ();
+    else
+        _errors_counter->add ();
+}
+
+bool
+SoftImageHandler::add_kernel (SmartPtr<SoftImageKernel> &kernel)
+{
+    _kernels.push_back (kernel);
+    return true;
+}
+
+bool
+SoftImageHandler::enable_handler (bool enable)
+{
+    _enable = enable;
+    return true;
+}
+
+bool
+SoftImageHandler::is_handler_enabled () const
+{
+    return _enable;
+}
+
+XCamReturn
+SoftImageHandler::create_buffer_pool (const VideoBufferInfo &video_info)
+{
+    SmartPtr<HostMemBufferPool> buffer_pool;
+
+    if (_buf_pool.ptr ())
+        return XCAM_RETURN_ERROR_PARAM;
+
+    buffer_pool = new HostMemBufferPool;
+    XCAM_ASSERT (buffer_pool.ptr ());
+    buffer_pool->set_name (XCAM_STR (_name));
+    buffer_pool->set_huge_page (_buf_pool_huge_page);
+
+    XCAM_FAIL_RETURN(
+        WARNING,
+        buffer_pool->set_video_info (video_info),
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftImageHandler(%s) set buffer pool video info failed", XCAM_STR (_name));
+
+    XCAM_FAIL_RETURN(
+        WARNING,
+        buffer_pool->reserve (_buf_pool_size),
+        XCAM_RETURN_ERROR_MEM,
+        "SoftImageHandler(%s) failed to init host buffer pool", XCAM_STR (_name));
+
+    _buf_pool = buffer_pool;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+bool SoftImageHandler::is_ready ()
+{
+    if (_disable_buf_pool)
+        return true;
+    if (!_buf_pool.ptr ())  //execute not triggered
+        return true;
+    if (_buf_pool->has_free_buffers ())
+        return true;
+    return false;
+}
+
+XCamReturn SoftImageHandler::prepare_buffer_pool_video_info (
+    const VideoBufferInfo &input,
+    VideoBufferInfo &output)
+{
+    output = input;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImageHandler::prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCAM_ASSERT (input.ptr () && output.ptr ());
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImageHandler::prepare_output_buf (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    SmartPtr<BufferProxy> new_buf;
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    if (_disable_buf_pool)
+        return XCAM_RETURN_NO_ERROR;
+
+    if (!_buf_pool.ptr ()) {
+        VideoBufferInfo output_video_info;
+
+        ret = prepare_buffer_pool_video_info (input->get_video_info (), output_video_info);
+        XCAM_FAIL_RETURN(
+            WARNING,
+            ret == XCAM_RETURN_NO_ERROR,
+            ret,
+            "SoftImageHandler(%s) prepare output video info failed", XCAM_STR (_name));
+
+        ret = create_buffer_pool (output_video_info);
+        XCAM_FAIL_RETURN(
+            WARNING,
+            ret == XCAM_RETURN_NO_ERROR,
+            ret,
+            "SoftImageHandler(%s) ensure host buffer pool failed", XCAM_STR (_name));
+    }
+
+    new_buf = _buf_pool->get_buffer (_buf_pool);
+    XCAM_FAIL_RETURN(
+        WARNING,
+        new_buf.ptr(),
+        XCAM_RETURN_ERROR_UNKNOWN,
+        "SoftImageHandler(%s) failed to get buffer from pool", XCAM_STR (_name));
+
+    new_buf->set_timestamp (input->get_timestamp ());
+    // input may come from v4l2 or CL, only buffer proxies carry attaches
+    SmartPtr<BufferProxy> in_proxy = input.dynamic_cast_ptr<BufferProxy> ();
+    if (in_proxy.ptr ())
+        new_buf->copy_attaches (in_proxy);
+
+    output = new_buf;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftImageHandler::emit_stop ()
+{
+    for (KernelList::iterator i_kernel = _kernels.begin ();
+            i_kernel != _kernels.end ();  ++i_kernel) {
+        (*i_kernel)->pre_stop ();
+    }
+
+    if (_buf_pool.ptr ())
+        _buf_pool->stop ();
+}
+
+XCamReturn
+SoftImageHandler::execute (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        !_kernels.empty (),
+        XCAM_RETURN_ERROR_PARAM,
+        "soft_image_handler(%s) no image kernel set", XCAM_STR (_name));
+
+    if (!is_handler_enabled ()) {
+        output = input;
+        return XCAM_RETURN_NO_ERROR;
+    }
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        (ret = prepare_output_buf (input, output)) == XCAM_RETURN_NO_ERROR,
+        ret,
+        "soft_image_handler (%s) prepare output buf failed", XCAM_STR (_name));
+    XCAM_ASSERT (output.ptr ());
+
+    ret = prepare_parameters (input, output);
+    XCAM_FAIL_RETURN (
+        WARNING,
+        (ret == XCAM_RETURN_NO_ERROR || ret == XCAM_RETURN_BYPASS),
+        ret,
+        "soft_image_handler (%s) prepare parameters failed", XCAM_STR (_name));
+    if (ret == XCAM_RETURN_BYPASS)
+        return ret;
+
+    XCAM_OBJ_PROFILING_START;
+    TraceSpan span ("soft_handler", _name);
+
+    for (KernelList::iterator i_kernel = _kernels.begin ();
+            i_kernel != _kernels.end (); ++i_kernel) {
+        SmartPtr<SoftImageKernel> &kernel = *i_kernel;
+
+        XCAM_FAIL_RETURN (
+            WARNING,
+            kernel.ptr(),
+            XCAM_RETURN_ERROR_PARAM,
+            "kernel empty");
+
+        if (!kernel->is_enabled ())
+            continue;
+
+        ret = execute_kernel (kernel, input, output);
+        XCAM_FAIL_RETURN (
+            WARNING,
+            (ret == XCAM_RETURN_NO_ERROR || ret == XCAM_RETURN_BYPASS),
+            ret,
+            "soft_image_handler(%s) execute kernel(%s) failed",
+            XCAM_STR (_name), kernel->get_kernel_name ());
+
+        if (ret == XCAM_RETURN_BYPASS)
+            break;
+    }
+
+    XCAM_OBJ_PROFILING_END (XCAM_STR (_name), XCAM_OBJ_DUR_FRAME_NUM);
+
+    if (ret != XCAM_RETURN_NO_ERROR)
+        return ret;
+
+    ret = execute_done (output);
+    return ret;
+}
+
+XCamReturn
+SoftImageHandler::execute_kernel (
+    SmartPtr<SoftImageKernel> &kernel,
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    TraceSpan span ("soft_kernel", kernel->get_kernel_name ());
+    XCamReturn ret = kernel->pre_execute (input, output);
+    if (ret == XCAM_RETURN_NO_ERROR)
+        ret = kernel->execute ();
+
+    // always unmap, frames are kept mapped only while tiles run
+    XCamReturn post_ret = kernel->post_execute (output);
+    if (ret != XCAM_RETURN_NO_ERROR)
+        return ret;
+    return post_ret;
+}
+
+XCamReturn
+SoftImageHandler::execute_done (SmartPtr<VideoBuffer> &output)
+{
+    XCAM_UNUSED (output);
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftImageHandler::set_3a_result (SmartPtr<X3aResult> &result)
+{
+    if (!result.ptr ())
+        return;
+
+    int64_t ts = result->get_timestamp ();
+    _result_timestamp = (ts != XCam::InvalidTimestamp) ? ts : _result_timestamp;
+
+    X3aResultList::iterator i_res = _3a_results.begin ();
+    for (; i_res != _3a_results.end(); ++i_res) {
+        if (result->get_type () == (*i_res)->get_type ()) {
+            (*i_res) = result;
+            break;
+        }
+    }
+
+    if (i_res == _3a_results.end ()) {
+        _3a_results.push_back (result);
+    }
+}
+
+SmartPtr<X3aResult>
+SoftImageHandler::get_3a_result (XCam3aResultType type)
+{
+    X3aResultList::iterator i_res = _3a_results.begin ();
+    SmartPtr<X3aResult> res;
+
+    for ( ; i_res != _3a_results.end(); ++i_res) {
+        if (type == (*i_res)->get_type ()) {
+            res = (*i_res);
+            break;
+        }
+    }
+    return res;
+}
+
+};
@@ -0,0 +1,254 @@
+/*
+ * soft_image_handler.h - CPU image handler, tiled on thread pool
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_IMAGE_HANDLER_H
+#define XCAM_SOFT_IMAGE_HANDLER_H
+
+#include "xcam_utils.h"
+#include "video_buffer.h"
+#include "buffer_pool.h"
+#include "x3a_result.h"
+#include "xcam_mutex.h"
+#include "xcam_metrics.h"
+#include "thread_pool.h"
+#include "soft_simd.h"
+#include <list>
+
+#define XCAM_SOFT_IMAGE_HANDLER_DEFAULT_BUF_NUM  4
+#define XCAM_SOFT_DEFAULT_TILE_WIDTH             256
+// per tile working set, fits in a share of L2; $XCAM_SOFT_TILE_CACHE_BYTES to tune
+#define XCAM_SOFT_DEFAULT_TILE_CACHE_BYTES       (256 * 1024)
+// tile width for row bands, clamped to work width
+#define XCAM_SOFT_TILE_FULL_WIDTH                0xFFFFFFFF
+
+namespace XCam {
+
+struct SoftImagePlane {
+    uint8_t   *data;
+    uint32_t   pitch;
+    uint32_t   width;
+    uint32_t   height;
+    uint32_t   pixel_bytes;
+
+    SoftImagePlane ();
+
+    uint8_t *row (uint32_t y) const {
+        XCAM_ASSERT (y < height);
+        return data + (size_t)y * pitch;
+    }
+    uint8_t *pixel (uint32_t x, uint32_t y) const {
+        XCAM_ASSERT (x < width);
+        return row (y) + (size_t)x * pixel_bytes;
+    }
+};
+
+// host view of all planes of a buffer, mapped until unmap or destruction
+class SoftImageFrame {
+public:
+    explicit SoftImageFrame ();
+    ~SoftImageFrame ();
+
+    XCamReturn map (const SmartPtr<VideoBuffer> &buf);
+    void unmap ();
+
+    bool is_mapped () const {
+        return _mem != NULL;
+    }
+    SmartPtr<VideoBuffer> &get_buffer () {
+        return _buf;
+    }
+    const VideoBufferInfo &get_video_info () const {
+        return _info;
+    }
+    uint32_t get_plane_count () const {
+        return _plane_count;
+    }
+    const SoftImagePlane &get_plane (uint32_t index = 0) const {
+        XCAM_ASSERT (index < _plane_count);
+        return _planes[index];
+    }
+
+private:
+    XCAM_DEAD_COPY (SoftImageFrame);
+
+private:
+    SmartPtr<VideoBuffer>    _buf;
+    uint8_t                 *_mem;
+    VideoBufferInfo          _info;
+    SoftImagePlane           _planes [XCAM_VIDEO_MAX_COMPONENTS];
+    uint32_t                 _plane_count;
+};
+
+/*
+ * CPU counterpart of CLImageKernel.
+ * work area is split into tiles which run on ThreadPool workers,
+ * derived kernels implement work_tile and must only write pixels
+ * of their own tile.
+ */
+class SoftImageKernel
+    : public TileFunc
+{
+public:
+    explicit SoftImageKernel (const char *name, bool enable = true);
+    virtual ~SoftImageKernel ();
+
+    const char *get_kernel_name () const {
+        return _name;
+    }
+    void set_enable (bool enable) {
+        _enable = enable;
+    }
+    bool is_enabled () const {
+        return _enable;
+    }
+
+    // 0 picks size from tile cache budget and bytes per pixel
+    void set_tile_size (uint32_t width, uint32_t height) {
+        _tile_width = width;
+        _tile_height = height;
+    }
+
+    XCamReturn pre_execute (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+    XCamReturn execute ();
+    virtual XCamReturn post_execute (SmartPtr<VideoBuffer> &output);
+    virtual void pre_stop ();
+
+protected:
+    // work area in pixels of tile coordinates, default is size of output plane 0
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    // bytes read and written per work pixel, sizes default tiles
+    virtual uint32_t get_bytes_per_pixel () const;
+
+private:
+    void get_tile_size (uint32_t &tile_width, uint32_t &tile_height) const;
+
+    XCAM_DEAD_COPY (SoftImageKernel);
+
+protected:
+    SoftImageFrame      _in;
+    SoftImageFrame      _out;
+
+private:
+    char               *_name;
+    bool                _enable;
+    uint32_t            _tile_width;
+    uint32_t            _tile_height;
+    uint32_t            _work_width;
+    uint32_t            _work_height;
+};
+
+/*
+ * CPU counterpart of CLImageHandler, same contract:
+ * prepare_output_buf, prepare_parameters, kernels, execute_done.
+ * output buffers come from a HostMemBufferPool.
+ */
+class SoftImageHandler
+{
+public:
+    typedef std::list<SmartPtr<SoftImageKernel>> KernelList;
+
+public:
+    explicit SoftImageHandler (const char *name);
+    virtual ~SoftImageHandler ();
+    const char *get_name () const {
+        return _name;
+    }
+
+    void set_3a_result (SmartPtr<X3aResult> &result);
+    SmartPtr<X3aResult> get_3a_result (XCam3aResultType type);
+
+    int64_t get_result_timestamp () const {
+        return _result_timestamp;
+    };
+
+    void set_pool_size (uint32_t size) {
+        XCAM_ASSERT (size);
+        _buf_pool_size = size;
+    }
+    void set_pool_huge_page (bool enable) {
+        _buf_pool_huge_page = enable;
+    }
+    void disable_buf_pool (bool flag) {
+        _disable_buf_pool = flag;
+    }
+    bool is_buf_pool_disabled () const {
+        return _disable_buf_pool;
+    }
+
+    bool add_kernel (SmartPtr<SoftImageKernel> &kernel);
+    bool enable_handler (bool enable);
+    bool is_handler_enabled () const;
+
+    // group "soft_handler/<name>", updated by the processor around execute
+    SmartPtr<MetricsGroup> &get_metrics () {
+        return _metrics;
+    }
+    void update_execute_metrics (int64_t duration_us, XCamReturn ret);
+
+    virtual bool is_ready ();
+    virtual XCamReturn execute (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+    virtual void emit_stop ();
+
+protected:
+    virtual XCamReturn prepare_buffer_pool_video_info (
+        const VideoBufferInfo &input,
+        VideoBufferInfo &output);
+
+    // if derive prepare_output_buf, then prepare_buffer_pool_video_info is not involked
+    virtual XCamReturn prepare_output_buf (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+    virtual XCamReturn prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+    virtual XCamReturn execute_done (SmartPtr<VideoBuffer> &output);
+    XCamReturn create_buffer_pool (const VideoBufferInfo &video_info);
+    SmartPtr<BufferPool> &get_buffer_pool () {
+        return _buf_pool;
+    }
+
+    XCamReturn execute_kernel (
+        SmartPtr<SoftImageKernel> &kernel,
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+
+private:
+    XCAM_DEAD_COPY (SoftImageHandler);
+
+private:
+    char                      *_name;
+    bool                       _enable;
+    KernelList                 _kernels;
+    SmartPtr<BufferPool>       _buf_pool;
+    bool                       _disable_buf_pool;
+    bool                       _buf_pool_huge_page;
+    uint32_t                   _buf_pool_size;
+    X3aResultList              _3a_results;
+    int64_t                    _result_timestamp;
+
+    SmartPtr<MetricsGroup>     _metrics;
+    SmartPtr<MetricHistogram>  _execute_latency;
+    SmartPtr<MetricCounter>    _frames_counter;
+    SmartPtr<MetricCounter>    _bypassed_counter;
+    SmartPtr<MetricCounter>    _errors_counter;
+
+    XCAM_OBJ_PROFILING_DEFINES;
+};
+
+};
+
+#endif //XCAM_SOFT_IMAGE_HANDLER_H
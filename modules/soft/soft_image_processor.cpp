@@ -0,0 +1,166 @@
+/*
+ * soft_image_processor.cpp - CPU image processor
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_image_processor.h"
+#include "soft_image_handler.h"
+#include "buffer_pool.h"
+
+namespace XCam {
+
+SoftImageProcessor::SoftImageProcessor (const char* name)
+    : ImageProcessor (name ? name : "SoftImageProcessor")
+    , _keep_attached_buffer (false)
+{
+    XCAM_LOG_DEBUG ("SoftImageProcessor constructed");
+}
+
+SoftImageProcessor::~SoftImageProcessor ()
+{
+    XCAM_LOG_DEBUG ("SoftImageProcessor destructed");
+}
+
+bool
+SoftImageProcessor::add_handler (SmartPtr<SoftImageHandler> &handler)
+{
+    XCAM_ASSERT (handler.ptr ());
+    SmartLock locker (_handler_mutex);
+    _handlers.push_back (handler);
+    return true;
+}
+
+SoftImageProcessor::ImageHandlerList::iterator
+SoftImageProcessor::handlers_begin ()
+{
+    return _handlers.begin ();
+}
+
+SoftImageProcessor::ImageHandlerList::iterator
+SoftImageProcessor::handlers_end ()
+{
+    return _handlers.end ();
+}
+
+XCamReturn
+SoftImageProcessor::create_handlers ()
+{
+    return XCAM_RETURN_NO_ERROR;
+}
+
+bool
+SoftImageProcessor::can_process_result (SmartPtr<X3aResult> &result)
+{
+    XCAM_UNUSED (result);
+    return false;
+}
+
+// results go to every handler, each one picks the types it needs
+XCamReturn
+SoftImageProcessor::apply_3a_results (X3aResultList &results)
+{
+    SmartLock locker (_handler_mutex);
+
+    for (X3aResultList::iterator i_res = results.begin ();
+            i_res != results.end (); ++i_res) {
+        for (ImageHandlerList::iterator i_handler = _handlers.begin ();
+                i_handler != _handlers.end (); ++i_handler)
+            (*i_handler)->set_3a_result (*i_res);
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImageProcessor::apply_3a_result (SmartPtr<X3aResult> &result)
+{
+    SmartLock locker (_handler_mutex);
+
+    for (ImageHandlerList::iterator i_handler = _handlers.begin ();
+            i_handler != _handlers.end (); ++i_handler)
+        (*i_handler)->set_3a_result (result);
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImageProcessor::process_buffer (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    SmartPtr<VideoBuffer> in_data = input;
+
+    SmartLock locker (_handler_mutex);
+
+    if (_handlers.empty ())
+        ret = create_handlers ();
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        !_handlers.empty () && ret == XCAM_RETURN_NO_ERROR,
+        XCAM_RETURN_ERROR_PARAM,
+        "Soft image processor(%s) create handlers failed", XCAM_STR (get_name ()));
+
+    for (ImageHandlerList::iterator i_handler = _handlers.begin ();
+            i_handler != _handlers.end (); ++i_handler) {
+        SmartPtr<SoftImageHandler> &handler = *i_handler;
+        SmartPtr<VideoBuffer> out_data;
+
+        if (!handler->is_handler_enabled ())
+            continue;
+
+        int64_t start_us = MetricsRegistry::is_enabled () ? xcam_metrics_now_us () : 0;
+        ret = handler->execute (in_data, out_data);
+        if (start_us)
+            handler->update_execute_metrics (xcam_metrics_now_us () - start_us, ret);
+        XCAM_FAIL_RETURN (
+            WARNING,
+            (ret == XCAM_RETURN_NO_ERROR || ret == XCAM_RETURN_BYPASS),
+            ret,
+            "SoftImageProcessor(%s) execute handler(%s) failed",
+            XCAM_STR (get_name ()), XCAM_STR (handler->get_name ()));
+
+        // handler keeps the frame, e.g. waiting for more input
+        if (ret == XCAM_RETURN_BYPASS) {
+            output.release ();
+            return ret;
+        }
+
+        XCAM_ASSERT (out_data.ptr ());
+        if (out_data.ptr () != in_data.ptr ())
+            out_data->copy_stage_times (*in_data.ptr ());
+        in_data = out_data;
+    }
+
+    if (!_keep_attached_buffer && in_data.ptr () != input.ptr ()) {
+        SmartPtr<BufferProxy> out_proxy = in_data.dynamic_cast_ptr<BufferProxy> ();
+        if (out_proxy.ptr ())
+            out_proxy->clear_attached_buffers ();
+    }
+
+    output = in_data;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+// no lock, process_buffer may be blocked on a handler buffer pool
+void
+SoftImageProcessor::emit_stop ()
+{
+    for (ImageHandlerList::iterator i_handler = _handlers.begin ();
+            i_handler != _handlers.end (); ++i_handler)
+        (*i_handler)->emit_stop ();
+}
+
+};
@@ -0,0 +1,81 @@
+/*
+ * soft_image_processor.h - CPU image processor
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_IMAGE_PROCESSOR_H
+#define XCAM_SOFT_IMAGE_PROCESSOR_H
+
+#include "xcam_utils.h"
+#include "image_processor.h"
+#include "xcam_mutex.h"
+#include <list>
+
+namespace XCam {
+
+class SoftImageHandler;
+
+/*
+ * runs soft handlers one after another in processor thread,
+ * parallelism comes from the tiles of each kernel.
+ * plugs into the same places as CLImageProcessor.
+ */
+class SoftImageProcessor
+    : public ImageProcessor
+{
+public:
+    typedef std::list<SmartPtr<SoftImageHandler>>  ImageHandlerList;
+
+public:
+    explicit SoftImageProcessor (const char* name = NULL);
+    virtual ~SoftImageProcessor ();
+
+    void keep_attached_buf (bool flag) {
+        _keep_attached_buffer = flag;
+    }
+
+    bool add_handler (SmartPtr<SoftImageHandler> &handler);
+    ImageHandlerList::iterator handlers_begin ();
+    ImageHandlerList::iterator handlers_end ();
+
+protected:
+
+    //derive from ImageProcessor
+    virtual bool can_process_result (SmartPtr<X3aResult> &result);
+    virtual XCamReturn apply_3a_results (X3aResultList &results);
+    virtual XCamReturn apply_3a_result (SmartPtr<X3aResult> &result);
+    virtual XCamReturn process_buffer (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+    virtual void emit_stop ();
+
+    virtual XCamReturn create_handlers ();
+
+private:
+    XCAM_DEAD_COPY (SoftImageProcessor);
+
+protected:
+    // held around handler creation, execute and result apply
+    Mutex                          _handler_mutex;
+
+private:
+    ImageHandlerList               _handlers;
+    bool                           _keep_attached_buffer;  //default false
+};
+
+};
+
+#endif //XCAM_SOFT_IMAGE_PROCESSOR_H
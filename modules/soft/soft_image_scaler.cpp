@@ -0,0 +1,626 @@
+/*
+ * soft_image_scaler.cpp - CPU image scaler, several outputs in one pass
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_image_scaler.h"
+#include "host_mem_buffer.h"
+#include <math.h>
+
+#define SOFT_SCALER_LANCZOS_LOBES  3
+#define SOFT_SCALER_H_SHIFT        (XCAM_SOFT_SCALER_WEIGHT_BITS - XCAM_SOFT_SCALER_INTER_BITS)
+// source row pairs per horizontal pass chunk
+#define SOFT_SCALER_H_GRAIN        8
+
+namespace XCam {
+
+static double
+lanczos_weight (double x)
+{
+    const double a = SOFT_SCALER_LANCZOS_LOBES;
+    if (x == 0.0)
+        return 1.0;
+    if (x <= -a || x >= a)
+        return 0.0;
+    double px = M_PI * x;
+    return a * sin (px) * sin (px / a) / (px * px);
+}
+
+/*
+ * ideal taps of output coordinate @j from source index @first on,
+ * may reach outside the source, folded back by compute_scaler_taps.
+ */
+static uint32_t
+ideal_scaler_taps (
+    SoftScalerMode mode, double scale, uint32_t j,
+    int32_t &first, std::vector<double> &weights)
+{
+    double center = (j + 0.5) * scale - 0.5;
+
+    switch (mode) {
+    case SOFT_SCALER_AREA: {
+        // box of one output pixel, weighted by covered part of each source pixel
+        double x0 = j * scale, x1 = x0 + scale;
+        uint32_t count = (uint32_t)ceil (scale) + 1;
+        first = (int32_t)floor (x0);
+        weights.assign (count, 0.0);
+        for (uint32_t k = 0; k < count; ++k) {
+            double covered = XCAM_MIN (x1, first + k + 1.0) - XCAM_MAX (x0, (double)(first + (int32_t)k));
+            weights[k] = XCAM_MAX (covered, 0.0);
+        }
+        return count;
+    }
+    case SOFT_SCALER_LANCZOS: {
+        // stretched by the scale on downscaling to stay band limited
+        double stretch = XCAM_MAX (scale, 1.0);
+        double support = SOFT_SCALER_LANCZOS_LOBES * stretch;
+        uint32_t count = (uint32_t)ceil (2.0 * support) + 1;
+        first = (int32_t)floor (center - support) + 1;
+        weights.assign (count, 0.0);
+        for (uint32_t k = 0; k < count; ++k)
+            weights[k] = lanczos_weight ((first + (int32_t)k - center) / stretch);
+        return count;
+    }
+    default: {
+        first = (int32_t)floor (center);
+        double frac = center - first;
+        weights.assign (2, 0.0);
+        weights[0] = 1.0 - frac;
+        weights[1] = frac;
+        return 2;
+    }
+    }
+}
+
+static void
+compute_scaler_taps (SoftScalerMode mode, uint32_t src_size, uint32_t dst_size, SoftScalerTaps &taps)
+{
+    const int32_t one = 1 << XCAM_SOFT_SCALER_WEIGHT_BITS;
+    double scale = (double)src_size / dst_size;
+    std::vector<double> ideal, folded;
+    int32_t first = 0;
+
+    uint32_t count = ideal_scaler_taps (mode, scale, 0, first, ideal);
+    count = XCAM_MIN (count, src_size);
+    taps.count = count;
+    taps.starts.resize (dst_size);
+    taps.weights.resize ((size_t)dst_size * count);
+
+    for (uint32_t j = 0; j < dst_size; ++j) {
+        uint32_t ideal_count = ideal_scaler_taps (mode, scale, j, first, ideal);
+        int32_t start = XCAM_MAX (XCAM_MIN (first, (int32_t)(src_size - count)), 0);
+
+        // clamp to edge, weights outside the window go to the nearest tap
+        folded.assign (count, 0.0);
+        for (uint32_t k = 0; k < ideal_count; ++k) {
+            int32_t index = XCAM_MAX (XCAM_MIN (first + (int32_t)k, (int32_t)src_size - 1), 0);
+            int32_t pos = XCAM_MAX (XCAM_MIN (index - start, (int32_t)count - 1), 0);
+            folded[pos] += ideal[k];
+        }
+
+        double sum = 0.0;
+        for (uint32_t k = 0; k < count; ++k)
+            sum += folded[k];
+        if (fabs (sum) < 1e-9) {
+            folded.assign (count, 0.0);
+            folded[0] = sum = 1.0;
+        }
+
+        // fixed point, rounding residue goes to the largest tap
+        int16_t *w = &taps.weights[(size_t)j * count];
+        int32_t total = 0;
+        uint32_t largest = 0;
+        for (uint32_t k = 0; k < count; ++k) {
+            double value = folded[k] / sum * one;
+            w[k] = (int16_t)(value >= 0.0 ? value + 0.5 : value - 0.5);
+            total += w[k];
+            if (abs (w[k]) > abs (w[largest]))
+                largest = k;
+        }
+        w[largest] += one - total;
+        taps.starts[j] = start;
+    }
+}
+
+// first output row whose center is at or after source row @src_row
+static uint32_t
+first_owned_row (const SoftScalerPlaneTable &table, uint32_t src_row)
+{
+    if (src_row == 0)
+        return 0;
+    if (src_row >= table.src_rows)
+        return table.dst_rows;
+
+    double scale = (double)table.src_rows / table.dst_rows;
+    double row = ceil ((src_row + 0.5) / scale - 0.5);
+    return (uint32_t)XCAM_MAX (XCAM_MIN (row, (double)table.dst_rows), 0.0);
+}
+
+static void
+hfilter_row (const SoftScalerPlaneTable &table, const uint8_t *src, int16_t *dst)
+{
+    const uint32_t count = table.elements.size ();
+    const int32_t round = 1 << (SOFT_SCALER_H_SHIFT - 1);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const SoftScalerElement &element = table.elements[i];
+        const SoftScalerTaps &taps = table.h_taps[element.axis];
+        const int16_t *w = &taps.weights[(size_t)element.coord * taps.count];
+        const uint8_t *s = src + element.offset;
+        int32_t sum = round;
+
+        for (uint32_t k = 0; k < taps.count; ++k, s += element.step)
+            sum += w[k] * (*s);
+        dst[i] = (int16_t)(sum >> SOFT_SCALER_H_SHIFT);
+    }
+}
+
+// marks rows read by vertical taps, sizes filtered rows of @table
+static void
+init_filtered_rows (SoftScalerPlaneTable &table)
+{
+    const SoftScalerTaps &v_taps = table.v_taps;
+    uint32_t row_elements = table.elements.size ();
+
+    table.row_used.assign (table.src_rows, 0);
+    for (uint32_t j = 0; j < table.dst_rows; ++j)
+        for (uint32_t k = 0; k < v_taps.count; ++k)
+            table.row_used[v_taps.starts[j] + k] = 1;
+
+    table.filtered.resize ((size_t)table.src_rows * row_elements);
+    table.filtered_rows.resize (table.src_rows);
+    for (uint32_t r = 0; r < table.src_rows; ++r)
+        table.filtered_rows[r] = &table.filtered[(size_t)r * row_elements];
+}
+
+static void
+add_scaler_elements (
+    SoftScalerPlaneTable &table, uint32_t axis, uint32_t coord,
+    uint32_t step, uint32_t offset)
+{
+    SoftScalerElement element;
+    element.offset = table.h_taps[axis].starts[coord] * step + offset;
+    element.step = step;
+    element.axis = axis;
+    element.coord = coord;
+    table.elements.push_back (element);
+}
+
+SoftImageScalerKernel::SoftImageScalerKernel (const char *name)
+    : SoftImageKernel (name)
+    , _mode (SOFT_SCALER_BILINEAR)
+    , _funcs (NULL)
+    , _output_count (0)
+    , _tables_valid (false)
+{
+    // bands of full rows, every output takes its rows of the band
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, 0);
+}
+
+SoftImageScalerKernel::~SoftImageScalerKernel ()
+{
+}
+
+void
+SoftImageScalerKernel::set_scaler_mode (SoftScalerMode mode)
+{
+    if (_mode == mode)
+        return;
+    _mode = mode;
+    _tables_valid = false;
+}
+
+bool
+SoftImageScalerKernel::set_scaler_outputs (const SmartPtr<VideoBuffer> *outputs, uint32_t count)
+{
+    XCAM_FAIL_RETURN (
+        WARNING,
+        count <= XCAM_SOFT_SCALER_MAX_OUTPUTS,
+        false,
+        "soft scaler kernel(%s) supports at most %d outputs",
+        XCAM_STR (get_kernel_name ()), XCAM_SOFT_SCALER_MAX_OUTPUTS);
+
+    for (uint32_t i = 0; i < count; ++i)
+        _output_bufs[i] = outputs[i];
+    for (uint32_t i = count; i < XCAM_SOFT_SCALER_MAX_OUTPUTS; ++i)
+        _output_bufs[i].release ();
+    _output_count = count;
+    return true;
+}
+
+static bool
+same_size (const VideoBufferInfo &a, const VideoBufferInfo &b)
+{
+    return a.format == b.format && a.width == b.width && a.height == b.height;
+}
+
+XCamReturn
+SoftImageScalerKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    const VideoBufferInfo &in_info = _in.get_video_info ();
+    XCAM_FAIL_RETURN (
+        WARNING,
+        (in_info.format == V4L2_PIX_FMT_NV12 || in_info.format == V4L2_PIX_FMT_YUYV) &&
+        !(in_info.width % 2) && !(in_info.height % 2),
+        XCAM_RETURN_ERROR_PARAM,
+        "soft scaler kernel(%s) unsupported input %s(%dx%d)",
+        XCAM_STR (get_kernel_name ()),
+        xcam_fourcc_to_string (in_info.format), in_info.width, in_info.height);
+
+    for (uint32_t i = 0; i < _output_count; ++i) {
+        XCAM_ASSERT (_output_bufs[i].ptr ());
+        ret = _outputs[i].map (_output_bufs[i]);
+        XCAM_FAIL_RETURN (
+            WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+            "soft scaler kernel(%s) map output(%d) failed", XCAM_STR (get_kernel_name ()), i);
+
+        const VideoBufferInfo &out_info = _outputs[i].get_video_info ();
+        XCAM_FAIL_RETURN (
+            WARNING,
+            out_info.format == in_info.format &&
+            out_info.width && out_info.height &&
+            !(out_info.width % 2) && !(out_info.height % 2),
+            XCAM_RETURN_ERROR_PARAM,
+            "soft scaler kernel(%s) output(%d) %s(%dx%d) doesn't fit input",
+            XCAM_STR (get_kernel_name ()), i,
+            xcam_fourcc_to_string (out_info.format), out_info.width, out_info.height);
+
+        if (!same_size (out_info, _table_out_info[i]))
+            _tables_valid = false;
+    }
+    if (!same_size (in_info, _table_in_info))
+        _tables_valid = false;
+
+    if (!_tables_valid) {
+        ret = update_tables ();
+        XCAM_FAIL_RETURN (
+            WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+            "soft scaler kernel(%s) update filter tables failed", XCAM_STR (get_kernel_name ()));
+    }
+
+    if (_output_count) {
+        ret = ThreadPool::instance ()->parallel_for (in_info.height / 2, *this, SOFT_SCALER_H_GRAIN);
+        XCAM_FAIL_RETURN (
+            WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+            "soft scaler kernel(%s) horizontal pass failed", XCAM_STR (get_kernel_name ()));
+    }
+
+    _funcs = &get_soft_scaler_funcs (soft_simd_level ());
+    work_width = _output_count ? in_info.width : 0;
+    work_height = in_info.height;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImageScalerKernel::update_tables ()
+{
+    const VideoBufferInfo &in_info = _in.get_video_info ();
+    uint32_t w = in_info.width, h = in_info.height;
+
+    for (uint32_t i = 0; i < _output_count; ++i) {
+        const VideoBufferInfo &out_info = _outputs[i].get_video_info ();
+        uint32_t out_w = out_info.width, out_h = out_info.height;
+        std::vector<SoftScalerPlaneTable> &tables = _tables[i];
+
+        if (in_info.format == V4L2_PIX_FMT_NV12) {
+            tables.resize (2);
+            SoftScalerPlaneTable &y = tables[0];
+            SoftScalerPlaneTable &uv = tables[1];
+
+            y.src_rows = h;
+            y.dst_rows = out_h;
+            y.row_shift = 0;
+            y.elements.clear ();
+            compute_scaler_taps (_mode, w, out_w, y.h_taps[0]);
+            compute_scaler_taps (_mode, h, out_h, y.v_taps);
+            for (uint32_t x = 0; x < out_w; ++x)
+                add_scaler_elements (y, 0, x, 1, 0);
+
+            uv.src_rows = h / 2;
+            uv.dst_rows = out_h / 2;
+            uv.row_shift = 1;
+            uv.elements.clear ();
+            compute_scaler_taps (_mode, w / 2, out_w / 2, uv.h_taps[1]);
+            compute_scaler_taps (_mode, h / 2, out_h / 2, uv.v_taps);
+            for (uint32_t x = 0; x < out_w / 2; ++x) {
+                add_scaler_elements (uv, 1, x, 2, 0);
+                add_scaler_elements (uv, 1, x, 2, 1);
+            }
+        } else {
+            // YUYV, Y0 U Y1 V per pixel pair, chroma has half the columns
+            tables.resize (1);
+            SoftScalerPlaneTable &yuyv = tables[0];
+
+            yuyv.src_rows = h;
+            yuyv.dst_rows = out_h;
+            yuyv.row_shift = 0;
+            yuyv.elements.clear ();
+            compute_scaler_taps (_mode, w, out_w, yuyv.h_taps[0]);
+            compute_scaler_taps (_mode, w / 2, out_w / 2, yuyv.h_taps[1]);
+            compute_scaler_taps (_mode, h, out_h, yuyv.v_taps);
+            for (uint32_t x = 0; x < out_w / 2; ++x) {
+                add_scaler_elements (yuyv, 0, x * 2, 2, 0);
+                add_scaler_elements (yuyv, 1, x, 4, 1);
+                add_scaler_elements (yuyv, 0, x * 2 + 1, 2, 0);
+                add_scaler_elements (yuyv, 1, x, 4, 3);
+            }
+        }
+        for (uint32_t p = 0; p < tables.size (); ++p)
+            init_filtered_rows (tables[p]);
+        _table_out_info[i] = out_info;
+    }
+
+    _table_in_info = in_info;
+    _tables_valid = true;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+uint32_t
+SoftImageScalerKernel::get_bytes_per_pixel () const
+{
+    // int16 rows read and output pixels written per source pixel
+    return 4;
+}
+
+XCamReturn
+SoftImageScalerKernel::work_range (uint32_t begin, uint32_t end)
+{
+    for (uint32_t i = 0; i < _output_count; ++i) {
+        std::vector<SoftScalerPlaneTable> &tables = _tables[i];
+        for (uint32_t p = 0; p < tables.size (); ++p) {
+            SoftScalerPlaneTable &table = tables[p];
+            const SoftImagePlane &src = _in.get_plane (p);
+            uint32_t row_end = (end * 2) >> table.row_shift;
+            for (uint32_t r = (begin * 2) >> table.row_shift; r < row_end; ++r) {
+                if (table.row_used[r])
+                    hfilter_row (table, src.row (r), &table.filtered[(size_t)r * table.elements.size ()]);
+            }
+        }
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftImageScalerKernel::scale_plane (
+    const SoftScalerPlaneTable &table, const SoftImagePlane &dst,
+    uint32_t src_row_begin, uint32_t src_row_end) const
+{
+    const SoftScalerTaps &v_taps = table.v_taps;
+    uint32_t row_begin = first_owned_row (table, src_row_begin);
+    uint32_t row_end = first_owned_row (table, src_row_end);
+    uint32_t row_elements = table.elements.size ();
+
+    for (uint32_t j = row_begin; j < row_end; ++j) {
+        _funcs->vfilter (
+            &table.filtered_rows[v_taps.starts[j]], &v_taps.weights[(size_t)j * v_taps.count], v_taps.count,
+            dst.row (j), row_elements);
+    }
+}
+
+XCamReturn
+SoftImageScalerKernel::work_tile (const ImageTile &tile)
+{
+    XCAM_ASSERT (_funcs);
+    XCAM_ASSERT (!(tile.y % 2) && !(tile.height % 2));
+
+    for (uint32_t i = 0; i < _output_count; ++i) {
+        const std::vector<SoftScalerPlaneTable> &tables = _tables[i];
+        for (uint32_t p = 0; p < tables.size (); ++p) {
+            const SoftScalerPlaneTable &table = tables[p];
+            scale_plane (
+                table, _outputs[i].get_plane (p),
+                tile.y >> table.row_shift, (tile.y + tile.height) >> table.row_shift);
+        }
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImageScalerKernel::post_execute (SmartPtr<VideoBuffer> &output)
+{
+    for (uint32_t i = 0; i < XCAM_SOFT_SCALER_MAX_OUTPUTS; ++i) {
+        _outputs[i].unmap ();
+        _output_bufs[i].release ();
+    }
+    return SoftImageKernel::post_execute (output);
+}
+
+void
+SoftImageScalerKernel::pre_stop ()
+{
+    for (uint32_t i = 0; i < XCAM_SOFT_SCALER_MAX_OUTPUTS; ++i)
+        _outputs[i].unmap ();
+    SoftImageKernel::pre_stop ();
+}
+
+SoftImageScaler::SoftImageScaler (const char *name)
+    : SoftImageHandler (name)
+    , _mode (SOFT_SCALER_BILINEAR)
+    , _output_count (1)
+{
+    xcam_mem_clear (_factors);
+    _factors[0] = 0.5;
+}
+
+bool
+SoftImageScaler::set_scaler_kernel (SmartPtr<SoftImageScalerKernel> &kernel)
+{
+    SmartPtr<SoftImageKernel> image_kernel = kernel;
+    add_kernel (image_kernel);
+    _scaler_kernel = kernel;
+    _scaler_kernel->set_scaler_mode (_mode);
+    return true;
+}
+
+bool
+SoftImageScaler::set_scaler_mode (SoftScalerMode mode)
+{
+    _mode = mode;
+    if (_scaler_kernel.ptr ())
+        _scaler_kernel->set_scaler_mode (mode);
+    return true;
+}
+
+bool
+SoftImageScaler::set_scaler_factors (const double *factors, uint32_t count)
+{
+    XCAM_FAIL_RETURN (
+        WARNING,
+        factors && count && count <= XCAM_SOFT_SCALER_MAX_OUTPUTS,
+        false,
+        "SoftImageScaler(%s) supports 1 to %d factors", XCAM_STR (get_name ()), XCAM_SOFT_SCALER_MAX_OUTPUTS);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        XCAM_FAIL_RETURN (
+            WARNING,
+            factors[i] > 0.0 && factors[i] <= 1.0,
+            false,
+            "SoftImageScaler(%s) factor(%.3f) out of (0, 1]", XCAM_STR (get_name ()), factors[i]);
+    }
+
+    // sizes change, pools are rebuilt on next frame
+    for (uint32_t i = 0; i < XCAM_SOFT_SCALER_MAX_OUTPUTS; ++i) {
+        _factors[i] = (i < count) ? factors[i] : 0.0;
+        _scaler_buf_pools[i].release ();
+        _scaler_bufs[i].release ();
+    }
+    _output_count = count;
+    return true;
+}
+
+XCamReturn
+SoftImageScaler::prepare_scaler_buf (uint32_t index, const VideoBufferInfo &video_info)
+{
+    SmartPtr<BufferPool> &pool = _scaler_buf_pools[index];
+
+    if (!pool.ptr ()) {
+        VideoBufferInfo scaler_video_info;
+        uint32_t new_width = XCAM_ALIGN_UP ((uint32_t)(video_info.width * _factors[index] + 0.5), 2);
+        uint32_t new_height = XCAM_ALIGN_UP ((uint32_t)(video_info.height * _factors[index] + 0.5), 2);
+        new_width = XCAM_MAX (new_width, 2u);
+        new_height = XCAM_MAX (new_height, 2u);
+
+        scaler_video_info.init (video_info.format, new_width, new_height);
+        pool = new HostMemBufferPool;
+        pool->set_name (XCAM_STR (get_name ()));
+        XCAM_FAIL_RETURN (
+            WARNING,
+            pool->set_video_info (scaler_video_info) && pool->reserve (XCAM_SOFT_SCALER_BUF_NUM),
+            XCAM_RETURN_ERROR_MEM,
+            "SoftImageScaler(%s) init scaler buffer pool(%dx%d) failed",
+            XCAM_STR (get_name ()), new_width, new_height);
+    }
+
+    SmartPtr<BufferProxy> buffer = pool->get_buffer (pool);
+    XCAM_FAIL_RETURN (
+        WARNING,
+        buffer.ptr (),
+        XCAM_RETURN_ERROR_MEM,
+        "SoftImageScaler(%s) get scaler buffer(%d) failed", XCAM_STR (get_name ()), index);
+
+    _scaler_bufs[index] = buffer;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImageScaler::prepare_output_buf (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    output = input;
+
+    for (uint32_t i = 0; i < _output_count; ++i) {
+        ret = prepare_scaler_buf (i, input->get_video_info ());
+        XCAM_FAIL_RETURN (
+            WARNING,
+            ret == XCAM_RETURN_NO_ERROR,
+            ret,
+            "SoftImageScaler(%s) prepare scaled video buf failed", XCAM_STR (get_name ()));
+        _scaler_bufs[i]->set_timestamp (input->get_timestamp ());
+    }
+    return ret;
+}
+
+XCamReturn
+SoftImageScaler::prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+    XCAM_ASSERT (_scaler_kernel.ptr ());
+
+    if (!_scaler_kernel->set_scaler_outputs (_scaler_bufs, _output_count))
+        return XCAM_RETURN_ERROR_PARAM;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftImageScaler::execute_done (SmartPtr<VideoBuffer> &output)
+{
+    XCAM_UNUSED (output);
+
+    if (!_scaler_callback.ptr ())
+        return XCAM_RETURN_NO_ERROR;
+
+    for (uint32_t i = 0; i < _output_count; ++i) {
+        SmartPtr<BufferProxy> buffer = _scaler_bufs[i].dynamic_cast_ptr<BufferProxy> ();
+        XCAM_ASSERT (buffer.ptr ());
+        XCamReturn ret = _scaler_callback->scaled_image_ready (buffer);
+        XCAM_FAIL_RETURN (
+            WARNING,
+            ret == XCAM_RETURN_NO_ERROR,
+            ret,
+            "SoftImageScaler(%s) post scaled buffer(%d) failed", XCAM_STR (get_name ()), i);
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+SoftImageScaler::emit_stop ()
+{
+    for (uint32_t i = 0; i < XCAM_SOFT_SCALER_MAX_OUTPUTS; ++i) {
+        if (_scaler_buf_pools[i].ptr ())
+            _scaler_buf_pools[i]->stop ();
+    }
+    SoftImageHandler::emit_stop ();
+}
+
+SmartPtr<SoftImageHandler>
+create_soft_image_scaler_handler (uint32_t format)
+{
+    SmartPtr<SoftImageScaler> scaler_handler;
+    SmartPtr<SoftImageScalerKernel> scaler_kernel;
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        V4L2_PIX_FMT_NV12 == format || V4L2_PIX_FMT_YUYV == format,
+        NULL,
+        "create soft image scaler failed, unsupported format:%s", xcam_fourcc_to_string (format));
+
+    scaler_handler = new SoftImageScaler ();
+    scaler_kernel = new SoftImageScalerKernel ("soft_image_scaler");
+    scaler_handler->set_scaler_kernel (scaler_kernel);
+
+    return scaler_handler;
+}
+
+};
@@ -0,0 +1,185 @@
+/*
+ * soft_image_scaler.h - CPU image scaler, several outputs in one pass
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_IMAGE_SCALER_H
+#define XCAM_SOFT_IMAGE_SCALER_H
+
+#include "xcam_utils.h"
+#include "soft_image_handler.h"
+#include "soft_scaler_simd.h"
+#include "stats_callback_interface.h"
+#include <vector>
+
+#define XCAM_SOFT_SCALER_MAX_OUTPUTS  4
+#define XCAM_SOFT_SCALER_BUF_NUM      6
+
+namespace XCam {
+
+enum SoftScalerMode {
+    SOFT_SCALER_BILINEAR = 0,
+    SOFT_SCALER_AREA,
+    SOFT_SCALER_LANCZOS,
+};
+
+// 1-D filter, @count taps per output coordinate, window kept inside source
+struct SoftScalerTaps {
+    uint32_t                count;
+    std::vector<uint32_t>   starts;
+    std::vector<int16_t>    weights;
+
+    SoftScalerTaps () : count (0) {}
+};
+
+// output element of a horizontally filtered row
+struct SoftScalerElement {
+    uint32_t   offset;   // source byte of first tap
+    uint16_t   step;     // source bytes between taps
+    uint16_t   axis;     // index of SoftScalerPlaneTable::h_taps
+    uint32_t   coord;    // output coordinate on that axis
+};
+
+// one plane of one output
+struct SoftScalerPlaneTable {
+    uint32_t                          src_rows;
+    uint32_t                          dst_rows;
+    uint32_t                          row_shift;   // band rows to plane rows, 1 for 4:2:0 chroma
+    std::vector<SoftScalerElement>    elements;
+    SoftScalerTaps                    h_taps[2];   // luma, chroma
+    SoftScalerTaps                    v_taps;
+
+    // horizontally filtered source rows, rows no vertical tap reads stay unset
+    std::vector<uint8_t>              row_used;
+    std::vector<int16_t>              filtered;
+    std::vector<const int16_t *>      filtered_rows;
+};
+
+/*
+ * scales NV12 or YUYV input to all outputs at once.
+ * every source row read by a vertical tap is filtered horizontally once
+ * per output into int16 rows kept with the tables, spread over the pool
+ * in prepare_arguments. tiles are row bands of source, each band
+ * filters vertically the output rows centered in it.
+ */
+class SoftImageScalerKernel
+    : public SoftImageKernel
+    , public ParallelFunc
+{
+public:
+    explicit SoftImageScalerKernel (const char *name);
+    virtual ~SoftImageScalerKernel ();
+
+    void set_scaler_mode (SoftScalerMode mode);
+    // outputs of next execute, same format as input
+    bool set_scaler_outputs (const SmartPtr<VideoBuffer> *outputs, uint32_t count);
+
+    virtual XCamReturn post_execute (SmartPtr<VideoBuffer> &output);
+    virtual void pre_stop ();
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual uint32_t get_bytes_per_pixel () const;
+    virtual XCamReturn work_tile (const ImageTile &tile);
+    // horizontal pass on source row pairs [begin, end)
+    virtual XCamReturn work_range (uint32_t begin, uint32_t end);
+
+private:
+    XCamReturn update_tables ();
+    void scale_plane (
+        const SoftScalerPlaneTable &table, const SoftImagePlane &dst,
+        uint32_t src_row_begin, uint32_t src_row_end) const;
+
+    XCAM_DEAD_COPY (SoftImageScalerKernel);
+
+private:
+    SoftScalerMode                       _mode;
+    const SoftScalerFuncs               *_funcs;
+    uint32_t                             _output_count;
+    SmartPtr<VideoBuffer>                _output_bufs[XCAM_SOFT_SCALER_MAX_OUTPUTS];
+    SoftImageFrame                       _outputs[XCAM_SOFT_SCALER_MAX_OUTPUTS];
+
+    // rebuilt when mode or any size changes
+    bool                                 _tables_valid;
+    VideoBufferInfo                      _table_in_info;
+    VideoBufferInfo                      _table_out_info[XCAM_SOFT_SCALER_MAX_OUTPUTS];
+    std::vector<SoftScalerPlaneTable>    _tables[XCAM_SOFT_SCALER_MAX_OUTPUTS];
+};
+
+/*
+ * CPU counterpart of CLImageScaler.
+ * input passes through, scaled copies are posted to the callback
+ * by scaled_image_ready in order of the factors.
+ */
+class SoftImageScaler
+    : public SoftImageHandler
+{
+public:
+    explicit SoftImageScaler (const char *name = "soft_image_scaler");
+
+    void set_buffer_callback (SmartPtr<StatsCallback> &callback) {
+        _scaler_callback = callback;
+    }
+
+    bool set_scaler_kernel (SmartPtr<SoftImageScalerKernel> &kernel);
+    bool set_scaler_mode (SoftScalerMode mode);
+    SoftScalerMode get_scaler_mode () const {
+        return _mode;
+    }
+    // factors of input size in (0, 1], e.g. {0.5, 0.25, 0.125}
+    bool set_scaler_factors (const double *factors, uint32_t count);
+    bool set_scaler_factor (const double factor) {
+        return set_scaler_factors (&factor, 1);
+    }
+    uint32_t get_output_count () const {
+        return _output_count;
+    }
+    SmartPtr<VideoBuffer> &get_scaler_buf (uint32_t index) {
+        XCAM_ASSERT (index < _output_count);
+        return _scaler_bufs[index];
+    }
+
+    virtual void emit_stop ();
+
+protected:
+    virtual XCamReturn prepare_output_buf (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+    virtual XCamReturn prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+    virtual XCamReturn execute_done (SmartPtr<VideoBuffer> &output);
+
+private:
+    XCamReturn prepare_scaler_buf (uint32_t index, const VideoBufferInfo &video_info);
+    XCAM_DEAD_COPY (SoftImageScaler);
+
+private:
+    SoftScalerMode                   _mode;
+    uint32_t                         _output_count;
+    double                           _factors[XCAM_SOFT_SCALER_MAX_OUTPUTS];
+    SmartPtr<BufferPool>             _scaler_buf_pools[XCAM_SOFT_SCALER_MAX_OUTPUTS];
+    SmartPtr<VideoBuffer>            _scaler_bufs[XCAM_SOFT_SCALER_MAX_OUTPUTS];
+    SmartPtr<SoftImageScalerKernel>  _scaler_kernel;
+    SmartPtr<StatsCallback>          _scaler_callback;
+};
+
+SmartPtr<SoftImageHandler>
+create_soft_image_scaler_handler (uint32_t format);
+
+};
+
+#endif //XCAM_SOFT_IMAGE_SCALER_H
@@ -0,0 +1,484 @@
+/*
+ * soft_pyramid_blender.cpp - CPU pyramid blender
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_pyramid_blender.h"
+#include <math.h>
+
+namespace XCam {
+
+static inline uint32_t
+clamp_index (int32_t i, uint32_t size)
+{
+    return (uint32_t)XCAM_MAX (XCAM_MIN (i, (int32_t)size - 1), 0);
+}
+
+// same blur as gauss_blur_buffer of CLPyramidBlender
+static void
+blur_mask (std::vector<float> &mask, int radius, float sigma)
+{
+    if (radius < 1)
+        return;
+
+    std::vector<float> coeffs (radius * 2 + 1);
+    float sum = 0.0f;
+    for (int i = 0; i < (int)coeffs.size (); ++i) {
+        float dis = (float)(i - radius) * (i - radius);
+        coeffs[i] = expf (-dis / (2.0f * sigma * sigma));
+        sum += coeffs[i];
+    }
+
+    std::vector<float> blurred (mask.size (), 0.0f);
+    for (uint32_t i = 0; i < mask.size (); ++i) {
+        for (int j = -radius; j <= radius; ++j)
+            blurred[i] += mask[clamp_index ((int32_t)i + j, mask.size ())] * coeffs[radius + j] / sum;
+    }
+    mask.swap (blurred);
+}
+
+// 9-tap blur of seam masks, same coeffs as kernel_mask_gauss_scale_slm
+static void
+blur_seam_mask (std::vector<float> &mask)
+{
+    static const float coeffs[] = {0.082f, 0.102f, 0.119f, 0.130f, 0.134f, 0.130f, 0.119f, 0.102f, 0.082f};
+    const int32_t radius = 4;
+
+    std::vector<float> blurred (mask.size (), 0.0f);
+    for (uint32_t i = 0; i < mask.size (); ++i) {
+        for (int32_t j = -radius; j <= radius; ++j)
+            blurred[i] += mask[clamp_index ((int32_t)i + j, mask.size ())] * coeffs[radius + j];
+    }
+    mask.swap (blurred);
+}
+
+static void
+convert_mask (const std::vector<float> &from, std::vector<int16_t> &to, uint32_t channels)
+{
+    const float one = (float)(1 << XCAM_SOFT_PYRAMID_MASK_BITS);
+    to.resize (from.size () * channels);
+    for (uint32_t i = 0; i < from.size (); ++i) {
+        float weight = XCAM_MAX (XCAM_MIN (from[i], 1.0f), 0.0f);
+        for (uint32_t c = 0; c < channels; ++c)
+            to[i * channels + c] = (int16_t)(weight * one + 0.5f);
+    }
+}
+
+// each output pixel averages two pixels of @from, edge clamped
+static void
+halve_mask (const std::vector<float> &from, std::vector<float> &to, uint32_t width)
+{
+    to.resize (width);
+    for (uint32_t i = 0; i < width; ++i)
+        to[i] = (from[clamp_index (i * 2, from.size ())] + from[clamp_index (i * 2 + 1, from.size ())]) / 2.0f;
+}
+
+static void
+set_image (SoftImagePlane &image, uint8_t *data, uint32_t pitch, uint32_t width, uint32_t height, uint32_t pixel_bytes)
+{
+    image.data = data;
+    image.pitch = pitch;
+    image.width = width;
+    image.height = height;
+    image.pixel_bytes = pixel_bytes;
+}
+
+SoftPyramidLayer::SoftPyramidLayer ()
+    : blend_width (0)
+    , blend_height (0)
+{
+    xcam_mem_clear (seam_mask_center);
+}
+
+SoftPyramidBlender::SoftPyramidBlender (const char *name, uint32_t layers, bool need_seam)
+    : SoftBlender (name)
+    , _layers (layers)
+    , _need_seam (need_seam)
+{
+    XCAM_ASSERT (layers > 0 && layers <= XCAM_SOFT_PYRAMID_MAX_LEVEL);
+}
+
+void
+SoftPyramidBlender::init_layers (uint32_t width, uint32_t height)
+{
+    uint32_t plane_width[SoftBlenderPlaneMax] = {width, width / 2};
+    uint32_t plane_height[SoftBlenderPlaneMax] = {height, height / 2};
+
+    for (uint32_t i_layer = 0; i_layer < _layers; ++i_layer) {
+        SoftPyramidLayer &layer = _pyramid_layers[i_layer];
+        if (i_layer) {
+            for (uint32_t plane = 0; plane < SoftBlenderPlaneMax; ++plane) {
+                plane_width[plane] = (plane_width[plane] + 1) / 2;
+                plane_height[plane] = (plane_height[plane] + 1) / 2;
+            }
+        }
+        layer.blend_width = plane_width[SoftBlenderPlaneY];
+        layer.blend_height = plane_height[SoftBlenderPlaneY];
+
+        // layer 0 is bound to buffers of each frame
+        if (!i_layer) {
+            std::vector<uint8_t> ().swap (layer.storage);
+            continue;
+        }
+
+        // gauss of both inputs and reconstruct per plane
+        uint32_t pitches[SoftBlenderPlaneMax];
+        size_t size = 0;
+        for (uint32_t plane = 0; plane < SoftBlenderPlaneMax; ++plane) {
+            pitches[plane] = XCAM_ALIGN_UP (plane_width[plane] * (plane + 1), 16);
+            size += (size_t)pitches[plane] * plane_height[plane] * (XCAM_SOFT_BLENDER_IMAGE_NUM + 1);
+        }
+        layer.storage.assign (size, 0);
+
+        uint8_t *data = &layer.storage[0];
+        for (uint32_t plane = 0; plane < SoftBlenderPlaneMax; ++plane) {
+            size_t image_size = (size_t)pitches[plane] * plane_height[plane];
+            for (uint32_t i = 0; i < XCAM_SOFT_BLENDER_IMAGE_NUM; ++i) {
+                set_image (
+                    layer.gauss_image[plane][i], data,
+                    pitches[plane], plane_width[plane], plane_height[plane], plane + 1);
+                data += image_size;
+            }
+            set_image (
+                layer.reconstruct_image[plane], data,
+                pitches[plane], plane_width[plane], plane_height[plane], plane + 1);
+            data += image_size;
+        }
+    }
+}
+
+/*
+ * same masks as CLPyramidBlender without seam: input 0 on the left half
+ * of the window, edge blurred on every layer, chroma follows luma.
+ */
+void
+SoftPyramidBlender::init_masks (uint32_t width)
+{
+    int radius = (int)((((float)(width - 1) / 2) / (1 << _layers)) * 1.2f);
+    float sigma = (float)radius;
+    std::vector<float> mask (width), chroma;
+
+    for (uint32_t i = 0; i < width; ++i)
+        mask[i] = (i <= width / 2) ? 1.0f : 0.0f;
+    blur_mask (mask, radius, sigma);
+
+    for (uint32_t i_layer = 0; i_layer < _layers; ++i_layer) {
+        SoftPyramidLayer &layer = _pyramid_layers[i_layer];
+        if (i_layer) {
+            std::vector<float> prev;
+            prev.swap (mask);
+            halve_mask (prev, mask, layer.blend_width);
+            blur_mask (mask, radius, sigma);
+        }
+        convert_mask (mask, layer.blend_mask[SoftBlenderPlaneY], 1);
+
+        halve_mask (mask, chroma, layer.gauss_image[SoftBlenderPlaneUV][0].width);
+        convert_mask (chroma, layer.blend_mask[SoftBlenderPlaneUV], 2);
+    }
+}
+
+/*
+ * seam masks are twice as wide as a layer plus margins, input 0 up to the
+ * center. a row starts at center - seam, which puts the step on the seam.
+ * like CLPyramidBlender, layer 0 is blurred by 9 taps and every other
+ * layer is halved from the one below and blurred again.
+ */
+void
+SoftPyramidBlender::init_seam_masks (uint32_t width)
+{
+    uint32_t center = width;
+    std::vector<float> mask (width * 2 + 2), chroma;
+
+    for (uint32_t i = 0; i < mask.size (); ++i)
+        mask[i] = (i <= center) ? 1.0f : 0.0f;
+    blur_seam_mask (mask);
+
+    for (uint32_t i_layer = 0; i_layer < _layers; ++i_layer) {
+        SoftPyramidLayer &layer = _pyramid_layers[i_layer];
+        if (i_layer) {
+            std::vector<float> prev;
+            prev.swap (mask);
+            halve_mask (prev, mask, (prev.size () + 1) / 2);
+            blur_seam_mask (mask);
+            center /= 2;
+        }
+        convert_mask (mask, layer.seam_mask[SoftBlenderPlaneY], 1);
+        layer.seam_mask_center[SoftBlenderPlaneY] = center;
+
+        halve_mask (mask, chroma, (mask.size () + 1) / 2);
+        convert_mask (chroma, layer.seam_mask[SoftBlenderPlaneUV], 2);
+        layer.seam_mask_center[SoftBlenderPlaneUV] = center / 2;
+    }
+}
+
+const int16_t *
+SoftPyramidBlender::get_blend_mask (uint32_t layer, uint32_t plane, uint32_t y) const
+{
+    const SoftPyramidLayer &pyr_layer = _pyramid_layers[layer];
+    const std::vector<int16_t> &seam = _seam_finder.get_seam ();
+    if (!_need_seam || seam.empty ())
+        return &pyr_layer.blend_mask[plane][0];
+
+    // seam is in luma columns of layer 0, one per row
+    uint32_t shift = layer + plane;
+    int32_t pos = seam[XCAM_MIN (y << shift, (uint32_t)seam.size () - 1)] >> shift;
+    return &pyr_layer.seam_mask[plane][(pyr_layer.seam_mask_center[plane] - pos) * (plane + 1)];
+}
+
+void
+SoftPyramidBlender::bind_frames_to_layer0 ()
+{
+    SoftPyramidLayer &layer = _pyramid_layers[0];
+    const Rect &window = get_merge_window ();
+
+    // frame planes of NV12 count chroma in bytes, layers count it in UV pairs
+    for (uint32_t plane = 0; plane < SoftBlenderPlaneMax; ++plane) {
+        uint32_t width = layer.blend_width >> plane;
+        for (uint32_t i = 0; i < XCAM_SOFT_BLENDER_IMAGE_NUM; ++i) {
+            const SoftImagePlane &in = get_input_frame (i).get_plane (plane);
+            set_image (
+                layer.gauss_image[plane][i], in.data + get_input_merge_area (i).pos_x,
+                in.pitch, width, in.height, plane + 1);
+        }
+        const SoftImagePlane &out = get_output_frame ().get_plane (plane);
+        set_image (
+            layer.reconstruct_image[plane], out.data + window.pos_x,
+            out.pitch, width, out.height, plane + 1);
+    }
+}
+
+XCamReturn
+SoftPyramidBlender::allocate_soft_buffers ()
+{
+    const Rect &window = get_merge_window ();
+    uint32_t height = get_output_frame ().get_plane (0).height;
+    SoftPyramidLayer &layer0 = _pyramid_layers[0];
+
+    // storage and masks of all layers are reused until the window changes
+    if ((uint32_t)window.width != layer0.blend_width || height != layer0.blend_height) {
+        XCAM_LOG_DEBUG (
+            "SoftPyramidBlender(%s) init %d layers of %dx%d",
+            get_name (), _layers, window.width, height);
+        init_layers (window.width, height);
+        bind_frames_to_layer0 ();
+        init_masks (window.width);
+        if (_need_seam) {
+            init_seam_masks (window.width);
+            _seam_finder.reset ();
+        }
+    } else {
+        bind_frames_to_layer0 ();
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftPyramidBlender::prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCamReturn ret = SoftBlender::prepare_parameters (input, output);
+    if (ret != XCAM_RETURN_NO_ERROR || !_need_seam)
+        return ret;
+
+    // search in the middle half of the window, same range as CLPyramidBlender
+    const SoftPyramidLayer &layer0 = _pyramid_layers[0];
+    uint32_t width = layer0.blend_width;
+    uint32_t begin = XCAM_ALIGN_UP (width / 4, XCAM_SOFT_BLENDER_ALIGNED_WIDTH);
+    uint32_t valid_width = XCAM_ALIGN_DOWN (width / 2, XCAM_SOFT_BLENDER_ALIGNED_WIDTH);
+    if (begin >= width)
+        begin = 0;
+    if (!valid_width)
+        valid_width = XCAM_SOFT_BLENDER_ALIGNED_WIDTH;
+
+    ret = _seam_finder.search (
+              layer0.gauss_image[SoftBlenderPlaneY][0], layer0.gauss_image[SoftBlenderPlaneY][1],
+              begin, XCAM_MIN (begin + valid_width, width));
+    if (ret != XCAM_RETURN_NO_ERROR) {
+        unmap_frames ();
+        XCAM_LOG_WARNING ("SoftPyramidBlender(%s) seam search failed", get_name ());
+    }
+    return ret;
+}
+
+SoftPyramidGaussKernel::SoftPyramidGaussKernel (SoftPyramidBlender *blender, uint32_t layer, uint32_t plane)
+    : SoftImageKernel ("soft_pyramid_gauss")
+    , _blender (blender)
+    , _layer (layer)
+    , _plane (plane)
+    , _funcs (NULL)
+    , _row_elements (0)
+{
+    XCAM_ASSERT (blender && layer + 1 < blender->get_layers ());
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, XCAM_SOFT_PYRAMID_TILE_ROWS);
+}
+
+XCamReturn
+SoftPyramidGaussKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    const SoftImagePlane &src = _blender->get_pyramid_layer (_layer).gauss_image[_plane][0];
+    const SoftImagePlane &dst = _blender->get_pyramid_layer (_layer + 1).gauss_image[_plane][0];
+    uint32_t tiles = XCAM_ALIGN_UP (dst.height, XCAM_SOFT_PYRAMID_TILE_ROWS) / XCAM_SOFT_PYRAMID_TILE_ROWS;
+
+    _funcs = &get_soft_pyramid_funcs (soft_simd_level ());
+    _row_elements = src.width * src.pixel_bytes + XCAM_SOFT_PYRAMID_ROW_MARGIN * 2;
+    if (_rows.size () < (size_t)_row_elements * tiles)
+        _rows.assign ((size_t)_row_elements * tiles, 0);
+
+    work_width = dst.width;
+    work_height = dst.height;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftPyramidGaussKernel::work_tile (const ImageTile &tile)
+{
+    const SoftPyramidLayer &from = _blender->get_pyramid_layer (_layer);
+    const SoftPyramidLayer &to = _blender->get_pyramid_layer (_layer + 1);
+    int16_t *row = &_rows[(size_t)_row_elements * (tile.y / XCAM_SOFT_PYRAMID_TILE_ROWS)] + XCAM_SOFT_PYRAMID_ROW_MARGIN;
+    uint32_t channels = from.gauss_image[_plane][0].pixel_bytes;
+    SoftPyramidGaussHFunc gauss_h = (channels == 1) ? _funcs->gauss_h_luma : _funcs->gauss_h_chroma;
+
+    for (uint32_t i = 0; i < XCAM_SOFT_BLENDER_IMAGE_NUM; ++i) {
+        const SoftImagePlane &src = from.gauss_image[_plane][i];
+        const SoftImagePlane &dst = to.gauss_image[_plane][i];
+        uint32_t src_bytes = src.width * channels;
+
+        for (uint32_t y = tile.y; y < tile.y + tile.height; ++y) {
+            const uint8_t *rows[5];
+            for (int32_t k = 0; k < 5; ++k)
+                rows[k] = src.row (clamp_index ((int32_t)y * 2 + k - 2, src.height));
+            _funcs->gauss_v (rows, row, src_bytes);
+
+            // replicate edge pixels of each channel into margins
+            int16_t *right = row + src_bytes - channels;
+            for (int32_t j = channels; j <= XCAM_SOFT_PYRAMID_ROW_MARGIN; j += channels) {
+                for (uint32_t c = 0; c < channels; ++c) {
+                    row[(int32_t)c - j] = row[c];
+                    right[c + j] = right[c];
+                }
+            }
+            gauss_h (row, dst.row (y), dst.width);
+        }
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SoftPyramidBlendKernel::SoftPyramidBlendKernel (SoftPyramidBlender *blender, uint32_t layer, uint32_t plane)
+    : SoftImageKernel ("soft_pyramid_blend")
+    , _blender (blender)
+    , _layer (layer)
+    , _plane (plane)
+    , _funcs (NULL)
+    , _row_elements (0)
+{
+    XCAM_ASSERT (blender && layer < blender->get_layers ());
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, XCAM_SOFT_PYRAMID_TILE_ROWS);
+}
+
+XCamReturn
+SoftPyramidBlendKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    const SoftImagePlane &dst = _blender->get_pyramid_layer (_layer).reconstruct_image[_plane];
+    uint32_t tiles = XCAM_ALIGN_UP (dst.height, XCAM_SOFT_PYRAMID_TILE_ROWS) / XCAM_SOFT_PYRAMID_TILE_ROWS;
+
+    _funcs = &get_soft_pyramid_funcs (soft_simd_level ());
+    _row_elements = XCAM_ALIGN_UP (dst.width * dst.pixel_bytes, 8);
+    if (_layer + 1 < _blender->get_layers () && _rows.size () < (size_t)_row_elements * 3 * tiles)
+        _rows.assign ((size_t)_row_elements * 3 * tiles, 0);
+
+    work_width = dst.width;
+    work_height = dst.height;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftPyramidBlendKernel::work_tile (const ImageTile &tile)
+{
+    const SoftPyramidLayer &layer = _blender->get_pyramid_layer (_layer);
+    const SoftImagePlane &in0 = layer.gauss_image[_plane][0];
+    const SoftImagePlane &in1 = layer.gauss_image[_plane][1];
+    const SoftImagePlane &dst = layer.reconstruct_image[_plane];
+    uint32_t bytes = dst.width * dst.pixel_bytes;
+
+    if (_layer + 1 == _blender->get_layers ()) {
+        for (uint32_t y = tile.y; y < tile.y + tile.height; ++y) {
+            const int16_t *mask = _blender->get_blend_mask (_layer, _plane, y);
+            _funcs->blend (in0.row (y), in1.row (y), mask, dst.row (y), bytes);
+        }
+        return XCAM_RETURN_NO_ERROR;
+    }
+
+    const SoftPyramidLayer &next = _blender->get_pyramid_layer (_layer + 1);
+    const SoftImagePlane *expand_from[3] = {
+        &next.gauss_image[_plane][0], &next.gauss_image[_plane][1], &next.reconstruct_image[_plane]
+    };
+    SoftPyramidExpandFunc expand = (dst.pixel_bytes == 1) ? _funcs->expand_luma : _funcs->expand_chroma;
+    int16_t *expanded[3];
+    for (uint32_t i = 0; i < 3; ++i)
+        expanded[i] = &_rows[(size_t)_row_elements * ((tile.y / XCAM_SOFT_PYRAMID_TILE_ROWS) * 3 + i)];
+
+    for (uint32_t y = tile.y; y < tile.y + tile.height; ++y) {
+        uint32_t top = y / 2;
+        uint32_t bottom = (y % 2) ? clamp_index (top + 1, expand_from[0]->height) : top;
+        for (uint32_t i = 0; i < 3; ++i)
+            expand (expand_from[i]->row (top), expand_from[i]->row (bottom), expanded[i], dst.width);
+
+        _funcs->reconstruct (
+            in0.row (y), in1.row (y), expanded[0], expanded[1], expanded[2],
+            _blender->get_blend_mask (_layer, _plane, y), dst.row (y), bytes);
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SmartPtr<SoftImageHandler>
+create_soft_pyramid_blender (uint32_t layers, bool need_seam)
+{
+    XCAM_FAIL_RETURN (
+        ERROR,
+        layers > 0 && layers <= XCAM_SOFT_PYRAMID_MAX_LEVEL,
+        NULL,
+        "create_soft_pyramid_blender failed with wrong layer:%d, please set it between %d and %d",
+        layers, 1, XCAM_SOFT_PYRAMID_MAX_LEVEL);
+
+    SmartPtr<SoftPyramidBlender> blender = new SoftPyramidBlender ("soft_pyramid_blender", layers, need_seam);
+    SmartPtr<SoftImageKernel> kernel = new SoftBlenderCopyKernel (blender.ptr ());
+    blender->add_kernel (kernel);
+
+    for (uint32_t plane = 0; plane < SoftBlenderPlaneMax; ++plane) {
+        for (uint32_t i = 0; i + 1 < layers; ++i) {
+            kernel = new SoftPyramidGaussKernel (blender.ptr (), i, plane);
+            blender->add_kernel (kernel);
+        }
+        for (int32_t i = layers - 1; i >= 0; --i) {
+            kernel = new SoftPyramidBlendKernel (blender.ptr (), i, plane);
+            blender->add_kernel (kernel);
+        }
+    }
+    return blender;
+}
+
+};
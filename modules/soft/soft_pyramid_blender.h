@@ -0,0 +1,165 @@
+/*
+ * soft_pyramid_blender.h - CPU pyramid blender
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_PYRAMID_BLENDER_H
+#define XCAM_SOFT_PYRAMID_BLENDER_H
+
+#include "xcam_utils.h"
+#include "soft_blender.h"
+#include "soft_pyramid_simd.h"
+#include "soft_seam_finder.h"
+#include <vector>
+
+#define XCAM_SOFT_PYRAMID_MAX_LEVEL  4
+// rows of a pyramid kernel tile, also indexes per tile scratch rows
+#define XCAM_SOFT_PYRAMID_TILE_ROWS  16
+
+namespace XCam {
+
+/*
+ * one layer of both planes. layer 0 images are views of the merge
+ * areas of inputs and the merge window of output, images of other
+ * layers live in storage, which is kept until merge window changes.
+ */
+struct SoftPyramidLayer {
+    uint32_t                 blend_width; // luma pixels of gauss and reconstruct
+    uint32_t                 blend_height;
+    SoftImagePlane           gauss_image[SoftBlenderPlaneMax][XCAM_SOFT_BLENDER_IMAGE_NUM];
+    SoftImagePlane           reconstruct_image[SoftBlenderPlaneMax];
+    std::vector<int16_t>     blend_mask[SoftBlenderPlaneMax]; // weight of input 0 per byte of a row
+    // blurred step of input 0 at seam_mask_center, rows are slid onto the seam
+    std::vector<int16_t>     seam_mask[SoftBlenderPlaneMax];
+    uint32_t                 seam_mask_center[SoftBlenderPlaneMax];
+    std::vector<uint8_t>     storage;
+
+    SoftPyramidLayer ();
+};
+
+/*
+ * CPU counterpart of CLPyramidBlender.
+ * gauss layers of both inputs are built by separable 5-tap filters,
+ * laplacian, blend and reconstruct of a layer then run in one pass,
+ * laplacian images are never stored.
+ * with @need_seam, input 0 is kept left of a seam cut through the
+ * luma difference of layer 0 instead of the middle of the window.
+ */
+class SoftPyramidBlender
+    : public SoftBlender
+{
+public:
+    explicit SoftPyramidBlender (const char *name, uint32_t layers, bool need_seam);
+
+    uint32_t get_layers () const {
+        return _layers;
+    }
+    bool need_seam () const {
+        return _need_seam;
+    }
+    const SoftPyramidLayer &get_pyramid_layer (uint32_t layer) const {
+        XCAM_ASSERT (layer < _layers);
+        return _pyramid_layers[layer];
+    }
+    SoftSeamFinder &get_seam_finder () {
+        return _seam_finder;
+    }
+
+    // weights of input 0 for row @y of @plane in @layer
+    const int16_t *get_blend_mask (uint32_t layer, uint32_t plane, uint32_t y) const;
+
+protected:
+    virtual XCamReturn prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+
+    // from SoftBlender
+    virtual XCamReturn allocate_soft_buffers ();
+
+private:
+    void init_layers (uint32_t width, uint32_t height);
+    void init_masks (uint32_t width);
+    void init_seam_masks (uint32_t width);
+    void bind_frames_to_layer0 ();
+
+    XCAM_DEAD_COPY (SoftPyramidBlender);
+
+private:
+    uint32_t                         _layers;
+    SoftPyramidLayer                 _pyramid_layers[XCAM_SOFT_PYRAMID_MAX_LEVEL];
+    bool                             _need_seam;
+    SoftSeamFinder                   _seam_finder;
+};
+
+// gauss @layer + 1 of both inputs from @layer
+class SoftPyramidGaussKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftPyramidGaussKernel (SoftPyramidBlender *blender, uint32_t layer, uint32_t plane);
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCAM_DEAD_COPY (SoftPyramidGaussKernel);
+
+private:
+    SoftPyramidBlender              *_blender;
+    uint32_t                         _layer;
+    uint32_t                         _plane;
+    const SoftPyramidFuncs          *_funcs;
+    uint32_t                         _row_elements;
+    std::vector<int16_t>             _rows;       // one filtered row per tile
+};
+
+/*
+ * blend of top layer, or laplacian, blend and reconstruct of @layer
+ * on top of reconstruct image of @layer + 1.
+ */
+class SoftPyramidBlendKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftPyramidBlendKernel (SoftPyramidBlender *blender, uint32_t layer, uint32_t plane);
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCAM_DEAD_COPY (SoftPyramidBlendKernel);
+
+private:
+    SoftPyramidBlender              *_blender;
+    uint32_t                         _layer;
+    uint32_t                         _plane;
+    const SoftPyramidFuncs          *_funcs;
+    uint32_t                         _row_elements;
+    std::vector<int16_t>             _rows;       // three expanded rows per tile
+};
+
+SmartPtr<SoftImageHandler>
+create_soft_pyramid_blender (uint32_t layers = 1, bool need_seam = false);
+
+};
+
+#endif //XCAM_SOFT_PYRAMID_BLENDER_H
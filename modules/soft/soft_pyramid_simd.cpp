@@ -0,0 +1,543 @@
+/*
+ * soft_pyramid_simd.cpp - row functions of CPU pyramid blender
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_pyramid_simd.h"
+#include <stdlib.h>
+
+#if XCAM_SOFT_SIMD_X86
+#include <immintrin.h>
+#endif
+#if XCAM_SOFT_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#define C0  XCAM_SOFT_PYRAMID_COEFF0
+#define C1  XCAM_SOFT_PYRAMID_COEFF1
+#define C2  XCAM_SOFT_PYRAMID_COEFF2
+
+#define GAUSS_V_SHIFT  (8 - XCAM_SOFT_PYRAMID_INTER_BITS)
+#define GAUSS_V_ROUND  (1 << (GAUSS_V_SHIFT - 1))
+#define GAUSS_H_SHIFT  (8 + XCAM_SOFT_PYRAMID_INTER_BITS)
+#define GAUSS_H_ROUND  (1 << (GAUSS_H_SHIFT - 1))
+
+#define MASK_ONE       (1 << XCAM_SOFT_PYRAMID_MASK_BITS)
+#define BLEND_ROUND    (1 << (XCAM_SOFT_PYRAMID_MASK_BITS - 1))
+// expands are scaled by 4
+#define RECON_SHIFT    (XCAM_SOFT_PYRAMID_MASK_BITS + 2)
+#define RECON_ROUND    (1 << (RECON_SHIFT - 1))
+
+namespace XCam {
+
+static inline uint8_t
+clamp_u8 (int32_t value)
+{
+    return (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+static void
+gauss_v_row_c (const uint8_t *const *rows, int16_t *dst, uint32_t x, uint32_t width)
+{
+    for (; x < width; ++x) {
+        int32_t sum =
+            (rows[0][x] + rows[4][x]) * C2 + (rows[1][x] + rows[3][x]) * C1 + rows[2][x] * C0;
+        dst[x] = (int16_t)((sum + GAUSS_V_ROUND) >> GAUSS_V_SHIFT);
+    }
+}
+
+static inline uint8_t
+gauss_h_pixel (const int16_t *src, int32_t step)
+{
+    int32_t sum =
+        (src[-2 * step] + src[2 * step]) * C2 + (src[-step] + src[step]) * C1 + src[0] * C0;
+    return clamp_u8 ((sum + GAUSS_H_ROUND) >> GAUSS_H_SHIFT);
+}
+
+static void
+gauss_h_luma_row_c (const int16_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+    for (; x < width; ++x)
+        dst[x] = gauss_h_pixel (src + x * 2, 1);
+}
+
+static void
+gauss_h_chroma_row_c (const int16_t *src, uint8_t *dst, uint32_t x, uint32_t width)
+{
+    for (; x < width; ++x) {
+        dst[x * 2] = gauss_h_pixel (src + x * 4, 2);
+        dst[x * 2 + 1] = gauss_h_pixel (src + x * 4 + 1, 2);
+    }
+}
+
+static void
+expand_luma_row_c (
+    const uint8_t *top, const uint8_t *bottom, int16_t *dst, uint32_t x, uint32_t width)
+{
+    uint32_t last = (width + 1) / 2 - 1;
+    for (; x < width; ++x) {
+        uint32_t i = x / 2;
+        uint32_t j = (x % 2) ? XCAM_MIN (i + 1, last) : i;
+        dst[x] = (int16_t)(top[i] + bottom[i] + top[j] + bottom[j]);
+    }
+}
+
+static void
+expand_chroma_row_c (
+    const uint8_t *top, const uint8_t *bottom, int16_t *dst, uint32_t x, uint32_t width)
+{
+    uint32_t last = (width + 1) / 2 - 1;
+    for (; x < width; ++x) {
+        uint32_t i = x / 2;
+        uint32_t j = (x % 2) ? XCAM_MIN (i + 1, last) : i;
+        for (uint32_t c = 0; c < 2; ++c) {
+            uint32_t a = i * 2 + c, b = j * 2 + c;
+            dst[x * 2 + c] = (int16_t)(top[a] + bottom[a] + top[b] + bottom[b]);
+        }
+    }
+}
+
+static void
+blend_row_c (
+    const uint8_t *in0, const uint8_t *in1, const int16_t *mask,
+    uint8_t *dst, uint32_t x, uint32_t width)
+{
+    for (; x < width; ++x) {
+        int32_t value = in0[x] * mask[x] + in1[x] * (MASK_ONE - mask[x]);
+        dst[x] = clamp_u8 ((value + BLEND_ROUND) >> XCAM_SOFT_PYRAMID_MASK_BITS);
+    }
+}
+
+static void
+reconstruct_row_c (
+    const uint8_t *in0, const uint8_t *in1,
+    const int16_t *expand0, const int16_t *expand1, const int16_t *expand_reconstruct,
+    const int16_t *mask, uint8_t *dst, uint32_t x, uint32_t width)
+{
+    for (; x < width; ++x) {
+        int32_t lap0 = in0[x] * 4 - expand0[x];
+        int32_t lap1 = in1[x] * 4 - expand1[x];
+        int32_t value =
+            expand_reconstruct[x] * MASK_ONE + lap0 * mask[x] + lap1 * (MASK_ONE - mask[x]);
+        dst[x] = clamp_u8 ((value + RECON_ROUND) >> RECON_SHIFT);
+    }
+}
+
+static void
+seam_dp_row_c (
+    const uint8_t *in0, const uint8_t *in1, const int32_t *prev,
+    int32_t *sum, int8_t *step, uint32_t x, uint32_t end)
+{
+    for (; x < end; ++x) {
+        int32_t best = prev[x];
+        int8_t s = 0;
+        if (prev[x - 1] < best) {
+            best = prev[x - 1];
+            s = -1;
+        }
+        if (prev[x + 1] < best) {
+            best = prev[x + 1];
+            s = 1;
+        }
+        sum[x] = best + abs ((int32_t)in0[x] - (int32_t)in1[x]);
+        step[x] = s;
+    }
+}
+
+static void
+gauss_v_c (const uint8_t *const *rows, int16_t *dst, uint32_t width)
+{
+    gauss_v_row_c (rows, dst, 0, width);
+}
+
+static void
+gauss_h_luma_c (const int16_t *src, uint8_t *dst, uint32_t width)
+{
+    gauss_h_luma_row_c (src, dst, 0, width);
+}
+
+static void
+gauss_h_chroma_c (const int16_t *src, uint8_t *dst, uint32_t width)
+{
+    gauss_h_chroma_row_c (src, dst, 0, width);
+}
+
+static void
+expand_luma_c (const uint8_t *top, const uint8_t *bottom, int16_t *dst, uint32_t width)
+{
+    expand_luma_row_c (top, bottom, dst, 0, width);
+}
+
+static void
+expand_chroma_c (const uint8_t *top, const uint8_t *bottom, int16_t *dst, uint32_t width)
+{
+    expand_chroma_row_c (top, bottom, dst, 0, width);
+}
+
+static void
+blend_c (
+    const uint8_t *in0, const uint8_t *in1, const int16_t *mask,
+    uint8_t *dst, uint32_t width)
+{
+    blend_row_c (in0, in1, mask, dst, 0, width);
+}
+
+static void
+reconstruct_c (
+    const uint8_t *in0, const uint8_t *in1,
+    const int16_t *expand0, const int16_t *expand1, const int16_t *expand_reconstruct,
+    const int16_t *mask, uint8_t *dst, uint32_t width)
+{
+    reconstruct_row_c (in0, in1, expand0, expand1, expand_reconstruct, mask, dst, 0, width);
+}
+
+static void
+seam_dp_c (
+    const uint8_t *in0, const uint8_t *in1, const int32_t *prev,
+    int32_t *sum, int8_t *step, uint32_t begin, uint32_t end)
+{
+    seam_dp_row_c (in0, in1, prev, sum, step, begin, end);
+}
+
+static const SoftPyramidFuncs pyramid_funcs_c = {
+    gauss_v_c,
+    gauss_h_luma_c,
+    gauss_h_chroma_c,
+    expand_luma_c,
+    expand_chroma_c,
+    blend_c,
+    reconstruct_c,
+    seam_dp_c,
+};
+
+#if XCAM_SOFT_SIMD_X86
+
+XCAM_SOFT_TARGET_SSE41 static void
+gauss_v_sse (const uint8_t *const *rows, int16_t *dst, uint32_t width)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128i c0 = _mm_set1_epi16 (C0);
+    const __m128i c1 = _mm_set1_epi16 (C1);
+    const __m128i c2 = _mm_set1_epi16 (C2);
+    const __m128i round = _mm_set1_epi16 (GAUSS_V_ROUND);
+    uint32_t x = 0;
+
+    // sums stay below 1 << 16, unsigned 16-bit lanes hold them
+    for (; x + 16 <= width; x += 16) {
+        __m128i r[5];
+        for (uint32_t k = 0; k < 5; ++k)
+            r[k] = _mm_loadu_si128 ((const __m128i *)(rows[k] + x));
+
+        __m128i lo = _mm_mullo_epi16 (
+                         _mm_add_epi16 (_mm_unpacklo_epi8 (r[0], zero), _mm_unpacklo_epi8 (r[4], zero)), c2);
+        lo = _mm_add_epi16 (lo, _mm_mullo_epi16 (
+                                _mm_add_epi16 (_mm_unpacklo_epi8 (r[1], zero), _mm_unpacklo_epi8 (r[3], zero)), c1));
+        lo = _mm_add_epi16 (lo, _mm_mullo_epi16 (_mm_unpacklo_epi8 (r[2], zero), c0));
+        __m128i hi = _mm_mullo_epi16 (
+                         _mm_add_epi16 (_mm_unpackhi_epi8 (r[0], zero), _mm_unpackhi_epi8 (r[4], zero)), c2);
+        hi = _mm_add_epi16 (hi, _mm_mullo_epi16 (
+                                _mm_add_epi16 (_mm_unpackhi_epi8 (r[1], zero), _mm_unpackhi_epi8 (r[3], zero)), c1));
+        hi = _mm_add_epi16 (hi, _mm_mullo_epi16 (_mm_unpackhi_epi8 (r[2], zero), c0));
+
+        _mm_storeu_si128 ((__m128i *)(dst + x), _mm_srli_epi16 (_mm_add_epi16 (lo, round), GAUSS_V_SHIFT));
+        _mm_storeu_si128 ((__m128i *)(dst + x + 8), _mm_srli_epi16 (_mm_add_epi16 (hi, round), GAUSS_V_SHIFT));
+    }
+    gauss_v_row_c (rows, dst, x, width);
+}
+
+/*
+ * 4 outputs centered on s[2], s[4], s[6], s[8] of series s[0..15] in (a, b),
+ * taps paired for madd: (s[2k], s[2k+1]), (s[2k+2], s[2k+3]), (s[2k+4], 0).
+ */
+XCAM_SOFT_TARGET_SSE41 static inline __m128i
+gauss_h4_sse (__m128i a, __m128i b)
+{
+    const __m128i w0 = _mm_setr_epi16 (C2, C1, C2, C1, C2, C1, C2, C1);
+    const __m128i w1 = _mm_setr_epi16 (C0, C1, C0, C1, C0, C1, C0, C1);
+    const __m128i w2 = _mm_setr_epi16 (C2, 0, C2, 0, C2, 0, C2, 0);
+    const __m128i round = _mm_set1_epi32 (GAUSS_H_ROUND);
+
+    __m128i sum = _mm_madd_epi16 (a, w0);
+    sum = _mm_add_epi32 (sum, _mm_madd_epi16 (_mm_alignr_epi8 (b, a, 4), w1));
+    sum = _mm_add_epi32 (sum, _mm_madd_epi16 (_mm_alignr_epi8 (b, a, 8), w2));
+    return _mm_srai_epi32 (_mm_add_epi32 (sum, round), GAUSS_H_SHIFT);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+gauss_h_luma_sse (const int16_t *src, uint8_t *dst, uint32_t width)
+{
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        const int16_t *s = src + x * 2 - 2;
+        __m128i a = _mm_loadu_si128 ((const __m128i *)s);
+        __m128i b = _mm_loadu_si128 ((const __m128i *)(s + 8));
+        __m128i c = _mm_loadu_si128 ((const __m128i *)(s + 16));
+        __m128i v = _mm_packs_epi32 (gauss_h4_sse (a, b), gauss_h4_sse (b, c));
+        _mm_storel_epi64 ((__m128i *)(dst + x), _mm_packus_epi16 (v, v));
+    }
+    gauss_h_luma_row_c (src, dst, x, width);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+gauss_h_chroma_sse (const int16_t *src, uint8_t *dst, uint32_t width)
+{
+    // u0 v0 u1 v1 u2 v2 u3 v3 to u0 u1 u2 u3 v0 v1 v2 v3
+    const __m128i split_uv = _mm_setr_epi8 (0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+    uint32_t x = 0;
+
+    for (; x + 4 <= width; x += 4) {
+        const int16_t *s = src + x * 4 - 4;
+        __m128i a = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)s), split_uv);
+        __m128i b = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)(s + 8)), split_uv);
+        __m128i c = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)(s + 16)), split_uv);
+
+        __m128i u = gauss_h4_sse (_mm_unpacklo_epi64 (a, b), _mm_unpacklo_epi64 (c, c));
+        __m128i v = gauss_h4_sse (_mm_unpackhi_epi64 (a, b), _mm_unpackhi_epi64 (c, c));
+        __m128i uv = _mm_packs_epi32 (u, v);
+        uv = _mm_unpacklo_epi16 (uv, _mm_srli_si128 (uv, 8));
+        _mm_storel_epi64 ((__m128i *)(dst + x * 2), _mm_packus_epi16 (uv, uv));
+    }
+    gauss_h_chroma_row_c (src, dst, x, width);
+}
+
+XCAM_SOFT_TARGET_SSE41 static inline __m128i
+load_sum_u8x8 (const uint8_t *top, const uint8_t *bottom)
+{
+    return _mm_add_epi16 (
+               _mm_cvtepu8_epi16 (_mm_loadl_epi64 ((const __m128i *)top)),
+               _mm_cvtepu8_epi16 (_mm_loadl_epi64 ((const __m128i *)bottom)));
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+expand_luma_sse (const uint8_t *top, const uint8_t *bottom, int16_t *dst, uint32_t width)
+{
+    uint32_t src_width = (width + 1) / 2;
+    uint32_t i = 0;
+
+    // right neighbour of the last source pixel is clamped, left to scalar
+    for (; i + 9 <= src_width; i += 8) {
+        __m128i cur = load_sum_u8x8 (top + i, bottom + i);
+        __m128i next = load_sum_u8x8 (top + i + 1, bottom + i + 1);
+        __m128i even = _mm_slli_epi16 (cur, 1);
+        __m128i odd = _mm_add_epi16 (cur, next);
+        _mm_storeu_si128 ((__m128i *)(dst + i * 2), _mm_unpacklo_epi16 (even, odd));
+        _mm_storeu_si128 ((__m128i *)(dst + i * 2 + 8), _mm_unpackhi_epi16 (even, odd));
+    }
+    expand_luma_row_c (top, bottom, dst, i * 2, width);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+expand_chroma_sse (const uint8_t *top, const uint8_t *bottom, int16_t *dst, uint32_t width)
+{
+    uint32_t src_width = (width + 1) / 2;
+    uint32_t i = 0;
+
+    for (; i + 5 <= src_width; i += 4) {
+        __m128i cur = load_sum_u8x8 (top + i * 2, bottom + i * 2);
+        __m128i next = load_sum_u8x8 (top + i * 2 + 2, bottom + i * 2 + 2);
+        __m128i even = _mm_slli_epi16 (cur, 1);
+        __m128i odd = _mm_add_epi16 (cur, next);
+        _mm_storeu_si128 ((__m128i *)(dst + i * 4), _mm_unpacklo_epi32 (even, odd));
+        _mm_storeu_si128 ((__m128i *)(dst + i * 4 + 8), _mm_unpackhi_epi32 (even, odd));
+    }
+    expand_chroma_row_c (top, bottom, dst, i * 2, width);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+blend_sse (
+    const uint8_t *in0, const uint8_t *in1, const int16_t *mask,
+    uint8_t *dst, uint32_t width)
+{
+    const __m128i one = _mm_set1_epi16 (MASK_ONE);
+    const __m128i round = _mm_set1_epi32 (BLEND_ROUND);
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        __m128i a = _mm_cvtepu8_epi16 (_mm_loadl_epi64 ((const __m128i *)(in0 + x)));
+        __m128i b = _mm_cvtepu8_epi16 (_mm_loadl_epi64 ((const __m128i *)(in1 + x)));
+        __m128i m = _mm_loadu_si128 ((const __m128i *)(mask + x));
+        __m128i im = _mm_sub_epi16 (one, m);
+
+        __m128i lo = _mm_madd_epi16 (_mm_unpacklo_epi16 (a, b), _mm_unpacklo_epi16 (m, im));
+        __m128i hi = _mm_madd_epi16 (_mm_unpackhi_epi16 (a, b), _mm_unpackhi_epi16 (m, im));
+        lo = _mm_srai_epi32 (_mm_add_epi32 (lo, round), XCAM_SOFT_PYRAMID_MASK_BITS);
+        hi = _mm_srai_epi32 (_mm_add_epi32 (hi, round), XCAM_SOFT_PYRAMID_MASK_BITS);
+        __m128i v = _mm_packs_epi32 (lo, hi);
+        _mm_storel_epi64 ((__m128i *)(dst + x), _mm_packus_epi16 (v, v));
+    }
+    blend_row_c (in0, in1, mask, dst, x, width);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+reconstruct_sse (
+    const uint8_t *in0, const uint8_t *in1,
+    const int16_t *expand0, const int16_t *expand1, const int16_t *expand_reconstruct,
+    const int16_t *mask, uint8_t *dst, uint32_t width)
+{
+    const __m128i one = _mm_set1_epi16 (MASK_ONE);
+    const __m128i round = _mm_set1_epi32 (RECON_ROUND);
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        __m128i a = _mm_slli_epi16 (_mm_cvtepu8_epi16 (_mm_loadl_epi64 ((const __m128i *)(in0 + x))), 2);
+        __m128i b = _mm_slli_epi16 (_mm_cvtepu8_epi16 (_mm_loadl_epi64 ((const __m128i *)(in1 + x))), 2);
+        __m128i lap0 = _mm_sub_epi16 (a, _mm_loadu_si128 ((const __m128i *)(expand0 + x)));
+        __m128i lap1 = _mm_sub_epi16 (b, _mm_loadu_si128 ((const __m128i *)(expand1 + x)));
+        __m128i m = _mm_loadu_si128 ((const __m128i *)(mask + x));
+        __m128i im = _mm_sub_epi16 (one, m);
+        __m128i er = _mm_loadu_si128 ((const __m128i *)(expand_reconstruct + x));
+
+        __m128i lo = _mm_madd_epi16 (_mm_unpacklo_epi16 (lap0, lap1), _mm_unpacklo_epi16 (m, im));
+        __m128i hi = _mm_madd_epi16 (_mm_unpackhi_epi16 (lap0, lap1), _mm_unpackhi_epi16 (m, im));
+        lo = _mm_add_epi32 (lo, _mm_slli_epi32 (_mm_cvtepi16_epi32 (er), XCAM_SOFT_PYRAMID_MASK_BITS));
+        hi = _mm_add_epi32 (hi, _mm_slli_epi32 (_mm_cvtepi16_epi32 (_mm_srli_si128 (er, 8)), XCAM_SOFT_PYRAMID_MASK_BITS));
+        lo = _mm_srai_epi32 (_mm_add_epi32 (lo, round), RECON_SHIFT);
+        hi = _mm_srai_epi32 (_mm_add_epi32 (hi, round), RECON_SHIFT);
+        __m128i v = _mm_packs_epi32 (lo, hi);
+        _mm_storel_epi64 ((__m128i *)(dst + x), _mm_packus_epi16 (v, v));
+    }
+    reconstruct_row_c (in0, in1, expand0, expand1, expand_reconstruct, mask, dst, x, width);
+}
+
+XCAM_SOFT_TARGET_SSE41 static inline __m128i
+seam_dp4_sse (const int32_t *prev, __m128i diff, int32_t *sum)
+{
+    const __m128i one = _mm_set1_epi32 (1);
+    __m128i mid = _mm_loadu_si128 ((const __m128i *)prev);
+    __m128i left = _mm_loadu_si128 ((const __m128i *)(prev - 1));
+    __m128i right = _mm_loadu_si128 ((const __m128i *)(prev + 1));
+
+    // all ones on left picks, which is step -1
+    __m128i step = _mm_cmpgt_epi32 (mid, left);
+    __m128i best = _mm_min_epi32 (mid, left);
+    __m128i pick_right = _mm_cmpgt_epi32 (best, right);
+    best = _mm_min_epi32 (best, right);
+    step = _mm_blendv_epi8 (step, one, pick_right);
+
+    _mm_storeu_si128 ((__m128i *)sum, _mm_add_epi32 (best, diff));
+    return step;
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+seam_dp_sse (
+    const uint8_t *in0, const uint8_t *in1, const int32_t *prev,
+    int32_t *sum, int8_t *step, uint32_t begin, uint32_t end)
+{
+    uint32_t x = begin;
+
+    for (; x + 8 <= end; x += 8) {
+        __m128i a = _mm_loadl_epi64 ((const __m128i *)(in0 + x));
+        __m128i b = _mm_loadl_epi64 ((const __m128i *)(in1 + x));
+        __m128i diff = _mm_sub_epi8 (_mm_max_epu8 (a, b), _mm_min_epu8 (a, b));
+
+        __m128i lo = seam_dp4_sse (prev + x, _mm_cvtepu8_epi32 (diff), sum + x);
+        __m128i hi = seam_dp4_sse (prev + x + 4, _mm_cvtepu8_epi32 (_mm_srli_si128 (diff, 4)), sum + x + 4);
+        __m128i steps = _mm_packs_epi32 (lo, hi);
+        _mm_storel_epi64 ((__m128i *)(step + x), _mm_packs_epi16 (steps, steps));
+    }
+    seam_dp_row_c (in0, in1, prev, sum, step, x, end);
+}
+
+// rows are memory bound, AVX2 shares the SSE4.1 functions
+static const SoftPyramidFuncs pyramid_funcs_sse41 = {
+    gauss_v_sse,
+    gauss_h_luma_sse,
+    gauss_h_chroma_sse,
+    expand_luma_sse,
+    expand_chroma_sse,
+    blend_sse,
+    reconstruct_sse,
+    seam_dp_sse,
+};
+
+#endif //XCAM_SOFT_SIMD_X86
+
+#if XCAM_SOFT_SIMD_NEON
+
+static void
+gauss_v_neon (const uint8_t *const *rows, int16_t *dst, uint32_t width)
+{
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        uint16x8_t sum = vmulq_n_u16 (vaddl_u8 (vld1_u8 (rows[0] + x), vld1_u8 (rows[4] + x)), C2);
+        sum = vmlaq_n_u16 (sum, vaddl_u8 (vld1_u8 (rows[1] + x), vld1_u8 (rows[3] + x)), C1);
+        sum = vmlaq_n_u16 (sum, vmovl_u8 (vld1_u8 (rows[2] + x)), C0);
+        vst1q_s16 (dst + x, vreinterpretq_s16_u16 (vrshrq_n_u16 (sum, GAUSS_V_SHIFT)));
+    }
+    gauss_v_row_c (rows, dst, x, width);
+}
+
+static void
+blend_neon (
+    const uint8_t *in0, const uint8_t *in1, const int16_t *mask,
+    uint8_t *dst, uint32_t width)
+{
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        int16x8_t a = vreinterpretq_s16_u16 (vmovl_u8 (vld1_u8 (in0 + x)));
+        int16x8_t b = vreinterpretq_s16_u16 (vmovl_u8 (vld1_u8 (in1 + x)));
+        int16x8_t m = vld1q_s16 (mask + x);
+        int16x8_t im = vsubq_s16 (vdupq_n_s16 (MASK_ONE), m);
+        int32x4_t lo = vmull_s16 (vget_low_s16 (a), vget_low_s16 (m));
+        int32x4_t hi = vmull_s16 (vget_high_s16 (a), vget_high_s16 (m));
+        lo = vmlal_s16 (lo, vget_low_s16 (b), vget_low_s16 (im));
+        hi = vmlal_s16 (hi, vget_high_s16 (b), vget_high_s16 (im));
+        int16x8_t v = vcombine_s16 (
+                          vqrshrn_n_s32 (lo, XCAM_SOFT_PYRAMID_MASK_BITS),
+                          vqrshrn_n_s32 (hi, XCAM_SOFT_PYRAMID_MASK_BITS));
+        vst1_u8 (dst + x, vqmovun_s16 (v));
+    }
+    blend_row_c (in0, in1, mask, dst, x, width);
+}
+
+static const SoftPyramidFuncs pyramid_funcs_neon = {
+    gauss_v_neon,
+    gauss_h_luma_c,
+    gauss_h_chroma_c,
+    expand_luma_c,
+    expand_chroma_c,
+    blend_neon,
+    reconstruct_c,
+    seam_dp_c,
+};
+
+#endif //XCAM_SOFT_SIMD_NEON
+
+const SoftPyramidFuncs &
+get_soft_pyramid_funcs (SoftSimdLevel level)
+{
+    switch (level) {
+#if XCAM_SOFT_SIMD_X86
+    case SoftSimdAVX2:
+    case SoftSimdSSE41:
+        return pyramid_funcs_sse41;
+#endif
+#if XCAM_SOFT_SIMD_NEON
+    case SoftSimdNEON:
+        return pyramid_funcs_neon;
+#endif
+    default:
+        break;
+    }
+    return pyramid_funcs_c;
+}
+
+};
@@ -0,0 +1,105 @@
+/*
+ * soft_pyramid_simd.h - row functions of CPU pyramid blender
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_PYRAMID_SIMD_H
+#define XCAM_SOFT_PYRAMID_SIMD_H
+
+#include "xcam_utils.h"
+#include "soft_simd.h"
+
+// 5-tap gauss weights, same shape as kernel_gauss_lap_pyramid.cl, sum is 256
+#define XCAM_SOFT_PYRAMID_COEFF0  64
+#define XCAM_SOFT_PYRAMID_COEFF1  57
+#define XCAM_SOFT_PYRAMID_COEFF2  39
+// fraction bits of vertically filtered gauss rows, int16
+#define XCAM_SOFT_PYRAMID_INTER_BITS  6
+// blend mask weight of input 0, 0 to 1 << XCAM_SOFT_PYRAMID_MASK_BITS
+#define XCAM_SOFT_PYRAMID_MASK_BITS   8
+// int16 elements kept on both sides of a vertically filtered row
+#define XCAM_SOFT_PYRAMID_ROW_MARGIN  16
+
+namespace XCam {
+
+/*
+ * vertical gauss of 5 rows, dst in XCAM_SOFT_PYRAMID_INTER_BITS.
+ * @width in bytes, same for luma and interleaved chroma.
+ */
+typedef void (*SoftPyramidGaussVFunc) (
+    const uint8_t *const *rows, int16_t *dst, uint32_t width);
+
+/*
+ * horizontal gauss and 2:1 decimation of a vertically filtered row,
+ * dst[i] centers on src[2i] of each channel. src is edge-replicated
+ * into XCAM_SOFT_PYRAMID_ROW_MARGIN elements on both sides.
+ * @width in dst pixels, luma bytes or chroma pairs.
+ */
+typedef void (*SoftPyramidGaussHFunc) (
+    const int16_t *src, uint8_t *dst, uint32_t width);
+
+/*
+ * 2x bilinear expand of the next layer, rows @top and @bottom are
+ * averaged, dst is scaled by 4. even dst pixels sit on src pixels.
+ * @width in dst pixels, src has (width + 1) / 2.
+ */
+typedef void (*SoftPyramidExpandFunc) (
+    const uint8_t *top, const uint8_t *bottom, int16_t *dst, uint32_t width);
+
+// dst = in0 * mask + in1 * (1 - mask), @width in bytes
+typedef void (*SoftPyramidBlendFunc) (
+    const uint8_t *in0, const uint8_t *in1, const int16_t *mask,
+    uint8_t *dst, uint32_t width);
+
+/*
+ * laplacian, blend and reconstruct of one layer in a single pass:
+ * dst = expand (next_reconstruct) + mask * (in0 - expand0) + (1 - mask) * (in1 - expand1),
+ * expands as given by SoftPyramidExpandFunc. @width in bytes.
+ */
+typedef void (*SoftPyramidReconstructFunc) (
+    const uint8_t *in0, const uint8_t *in1,
+    const int16_t *expand0, const int16_t *expand1, const int16_t *expand_reconstruct,
+    const int16_t *mask, uint8_t *dst, uint32_t width);
+
+/*
+ * one row of the seam dynamic programming over columns [@begin, @end):
+ * sum[x] = |in0[x] - in1[x]| + min (prev[x - 1], prev[x], prev[x + 1]),
+ * step[x] is the column offset -1, 0 or 1 of the chosen minimum, ties
+ * keep 0 then -1. all pointers index absolute columns, prev is read at
+ * @begin - 1 and @end as well.
+ */
+typedef void (*SoftPyramidSeamDPFunc) (
+    const uint8_t *in0, const uint8_t *in1, const int32_t *prev,
+    int32_t *sum, int8_t *step, uint32_t begin, uint32_t end);
+
+struct SoftPyramidFuncs {
+    SoftPyramidGaussVFunc         gauss_v;
+    SoftPyramidGaussHFunc         gauss_h_luma;
+    SoftPyramidGaussHFunc         gauss_h_chroma;
+    SoftPyramidExpandFunc         expand_luma;
+    SoftPyramidExpandFunc         expand_chroma;
+    SoftPyramidBlendFunc          blend;
+    SoftPyramidReconstructFunc    reconstruct;
+    SoftPyramidSeamDPFunc         seam_dp;
+};
+
+const SoftPyramidFuncs &get_soft_pyramid_funcs (SoftSimdLevel level);
+
+};
+
+#endif //XCAM_SOFT_PYRAMID_SIMD_H
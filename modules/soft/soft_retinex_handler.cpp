@@ -0,0 +1,366 @@
+/*
+ * soft_retinex_handler.cpp - CPU multi-scale retinex handler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_retinex_handler.h"
+#include "soft_box_filter.h"
+
+// same log range as CLRetinexImageKernel
+#define SOFT_RETINEX_LOG_MIN          -0.12f
+#define SOFT_RETINEX_LOG_MAX          0.18f
+
+namespace XCam {
+
+static const float default_retinex_sigmas[] = {2.0f, 20.0f};
+
+static inline uint8_t
+retinex_unorm8 (float value)
+{
+    return (uint8_t)(XCAM_MIN (XCAM_MAX (value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+SoftRetinexReduceKernel::SoftRetinexReduceKernel (SoftRetinexImageHandler *handler)
+    : SoftImageKernel ("soft_retinex_reduce")
+    , _handler (handler)
+{
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, 0);
+}
+
+XCamReturn
+SoftRetinexReduceKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    work_width = _handler->_map_width;
+    work_height = _handler->_map_height;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+uint32_t
+SoftRetinexReduceKernel::get_bytes_per_pixel () const
+{
+    // 2x2 luma in, a float out
+    return 4 + 4;
+}
+
+XCamReturn
+SoftRetinexReduceKernel::work_tile (const ImageTile &tile)
+{
+    const SoftImagePlane &in_y = _in.get_plane (0);
+    const uint32_t map_width = _handler->_map_width;
+
+    XCAM_ASSERT (tile.x == 0 && tile.width == map_width);
+
+    for (uint32_t my = tile.y; my < tile.y + tile.height; ++my) {
+        const uint8_t *y0 = in_y.row (my * 2), *y1 = in_y.row (my * 2 + 1);
+        float *reduced = &_handler->_reduced[(size_t)my * map_width];
+        for (uint32_t mx = 0; mx < map_width; ++mx) {
+            uint32_t x = mx * 2;
+            reduced[mx] = (y0[x] + y0[x + 1] + y1[x] + y1[x + 1]) * 0.25f;
+        }
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SoftRetinexGaussKernel::SoftRetinexGaussKernel (SoftRetinexImageHandler *handler)
+    : SoftImageKernel ("soft_retinex_gauss")
+    , _handler (handler)
+{
+    // whole map in one tile, passes inside are parallel
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, XCAM_SOFT_TILE_FULL_WIDTH);
+}
+
+XCamReturn
+SoftRetinexGaussKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    work_width = _handler->_map_width;
+    work_height = _handler->_map_height;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftRetinexGaussKernel::work_tile (const ImageTile &tile)
+{
+    SoftRetinexImageHandler *handler = _handler;
+    const uint32_t width = tile.width, height = tile.height;
+    const std::vector<float> *src = &handler->_reduced;
+    float prev_sigma = 0.0f;
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+
+    XCAM_ASSERT (width == handler->_map_width && height == handler->_map_height);
+
+    for (uint32_t i = 0; i < handler->_scale_count; ++i) {
+        std::vector<float> &gauss = handler->_gauss[i];
+        float sigma = handler->_sigmas[i];
+
+        gauss = *src;
+        ret = soft_box_gauss_map (
+                  &gauss[0], &handler->_box_tmp[0], width, height,
+                  sqrtf (sigma * sigma - prev_sigma * prev_sigma), XCAM_SOFT_RETINEX_BOX_PASSES);
+        XCAM_FAIL_RETURN (
+            WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+            "soft retinex gauss of scale(%d) failed", i);
+
+        src = &gauss;
+        prev_sigma = sigma;
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SoftRetinexKernel::SoftRetinexKernel (SoftRetinexImageHandler *handler)
+    : SoftImageKernel ("soft_retinex")
+    , _handler (handler)
+{
+    // fixed bands, each works in its own rows of the handler
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, XCAM_SOFT_RETINEX_BAND_PAIRS);
+}
+
+XCamReturn
+SoftRetinexKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    // pairs of luma rows sharing one chroma row
+    work_width = _handler->_width;
+    work_height = _handler->_height / 2;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+uint32_t
+SoftRetinexKernel::get_bytes_per_pixel () const
+{
+    // two luma rows and a chroma row of input and output
+    return 3 * 2;
+}
+
+XCamReturn
+SoftRetinexKernel::work_tile (const ImageTile &tile)
+{
+    SoftRetinexImageHandler *handler = _handler;
+    const SoftImagePlane &in_y = _in.get_plane (0);
+    const SoftImagePlane &in_uv = _in.get_plane (1);
+    const SoftImagePlane &out_y = _out.get_plane (0);
+    const SoftImagePlane &out_uv = _out.get_plane (1);
+    const uint32_t map_width = handler->_map_width, map_height = handler->_map_height;
+    const uint32_t scale_count = handler->_scale_count;
+    const uint32_t *map_x = &handler->_map_x[0];
+    const float *map_fx = &handler->_map_fx[0];
+    const float gain = 1.0f / (SOFT_RETINEX_LOG_MAX - SOFT_RETINEX_LOG_MIN);
+    const float inv_scale_count = 1.0f / scale_count;
+    const float *log_table = handler->_log_table;
+    // one more column so the last map column interpolates with itself
+    float *row = &handler->_band_rows[(tile.y / XCAM_SOFT_RETINEX_BAND_PAIRS) * handler->band_rows_size ()];
+    float *base = row + map_width + 1;
+    float *log_ratio = base + handler->_width;
+
+    XCAM_ASSERT (tile.x == 0 && tile.width == in_y.width && tile.width == handler->_width);
+    XCAM_ASSERT (!(tile.y % XCAM_SOFT_RETINEX_BAND_PAIRS));
+
+    for (uint32_t pair = tile.y; pair < tile.y + tile.height; ++pair) {
+        uint32_t y = pair * 2;
+
+        // even row last, its output left in log_ratio steers the chroma of the pair
+        for (int32_t k = 1; k >= 0; --k) {
+            const uint8_t *src = in_y.row (y + k);
+            uint8_t *dst = out_y.row (y + k);
+            float sy = XCAM_MIN (XCAM_MAX ((y + k) * 0.5f - 0.5f, 0.0f), (float)(map_height - 1));
+            uint32_t y0 = (uint32_t)sy, y1 = XCAM_MIN (y0 + 1, map_height - 1);
+            float fy = sy - y0;
+
+            for (uint32_t x = 0; x < tile.width; ++x)
+                log_ratio[x] = 0.0f;
+
+            for (uint32_t i = 0; i < scale_count; ++i) {
+                const float *g0 = &handler->_gauss[i][(size_t)y0 * map_width];
+                const float *g1 = &handler->_gauss[i][(size_t)y1 * map_width];
+                for (uint32_t mx = 0; mx < map_width; ++mx)
+                    row[mx] = g0[mx] + (g1[mx] - g0[mx]) * fy;
+                row[map_width] = row[map_width - 1];
+
+                for (uint32_t x = 0; x < tile.width; ++x) {
+                    uint32_t mx = map_x[x];
+                    float ga = row[mx] + (row[mx + 1] - row[mx]) * map_fx[x];
+                    uint32_t index = XCAM_MIN ((uint32_t)ga, 254u);
+                    float log_ga = log_table[index] + (log_table[index + 1] - log_table[index]) * (ga - index);
+                    log_ratio[x] += log_table[src[x]] - log_ga;
+                    if (i == 0)
+                        base[x] = ga;
+                }
+            }
+
+            for (uint32_t x = 0; x < tile.width; ++x) {
+                float out = gain * (base[x] + 20.0f) / 128.0f *
+                            (log_ratio[x] * inv_scale_count - SOFT_RETINEX_LOG_MIN);
+                dst[x] = retinex_unorm8 (out);
+                log_ratio[x] = out;
+            }
+        }
+
+        const uint8_t *src_y = in_y.row (y);
+        const uint8_t *src_uv = in_uv.row (pair);
+        uint8_t *dst_uv = out_uv.row (pair);
+        for (uint32_t x = 0; x < tile.width; x += 2) {
+            float avg_in = (src_y[x] + src_y[x + 1]) * (0.5f / 255.0f);
+            float avg_out = (log_ratio[x] + log_ratio[x + 1]) * 0.5f;
+            avg_out = XCAM_MIN (XCAM_MAX (avg_out, 0.0f), 1.0f);
+            avg_in = (avg_in > 0.5f) ? (1.0f - avg_in) : avg_in;
+            avg_out = (avg_out > 0.5f) ? (1.0f - avg_out) : avg_out;
+            float gain_y = (avg_out + 0.1f) / (avg_in + 0.05f) * (avg_in * 2.0f + 1.0f);
+
+            float u = src_uv[x] / 255.0f - 0.5f;
+            float v = src_uv[x + 1] / 255.0f - 0.5f;
+            float coeffs[2] = {1.01f / (1.13f * u + 0.01f), 1.01f / (2.03f * v + 0.01f)};
+            for (uint32_t c = 0; c < 2; ++c) {
+                float gain_1 = coeffs[c] - avg_in * coeffs[c];
+                float gain_2 = -coeffs[c];
+                float gain_min = XCAM_MAX (XCAM_MIN (gain_1, gain_2), 0.1f);
+                float gain_max = XCAM_MAX (XCAM_MAX (gain_1, gain_2), 0.1f);
+                gain_y = XCAM_MIN (XCAM_MAX (gain_y, gain_min), gain_max);
+            }
+
+            dst_uv[x] = retinex_unorm8 (u * gain_y + 0.5f);
+            dst_uv[x + 1] = retinex_unorm8 (v * gain_y + 0.5f);
+        }
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SoftRetinexImageHandler::SoftRetinexImageHandler (const char *name)
+    : SoftImageHandler (name)
+    , _scale_count (0)
+    , _width (0)
+    , _height (0)
+    , _map_width (0)
+    , _map_height (0)
+{
+    xcam_mem_clear (_sigmas);
+    for (uint32_t i = 0; i < 256; ++i)
+        _log_table[i] = logf (i + 1.0f);
+    set_scales (default_retinex_sigmas, sizeof (default_retinex_sigmas) / sizeof (default_retinex_sigmas[0]));
+}
+
+bool
+SoftRetinexImageHandler::set_scales (const float *sigmas, uint32_t count)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, sigmas && count > 0 && count <= XCAM_SOFT_RETINEX_MAX_SCALE, false,
+        "soft retinex handler(%s) scale count(%d) must be in [1, %d]",
+        XCAM_STR (get_name ()), count, XCAM_SOFT_RETINEX_MAX_SCALE);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        XCAM_FAIL_RETURN (
+            WARNING, sigmas[i] > 0.0f && (i == 0 || sigmas[i] >= sigmas[i - 1]), false,
+            "soft retinex handler(%s) sigmas must be positive and ascending", XCAM_STR (get_name ()));
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+        _sigmas[i] = sigmas[i];
+    _scale_count = count;
+    return true;
+}
+
+void
+SoftRetinexImageHandler::init_maps (uint32_t width, uint32_t height)
+{
+    _width = width;
+    _height = height;
+    _map_width = width / 2;
+    _map_height = height / 2;
+
+    size_t count = (size_t)_map_width * _map_height;
+    _reduced.resize (count);
+    for (uint32_t i = 0; i < XCAM_SOFT_RETINEX_MAX_SCALE; ++i)
+        _gauss[i].resize (count);
+    _box_tmp.resize (count);
+    uint32_t band_count = XCAM_ALIGN_UP (height / 2, XCAM_SOFT_RETINEX_BAND_PAIRS) / XCAM_SOFT_RETINEX_BAND_PAIRS;
+    _band_rows.resize (band_count * band_rows_size ());
+
+    // sampled like the linear sampler of kernel_retinex
+    _map_x.resize (width);
+    _map_fx.resize (width);
+    for (uint32_t x = 0; x < width; ++x) {
+        float sx = XCAM_MIN (XCAM_MAX (x * 0.5f - 0.5f, 0.0f), (float)(_map_width - 1));
+        _map_x[x] = (uint32_t)sx;
+        _map_fx[x] = sx - _map_x[x];
+    }
+
+    XCAM_LOG_DEBUG (
+        "soft retinex handler(%s) %dx%d, gaussian maps %dx%d",
+        XCAM_STR (get_name ()), width, height, _map_width, _map_height);
+}
+
+XCamReturn
+SoftRetinexImageHandler::prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    const VideoBufferInfo &in_info = input->get_video_info ();
+    const VideoBufferInfo &out_info = output->get_video_info ();
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in_info.format == V4L2_PIX_FMT_NV12 && out_info.format == V4L2_PIX_FMT_NV12,
+        XCAM_RETURN_ERROR_PARAM,
+        "soft retinex handler(%s) only supports NV12, input %s, output %s",
+        XCAM_STR (get_name ()),
+        xcam_fourcc_to_string (in_info.format), xcam_fourcc_to_string (out_info.format));
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in_info.width == out_info.width && in_info.height == out_info.height &&
+        !(in_info.width % 2) && !(in_info.height % 2),
+        XCAM_RETURN_ERROR_PARAM,
+        "soft retinex handler(%s) input(%dx%d) and output(%dx%d) must be same even size",
+        XCAM_STR (get_name ()),
+        in_info.width, in_info.height, out_info.width, out_info.height);
+
+    if (in_info.width != _width || in_info.height != _height)
+        init_maps (in_info.width, in_info.height);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SmartPtr<SoftImageHandler>
+create_soft_retinex_image_handler ()
+{
+    SmartPtr<SoftRetinexImageHandler> retinex_handler;
+    SmartPtr<SoftImageKernel> kernel;
+
+    retinex_handler = new SoftRetinexImageHandler ("soft_retinex_handler");
+
+    kernel = new SoftRetinexReduceKernel (retinex_handler.ptr ());
+    retinex_handler->add_kernel (kernel);
+    kernel = new SoftRetinexGaussKernel (retinex_handler.ptr ());
+    retinex_handler->add_kernel (kernel);
+    kernel = new SoftRetinexKernel (retinex_handler.ptr ());
+    retinex_handler->add_kernel (kernel);
+
+    return retinex_handler;
+}
+
+};
@@ -0,0 +1,166 @@
+/*
+ * soft_retinex_handler.h - CPU multi-scale retinex handler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_RETINEX_HANDLER_H
+#define XCAM_SOFT_RETINEX_HANDLER_H
+
+#include "xcam_utils.h"
+#include "soft_image_handler.h"
+#include <vector>
+
+#define XCAM_SOFT_RETINEX_MAX_SCALE    3
+// box filters stacked per gaussian
+#define XCAM_SOFT_RETINEX_BOX_PASSES   3
+// luma row pairs per band of the full resolution pass
+#define XCAM_SOFT_RETINEX_BAND_PAIRS   16
+
+namespace XCam {
+
+class SoftRetinexImageHandler;
+
+// luma reduced by 2 in both directions, 2x2 mean
+class SoftRetinexReduceKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftRetinexReduceKernel (SoftRetinexImageHandler *handler);
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual uint32_t get_bytes_per_pixel () const;
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCAM_DEAD_COPY (SoftRetinexReduceKernel);
+
+private:
+    SoftRetinexImageHandler     *_handler;
+};
+
+/*
+ * gaussians of all scales on the reduced luma in one tile, each as
+ * stacked box filters spread over the pool. scale i blurs scale i - 1
+ * by the remaining sqrt (sigma_i^2 - sigma_(i-1)^2), so bigger scales
+ * reuse the passes of smaller ones and cost per pixel does not depend
+ * on sigma.
+ */
+class SoftRetinexGaussKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftRetinexGaussKernel (SoftRetinexImageHandler *handler);
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCAM_DEAD_COPY (SoftRetinexGaussKernel);
+
+private:
+    SoftRetinexImageHandler     *_handler;
+};
+
+/*
+ * full resolution pass, same math as kernel_retinex: log ratio of luma
+ * to bilinear upsampled gaussians averaged over scales, chroma scaled
+ * by the luma change within the range keeping rgb valid. gaussians stay
+ * float and their log is interpolated in the table, truncating them to
+ * 8 bits as kernel_retinex does bands smooth gradients.
+ */
+class SoftRetinexKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftRetinexKernel (SoftRetinexImageHandler *handler);
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual uint32_t get_bytes_per_pixel () const;
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCAM_DEAD_COPY (SoftRetinexKernel);
+
+private:
+    SoftRetinexImageHandler     *_handler;
+};
+
+/*
+ * CPU counterpart of CLRetinexImageHandler in its box gaussian mode,
+ * NV12 only.
+ */
+class SoftRetinexImageHandler
+    : public SoftImageHandler
+{
+    friend class SoftRetinexReduceKernel;
+    friend class SoftRetinexGaussKernel;
+    friend class SoftRetinexKernel;
+
+public:
+    explicit SoftRetinexImageHandler (const char *name);
+
+    // sigmas in reduced map pixels, ascending
+    bool set_scales (const float *sigmas, uint32_t count);
+
+protected:
+    virtual XCamReturn prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+
+private:
+    void init_maps (uint32_t width, uint32_t height);
+    // interpolated map row with one more column, base and log ratio rows
+    size_t band_rows_size () const {
+        return (size_t)_map_width + 1 + (size_t)_width * 2;
+    }
+
+    XCAM_DEAD_COPY (SoftRetinexImageHandler);
+
+private:
+    float                       _sigmas[XCAM_SOFT_RETINEX_MAX_SCALE];
+    uint32_t                    _scale_count;
+    // log (i + 1), log_table of kernel_retinex
+    float                       _log_table[256];
+
+    uint32_t                    _width;
+    uint32_t                    _height;
+    uint32_t                    _map_width;
+    uint32_t                    _map_height;
+    std::vector<float>          _reduced;
+    std::vector<float>          _gauss[XCAM_SOFT_RETINEX_MAX_SCALE];
+    std::vector<float>          _box_tmp;
+    // working rows of each full resolution band, see band_rows_size
+    std::vector<float>          _band_rows;
+    // bilinear source column and weight of each output column
+    std::vector<uint32_t>       _map_x;
+    std::vector<float>          _map_fx;
+};
+
+SmartPtr<SoftImageHandler>
+create_soft_retinex_image_handler ();
+
+};
+
+#endif //XCAM_SOFT_RETINEX_HANDLER_H
@@ -0,0 +1,182 @@
+/*
+ * soft_scaler_simd.cpp - row functions of CPU image scaler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_scaler_simd.h"
+
+#if XCAM_SOFT_SIMD_X86
+#include <immintrin.h>
+#endif
+#if XCAM_SOFT_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#define SCALER_SHIFT  (XCAM_SOFT_SCALER_WEIGHT_BITS + XCAM_SOFT_SCALER_INTER_BITS)
+#define SCALER_ROUND  (1 << (SCALER_SHIFT - 1))
+
+namespace XCam {
+
+static void
+vfilter_row_c (
+    const int16_t *const *rows, const int16_t *weights, uint32_t taps,
+    uint8_t *dst, uint32_t x, uint32_t width)
+{
+    for (; x < width; ++x) {
+        int32_t sum = SCALER_ROUND;
+        for (uint32_t k = 0; k < taps; ++k)
+            sum += weights[k] * rows[k][x];
+        sum >>= SCALER_SHIFT;
+        dst[x] = (uint8_t)(sum < 0 ? 0 : (sum > 255 ? 255 : sum));
+    }
+}
+
+static void
+vfilter_c (
+    const int16_t *const *rows, const int16_t *weights, uint32_t taps,
+    uint8_t *dst, uint32_t width)
+{
+    vfilter_row_c (rows, weights, taps, dst, 0, width);
+}
+
+static const SoftScalerFuncs scaler_funcs_c = {
+    vfilter_c,
+};
+
+#if XCAM_SOFT_SIMD_X86
+
+static inline int32_t
+weight_pair (const int16_t *weights, uint32_t k, uint32_t taps)
+{
+    uint16_t w1 = (k + 1 < taps) ? (uint16_t)weights[k + 1] : 0;
+    return (int32_t)((uint16_t)weights[k] | ((uint32_t)w1 << 16));
+}
+
+// taps are consumed in pairs by madd, an odd last tap pairs with zeros
+XCAM_SOFT_TARGET_SSE41 static void
+vfilter_sse (
+    const int16_t *const *rows, const int16_t *weights, uint32_t taps,
+    uint8_t *dst, uint32_t width)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        __m128i lo = _mm_set1_epi32 (SCALER_ROUND);
+        __m128i hi = lo;
+        for (uint32_t k = 0; k < taps; k += 2) {
+            __m128i a = _mm_loadu_si128 ((const __m128i *)(rows[k] + x));
+            __m128i b = (k + 1 < taps) ? _mm_loadu_si128 ((const __m128i *)(rows[k + 1] + x)) : zero;
+            __m128i w = _mm_set1_epi32 (weight_pair (weights, k, taps));
+            lo = _mm_add_epi32 (lo, _mm_madd_epi16 (_mm_unpacklo_epi16 (a, b), w));
+            hi = _mm_add_epi32 (hi, _mm_madd_epi16 (_mm_unpackhi_epi16 (a, b), w));
+        }
+        __m128i v = _mm_packs_epi32 (_mm_srai_epi32 (lo, SCALER_SHIFT), _mm_srai_epi32 (hi, SCALER_SHIFT));
+        _mm_storel_epi64 ((__m128i *)(dst + x), _mm_packus_epi16 (v, v));
+    }
+    vfilter_row_c (rows, weights, taps, dst, x, width);
+}
+
+static const SoftScalerFuncs scaler_funcs_sse41 = {
+    vfilter_sse,
+};
+
+XCAM_SOFT_TARGET_AVX2 static void
+vfilter_avx2 (
+    const int16_t *const *rows, const int16_t *weights, uint32_t taps,
+    uint8_t *dst, uint32_t width)
+{
+    const __m256i zero = _mm256_setzero_si256 ();
+    uint32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        __m256i lo = _mm256_set1_epi32 (SCALER_ROUND);
+        __m256i hi = lo;
+        for (uint32_t k = 0; k < taps; k += 2) {
+            __m256i a = _mm256_loadu_si256 ((const __m256i *)(rows[k] + x));
+            __m256i b = (k + 1 < taps) ? _mm256_loadu_si256 ((const __m256i *)(rows[k + 1] + x)) : zero;
+            __m256i w = _mm256_set1_epi32 (weight_pair (weights, k, taps));
+            lo = _mm256_add_epi32 (lo, _mm256_madd_epi16 (_mm256_unpacklo_epi16 (a, b), w));
+            hi = _mm256_add_epi32 (hi, _mm256_madd_epi16 (_mm256_unpackhi_epi16 (a, b), w));
+        }
+        // in-lane unpack and pack keep order, 8-bit halves sit in q0 and q2
+        __m256i v = _mm256_packs_epi32 (_mm256_srai_epi32 (lo, SCALER_SHIFT), _mm256_srai_epi32 (hi, SCALER_SHIFT));
+        v = _mm256_permute4x64_epi64 (_mm256_packus_epi16 (v, v), 0x08);
+        _mm_storeu_si128 ((__m128i *)(dst + x), _mm256_castsi256_si128 (v));
+    }
+    vfilter_row_c (rows, weights, taps, dst, x, width);
+}
+
+static const SoftScalerFuncs scaler_funcs_avx2 = {
+    vfilter_avx2,
+};
+
+#endif //XCAM_SOFT_SIMD_X86
+
+#if XCAM_SOFT_SIMD_NEON
+
+static void
+vfilter_neon (
+    const int16_t *const *rows, const int16_t *weights, uint32_t taps,
+    uint8_t *dst, uint32_t width)
+{
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        int32x4_t lo = vdupq_n_s32 (0);
+        int32x4_t hi = vdupq_n_s32 (0);
+        for (uint32_t k = 0; k < taps; ++k) {
+            int16x8_t row = vld1q_s16 (rows[k] + x);
+            lo = vmlal_n_s16 (lo, vget_low_s16 (row), weights[k]);
+            hi = vmlal_n_s16 (hi, vget_high_s16 (row), weights[k]);
+        }
+        int16x8_t v = vcombine_s16 (
+                          vqmovn_s32 (vrshrq_n_s32 (lo, SCALER_SHIFT)),
+                          vqmovn_s32 (vrshrq_n_s32 (hi, SCALER_SHIFT)));
+        vst1_u8 (dst + x, vqmovun_s16 (v));
+    }
+    vfilter_row_c (rows, weights, taps, dst, x, width);
+}
+
+static const SoftScalerFuncs scaler_funcs_neon = {
+    vfilter_neon,
+};
+
+#endif //XCAM_SOFT_SIMD_NEON
+
+const SoftScalerFuncs &
+get_soft_scaler_funcs (SoftSimdLevel level)
+{
+    switch (level) {
+#if XCAM_SOFT_SIMD_X86
+    case SoftSimdAVX2:
+        return scaler_funcs_avx2;
+    case SoftSimdSSE41:
+        return scaler_funcs_sse41;
+#endif
+#if XCAM_SOFT_SIMD_NEON
+    case SoftSimdNEON:
+        return scaler_funcs_neon;
+#endif
+    default:
+        break;
+    }
+    return scaler_funcs_c;
+}
+
+};
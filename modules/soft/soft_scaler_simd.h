@@ -0,0 +1,50 @@
+/*
+ * soft_scaler_simd.h - row functions of CPU image scaler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_SCALER_SIMD_H
+#define XCAM_SOFT_SCALER_SIMD_H
+
+#include "xcam_utils.h"
+#include "soft_simd.h"
+
+// filter weights, sum of taps is 1 << XCAM_SOFT_SCALER_WEIGHT_BITS
+#define XCAM_SOFT_SCALER_WEIGHT_BITS  14
+// fraction bits of horizontally filtered rows, int16
+#define XCAM_SOFT_SCALER_INTER_BITS   6
+
+namespace XCam {
+
+/*
+ * vertical pass, dst[x] = sum (weights[k] * rows[k][x]) for k < taps,
+ * rows are horizontally filtered int16 with XCAM_SOFT_SCALER_INTER_BITS.
+ */
+typedef void (*SoftScalerVFilterFunc) (
+    const int16_t *const *rows, const int16_t *weights, uint32_t taps,
+    uint8_t *dst, uint32_t width);
+
+struct SoftScalerFuncs {
+    SoftScalerVFilterFunc   vfilter;
+};
+
+const SoftScalerFuncs &get_soft_scaler_funcs (SoftSimdLevel level);
+
+};
+
+#endif //XCAM_SOFT_SCALER_SIMD_H
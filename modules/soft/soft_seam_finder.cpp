@@ -0,0 +1,122 @@
+/*
+ * soft_seam_finder.cpp - CPU seam finder of blender overlaps
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_seam_finder.h"
+#include <algorithm>
+
+// sum of columns out of the searched band
+#define SEAM_SUM_MAX          0x3FFFFFFF
+// guard columns on both sides of a sum row
+#define SEAM_SUM_GUARD        2
+// cost allowed to grow per row without a full search, avoids flip-flop on flat scenes
+#define SEAM_COST_SLACK_ROW   2
+
+namespace XCam {
+
+SoftSeamFinder::SoftSeamFinder ()
+    : _band_radius (XCAM_SOFT_SEAM_BAND_RADIUS)
+    , _scene_change_ratio (XCAM_SOFT_SEAM_SCENE_CHANGE_RATIO)
+    , _width (0)
+    , _height (0)
+    , _begin (0)
+    , _end (0)
+    , _seam_cost (0)
+{
+}
+
+XCamReturn
+SoftSeamFinder::search (
+    const SoftImagePlane &in0, const SoftImagePlane &in1,
+    uint32_t begin, uint32_t end)
+{
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in0.width == in1.width && in0.height == in1.height && in0.pixel_bytes == 1 && in1.pixel_bytes == 1,
+        XCAM_RETURN_ERROR_PARAM,
+        "SoftSeamFinder inputs(%dx%d, %dx%d) should be luma of the same size",
+        in0.width, in0.height, in1.width, in1.height);
+    XCAM_FAIL_RETURN (
+        WARNING, begin < end && end <= in0.width && in0.height, XCAM_RETURN_ERROR_PARAM,
+        "SoftSeamFinder seam range(%d, %d) out of width(%d)", begin, end, in0.width);
+
+    bool full = (in0.width != _width || in0.height != _height || begin != _begin || end != _end ||
+                 _seam.size () != in0.height);
+    if (full) {
+        _width = in0.width;
+        _height = in0.height;
+        _begin = begin;
+        _end = end;
+        _steps.resize ((size_t)_width * _height);
+        _sums.resize ((_width + SEAM_SUM_GUARD * 2) * 2);
+    }
+
+    _last_seam.swap (_seam);
+    _seam.resize (_height);
+
+    int32_t cost = search_rows (in0, in1, full);
+    if (!full && cost > _seam_cost * _scene_change_ratio + (float)_height * SEAM_COST_SLACK_ROW) {
+        XCAM_LOG_DEBUG (
+            "SoftSeamFinder seam cost grows from %d to %d, search full range",
+            _seam_cost, cost);
+        cost = search_rows (in0, in1, true);
+    }
+    _seam_cost = cost;
+    return XCAM_RETURN_NO_ERROR;
+}
+
+/*
+ * columns out of a row band, including guards, are never read by the next
+ * row since seams and bands move by one column per row at most.
+ */
+int32_t
+SoftSeamFinder::search_rows (const SoftImagePlane &in0, const SoftImagePlane &in1, bool full)
+{
+    const SoftPyramidFuncs &funcs = get_soft_pyramid_funcs (soft_simd_level ());
+    uint32_t row_elements = _width + SEAM_SUM_GUARD * 2;
+    int32_t *prev = &_sums[SEAM_SUM_GUARD];
+    int32_t *cur = prev + row_elements;
+    uint32_t begin = _begin, end = _end;
+
+    std::fill (_sums.begin (), _sums.end (), SEAM_SUM_MAX);
+    for (uint32_t y = 0; y < _height; ++y) {
+        if (!full) {
+            int32_t last = _last_seam[y];
+            begin = (uint32_t)XCAM_MAX (last - (int32_t)_band_radius, (int32_t)_begin);
+            end = (uint32_t)XCAM_MIN (last + (int32_t)_band_radius + 1, (int32_t)_end);
+        }
+        if (!y)
+            std::fill (prev + begin, prev + end, 0);
+
+        funcs.seam_dp (in0.row (y), in1.row (y), prev, cur, &_steps[(size_t)_width * y], begin, end);
+        cur[(int32_t)begin - 2] = cur[(int32_t)begin - 1] = SEAM_SUM_MAX;
+        cur[end] = cur[end + 1] = SEAM_SUM_MAX;
+        std::swap (prev, cur);
+    }
+
+    int32_t pos = (int32_t)(std::min_element (prev + begin, prev + end) - prev);
+    int32_t cost = prev[pos];
+    for (int32_t y = _height - 1; y >= 0; --y) {
+        _seam[y] = (int16_t)pos;
+        pos += _steps[(size_t)_width * y + pos];
+    }
+    return cost;
+}
+
+};
@@ -0,0 +1,94 @@
+/*
+ * soft_seam_finder.h - CPU seam finder of blender overlaps
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_SEAM_FINDER_H
+#define XCAM_SOFT_SEAM_FINDER_H
+
+#include "xcam_utils.h"
+#include "soft_image_handler.h"
+#include "soft_pyramid_simd.h"
+#include <vector>
+
+// columns on each side of the last seam searched in following frames
+#define XCAM_SOFT_SEAM_BAND_RADIUS          16
+// band search is redone over full range if its cost grows over this ratio
+#define XCAM_SOFT_SEAM_SCENE_CHANGE_RATIO   2.0f
+
+namespace XCam {
+
+/*
+ * minimal cost vertical seam through the absolute difference of two
+ * overlapped luma images, same dynamic programming as kernel_seam_dp.
+ * the first frame searches the full range, following frames only search
+ * a band around the last seam, which keeps the seam steady across frames.
+ * a full search is redone on scene change, when the band seam costs
+ * much more than the last one, or when sizes change.
+ */
+class SoftSeamFinder
+{
+public:
+    explicit SoftSeamFinder ();
+
+    void set_band_radius (uint32_t radius) {
+        _band_radius = radius;
+    }
+    void set_scene_change_ratio (float ratio) {
+        _scene_change_ratio = ratio;
+    }
+    // next search runs over the full range
+    void reset () {
+        _seam.clear ();
+    }
+
+    /*
+     * @in0, @in1 are the overlapped areas, same size.
+     * seam columns stay in [@begin, @end).
+     */
+    XCamReturn search (
+        const SoftImagePlane &in0, const SoftImagePlane &in1,
+        uint32_t begin, uint32_t end);
+
+    // seam column of each row, empty before the first search
+    const std::vector<int16_t> &get_seam () const {
+        return _seam;
+    }
+
+private:
+    int32_t search_rows (const SoftImagePlane &in0, const SoftImagePlane &in1, bool full);
+
+    XCAM_DEAD_COPY (SoftSeamFinder);
+
+private:
+    uint32_t                         _band_radius;
+    float                            _scene_change_ratio;
+    uint32_t                         _width;
+    uint32_t                         _height;
+    uint32_t                         _begin;
+    uint32_t                         _end;
+    int32_t                          _seam_cost;
+    std::vector<int16_t>             _seam;
+    std::vector<int16_t>             _last_seam;
+    std::vector<int32_t>             _sums;   // two rows with guards
+    std::vector<int8_t>              _steps;  // one row per image row
+};
+
+};
+
+#endif //XCAM_SOFT_SEAM_FINDER_H
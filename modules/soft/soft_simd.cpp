@@ -0,0 +1,94 @@
+/*
+ * soft_simd.cpp - runtime SIMD level of CPU handlers
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_simd.h"
+
+namespace XCam {
+
+static SoftSimdLevel
+detect_simd_level ()
+{
+#if XCAM_SOFT_SIMD_X86
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2"))
+        return SoftSimdAVX2;
+    if (__builtin_cpu_supports ("sse4.1"))
+        return SoftSimdSSE41;
+    return SoftSimdNone;
+#elif XCAM_SOFT_SIMD_NEON
+    return SoftSimdNEON;
+#else
+    return SoftSimdNone;
+#endif
+}
+
+static SoftSimdLevel
+init_simd_level ()
+{
+    SoftSimdLevel level = detect_simd_level ();
+    const char *env = getenv ("XCAM_SOFT_SIMD");
+    SoftSimdLevel limit = level;
+
+    if (env) {
+        if (!strcasecmp (env, "none"))
+            limit = SoftSimdNone;
+        else if (!strcasecmp (env, "sse4.1"))
+            limit = SoftSimdSSE41;
+        else if (!strcasecmp (env, "avx2"))
+            limit = SoftSimdAVX2;
+        else if (!strcasecmp (env, "neon"))
+            limit = SoftSimdNEON;
+        else
+            XCAM_LOG_WARNING ("XCAM_SOFT_SIMD=%s unknown, use detected level", env);
+    }
+
+    // NEON and x86 levels do not mix, only allow going down to none
+    if (limit == SoftSimdNone ||
+            (limit < level && level != SoftSimdNEON && limit != SoftSimdNEON))
+        level = limit;
+
+    XCAM_LOG_DEBUG ("soft handlers simd level:%s", soft_simd_level_name (level));
+    return level;
+}
+
+SoftSimdLevel
+soft_simd_level ()
+{
+    static SoftSimdLevel level = init_simd_level ();
+    return level;
+}
+
+const char *
+soft_simd_level_name (SoftSimdLevel level)
+{
+    switch (level) {
+    case SoftSimdSSE41:
+        return "sse4.1";
+    case SoftSimdAVX2:
+        return "avx2";
+    case SoftSimdNEON:
+        return "neon";
+    default:
+        break;
+    }
+    return "none";
+}
+
+};
@@ -0,0 +1,55 @@
+/*
+ * soft_simd.h - runtime SIMD level of CPU handlers
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_SIMD_H
+#define XCAM_SOFT_SIMD_H
+
+#include "xcam_utils.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define XCAM_SOFT_SIMD_X86 1
+// per-function target, no global -m flags needed
+#define XCAM_SOFT_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define XCAM_SOFT_TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define XCAM_SOFT_SIMD_NEON 1
+#endif
+
+namespace XCam {
+
+enum SoftSimdLevel {
+    SoftSimdNone = 0,
+    SoftSimdSSE41,
+    SoftSimdAVX2,
+    SoftSimdNEON,
+};
+
+/*
+ * best level supported by this cpu, lowered by
+ * $XCAM_SOFT_SIMD=none|sse4.1|avx2|neon for comparison and debugging
+ */
+SoftSimdLevel soft_simd_level ();
+const char *soft_simd_level_name (SoftSimdLevel level);
+
+};
+
+#endif //XCAM_SOFT_SIMD_H
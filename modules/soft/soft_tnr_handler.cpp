@@ -0,0 +1,420 @@
+/*
+ * soft_tnr_handler.cpp - CPU temporal noise reduction handler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_tnr_handler.h"
+#include "host_mem_buffer.h"
+#include <math.h>
+
+// difference of full motion weight, same as kernel_tnr_yuv
+#define SOFT_TNR_DIFF_MAX  0.8f
+
+namespace XCam {
+
+/*
+ * kernel_tnr_yuv weight of diff d (0 to 1):
+ *   d < thr ? gain : (d * (1 - gain) + DIFF_MAX * gain - thr) / (DIFF_MAX - thr)
+ * the second branch equals gain at d = thr and grows with d, so it is
+ * max (slope * d + offset, gain), clipped to 1.
+ */
+static SoftTnrCoeffs
+get_tnr_coeffs (float gain, float threshold)
+{
+    SoftTnrCoeffs coeffs;
+    const float one = (float)(1 << XCAM_SOFT_TNR_COEFF_BITS);
+
+    gain = XCAM_MAX (XCAM_MIN (gain, 1.0f), 0.0f);
+    threshold = XCAM_MAX (XCAM_MIN (threshold, SOFT_TNR_DIFF_MAX - 1.0f / 255.0f), 0.0f);
+    float range = SOFT_TNR_DIFF_MAX - threshold;
+
+    // slope per 8-bit diff step in coeff units, scaled by 1 << 16
+    float slope = (1.0f - gain) / (range * 255.0f) * one * 65536.0f / 256.0f;
+    float offset = (SOFT_TNR_DIFF_MAX * gain - threshold) / range * one;
+
+    coeffs.slope = (uint16_t)XCAM_MIN (slope + 0.5f, 65535.0f);
+    coeffs.offset = (int16_t)roundf (XCAM_MAX (XCAM_MIN (offset, one), one - XCAM_SOFT_TNR_SLOPE_MAX));
+    coeffs.gain = (int16_t)roundf (gain * one);
+    return coeffs;
+}
+
+SoftTnrImageKernel::SoftTnrImageKernel (const char *name, SoftTnrType type)
+    : SoftImageKernel (name)
+    , _type (type)
+    , _frame_count (XCAM_SOFT_TNR_DEFAULT_FRAMES)
+    , _rgb_threshold (0.064f + 0.045f + 0.073f) // same strong initial denoise as CL
+    , _rgb_sad_threshold (0)
+    , _funcs (NULL)
+    , _ref_slots (0)
+    , _ref_head (0)
+    , _refs_ready (false)
+{
+    // same initial gain and thresholds as CLTnrImageKernel
+    _y_coeffs = get_tnr_coeffs (1.0f, 0.05f);
+    _uv_coeffs = get_tnr_coeffs (1.0f, 0.05f);
+    // row bands, simd runs along whole rows
+    set_tile_size (XCAM_SOFT_TILE_FULL_WIDTH, 0);
+}
+
+bool
+SoftTnrImageKernel::set_rgb_config (const XCam3aResultTemporalNoiseReduction &config)
+{
+    // gain is unused by kernel_tnr_rgb as well
+    _rgb_threshold = (float)(config.threshold[0] + config.threshold[1] + config.threshold[2]);
+    XCAM_LOG_DEBUG ("set soft TNR RGB config: _thr_r(%f), _thr_g(%f), _thr_b(%f)",
+                    config.threshold[0], config.threshold[1], config.threshold[2]);
+    return true;
+}
+
+bool
+SoftTnrImageKernel::set_yuv_config (const XCam3aResultTemporalNoiseReduction &config)
+{
+    _y_coeffs = get_tnr_coeffs ((float)config.gain, (float)config.threshold[0]);
+    _uv_coeffs = get_tnr_coeffs ((float)config.gain, (float)config.threshold[1]);
+    XCAM_LOG_DEBUG ("set soft TNR YUV config: _gain(%f), _thr_y(%f), _thr_uv(%f)",
+                    config.gain, config.threshold[0], config.threshold[1]);
+    return true;
+}
+
+bool
+SoftTnrImageKernel::set_framecount (uint32_t count)
+{
+    XCAM_FAIL_RETURN (
+        WARNING,
+        count >= 2 && count <= XCAM_SOFT_TNR_MAX_FRAMES,
+        false,
+        "soft tnr kernel(%s) frame count(%d) only support 2/3/4",
+        XCAM_STR (get_kernel_name ()), count);
+
+    if (count != _frame_count) {
+        _frame_count = count;
+        restart_refs ();
+    }
+    return true;
+}
+
+void
+SoftTnrImageKernel::reset_refs ()
+{
+    for (uint32_t i = 0; i < XCAM_SOFT_TNR_MAX_FRAMES - 1; ++i) {
+        _ref_frames[i].unmap ();
+        _refs[i].release ();
+    }
+    if (_ref_pool.ptr ()) {
+        _ref_pool->stop ();
+        _ref_pool.release ();
+    }
+    _ref_slots = 0;
+    _ref_head = 0;
+    _refs_ready = false;
+}
+
+/*
+ * RGB always holds XCAM_SOFT_TNR_MAX_FRAMES - 1 slots so frame count
+ * changes reuse them, YUV holds the previous output only.
+ */
+XCamReturn
+SoftTnrImageKernel::ensure_refs (const VideoBufferInfo &info)
+{
+    if (_ref_pool.ptr ()) {
+        const VideoBufferInfo &pool_info = _ref_pool->get_video_info ();
+        if (pool_info.format != info.format ||
+                pool_info.width != info.width || pool_info.height != info.height)
+            reset_refs ();
+    }
+
+    if (!_ref_pool.ptr ()) {
+        uint32_t slots = (_type == SOFT_TNR_TYPE_RGB) ? XCAM_SOFT_TNR_MAX_FRAMES - 1 : 1;
+        SmartPtr<BufferPool> pool = new HostMemBufferPool;
+        pool->set_name ("soft_tnr_ref");
+        XCAM_FAIL_RETURN (
+            WARNING,
+            pool->set_video_info (info) && pool->reserve (slots),
+            XCAM_RETURN_ERROR_MEM,
+            "soft tnr kernel(%s) init reference pool failed", XCAM_STR (get_kernel_name ()));
+
+        for (uint32_t i = 0; i < slots; ++i) {
+            _refs[i] = pool->get_buffer (pool);
+            XCAM_ASSERT (_refs[i].ptr ());
+        }
+        _ref_pool = pool;
+        _ref_slots = slots;
+        _ref_head = 0;
+        _refs_ready = false;
+    }
+
+    for (uint32_t i = 0; i < _ref_slots; ++i) {
+        XCamReturn ret = _ref_frames[i].map (_refs[i]);
+        XCAM_FAIL_RETURN (
+            WARNING, ret == XCAM_RETURN_NO_ERROR, ret,
+            "soft tnr kernel(%s) map reference %d failed", XCAM_STR (get_kernel_name ()), i);
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftTnrImageKernel::prepare_arguments (
+    SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+    uint32_t &work_width, uint32_t &work_height)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+
+    const VideoBufferInfo &in_info = _in.get_video_info ();
+    const VideoBufferInfo &out_info = _out.get_video_info ();
+    uint32_t format = (_type == SOFT_TNR_TYPE_RGB) ? V4L2_PIX_FMT_RGBA32 : V4L2_PIX_FMT_NV12;
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in_info.format == format && out_info.format == format,
+        XCAM_RETURN_ERROR_PARAM,
+        "soft tnr kernel(%s) only supports %s, input %s, output %s",
+        XCAM_STR (get_kernel_name ()), xcam_fourcc_to_string (format),
+        xcam_fourcc_to_string (in_info.format), xcam_fourcc_to_string (out_info.format));
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        in_info.width == out_info.width && in_info.height == out_info.height,
+        XCAM_RETURN_ERROR_PARAM,
+        "soft tnr kernel(%s) input(%dx%d) and output(%dx%d) size differ",
+        XCAM_STR (get_kernel_name ()),
+        in_info.width, in_info.height, out_info.width, out_info.height);
+
+    work_width = in_info.width;
+    work_height = in_info.height;
+    if (_type == SOFT_TNR_TYPE_YUV) {
+        XCAM_FAIL_RETURN (
+            WARNING,
+            !(work_width % 2) && !(work_height % 2),
+            XCAM_RETURN_ERROR_PARAM,
+            "soft tnr kernel(%s) size(%dx%d) must be even",
+            XCAM_STR (get_kernel_name ()), work_width, work_height);
+        // pairs of luma rows sharing one chroma row
+        work_height /= 2;
+    }
+
+    XCamReturn ret = ensure_refs (in_info);
+    if (ret != XCAM_RETURN_NO_ERROR)
+        return ret;
+
+    // summed rgb differences of frame_count - 1 pairs, 8-bit steps
+    _rgb_sad_threshold = (int32_t)ceilf (_rgb_threshold * 255.0f * (_frame_count - 1));
+    _funcs = &get_soft_tnr_funcs (soft_simd_level ());
+    return XCAM_RETURN_NO_ERROR;
+}
+
+uint32_t
+SoftTnrImageKernel::get_bytes_per_pixel () const
+{
+    if (_type == SOFT_TNR_TYPE_RGB)
+        return 4 * (_frame_count + 1);
+    // two luma rows and a chroma row each of input, reference and output
+    return 3 * 3;
+}
+
+void
+SoftTnrImageKernel::init_refs_tile (const ImageTile &tile)
+{
+    uint32_t slots = (_type == SOFT_TNR_TYPE_RGB) ? _frame_count - 1 : 1;
+
+    for (uint32_t i = 0; i < _in.get_plane_count (); ++i) {
+        const SoftImagePlane &in = _in.get_plane (i);
+        const SoftImagePlane &out = _out.get_plane (i);
+        uint32_t bytes = tile.width * in.pixel_bytes;
+        // work rows of NV12 are luma row pairs
+        uint32_t rows = (_type == SOFT_TNR_TYPE_YUV && i == 0) ? 2 : 1;
+
+        for (uint32_t y = tile.y * rows; y < (tile.y + tile.height) * rows; ++y) {
+            const uint8_t *src = in.pixel (tile.x, y);
+            memcpy (out.pixel (tile.x, y), src, bytes);
+            for (uint32_t k = 0; k < slots; ++k)
+                memcpy (_ref_frames[k].get_plane (i).pixel (tile.x, y), src, bytes);
+        }
+    }
+}
+
+XCamReturn
+SoftTnrImageKernel::work_tile (const ImageTile &tile)
+{
+    XCAM_ASSERT (_funcs);
+    const SoftImagePlane &in = _in.get_plane (0);
+    const SoftImagePlane &out = _out.get_plane (0);
+    uint32_t x = tile.x, width = tile.width;
+    uint32_t y_end = tile.y + tile.height;
+
+    // first frame of a history is passed through
+    if (!_refs_ready) {
+        init_refs_tile (tile);
+        return XCAM_RETURN_NO_ERROR;
+    }
+
+    if (_type == SOFT_TNR_TYPE_YUV) {
+        const SoftImagePlane &ref = _ref_frames[0].get_plane (0);
+        const SoftImagePlane &in_uv = _in.get_plane (1);
+        const SoftImagePlane &ref_uv = _ref_frames[0].get_plane (1);
+        const SoftImagePlane &out_uv = _out.get_plane (1);
+        XCAM_ASSERT (!(x % 2) && !(width % 2));
+
+        for (uint32_t y = tile.y; y < y_end; ++y) {
+            _funcs->luma (
+                in.row (y * 2) + x, in.row (y * 2 + 1) + x,
+                ref.row (y * 2) + x, ref.row (y * 2 + 1) + x,
+                out.row (y * 2) + x, out.row (y * 2 + 1) + x,
+                width, _y_coeffs);
+            _funcs->chroma (in_uv.row (y) + x, ref_uv.row (y) + x, out_uv.row (y) + x, width, _uv_coeffs);
+        }
+        return XCAM_RETURN_NO_ERROR;
+    }
+
+    uint32_t ref_count = _frame_count - 1;
+    for (uint32_t y = tile.y; y < y_end; ++y) {
+        uint8_t *refs[XCAM_SOFT_TNR_MAX_FRAMES - 1];
+        for (uint32_t k = 0; k < ref_count; ++k)
+            refs[k] = _ref_frames[(_ref_head + k) % ref_count].get_plane (0).pixel (x, y);
+        _funcs->rgb (in.pixel (x, y), refs, ref_count, out.pixel (x, y), width, _rgb_sad_threshold);
+    }
+    return XCAM_RETURN_NO_ERROR;
+}
+
+XCamReturn
+SoftTnrImageKernel::post_execute (SmartPtr<VideoBuffer> &output)
+{
+    for (uint32_t i = 0; i < _ref_slots; ++i)
+        _ref_frames[i].unmap ();
+
+    // current frame took the oldest slot, the next one is now oldest
+    if (!_refs_ready) {
+        _ref_head = 0;
+        _refs_ready = true;
+    } else if (_type == SOFT_TNR_TYPE_RGB) {
+        _ref_head = (_ref_head + 1) % (_frame_count - 1);
+    }
+
+    return SoftImageKernel::post_execute (output);
+}
+
+void
+SoftTnrImageKernel::pre_stop ()
+{
+    SoftImageKernel::pre_stop ();
+    reset_refs ();
+}
+
+SoftTnrImageHandler::SoftTnrImageHandler (const char *name)
+    : SoftImageHandler (name)
+{
+}
+
+bool
+SoftTnrImageHandler::set_tnr_kernel (SmartPtr<SoftTnrImageKernel> &kernel)
+{
+    SmartPtr<SoftImageKernel> image_kernel = kernel;
+    add_kernel (image_kernel);
+    _tnr_kernel = kernel;
+    return true;
+}
+
+/*
+ * a disabled handler passes input through, references would be stale
+ * when it is enabled again.
+ */
+bool
+SoftTnrImageHandler::set_mode (uint32_t mode)
+{
+    XCAM_ASSERT (_tnr_kernel.ptr ());
+    bool enable = (mode & _tnr_kernel->get_type ());
+
+    if (enable && !is_handler_enabled ())
+        _tnr_kernel->restart_refs ();
+    return enable_handler (enable);
+}
+
+bool
+SoftTnrImageHandler::set_framecount (uint32_t count)
+{
+    XCAM_ASSERT (_tnr_kernel.ptr ());
+    return _tnr_kernel->set_framecount (count);
+}
+
+bool
+SoftTnrImageHandler::set_rgb_config (const XCam3aResultTemporalNoiseReduction &config)
+{
+    XCAM_ASSERT (_tnr_kernel.ptr ());
+    return _tnr_kernel->set_rgb_config (config);
+}
+
+bool
+SoftTnrImageHandler::set_yuv_config (const XCam3aResultTemporalNoiseReduction &config)
+{
+    XCAM_ASSERT (_tnr_kernel.ptr ());
+    return _tnr_kernel->set_yuv_config (config);
+}
+
+XCamReturn
+SoftTnrImageHandler::prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output)
+{
+    XCAM_UNUSED (input);
+    XCAM_UNUSED (output);
+    XCAM_ASSERT (_tnr_kernel.ptr ());
+
+    if (_tnr_kernel->get_type () != SOFT_TNR_TYPE_YUV)
+        return XCAM_RETURN_NO_ERROR;
+
+    SmartPtr<X3aResult> result = get_3a_result (XCAM_3A_RESULT_TEMPORAL_NOISE_REDUCTION_YUV);
+    if (!result.ptr ())
+        return XCAM_RETURN_NO_ERROR;
+
+    SmartPtr<X3aTemporalNoiseReduction> tnr_res = result.dynamic_cast_ptr<X3aTemporalNoiseReduction> ();
+    XCAM_FAIL_RETURN (
+        WARNING,
+        tnr_res.ptr (),
+        XCAM_RETURN_ERROR_PARAM,
+        "soft image handler(%s) tnr result is not a temporal noise reduction", get_name ());
+
+    set_yuv_config (tnr_res->get_standard_result ());
+    return XCAM_RETURN_NO_ERROR;
+}
+
+SmartPtr<SoftImageHandler>
+create_soft_tnr_image_handler (SoftTnrType type)
+{
+    SmartPtr<SoftTnrImageHandler> tnr_handler;
+    SmartPtr<SoftTnrImageKernel> tnr_kernel;
+    const char *kernel_name = NULL;
+
+    if (type == SOFT_TNR_TYPE_YUV)
+        kernel_name = "soft_tnr_yuv";
+    else if (type == SOFT_TNR_TYPE_RGB)
+        kernel_name = "soft_tnr_rgb";
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        kernel_name,
+        NULL,
+        "create soft tnr image handler failed, unknown type:%d", (int)type);
+
+    XCAM_LOG_DEBUG ("soft tnr(%s) uses simd level %s", kernel_name, soft_simd_level_name (soft_simd_level ()));
+
+    tnr_kernel = new SoftTnrImageKernel (kernel_name, type);
+    tnr_handler = new SoftTnrImageHandler ("soft_handler_tnr");
+    tnr_handler->set_tnr_kernel (tnr_kernel);
+
+    return tnr_handler;
+}
+
+};
@@ -0,0 +1,131 @@
+/*
+ * soft_tnr_handler.h - CPU temporal noise reduction handler
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_TNR_HANDLER_H
+#define XCAM_SOFT_TNR_HANDLER_H
+
+#include "xcam_utils.h"
+#include "soft_image_handler.h"
+#include "soft_tnr_simd.h"
+#include "base/xcam_3a_result.h"
+
+#define XCAM_SOFT_TNR_DEFAULT_FRAMES  4
+
+namespace XCam {
+
+enum SoftTnrType {
+    SOFT_TNR_DISABLE = 0,
+    SOFT_TNR_TYPE_YUV = 1 << 0,
+    SOFT_TNR_TYPE_RGB = 1 << 1,
+};
+
+/*
+ * CPU counterpart of CLTnrImageKernel.
+ * YUV (NV12) blends with the previous output, RGB (RGBA) averages
+ * the last frame_count inputs where they are still. reference frames
+ * live in a ring of host buffers owned by the kernel, rewritten in the
+ * same band pass that produces the output, so no frame is allocated or
+ * copied per frame and upstream buffers are not held.
+ */
+class SoftTnrImageKernel
+    : public SoftImageKernel
+{
+public:
+    explicit SoftTnrImageKernel (const char *name, SoftTnrType type);
+
+    SoftTnrType get_type () const {
+        return _type;
+    }
+    uint32_t get_framecount () const {
+        return _frame_count;
+    }
+
+    bool set_rgb_config (const XCam3aResultTemporalNoiseReduction &config);
+    bool set_yuv_config (const XCam3aResultTemporalNoiseReduction &config);
+    bool set_framecount (uint32_t count);
+    // next frame starts a new reference history
+    void restart_refs () {
+        _refs_ready = false;
+    }
+
+    virtual XCamReturn post_execute (SmartPtr<VideoBuffer> &output);
+    virtual void pre_stop ();
+
+protected:
+    virtual XCamReturn prepare_arguments (
+        SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output,
+        uint32_t &work_width, uint32_t &work_height);
+    virtual uint32_t get_bytes_per_pixel () const;
+    virtual XCamReturn work_tile (const ImageTile &tile);
+
+private:
+    XCamReturn ensure_refs (const VideoBufferInfo &info);
+    void reset_refs ();
+    void init_refs_tile (const ImageTile &tile);
+
+    XCAM_DEAD_COPY (SoftTnrImageKernel);
+
+private:
+    SoftTnrType               _type;
+    uint32_t                  _frame_count;
+    SoftTnrCoeffs             _y_coeffs;
+    SoftTnrCoeffs             _uv_coeffs;
+    // thr_r + thr_g + thr_b, scaled by frame count on each frame
+    float                     _rgb_threshold;
+    int32_t                   _rgb_sad_threshold;
+    const SoftTnrFuncs       *_funcs;
+
+    SmartPtr<BufferPool>      _ref_pool;
+    SmartPtr<VideoBuffer>     _refs[XCAM_SOFT_TNR_MAX_FRAMES - 1];
+    SoftImageFrame            _ref_frames[XCAM_SOFT_TNR_MAX_FRAMES - 1];
+    uint32_t                  _ref_slots;
+    // oldest slot, rewritten with the current frame
+    uint32_t                  _ref_head;
+    // first frame fills all slots
+    bool                      _refs_ready;
+};
+
+class SoftTnrImageHandler
+    : public SoftImageHandler
+{
+public:
+    explicit SoftTnrImageHandler (const char *name);
+    bool set_tnr_kernel (SmartPtr<SoftTnrImageKernel> &kernel);
+    bool set_mode (uint32_t mode);
+    bool set_framecount (uint32_t count);
+    bool set_rgb_config (const XCam3aResultTemporalNoiseReduction &config);
+    bool set_yuv_config (const XCam3aResultTemporalNoiseReduction &config);
+
+protected:
+    virtual XCamReturn prepare_parameters (SmartPtr<VideoBuffer> &input, SmartPtr<VideoBuffer> &output);
+
+private:
+    XCAM_DEAD_COPY (SoftTnrImageHandler);
+
+private:
+    SmartPtr<SoftTnrImageKernel>   _tnr_kernel;
+};
+
+SmartPtr<SoftImageHandler>
+create_soft_tnr_image_handler (SoftTnrType type);
+
+};
+
+#endif //XCAM_SOFT_TNR_HANDLER_H
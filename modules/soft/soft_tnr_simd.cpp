@@ -0,0 +1,406 @@
+/*
+ * soft_tnr_simd.cpp - row functions of CPU temporal noise reduction
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "soft_tnr_simd.h"
+#include <stdlib.h>
+
+#if XCAM_SOFT_SIMD_X86
+#include <immintrin.h>
+#endif
+#if XCAM_SOFT_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#define COEFF_ONE     (1 << XCAM_SOFT_TNR_COEFF_BITS)
+#define BLEND_ROUND   (1 << (XCAM_SOFT_TNR_COEFF_BITS - 1))
+// (cur - ref) scaled up so that mulhrs by coeff gives the Q8 product
+#define BLEND_SHIFT   (15 - XCAM_SOFT_TNR_COEFF_BITS)
+
+namespace XCam {
+
+// (sum + n / 2) * recip >> 16 rounds sum / n for sums of up to 4 bytes
+static const uint16_t tnr_mean_recip[XCAM_SOFT_TNR_MAX_FRAMES + 1] = {
+    0, 0, 32768, 21846, 16384
+};
+
+static inline uint8_t
+clamp_u8 (int32_t value)
+{
+    return (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+static inline int32_t
+tnr_coeff (int32_t diff, const SoftTnrCoeffs &coeffs)
+{
+    int32_t t = (int32_t)((((uint32_t)diff << 8) * coeffs.slope) >> 16);
+    t = XCAM_MIN (t, XCAM_SOFT_TNR_SLOPE_MAX) + coeffs.offset;
+    t = XCAM_MAX (t, (int32_t)coeffs.gain);
+    return XCAM_MIN (t, COEFF_ONE);
+}
+
+static inline uint8_t
+tnr_blend (uint8_t cur, uint8_t ref, int32_t coeff)
+{
+    int32_t delta = ((int32_t)cur - (int32_t)ref) * coeff;
+    return clamp_u8 (ref + ((delta + BLEND_ROUND) >> XCAM_SOFT_TNR_COEFF_BITS));
+}
+
+static void
+luma_row_c (
+    const uint8_t *cur0, const uint8_t *cur1, uint8_t *ref0, uint8_t *ref1,
+    uint8_t *out0, uint8_t *out1, uint32_t x, uint32_t width, const SoftTnrCoeffs &coeffs)
+{
+    for (; x < width; x += 2) {
+        int32_t sum =
+            abs ((int32_t)cur0[x] - ref0[x]) + abs ((int32_t)cur0[x + 1] - ref0[x + 1]) +
+            abs ((int32_t)cur1[x] - ref1[x]) + abs ((int32_t)cur1[x + 1] - ref1[x + 1]);
+        int32_t coeff = tnr_coeff ((sum + 2) >> 2, coeffs);
+
+        out0[x] = ref0[x] = tnr_blend (cur0[x], ref0[x], coeff);
+        out0[x + 1] = ref0[x + 1] = tnr_blend (cur0[x + 1], ref0[x + 1], coeff);
+        out1[x] = ref1[x] = tnr_blend (cur1[x], ref1[x], coeff);
+        out1[x + 1] = ref1[x + 1] = tnr_blend (cur1[x + 1], ref1[x + 1], coeff);
+    }
+}
+
+static void
+chroma_row_c (
+    const uint8_t *cur, uint8_t *ref, uint8_t *out,
+    uint32_t x, uint32_t width, const SoftTnrCoeffs &coeffs)
+{
+    for (; x < width; ++x) {
+        int32_t coeff = tnr_coeff (abs ((int32_t)cur[x] - ref[x]), coeffs);
+        out[x] = ref[x] = tnr_blend (cur[x], ref[x], coeff);
+    }
+}
+
+static void
+rgb_row_c (
+    const uint8_t *cur, uint8_t *const *refs, uint32_t ref_count,
+    uint8_t *out, uint32_t x, uint32_t width, int32_t threshold)
+{
+    const uint8_t *frames[XCAM_SOFT_TNR_MAX_FRAMES];
+    uint32_t count = ref_count + 1;
+    uint32_t recip = tnr_mean_recip[count];
+
+    XCAM_ASSERT (ref_count && count <= XCAM_SOFT_TNR_MAX_FRAMES);
+    for (uint32_t k = 0; k < ref_count; ++k)
+        frames[k] = refs[k];
+    frames[ref_count] = cur;
+
+    for (; x < width; ++x) {
+        uint32_t i = x * 4;
+        int32_t var = 0;
+        for (uint32_t k = 0; k < ref_count; ++k) {
+            for (uint32_t c = 0; c < 3; ++c)
+                var += abs ((int32_t)frames[k][i + c] - frames[k + 1][i + c]);
+        }
+
+        uint8_t pixel[4];
+        for (uint32_t c = 0; c < 4; ++c) {
+            if (var < threshold) {
+                uint32_t sum = count / 2;
+                for (uint32_t k = 0; k < count; ++k)
+                    sum += frames[k][i + c];
+                pixel[c] = (uint8_t)((sum * recip) >> 16);
+            } else
+                pixel[c] = cur[i + c];
+        }
+        for (uint32_t c = 0; c < 4; ++c) {
+            out[i + c] = pixel[c];
+            refs[0][i + c] = cur[i + c];
+        }
+    }
+}
+
+static void
+luma_c (
+    const uint8_t *cur0, const uint8_t *cur1, uint8_t *ref0, uint8_t *ref1,
+    uint8_t *out0, uint8_t *out1, uint32_t width, const SoftTnrCoeffs &coeffs)
+{
+    luma_row_c (cur0, cur1, ref0, ref1, out0, out1, 0, width, coeffs);
+}
+
+static void
+chroma_c (
+    const uint8_t *cur, uint8_t *ref, uint8_t *out,
+    uint32_t width, const SoftTnrCoeffs &coeffs)
+{
+    chroma_row_c (cur, ref, out, 0, width, coeffs);
+}
+
+static void
+rgb_c (
+    const uint8_t *cur, uint8_t *const *refs, uint32_t ref_count,
+    uint8_t *out, uint32_t width, int32_t threshold)
+{
+    rgb_row_c (cur, refs, ref_count, out, 0, width, threshold);
+}
+
+static const SoftTnrFuncs tnr_funcs_c = {
+    luma_c,
+    chroma_c,
+    rgb_c,
+};
+
+#if XCAM_SOFT_SIMD_X86
+
+XCAM_SOFT_TARGET_SSE41 static inline __m128i
+absdiff_sse (__m128i a, __m128i b)
+{
+    return _mm_or_si128 (_mm_subs_epu8 (a, b), _mm_subs_epu8 (b, a));
+}
+
+// @diff in unsigned 16-bit lanes, same steps as tnr_coeff
+XCAM_SOFT_TARGET_SSE41 static inline __m128i
+coeff_sse (__m128i diff, const SoftTnrCoeffs &coeffs)
+{
+    __m128i t = _mm_mulhi_epu16 (_mm_slli_epi16 (diff, 8), _mm_set1_epi16 ((int16_t)coeffs.slope));
+    t = _mm_min_epu16 (t, _mm_set1_epi16 (XCAM_SOFT_TNR_SLOPE_MAX));
+    t = _mm_add_epi16 (t, _mm_set1_epi16 (coeffs.offset));
+    t = _mm_max_epi16 (t, _mm_set1_epi16 (coeffs.gain));
+    return _mm_min_epi16 (t, _mm_set1_epi16 (COEFF_ONE));
+}
+
+// 16 bytes of ref + coeff * (cur - ref), mulhrs rounds as BLEND_ROUND
+XCAM_SOFT_TARGET_SSE41 static inline __m128i
+blend_sse (__m128i cur, __m128i ref, __m128i coeff_lo, __m128i coeff_hi)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    __m128i ref_lo = _mm_unpacklo_epi8 (ref, zero);
+    __m128i ref_hi = _mm_unpackhi_epi8 (ref, zero);
+    __m128i d_lo = _mm_slli_epi16 (_mm_sub_epi16 (_mm_unpacklo_epi8 (cur, zero), ref_lo), BLEND_SHIFT);
+    __m128i d_hi = _mm_slli_epi16 (_mm_sub_epi16 (_mm_unpackhi_epi8 (cur, zero), ref_hi), BLEND_SHIFT);
+    return _mm_packus_epi16 (
+               _mm_add_epi16 (ref_lo, _mm_mulhrs_epi16 (d_lo, coeff_lo)),
+               _mm_add_epi16 (ref_hi, _mm_mulhrs_epi16 (d_hi, coeff_hi)));
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+luma_sse (
+    const uint8_t *cur0, const uint8_t *cur1, uint8_t *ref0, uint8_t *ref1,
+    uint8_t *out0, uint8_t *out1, uint32_t width, const SoftTnrCoeffs &coeffs)
+{
+    const __m128i ones = _mm_set1_epi8 (1);
+    const __m128i round = _mm_set1_epi16 (2);
+    uint32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        __m128i c0 = _mm_loadu_si128 ((const __m128i *)(cur0 + x));
+        __m128i c1 = _mm_loadu_si128 ((const __m128i *)(cur1 + x));
+        __m128i r0 = _mm_loadu_si128 ((const __m128i *)(ref0 + x));
+        __m128i r1 = _mm_loadu_si128 ((const __m128i *)(ref1 + x));
+
+        // horizontal pairs of both rows, mean of each 2x2 block
+        __m128i sum = _mm_add_epi16 (
+                          _mm_maddubs_epi16 (absdiff_sse (c0, r0), ones),
+                          _mm_maddubs_epi16 (absdiff_sse (c1, r1), ones));
+        __m128i coeff = coeff_sse (_mm_srli_epi16 (_mm_add_epi16 (sum, round), 2), coeffs);
+        __m128i coeff_lo = _mm_unpacklo_epi16 (coeff, coeff);
+        __m128i coeff_hi = _mm_unpackhi_epi16 (coeff, coeff);
+
+        __m128i o0 = blend_sse (c0, r0, coeff_lo, coeff_hi);
+        __m128i o1 = blend_sse (c1, r1, coeff_lo, coeff_hi);
+        _mm_storeu_si128 ((__m128i *)(out0 + x), o0);
+        _mm_storeu_si128 ((__m128i *)(ref0 + x), o0);
+        _mm_storeu_si128 ((__m128i *)(out1 + x), o1);
+        _mm_storeu_si128 ((__m128i *)(ref1 + x), o1);
+    }
+    luma_row_c (cur0, cur1, ref0, ref1, out0, out1, x, width, coeffs);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+chroma_sse (
+    const uint8_t *cur, uint8_t *ref, uint8_t *out,
+    uint32_t width, const SoftTnrCoeffs &coeffs)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    uint32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        __m128i c = _mm_loadu_si128 ((const __m128i *)(cur + x));
+        __m128i r = _mm_loadu_si128 ((const __m128i *)(ref + x));
+        __m128i diff = absdiff_sse (c, r);
+        __m128i coeff_lo = coeff_sse (_mm_unpacklo_epi8 (diff, zero), coeffs);
+        __m128i coeff_hi = coeff_sse (_mm_unpackhi_epi8 (diff, zero), coeffs);
+
+        __m128i o = blend_sse (c, r, coeff_lo, coeff_hi);
+        _mm_storeu_si128 ((__m128i *)(out + x), o);
+        _mm_storeu_si128 ((__m128i *)(ref + x), o);
+    }
+    chroma_row_c (cur, ref, out, x, width, coeffs);
+}
+
+XCAM_SOFT_TARGET_SSE41 static void
+rgb_sse (
+    const uint8_t *cur, uint8_t *const *refs, uint32_t ref_count,
+    uint8_t *out, uint32_t width, int32_t threshold)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    // r, g, b weighted 1, alpha 0
+    const __m128i rgb_weight = _mm_set1_epi32 (0x00010101);
+    const __m128i ones = _mm_set1_epi16 (1);
+    const __m128i thr = _mm_set1_epi32 (threshold);
+    uint32_t count = ref_count + 1;
+    const __m128i round = _mm_set1_epi16 ((int16_t)(count / 2));
+    const __m128i recip = _mm_set1_epi16 ((int16_t)tnr_mean_recip[count]);
+    uint32_t x = 0;
+
+    XCAM_ASSERT (ref_count && count <= XCAM_SOFT_TNR_MAX_FRAMES);
+    for (; x + 4 <= width; x += 4) {
+        __m128i f[XCAM_SOFT_TNR_MAX_FRAMES];
+        for (uint32_t k = 0; k < ref_count; ++k)
+            f[k] = _mm_loadu_si128 ((const __m128i *)(refs[k] + x * 4));
+        f[ref_count] = _mm_loadu_si128 ((const __m128i *)(cur + x * 4));
+
+        __m128i var = zero;
+        __m128i sum_lo = zero, sum_hi = zero;
+        for (uint32_t k = 0; k < ref_count; ++k)
+            var = _mm_add_epi16 (var, _mm_maddubs_epi16 (absdiff_sse (f[k], f[k + 1]), rgb_weight));
+        for (uint32_t k = 0; k < count; ++k) {
+            sum_lo = _mm_add_epi16 (sum_lo, _mm_unpacklo_epi8 (f[k], zero));
+            sum_hi = _mm_add_epi16 (sum_hi, _mm_unpackhi_epi8 (f[k], zero));
+        }
+
+        // per pixel sum of (r + g) and (b + 0) pairs
+        __m128i still = _mm_cmpgt_epi32 (thr, _mm_madd_epi16 (var, ones));
+        __m128i mean = _mm_packus_epi16 (
+                           _mm_mulhi_epu16 (_mm_add_epi16 (sum_lo, round), recip),
+                           _mm_mulhi_epu16 (_mm_add_epi16 (sum_hi, round), recip));
+
+        _mm_storeu_si128 ((__m128i *)(out + x * 4), _mm_blendv_epi8 (f[ref_count], mean, still));
+        _mm_storeu_si128 ((__m128i *)(refs[0] + x * 4), f[ref_count]);
+    }
+    rgb_row_c (cur, refs, ref_count, out, x, width, threshold);
+}
+
+// rows are bandwidth bound, AVX2 uses the SSE4.1 rows
+static const SoftTnrFuncs tnr_funcs_sse41 = {
+    luma_sse,
+    chroma_sse,
+    rgb_sse,
+};
+
+#endif //XCAM_SOFT_SIMD_X86
+
+#if XCAM_SOFT_SIMD_NEON
+
+static inline int16x8_t
+coeff_neon (uint16x8_t diff, const SoftTnrCoeffs &coeffs)
+{
+    uint16x8_t scaled = vshlq_n_u16 (diff, 8);
+    uint16x4_t slope = vdup_n_u16 (coeffs.slope);
+    uint16x8_t t = vcombine_u16 (
+                       vshrn_n_u32 (vmull_u16 (vget_low_u16 (scaled), slope), 16),
+                       vshrn_n_u32 (vmull_u16 (vget_high_u16 (scaled), slope), 16));
+    t = vminq_u16 (t, vdupq_n_u16 (XCAM_SOFT_TNR_SLOPE_MAX));
+    int16x8_t c = vaddq_s16 (vreinterpretq_s16_u16 (t), vdupq_n_s16 (coeffs.offset));
+    c = vmaxq_s16 (c, vdupq_n_s16 (coeffs.gain));
+    return vminq_s16 (c, vdupq_n_s16 (COEFF_ONE));
+}
+
+// vqrdmulh rounds as mulhrs, products stay far below saturation
+static inline uint8x8_t
+blend_neon (uint8x8_t cur, uint8x8_t ref, int16x8_t coeff)
+{
+    int16x8_t ref16 = vreinterpretq_s16_u16 (vmovl_u8 (ref));
+    int16x8_t d = vsubq_s16 (vreinterpretq_s16_u16 (vmovl_u8 (cur)), ref16);
+    d = vshlq_n_s16 (d, BLEND_SHIFT);
+    return vqmovun_s16 (vaddq_s16 (ref16, vqrdmulhq_s16 (d, coeff)));
+}
+
+static void
+luma_neon (
+    const uint8_t *cur0, const uint8_t *cur1, uint8_t *ref0, uint8_t *ref1,
+    uint8_t *out0, uint8_t *out1, uint32_t width, const SoftTnrCoeffs &coeffs)
+{
+    uint32_t x = 0;
+
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t c0 = vld1q_u8 (cur0 + x);
+        uint8x16_t c1 = vld1q_u8 (cur1 + x);
+        uint8x16_t r0 = vld1q_u8 (ref0 + x);
+        uint8x16_t r1 = vld1q_u8 (ref1 + x);
+
+        uint16x8_t sum = vaddq_u16 (vpaddlq_u8 (vabdq_u8 (c0, r0)), vpaddlq_u8 (vabdq_u8 (c1, r1)));
+        int16x8_t coeff = coeff_neon (vrshrq_n_u16 (sum, 2), coeffs);
+        int16x8x2_t dup = vzipq_s16 (coeff, coeff);
+
+        uint8x16_t o0 = vcombine_u8 (
+                            blend_neon (vget_low_u8 (c0), vget_low_u8 (r0), dup.val[0]),
+                            blend_neon (vget_high_u8 (c0), vget_high_u8 (r0), dup.val[1]));
+        uint8x16_t o1 = vcombine_u8 (
+                            blend_neon (vget_low_u8 (c1), vget_low_u8 (r1), dup.val[0]),
+                            blend_neon (vget_high_u8 (c1), vget_high_u8 (r1), dup.val[1]));
+        vst1q_u8 (out0 + x, o0);
+        vst1q_u8 (ref0 + x, o0);
+        vst1q_u8 (out1 + x, o1);
+        vst1q_u8 (ref1 + x, o1);
+    }
+    luma_row_c (cur0, cur1, ref0, ref1, out0, out1, x, width, coeffs);
+}
+
+static void
+chroma_neon (
+    const uint8_t *cur, uint8_t *ref, uint8_t *out,
+    uint32_t width, const SoftTnrCoeffs &coeffs)
+{
+    uint32_t x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        uint8x8_t c = vld1_u8 (cur + x);
+        uint8x8_t r = vld1_u8 (ref + x);
+        int16x8_t coeff = coeff_neon (vmovl_u8 (vabd_u8 (c, r)), coeffs);
+
+        uint8x8_t o = blend_neon (c, r, coeff);
+        vst1_u8 (out + x, o);
+        vst1_u8 (ref + x, o);
+    }
+    chroma_row_c (cur, ref, out, x, width, coeffs);
+}
+
+static const SoftTnrFuncs tnr_funcs_neon = {
+    luma_neon,
+    chroma_neon,
+    rgb_c,
+};
+
+#endif //XCAM_SOFT_SIMD_NEON
+
+const SoftTnrFuncs &
+get_soft_tnr_funcs (SoftSimdLevel level)
+{
+    switch (level) {
+#if XCAM_SOFT_SIMD_X86
+    case SoftSimdAVX2:
+    case SoftSimdSSE41:
+        return tnr_funcs_sse41;
+#endif
+#if XCAM_SOFT_SIMD_NEON
+    case SoftSimdNEON:
+        return tnr_funcs_neon;
+#endif
+    default:
+        break;
+    }
+    return tnr_funcs_c;
+}
+
+};
@@ -0,0 +1,78 @@
+/*
+ * soft_tnr_simd.h - row functions of CPU temporal noise reduction
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SOFT_TNR_SIMD_H
+#define XCAM_SOFT_TNR_SIMD_H
+
+#include "xcam_utils.h"
+#include "soft_simd.h"
+
+// blend weight of current frame, 0 to 1 << XCAM_SOFT_TNR_COEFF_BITS
+#define XCAM_SOFT_TNR_COEFF_BITS   8
+// clip of slope term, keeps it and the offset in int16
+#define XCAM_SOFT_TNR_SLOPE_MAX    2048
+#define XCAM_SOFT_TNR_MAX_FRAMES   4
+
+namespace XCam {
+
+/*
+ * motion-adaptive weight of current frame, as kernel_tnr_yuv:
+ * coeff = min (max (min ((diff << 8) * slope >> 16, SLOPE_MAX) + offset, gain), 1 << COEFF_BITS)
+ * diff is 8-bit mean absolute difference to reference.
+ */
+struct SoftTnrCoeffs {
+    uint16_t   slope;
+    int16_t    offset;
+    int16_t    gain;
+};
+
+/*
+ * output = ref + coeff * (cur - ref), written to @out and back to @ref.
+ * luma: two rows, one coeff per 2x2 block, @width in pixels (even).
+ * chroma: interleaved uv row, one coeff per byte, @width in bytes.
+ */
+typedef void (*SoftTnrLumaFunc) (
+    const uint8_t *cur0, const uint8_t *cur1, uint8_t *ref0, uint8_t *ref1,
+    uint8_t *out0, uint8_t *out1, uint32_t width, const SoftTnrCoeffs &coeffs);
+typedef void (*SoftTnrChromaFunc) (
+    const uint8_t *cur, uint8_t *ref, uint8_t *out,
+    uint32_t width, const SoftTnrCoeffs &coeffs);
+
+/*
+ * RGBA row of kernel_tnr_rgb over @ref_count reference rows, oldest first,
+ * and @cur. a pixel whose summed rgb differences between consecutive
+ * frames is below @threshold gets the mean of all frames, others keep
+ * @cur. @cur is copied to refs[0], the oldest slot. @width in pixels.
+ */
+typedef void (*SoftTnrRgbFunc) (
+    const uint8_t *cur, uint8_t *const *refs, uint32_t ref_count,
+    uint8_t *out, uint32_t width, int32_t threshold);
+
+struct SoftTnrFuncs {
+    SoftTnrLumaFunc      luma;
+    SoftTnrChromaFunc    chroma;
+    SoftTnrRgbFunc       rgb;
+};
+
+const SoftTnrFuncs &get_soft_tnr_funcs (SoftSimdLevel level);
+
+};
+
+#endif //XCAM_SOFT_TNR_SIMD_H
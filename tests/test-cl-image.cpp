@@ -49,6 +49,7 @@ enum TestHandlerType {
     TestHandlerYuvPipe,
     TestHandlerTonemapping,
     TestHandlerRetinex,
+    TestHandlerRetinexBox,
     TestHandlerGauss,
     TestHandlerHatWavelet,
     TestHandlerHaarWavelet,
@@ -130,7 +131,7 @@ print_help (const char *bin_name)
     printf ("Usage: %s [-f format] -i input -o output\n"
             "\t -t type      specify image handler type\n"
             "\t              select from [demo, blacklevel, defect, demosaic, tonemapping, csc, hdr, wb, denoise,"
-            " gamma, snr, bnr, macc, ee, bayerpipe, yuvpipe, retinex, gauss, wavelet-hat, wavelet-haar, dcp, fisheye]\n"
+            " gamma, snr, bnr, macc, ee, bayerpipe, yuvpipe, retinex, retinex-box, gauss, wavelet-hat, wavelet-haar, dcp, fisheye]\n"
             "\t -f input_format    specify a input format\n"
             "\t -W image width     specify input image width\n"
             "\t -H image height    specify input image height\n"
@@ -233,6 +234,8 @@ int main (int argc, char *argv[])
                 handler_type = TestHandlerTonemapping;
             else if (!strcasecmp (optarg, "retinex"))
                 handler_type = TestHandlerRetinex;
+            else if (!strcasecmp (optarg, "retinex-box"))
+                handler_type = TestHandlerRetinexBox;
             else if (!strcasecmp (optarg, "gauss"))
                 handler_type = TestHandlerGauss;
             else if (!strcasecmp (optarg, "wavelet-hat"))
@@ -347,6 +350,12 @@ int main (int argc, char *argv[])
         XCAM_ASSERT (retinex.ptr ());
         break;
     }
+    case TestHandlerRetinexBox: {
+        image_handler = create_cl_retinex_image_handler (context, CL_RETINEX_GAUSS_BOX);
+        SmartPtr<CLRetinexImageHandler> retinex = image_handler.dynamic_cast_ptr<CLRetinexImageHandler> ();
+        XCAM_ASSERT (retinex.ptr ());
+        break;
+    }
     case TestHandlerGauss: {
         image_handler = create_cl_gauss_image_handler (context);
         SmartPtr<CLGaussImageHandler> gauss = image_handler.dynamic_cast_ptr<CLGaussImageHandler> ();
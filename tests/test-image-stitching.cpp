@@ -22,15 +22,19 @@
 #include "test_common.h"
 #include <unistd.h>
 #include <getopt.h>
+#include "image_file_handle.h"
+#include "host_mem_buffer.h"
+#include "soft_image_360_stitch.h"
+
+#if HAVE_LIBCL
 #include "cl_device.h"
 #include "cl_context.h"
 #include "drm_display.h"
-#include "image_file_handle.h"
-
 #include "cl_fisheye_handler.h"
 #include "cl_image_360_stitch.h"
+#endif
 
-#if HAVE_OPENCV
+#if HAVE_LIBCL && HAVE_OPENCV
 #include "cv_feature_match.h"
 #endif
 
@@ -39,10 +43,10 @@
 
 using namespace XCam;
 
-static CLStitchInfo
+static StitchInfo
 get_stitch_initial_info ()
 {
-    CLStitchInfo stitch_info;
+    StitchInfo stitch_info;
 
     stitch_info.merge_width[0] = 56;
     stitch_info.merge_width[1] = 56;
@@ -84,10 +88,75 @@ void usage(const char* arg0)
             "\t--save        optional, save file or not, select from [true/false], default: true\n"
             "\t--scale-mode  optional, image scaling mode, select from [local/global], default: local\n"
             "\t--enable-seam optional, enable seam finder in blending area, default: no\n"
+            "\t--soft        optional, stitch on CPU, scale mode is ignored, default: no without OpenCL\n"
             "\t--help        usage\n",
             arg0);
 }
 
+static int
+run_soft_stitching (
+    const char *file_in_name, const char *file_out_name,
+    const VideoBufferInfo &input_buf_info, const VideoBufferInfo &output_buf_info,
+    int loop, bool enable_seam, bool need_save_output)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    ImageFileHandle file_in, file_out;
+    SmartPtr<BufferProxy> read_buf;
+    SmartPtr<VideoBuffer> input_buf, output_buf;
+
+    SmartPtr<SoftImage360Stitch> image_360 =
+        create_soft_image_360_stitch (enable_seam).dynamic_cast_ptr<SoftImage360Stitch> ();
+    XCAM_ASSERT (image_360.ptr ());
+    image_360->set_output_size (output_buf_info.width, output_buf_info.height);
+    image_360->init_stitch_info (get_stitch_initial_info ());
+
+    SmartPtr<BufferPool> buf_pool = new HostMemBufferPool;
+    XCAM_ASSERT (buf_pool.ptr ());
+    buf_pool->set_video_info (input_buf_info);
+    if (!buf_pool->reserve (2)) {
+        XCAM_LOG_ERROR ("init buffer pool failed");
+        return -1;
+    }
+
+    ret = file_in.open (file_in_name, "rb");
+    CHECK (ret, "open %s failed", file_in_name);
+    if (need_save_output) {
+        ret = file_out.open (file_out_name, "wb");
+        CHECK (ret, "open %s failed", file_out_name);
+    }
+
+    while (loop--) {
+        ret = file_in.rewind ();
+        CHECK (ret, "soft image_360 stitch rewind file(%s) failed", file_in_name);
+
+        do {
+            read_buf = buf_pool->get_buffer (buf_pool);
+            XCAM_ASSERT (read_buf.ptr ());
+            ret = file_in.read_buf (read_buf);
+            if (ret == XCAM_RETURN_BYPASS)
+                break;
+            if (ret == XCAM_RETURN_ERROR_FILE) {
+                XCAM_LOG_ERROR ("read buffer from %s failed", file_in_name);
+                return -1;
+            }
+
+            input_buf = read_buf;
+            ret = image_360->execute (input_buf, output_buf);
+            CHECK (ret, "soft image_360 stitch execute failed");
+
+            if (need_save_output) {
+                ret = file_out.write_buf (output_buf.dynamic_cast_ptr<BufferProxy> ());
+                CHECK (ret, "write buffer to %s failed", file_out_name);
+            }
+
+            FPS_CALCULATION (soft_image_stitching, XCAM_OBJ_DUR_FRAME_NUM);
+        } while (true);
+    }
+
+    return 0;
+}
+
+#if HAVE_LIBCL
 static void
 ensure_gpu_buffer_done (SmartPtr<BufferProxy> buf)
 {
@@ -109,9 +178,11 @@ ensure_gpu_buffer_done (SmartPtr<BufferProxy> buf)
     }
     buf->unmap ();
 }
+#endif
 
 int main (int argc, char *argv[])
 {
+#if HAVE_LIBCL
     XCamReturn ret = XCAM_RETURN_NO_ERROR;
     SmartPtr<CLContext> context;
     SmartPtr<DrmDisplay> display;
@@ -119,9 +190,14 @@ int main (int argc, char *argv[])
     SmartPtr<BufferProxy> read_buf;
     ImageFileHandle file_in, file_out;
     SmartPtr<DrmBoBuffer> input_buf, output_buf;
-    VideoBufferInfo input_buf_info, output_buf_info;
     SmartPtr<CLImageHandler> image_handler;
     SmartPtr<CLImage360Stitch> image_360;
+    CLBlenderScaleMode scale_mode = CLBlenderScaleLocal;
+    bool use_soft = false;
+#else
+    bool use_soft = true;
+#endif
+    VideoBufferInfo input_buf_info, output_buf_info;
 
     uint32_t input_format = V4L2_PIX_FMT_NV12;
     uint32_t input_width = 1920;
@@ -133,7 +209,6 @@ int main (int argc, char *argv[])
     bool enable_seam = false;
     bool enable_fisheye_map = false;
     bool need_save_output = true;
-    CLBlenderScaleMode scale_mode = CLBlenderScaleLocal;
     const char *file_in_name = NULL;
     const char *file_out_name = NULL;
 
@@ -149,6 +224,7 @@ int main (int argc, char *argv[])
         {"scale-mode", required_argument, NULL, 'c'},
         {"enable-seam", no_argument, NULL, 'S'},
         {"enable-fisheyemap", no_argument, NULL, 'F'},
+        {"soft", no_argument, NULL, 'f'},
         {"help", no_argument, NULL, 'e'},
         {NULL, 0, NULL, 0},
     };
@@ -183,6 +259,7 @@ int main (int argc, char *argv[])
             need_save_output = (strcasecmp (optarg, "false") == 0 ? false : true);
             break;
         case 'c':
+#if HAVE_LIBCL
             if (!strcasecmp (optarg, "local"))
                 scale_mode = CLBlenderScaleLocal;
             else if (!strcasecmp (optarg, "global"))
@@ -191,6 +268,7 @@ int main (int argc, char *argv[])
                 XCAM_LOG_ERROR ("incorrect scaling mode");
                 return -1;
             }
+#endif
             break;
         case 'S':
             enable_seam = true;
@@ -198,6 +276,9 @@ int main (int argc, char *argv[])
         case 'F':
             enable_fisheye_map = true;
             break;
+        case 'f':
+            use_soft = true;
+            break;
         case 'e':
             usage (argv[0]);
             return -1;
@@ -235,11 +316,24 @@ int main (int argc, char *argv[])
     printf ("output height:\t%d\n", output_height);
     printf ("loop count:\t%d\n", loop);
     printf ("save file:\t%s\n", need_save_output ? "true" : "false");
-    printf ("scale mode:\t%s\n", scale_mode == CLBlenderScaleLocal ? "local" : "global");
+#if HAVE_LIBCL
+    if (!use_soft)
+        printf ("scale mode:\t%s\n", scale_mode == CLBlenderScaleLocal ? "local" : "global");
+#endif
     printf ("seam mask:\t%s\n", enable_seam ? "true" : "false");
     printf ("fisheye map:\t%s\n", enable_fisheye_map ? "true" : "false");
+    printf ("stitch on:\t%s\n", use_soft ? "CPU" : "GPU");
     printf ("---------------------------\n");
 
+    input_buf_info.init (input_format, input_width, input_height);
+    output_buf_info.init (input_format, output_width, output_height);
+    if (use_soft)
+        return run_soft_stitching (
+                   file_in_name, file_out_name, input_buf_info, output_buf_info,
+                   loop, enable_seam, need_save_output);
+
+#if HAVE_LIBCL
+
     context = CLDevice::instance ()->get_context ();
     image_360 =
         create_image_360_stitch (
@@ -249,8 +343,6 @@ int main (int argc, char *argv[])
     CLStitchInfo stitch_info = get_stitch_initial_info ();
     image_360->init_stitch_info (stitch_info);
 
-    input_buf_info.init (input_format, input_width, input_height);
-    output_buf_info.init (input_format, output_width, output_height);
     display = DrmDisplay::instance ();
     buf_pool = new DrmBoBufferPool (display);
     XCAM_ASSERT (buf_pool.ptr ());
@@ -310,6 +402,7 @@ int main (int argc, char *argv[])
             ++i;
         } while (true);
     }
+#endif
 
     return 0;
 }
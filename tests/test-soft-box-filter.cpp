@@ -0,0 +1,119 @@
+/*
+ * test_soft_box_filter.cpp - test box filters standing in for gaussian
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "test_common.h"
+#include "soft_box_filter.h"
+#include <math.h>
+
+using namespace XCam;
+
+// odd size, wider than all radii summed and not a multiple of column lanes
+#define TEST_MAP_SIZE      161
+#define TEST_BOX_PASSES    3
+
+// variance of a box of radius r is ((2r + 1)^2 - 1) / 12
+static double
+box_variance (const uint32_t *radii, uint32_t count)
+{
+    double variance = 0.0;
+    for (uint32_t i = 0; i < count; ++i)
+        variance += radii[i] * (radii[i] + 1.0) / 3.0;
+    return variance;
+}
+
+static int
+check_radii (float sigma, uint32_t count)
+{
+    uint32_t radii[TEST_BOX_PASSES];
+    box_gauss_radii (sigma, count, radii);
+
+    // moving one box between the two widths changes the sum by (lower + 1) / 3,
+    // rounding to the nearest split stays within half of it
+    uint32_t lower = radii[0] * 2 + 1;
+    double error = fabs (box_variance (radii, count) - (double)sigma * sigma);
+    CHECK_EXP (
+        error <= (lower + 1) / 6.0 + 1e-6,
+        "box radii of sigma(%f) have variance off by %f", sigma, error);
+    return 0;
+}
+
+static int
+check_impulse (float sigma, uint32_t count)
+{
+    const uint32_t size = TEST_MAP_SIZE, center = TEST_MAP_SIZE / 2;
+    std::vector<float> map (size * size, 0.0f), tmp (size * size);
+    uint32_t radii[TEST_BOX_PASSES];
+
+    map[center * size + center] = 1.0f;
+    XCamReturn ret = soft_box_gauss_map (&map[0], &tmp[0], size, size, sigma, count);
+    CHECK (ret, "soft box gauss of sigma(%f) failed", sigma);
+
+    double sum = 0.0, var_x = 0.0, var_y = 0.0;
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            double value = map[y * size + x];
+            double dx = (double)x - center, dy = (double)y - center;
+            sum += value;
+            var_x += value * dx * dx;
+            var_y += value * dy * dy;
+        }
+    }
+
+    box_gauss_radii (sigma, count, radii);
+    double expect = box_variance (radii, count);
+    CHECK_EXP (fabs (sum - 1.0) < 1e-4, "blurred impulse of sigma(%f) sums to %f", sigma, sum);
+    CHECK_EXP (
+        fabs (var_x - expect) < 1e-3 * (expect + 1.0) && fabs (var_y - expect) < 1e-3 * (expect + 1.0),
+        "blurred impulse of sigma(%f) has variance(%f, %f), expect %f", sigma, var_x, var_y, expect);
+    return 0;
+}
+
+static int
+check_flat (float sigma, uint32_t count)
+{
+    // borders clip the window, a flat map must stay flat up to them
+    const uint32_t width = TEST_MAP_SIZE, height = 37;
+    std::vector<float> map (width * height, 0.5f), tmp (width * height);
+
+    XCamReturn ret = soft_box_gauss_map (&map[0], &tmp[0], width, height, sigma, count);
+    CHECK (ret, "soft box gauss of sigma(%f) failed", sigma);
+
+    for (uint32_t i = 0; i < width * height; ++i) {
+        CHECK_EXP (
+            fabs (map[i] - 0.5f) < 1e-5f,
+            "flat map of sigma(%f) changed to %f at (%d, %d)", sigma, map[i], i % width, i / width);
+    }
+    return 0;
+}
+
+int main ()
+{
+    const float sigmas[] = {0.5f, 1.0f, 2.5f, 4.0f, 7.3f, 12.0f, 16.0f};
+
+    for (uint32_t i = 0; i < sizeof (sigmas) / sizeof (sigmas[0]); ++i) {
+        for (uint32_t count = 1; count <= TEST_BOX_PASSES; ++count) {
+            if (check_radii (sigmas[i], count) || check_impulse (sigmas[i], count) ||
+                    check_flat (sigmas[i], count))
+                return -1;
+        }
+        printf ("PASS: box gauss sigma %.1f\n", sigmas[i]);
+    }
+    return 0;
+}
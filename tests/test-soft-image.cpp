@@ -0,0 +1,426 @@
+/*
+ * test_soft_image.cpp - test soft image handlers
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "test_common.h"
+#include <unistd.h>
+#include <getopt.h>
+#include "image_file_handle.h"
+#include "host_mem_buffer.h"
+#include "soft_simd.h"
+#include "soft_csc_handler.h"
+#include "soft_image_scaler.h"
+#include "soft_geo_map_handler.h"
+#include "soft_fisheye_handler.h"
+#include "soft_pyramid_blender.h"
+#include "soft_tnr_handler.h"
+#include "soft_defog_dcp_handler.h"
+#include "soft_retinex_handler.h"
+#include <math.h>
+
+using namespace XCam;
+
+enum TestHandlerType {
+    TestHandlerUnknown  = 0,
+    TestHandlerColorConversion,
+    TestHandlerScaler,
+    TestHandlerGeoMap,
+    TestHandlerFisheye,
+    TestHandlerBlender,
+    TestHandlerTnr,
+    TestHandlerDefog,
+    TestHandlerRetinex,
+};
+
+static XCamReturn
+kernel_loop (
+    SmartPtr<SoftImageHandler> &image_handler,
+    SmartPtr<VideoBuffer> &input_buf, SmartPtr<VideoBuffer> &output_buf,
+    uint32_t kernel_loop_count)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    for (uint32_t i = 0; i < kernel_loop_count; i++) {
+        PROFILING_START (soft_kernel);
+        output_buf.release ();
+        ret = image_handler->execute (input_buf, output_buf);
+        PROFILING_END (soft_kernel, kernel_loop_count)
+    }
+    return ret;
+}
+
+static XCamReturn
+write_scaler_bufs (SmartPtr<SoftImageScaler> &scaler, ImageFileHandle *scaler_fps)
+{
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    for (uint32_t i = 0; i < scaler->get_output_count (); ++i) {
+        SmartPtr<BufferProxy> scaler_buf = scaler->get_scaler_buf (i).dynamic_cast_ptr<BufferProxy> ();
+        XCAM_ASSERT (scaler_buf.ptr ());
+        ret = scaler_fps[i].write_buf (scaler_buf);
+        if (ret != XCAM_RETURN_NO_ERROR)
+            return ret;
+    }
+    return ret;
+}
+
+// subsampled map rotating input around its center
+static void
+generate_rotation_map (
+    GeoPos *map, uint32_t map_width, uint32_t map_height,
+    float unit, uint32_t width, uint32_t height, float degree)
+{
+    double angle = degree * M_PI / 180.0;
+    for (uint32_t y = 0; y < map_height; ++y) {
+        for (uint32_t x = 0; x < map_width; ++x) {
+            double dx = (x + 0.5 - map_width / 2.0) * unit;
+            double dy = (y + 0.5 - map_height / 2.0) * unit;
+            GeoPos &pos = map[y * map_width + x];
+            pos.x = dx * cos (angle) - dy * sin (angle) + width / 2.0 + 0.5;
+            pos.y = dx * sin (angle) + dy * cos (angle) + height / 2.0 + 0.5;
+        }
+    }
+}
+
+static uint32_t
+parse_format (const char *name)
+{
+    if (!strcasecmp (name, "nv12"))
+        return V4L2_PIX_FMT_NV12;
+    else if (!strcasecmp (name, "yuyv"))
+        return V4L2_PIX_FMT_YUYV;
+    else if (!strcasecmp (name, "rgba"))
+        return V4L2_PIX_FMT_RGBA32;
+    else if (!strcasecmp (name, "rgba64"))
+        return XCAM_PIX_FMT_RGBA64;
+    return 0;
+}
+
+static void
+print_help (const char *bin_name)
+{
+    printf ("Usage: %s [-f format] -i input -o output\n"
+            "\t -t type      specify image handler type\n"
+            "\t              select from [csc, scaler, geomap, fisheye, blend, tnr, defog, retinex]\n"
+            "\t -f input_format    specify a input format\n"
+            "\t              select from [NV12, YUYV, RGBA, RGBA64]\n"
+            "\t -W image width     specify input image width\n"
+            "\t -H image height    specify input image height\n"
+            "\t -i input     specify input file path\n"
+            "\t -o output    specify output file path\n"
+            "\t -p count     specify soft kernel loop count\n"
+            "\t -c csc_type  specify csc type, default:rgbatonv12\n"
+            "\t              select from [rgbatonv12, rgbatolab, rgba64torgba, yuyvtorgba, nv12torgba]\n"
+            "\t -s mode      specify scaler mode, outputs 1/2, 1/4, 1/8 to output.0-2\n"
+            "\t              select from [bilinear, area, lanczos], default:bilinear\n"
+            "\t -r degree    specify geomap rotation of 16x16 subsampled map, default:5.0\n"
+            "\t -d dir       specify fisheye table directory, tables are loaded or saved there\n"
+            "\t -l layers    specify pyramid blender layers, default:2\n"
+            "\t              blend takes frames in pairs, output is 3/2 of input width\n"
+            "\t -S           enable seam cut of pyramid blender\n"
+            "\t -n count     specify tnr frame count of RGBA input, select from [2, 3, 4], default:4\n"
+            "\t              tnr runs yuv mode on NV12 input, rgb mode on RGBA input\n"
+            "\t              defog and retinex only run on NV12 input\n"
+            "\t -h           help\n"
+            "\t env XCAM_SOFT_SIMD=[none|sse4.1|avx2|neon] limits simd level, level used is printed\n"
+            , bin_name);
+}
+
+int main (int argc, char *argv[])
+{
+    uint32_t input_format = 0;
+    uint32_t width = 1920;
+    uint32_t height = 1080;
+    uint32_t buf_count = 0;
+    int32_t kernel_loop_count = 0;
+    const char *input_file = NULL, *output_file = NULL;
+    ImageFileHandle input_fp, output_fp;
+    const char *bin_name = argv[0];
+    TestHandlerType handler_type = TestHandlerUnknown;
+    XCamReturn ret = XCAM_RETURN_NO_ERROR;
+    SmartPtr<SoftImageHandler> image_handler;
+    VideoBufferInfo input_buf_info;
+    SmartPtr<BufferPool> buf_pool;
+    int opt = 0;
+    SoftCscType csc_type = SOFT_CSC_TYPE_RGBATONV12;
+    SoftScalerMode scaler_mode = SOFT_SCALER_BILINEAR;
+    const double scaler_factors[] = {0.5, 0.25, 0.125};
+    const uint32_t scaler_count = sizeof (scaler_factors) / sizeof (scaler_factors[0]);
+    SmartPtr<SoftImageScaler> scaler;
+    ImageFileHandle scaler_fps[scaler_count];
+    float geo_degree = 5.0f;
+    const float geo_unit = 16.0f;
+    const char *table_dir = NULL;
+    uint32_t blend_layers = 2;
+    bool blend_seam = false;
+    uint32_t tnr_frame_count = XCAM_SOFT_TNR_DEFAULT_FRAMES;
+
+    while ((opt =  getopt(argc, argv, "f:W:H:i:o:t:p:c:s:r:d:l:Sn:h")) != -1) {
+        switch (opt) {
+        case 'i':
+            input_file = optarg;
+            break;
+        case 'o':
+            output_file = optarg;
+            break;
+        case 'f':
+            input_format = parse_format (optarg);
+            if (!input_format)
+                print_help (bin_name);
+            break;
+        case 'W':
+            width = atoi (optarg);
+            break;
+        case 'H':
+            height = atoi (optarg);
+            break;
+        case 't':
+            if (!strcasecmp (optarg, "csc"))
+                handler_type = TestHandlerColorConversion;
+            else if (!strcasecmp (optarg, "scaler"))
+                handler_type = TestHandlerScaler;
+            else if (!strcasecmp (optarg, "geomap"))
+                handler_type = TestHandlerGeoMap;
+            else if (!strcasecmp (optarg, "fisheye"))
+                handler_type = TestHandlerFisheye;
+            else if (!strcasecmp (optarg, "blend"))
+                handler_type = TestHandlerBlender;
+            else if (!strcasecmp (optarg, "tnr"))
+                handler_type = TestHandlerTnr;
+            else if (!strcasecmp (optarg, "defog"))
+                handler_type = TestHandlerDefog;
+            else if (!strcasecmp (optarg, "retinex"))
+                handler_type = TestHandlerRetinex;
+            else
+                print_help (bin_name);
+            break;
+        case 'p':
+            kernel_loop_count = atoi (optarg);
+            XCAM_ASSERT (kernel_loop_count >= 0 && kernel_loop_count < INT32_MAX);
+            break;
+        case 'c':
+            if (!strcasecmp (optarg, "rgbatonv12"))
+                csc_type = SOFT_CSC_TYPE_RGBATONV12;
+            else if (!strcasecmp (optarg, "rgbatolab"))
+                csc_type = SOFT_CSC_TYPE_RGBATOLAB;
+            else if (!strcasecmp (optarg, "rgba64torgba"))
+                csc_type = SOFT_CSC_TYPE_RGBA64TORGBA;
+            else if (!strcasecmp (optarg, "yuyvtorgba"))
+                csc_type = SOFT_CSC_TYPE_YUYVTORGBA;
+            else if (!strcasecmp (optarg, "nv12torgba"))
+                csc_type = SOFT_CSC_TYPE_NV12TORGBA;
+            else
+                print_help (bin_name);
+            break;
+        case 's':
+            if (!strcasecmp (optarg, "bilinear"))
+                scaler_mode = SOFT_SCALER_BILINEAR;
+            else if (!strcasecmp (optarg, "area"))
+                scaler_mode = SOFT_SCALER_AREA;
+            else if (!strcasecmp (optarg, "lanczos"))
+                scaler_mode = SOFT_SCALER_LANCZOS;
+            else
+                print_help (bin_name);
+            break;
+        case 'r':
+            geo_degree = atof (optarg);
+            break;
+        case 'd':
+            table_dir = optarg;
+            break;
+        case 'l':
+            blend_layers = atoi (optarg);
+            break;
+        case 'S':
+            blend_seam = true;
+            break;
+        case 'n':
+            tnr_frame_count = atoi (optarg);
+            break;
+        case 'h':
+            print_help (bin_name);
+            return 0;
+
+        default:
+            print_help (bin_name);
+            return -1;
+        }
+    }
+
+    if (!input_format || !input_file || !output_file || handler_type == TestHandlerUnknown) {
+        print_help (bin_name);
+        return -1;
+    }
+
+    ret = input_fp.open (input_file, "rb");
+    CHECK (ret, "open input file(%s) failed", XCAM_STR (input_file));
+    ret = output_fp.open (output_file, "wb");
+    CHECK (ret, "open output file(%s) failed", XCAM_STR (output_file));
+
+    // level actually used, XCAM_SOFT_SIMD falls back on levels the host lacks
+    printf ("soft simd level: %s\n", soft_simd_level_name (soft_simd_level ()));
+
+    switch (handler_type) {
+    case TestHandlerColorConversion:
+        image_handler = create_soft_csc_image_handler (csc_type);
+        break;
+    case TestHandlerScaler:
+        image_handler = create_soft_image_scaler_handler (input_format);
+        scaler = image_handler.dynamic_cast_ptr<SoftImageScaler> ();
+        if (!scaler.ptr ())
+            break;
+        scaler->set_scaler_mode (scaler_mode);
+        scaler->set_scaler_factors (scaler_factors, scaler_count);
+        for (uint32_t i = 0; i < scaler_count; ++i) {
+            char scaler_file[XCAM_MAX_STR_SIZE];
+            snprintf (scaler_file, sizeof (scaler_file), "%s.%d", output_file, i);
+            ret = scaler_fps[i].open (scaler_file, "wb");
+            CHECK (ret, "open scaler output file(%s) failed", scaler_file);
+        }
+        break;
+    case TestHandlerGeoMap: {
+        image_handler = create_soft_geo_map_handler ();
+        SmartPtr<SoftGeoMapHandler> geo_handler = image_handler.dynamic_cast_ptr<SoftGeoMapHandler> ();
+        XCAM_ASSERT (geo_handler.ptr ());
+        uint32_t map_width = XCAM_ALIGN_UP (width, (uint32_t)geo_unit) / (uint32_t)geo_unit;
+        uint32_t map_height = XCAM_ALIGN_UP (height, (uint32_t)geo_unit) / (uint32_t)geo_unit;
+        std::vector<GeoPos> geo_map (map_width * map_height);
+        generate_rotation_map (&geo_map[0], map_width, map_height, geo_unit, width, height, geo_degree);
+        geo_handler->set_map_data (&geo_map[0], map_width, map_height);
+        geo_handler->set_map_uint (geo_unit, geo_unit);
+        break;
+    }
+    case TestHandlerFisheye: {
+        // 180 degree lens filling the input, unwrapped to the same size
+        image_handler = create_soft_fisheye_handler ();
+        SmartPtr<SoftFisheyeHandler> fisheye = image_handler.dynamic_cast_ptr<SoftFisheyeHandler> ();
+        XCAM_ASSERT (fisheye.ptr ());
+        FisheyeInfo info;
+        info.center_x = width / 2.0f;
+        info.center_y = height / 2.0f;
+        info.radius = XCAM_MIN (width, height) / 2.0f;
+        info.wide_angle = 180.0f;
+        fisheye->set_fisheye_info (info);
+        fisheye->set_dst_range (180.0f, 180.0f);
+        fisheye->set_output_size (width, height);
+        fisheye->set_table_dir (table_dir);
+        break;
+    }
+    case TestHandlerBlender: {
+        image_handler = create_soft_pyramid_blender (blend_layers, blend_seam);
+        SmartPtr<SoftBlender> blender = image_handler.dynamic_cast_ptr<SoftBlender> ();
+        if (blender.ptr ())
+            blender->set_output_size (XCAM_ALIGN_UP (width * 3 / 2, 8), height);
+        break;
+    }
+    case TestHandlerTnr: {
+        SoftTnrType tnr_type = (input_format == V4L2_PIX_FMT_RGBA32) ? SOFT_TNR_TYPE_RGB : SOFT_TNR_TYPE_YUV;
+        image_handler = create_soft_tnr_image_handler (tnr_type);
+        SmartPtr<SoftTnrImageHandler> tnr = image_handler.dynamic_cast_ptr<SoftTnrImageHandler> ();
+        XCAM_ASSERT (tnr.ptr ());
+        if (!tnr->set_framecount (tnr_frame_count))
+            return -1;
+        if (tnr_type == SOFT_TNR_TYPE_YUV) {
+            // default gain of 1.0 keeps current frame, use a denoising one
+            XCam3aResultTemporalNoiseReduction config;
+            xcam_mem_clear (config);
+            config.gain = 0.5;
+            config.threshold[0] = 0.05;
+            config.threshold[1] = 0.05;
+            tnr->set_yuv_config (config);
+        }
+        break;
+    }
+    case TestHandlerDefog:
+        image_handler = create_soft_defog_dcp_image_handler ();
+        break;
+    case TestHandlerRetinex:
+        image_handler = create_soft_retinex_image_handler ();
+        break;
+    default:
+        XCAM_LOG_ERROR ("unsupported image handler type:%d", handler_type);
+        return -1;
+    }
+    if (!image_handler.ptr ()) {
+        XCAM_LOG_ERROR ("create image_handler failed");
+        return -1;
+    }
+
+    input_buf_info.init (input_format, width, height);
+    buf_pool = new HostMemBufferPool ();
+    XCAM_ASSERT (buf_pool.ptr ());
+    buf_pool->set_video_info (input_buf_info);
+    if (!buf_pool->reserve (6)) {
+        XCAM_LOG_ERROR ("init buffer pool failed");
+        return -1;
+    }
+
+    while (true) {
+        SmartPtr<VideoBuffer> input_buf, output_buf;
+        SmartPtr<BufferProxy> tmp_buf = buf_pool->get_buffer (buf_pool);
+        XCAM_ASSERT (tmp_buf.ptr ());
+
+        ret = input_fp.read_buf (tmp_buf);
+        if (ret == XCAM_RETURN_BYPASS)
+            break;
+        if (ret == XCAM_RETURN_ERROR_FILE) {
+            XCAM_LOG_ERROR ("read buffer from %s failed", XCAM_STR (input_file));
+            return -1;
+        }
+        input_buf = tmp_buf;
+
+        if (handler_type == TestHandlerBlender) {
+            // next frame is the right image
+            SmartPtr<BufferProxy> next_buf = buf_pool->get_buffer (buf_pool);
+            XCAM_ASSERT (next_buf.ptr ());
+            ret = input_fp.read_buf (next_buf);
+            if (ret == XCAM_RETURN_BYPASS)
+                break;
+            if (ret == XCAM_RETURN_ERROR_FILE) {
+                XCAM_LOG_ERROR ("read buffer from %s failed", XCAM_STR (input_file));
+                return -1;
+            }
+            tmp_buf->attach_buffer (next_buf);
+        }
+
+        if (kernel_loop_count != 0) {
+            ret = kernel_loop (image_handler, input_buf, output_buf, kernel_loop_count);
+            CHECK (ret, "execute kernels failed");
+            return 0;
+        }
+
+        ret = image_handler->execute (input_buf, output_buf);
+        CHECK_EXP ((ret == XCAM_RETURN_NO_ERROR || ret == XCAM_RETURN_BYPASS), "execute kernels failed");
+        if (ret == XCAM_RETURN_BYPASS)
+            continue;
+
+        if (scaler.ptr ()) {
+            ret = write_scaler_bufs (scaler, scaler_fps);
+            CHECK (ret, "write scaler buffers of %s failed", XCAM_STR (output_file));
+        }
+
+        SmartPtr<BufferProxy> output_proxy = output_buf.dynamic_cast_ptr<BufferProxy> ();
+        XCAM_ASSERT (output_proxy.ptr ());
+        ret = output_fp.write_buf (output_proxy);
+        CHECK (ret, "write buffer to %s failed", XCAM_STR (output_file));
+
+        ++buf_count;
+    }
+
+    XCAM_LOG_INFO ("processed %d buffers successfully", buf_count);
+    return 0;
+}
@@ -0,0 +1,265 @@
+#!/bin/sh
+#
+# run soft handlers on random input with each simd level,
+# every level must give the same output as plain c (XCAM_SOFT_SIMD=none).
+# known answer cases check flat frames against outputs worked out by hand,
+# on every level too. levels the host lacks are skipped.
+#
+
+TEST_BIN=./test-soft-image
+WIDTH=640
+HEIGHT=480
+LEVELS="sse4.1 avx2 neon"
+
+WORK_DIR=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# four frames of the biggest format, RGBA
+INPUT="$WORK_DIR/input"
+head -c $((WIDTH * HEIGHT * 4 * 4)) /dev/urandom > "$INPUT" || exit 1
+
+failed=0
+
+# $1 level, $2 output, rest passed to test binary
+# returns 1 on failure, 2 if the binary fell back to another level
+run_level ()
+{
+    level=$1
+    out=$2
+    shift 2
+
+    XCAM_SOFT_SIMD=$level $TEST_BIN -W $WIDTH -H $HEIGHT -o "$out" -d "$WORK_DIR" "$@" \
+        > "$WORK_DIR/log" 2>&1 || return 1
+    used=$(sed -n 's/^soft simd level: //p' "$WORK_DIR/log")
+    [ "$used" = "$level" ] || return 2
+    return 0
+}
+
+# $1 case name, $2 reference prefix, $3 output prefix
+# every reference file needs an equal output file
+compare_outputs ()
+{
+    same=0
+    for ref in "$2"*; do
+        out="$3${ref#$2}"
+        if ! cmp -s "$ref" "$out"; then
+            echo "FAIL: $1, ${out#$WORK_DIR/} differs from ${ref#$WORK_DIR/}"
+            same=1
+        fi
+    done
+    return $same
+}
+
+# $1 case name, $2 handler type, $3 format, rest passed to test binary
+run_case ()
+{
+    name=$1
+    type=$2
+    format=$3
+    shift 3
+    case_failed=0
+
+    run_level none "$WORK_DIR/$name.none" -t $type -f $format -i "$INPUT" "$@"
+    if [ $? -ne 0 ]; then
+        echo "FAIL: $name, none"
+        failed=1
+        return
+    fi
+
+    for level in $LEVELS; do
+        run_level $level "$WORK_DIR/$name.$level" -t $type -f $format -i "$INPUT" "$@"
+        case $? in
+        0)
+            compare_outputs "$name, $level" "$WORK_DIR/$name.none" "$WORK_DIR/$name.$level" ||
+                case_failed=1
+            ;;
+        2)
+            echo "SKIP: $name, $level (host runs $used)"
+            ;;
+        *)
+            echo "FAIL: $name, $level"
+            case_failed=1
+            ;;
+        esac
+    done
+
+    if [ $case_failed -ne 0 ]; then
+        failed=1
+    else
+        echo "PASS: $name"
+    fi
+}
+
+# $1 case name, $2 expected output prefix, $3 handler type, $4 format,
+# $5 input, rest passed to test binary
+run_known ()
+{
+    name=$1
+    expected=$2
+    type=$3
+    format=$4
+    input=$5
+    shift 5
+    case_failed=0
+
+    for level in none $LEVELS; do
+        run_level $level "$WORK_DIR/$name.$level" -t $type -f $format -i "$input" "$@"
+        case $? in
+        0)
+            compare_outputs "$name, $level" "$expected" "$WORK_DIR/$name.$level" ||
+                case_failed=1
+            ;;
+        2)
+            echo "SKIP: $name, $level (host runs $used)"
+            ;;
+        *)
+            echo "FAIL: $name, $level"
+            case_failed=1
+            ;;
+        esac
+    done
+
+    if [ $case_failed -ne 0 ]; then
+        failed=1
+    else
+        echo "PASS: $name"
+    fi
+}
+
+# $1 case name, $2 handler type, $3 flat NV12 input, rest passed to test binary
+# output must stay flat, with any value
+run_flat ()
+{
+    name=$1
+    type=$2
+    input=$3
+    shift 3
+    case_failed=0
+
+    for level in none $LEVELS; do
+        out="$WORK_DIR/$name.$level"
+        run_level $level "$out" -t $type -f NV12 -i "$input" "$@"
+        case $? in
+        0)
+            flat_y=$(od -An -tu1 -N1 "$out")
+            flat_uv=$(od -An -tu1 -N2 -j $((WIDTH * HEIGHT)) "$out")
+            flat_nv12 "$WORK_DIR/$name.flat" $WIDTH $HEIGHT $flat_y $flat_uv 4
+            if ! cmp -s "$WORK_DIR/$name.flat" "$out"; then
+                echo "FAIL: $name, $level output is not flat"
+                case_failed=1
+            fi
+            ;;
+        2)
+            echo "SKIP: $name, $level (host runs $used)"
+            ;;
+        *)
+            echo "FAIL: $name, $level"
+            case_failed=1
+            ;;
+        esac
+    done
+
+    if [ $case_failed -ne 0 ]; then
+        failed=1
+    else
+        echo "PASS: $name"
+    fi
+}
+
+# $1 octal escapes of a byte pattern, $2 byte count, repeated to stdout
+repeat_pattern ()
+{
+    unit="$WORK_DIR/unit"
+    printf "$1" > "$unit"
+    while [ $(wc -c < "$unit") -lt $2 ]; do
+        cat "$unit" "$unit" > "$unit.2" && mv "$unit.2" "$unit"
+    done
+    head -c $2 "$unit"
+}
+
+# bytes as octal escapes for repeat_pattern
+octal ()
+{
+    for byte in "$@"; do
+        printf '\\%03o' $byte
+    done
+}
+
+# $1 file, $2 width, $3 height, $4 $5 $6 Y U V, $7 frame count
+flat_nv12 ()
+{
+    : > "$1"
+    i=0
+    while [ $i -lt $7 ]; do
+        repeat_pattern "$(octal $4)" $(($2 * $3)) >> "$1"
+        repeat_pattern "$(octal $5 $6)" $(($2 * $3 / 2)) >> "$1"
+        i=$((i + 1))
+    done
+}
+
+# $1 file, $2 width, $3 height, $4 frame count, rest bytes of one pixel
+flat_pixels ()
+{
+    file=$1
+    bytes=$(($2 * $3 * $4 * ($# - 4)))
+    shift 4
+    repeat_pattern "$(octal "$@")" $bytes > "$file"
+}
+
+run_case csc-rgbatonv12 csc RGBA -c rgbatonv12
+run_case csc-rgbatolab csc RGBA -c rgbatolab
+run_case csc-yuyvtorgba csc YUYV -c yuyvtorgba
+run_case csc-nv12torgba csc NV12 -c nv12torgba
+run_case csc-rgba64torgba csc RGBA64 -c rgba64torgba
+run_case scaler-bilinear scaler NV12 -s bilinear
+run_case scaler-area scaler NV12 -s area
+run_case scaler-lanczos scaler NV12 -s lanczos
+run_case geomap geomap NV12
+run_case fisheye fisheye NV12
+run_case blend blend NV12
+run_case tnr-yuv tnr NV12
+run_case tnr-rgb tnr RGBA
+run_case defog defog NV12
+run_case retinex retinex NV12
+
+# weights of every filter sum to one, flat frames keep their value
+FLAT="$WORK_DIR/flat.nv12"
+flat_nv12 "$FLAT" $WIDTH $HEIGHT 100 60 200 4
+cp "$FLAT" "$WORK_DIR/scaler.expected"
+flat_nv12 "$WORK_DIR/scaler.expected.0" $((WIDTH / 2)) $((HEIGHT / 2)) 100 60 200 4
+flat_nv12 "$WORK_DIR/scaler.expected.1" $((WIDTH / 4)) $((HEIGHT / 4)) 100 60 200 4
+flat_nv12 "$WORK_DIR/scaler.expected.2" $((WIDTH / 8)) $((HEIGHT / 8)) 100 60 200 4
+for mode in bilinear area lanczos; do
+    run_known known-scaler-$mode "$WORK_DIR/scaler.expected" scaler NV12 "$FLAT" -s $mode
+done
+run_known known-geomap "$FLAT" geomap NV12 "$FLAT"
+run_known known-fisheye "$FLAT" fisheye NV12 "$FLAT"
+# frames blend in pairs into 3/2 width
+flat_nv12 "$WORK_DIR/blend.expected" $((WIDTH * 3 / 2)) $HEIGHT 100 60 200 2
+run_known known-blend "$WORK_DIR/blend.expected" blend NV12 "$FLAT"
+# no motion and no noise, nothing to filter
+run_known known-tnr-yuv "$FLAT" tnr NV12 "$FLAT"
+flat_pixels "$WORK_DIR/flat.rgba" $WIDTH $HEIGHT 4 80 160 40 255
+run_known known-tnr-rgb "$WORK_DIR/flat.rgba" tnr RGBA "$WORK_DIR/flat.rgba"
+# illumination estimated by gaussians is flat too, so is the log ratio
+run_flat flat-retinex retinex "$FLAT"
+# dark channel 86 from min (r, g, b), airlight held at its floor 128,
+# t = 1 - 0.95 * 86 / 128, Y' = 128 + (Y - 128) / t, UV' = 128 + (UV - 128) / t
+flat_nv12 "$WORK_DIR/defog.in" $WIDTH $HEIGHT 100 120 136 4
+flat_nv12 "$WORK_DIR/defog.out" $WIDTH $HEIGHT 51 106 150 4
+run_known known-defog "$WORK_DIR/defog.out" defog NV12 "$WORK_DIR/defog.in"
+
+# bt.601 full range, U V offset by 128, alpha dropped to 0 on yuv to rgba
+flat_pixels "$WORK_DIR/bt601.rgba" $WIDTH $HEIGHT 4 80 160 40 255
+flat_nv12 "$WORK_DIR/bt601.nv12" $WIDTH $HEIGHT 122 87 91 4
+flat_pixels "$WORK_DIR/bt601.yuyv" $((WIDTH / 2)) $HEIGHT 4 122 87 122 91
+flat_pixels "$WORK_DIR/bt601.out" $WIDTH $HEIGHT 4 80 160 39 0
+run_known known-csc-rgbatonv12 "$WORK_DIR/bt601.nv12" csc RGBA "$WORK_DIR/bt601.rgba" -c rgbatonv12
+run_known known-csc-nv12torgba "$WORK_DIR/bt601.out" csc NV12 "$WORK_DIR/bt601.nv12" -c nv12torgba
+run_known known-csc-yuyvtorgba "$WORK_DIR/bt601.out" csc YUYV "$WORK_DIR/bt601.yuyv" -c yuyvtorgba
+# 16 bits little endian, v * 255 / 65535 rounded
+flat_pixels "$WORK_DIR/rgba64.in" $WIDTH $HEIGHT 2 255 255 128 128 0 0 52 18
+flat_pixels "$WORK_DIR/rgba64.out" $WIDTH $HEIGHT 2 255 128 0 18
+run_known known-csc-rgba64torgba "$WORK_DIR/rgba64.out" csc RGBA64 "$WORK_DIR/rgba64.in" -c rgba64torgba
+
+exit $failed
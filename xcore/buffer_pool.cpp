@@ -23,6 +23,43 @@
 
 namespace XCam {
 
+BufferData::BufferData ()
+    : _cache_generation (0)
+{
+}
+
+SmartPtr<BufferDataCache>
+BufferData::get_cache ()
+{
+    SmartLock lock (_cache_mutex);
+    return _cache;
+}
+
+SmartPtr<BufferDataCache>
+BufferData::bind_cache (const SmartPtr<BufferDataCache> &cache)
+{
+    SmartLock lock (_cache_mutex);
+    if (!_cache.ptr ())
+        _cache = cache;
+    return _cache;
+}
+
+void
+BufferData::validate_cache (uint32_t generation)
+{
+    SmartPtr<BufferDataCache> stale;
+    {
+        SmartLock lock (_cache_mutex);
+        if (generation == _cache_generation)
+            return;
+        _cache_generation = generation;
+        stale = _cache;
+        _cache.release ();
+    }
+    // cached objects are released out of the lock
+    stale.release ();
+}
+
 BufferProxy::BufferProxy (const VideoBufferInfo &info, const SmartPtr<BufferData> &data)
     : VideoBuffer (info)
     , _data (data)
@@ -68,9 +105,25 @@ BufferProxy::get_fd ()
     return _data->get_fd ();
 }
 
+SmartPtr<BufferDataCache>
+BufferProxy::get_data_cache ()
+{
+    XCAM_ASSERT (_data.ptr ());
+    return _data->get_cache ();
+}
+
+SmartPtr<BufferDataCache>
+BufferProxy::bind_data_cache (const SmartPtr<BufferDataCache> &cache)
+{
+    XCAM_ASSERT (_data.ptr ());
+    return _data->bind_cache (cache);
+}
+
 bool
 BufferProxy::attach_buffer (const SmartPtr<VideoBuffer>& buf)
 {
+    // attached results belong to this frame
+    buf->copy_stage_times (*this);
     _attached_bufs.push_back (buf);
     return true;
 }
@@ -94,6 +147,7 @@ BufferProxy::detach_buffer (const SmartPtr<VideoBuffer>& buf)
 bool
 BufferProxy::copy_attaches (const SmartPtr<BufferProxy>& buf)
 {
+    copy_stage_times (*buf.ptr ());
     _attached_bufs.insert (
         _attached_bufs.end (), buf->_attached_bufs.begin (), buf->_attached_bufs.end ());
     return true;
@@ -106,14 +160,72 @@ BufferProxy::clear_attached_buffers ()
 }
 
 BufferPool::BufferPool ()
-    : _allocated_num (0)
+    : _name (NULL)
+    , _allocated_num (0)
     , _max_count (0)
     , _started (false)
+    , _cache_generation (0)
 {
 }
 
 BufferPool::~BufferPool ()
 {
+    if (_metrics.ptr ())
+        MetricsRegistry::instance ()->unregister_group (_metrics);
+    if (_name)
+        xcam_free (_name);
+}
+
+bool
+BufferPool::set_name (const char *name)
+{
+    SmartLock lock (_mutex);
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        name && !_metrics.ptr (),
+        false,
+        "BufferPool set name failed, must be set before reserve");
+
+    if (_name)
+        xcam_free (_name);
+    _name = strndup (name, XCAM_MAX_STR_SIZE);
+    return true;
+}
+
+// group named once data is added, video info is known by then
+void
+BufferPool::register_metrics_unsafe ()
+{
+    char default_name[64];
+
+    if (_metrics.ptr ())
+        return;
+
+    if (!_name) {
+        uint32_t format = _buffer_info.format;
+        snprintf (
+            default_name, sizeof (default_name), "%c%c%c%c_%dx%d",
+            (char)(format & 0xff), (char)((format >> 8) & 0xff),
+            (char)((format >> 16) & 0xff), (char)((format >> 24) & 0xff),
+            _buffer_info.width, _buffer_info.height);
+    }
+
+    _metrics = MetricsRegistry::instance ()->register_group ("buffer_pool", _name ? _name : default_name);
+    _in_use_gauge = _metrics->get_gauge ("in_use");
+    _capacity_gauge = _metrics->get_gauge ("capacity");
+    _get_failed_counter = _metrics->get_counter ("get_failed");
+}
+
+void
+BufferPool::update_metrics ()
+{
+    if (!MetricsRegistry::is_enabled () || !_metrics.ptr ())
+        return;
+
+    int64_t capacity = _allocated_num;
+    _capacity_gauge->set (capacity);
+    _in_use_gauge->set (capacity - (int64_t)_buf_list.size ());
 }
 
 bool
@@ -135,6 +247,7 @@ void
 BufferPool::update_video_info_unsafe (const VideoBufferInfo &info)
 {
     _buffer_info = info;
+    ++_cache_generation;
 }
 
 bool
@@ -146,6 +259,14 @@ BufferPool::reserve (uint32_t max_count)
 
     SmartLock lock (_mutex);
 
+    XCAM_FAIL_RETURN (
+        ERROR,
+        _buf_list.ensure_capacity (max_count),
+        false,
+        "BufferPool reserve failed to hold %d buffers", max_count);
+
+    register_metrics_unsafe ();
+
     for (i = _allocated_num; i < max_count; ++i) {
         SmartPtr<BufferData> new_data = allocate_data (_buffer_info);
         if (!new_data.ptr ())
@@ -165,6 +286,7 @@ BufferPool::reserve (uint32_t max_count)
     _max_count = i;
     _allocated_num = _max_count;
     _started = true;
+    update_metrics ();
 
     return true;
 }
@@ -175,8 +297,12 @@ BufferPool::add_data_unsafe (SmartPtr<BufferData> data)
     if (!data.ptr ())
         return false;
 
+    if (!_buf_list.ensure_capacity (_allocated_num + 1))
+        return false;
+    register_metrics_unsafe ();
     _buf_list.push (data);
     ++_allocated_num;
+    update_metrics ();
 
     XCAM_ASSERT (_allocated_num <= _max_count || !_max_count);
     return true;
@@ -187,11 +313,13 @@ BufferPool::get_buffer (const SmartPtr<BufferPool> &self)
 {
     SmartPtr<BufferProxy> ret_buf;
     SmartPtr<BufferData> data;
+    uint32_t cache_generation = 0;
 
     {
         SmartLock lock (_mutex);
         if (!_started)
             return NULL;
+        cache_generation = _cache_generation;
     }
 
     XCAM_ASSERT (self.ptr () == this);
@@ -203,9 +331,13 @@ BufferPool::get_buffer (const SmartPtr<BufferPool> &self)
 
     data = _buf_list.pop ();
     if (!data.ptr ()) {
+        if (MetricsRegistry::is_enabled () && _get_failed_counter.ptr ())
+            _get_failed_counter->add ();
         XCAM_LOG_DEBUG ("BufferPool failed to get buffer");
         return NULL;
     }
+    update_metrics ();
+    data->validate_cache (cache_generation);
     ret_buf = create_buffer_from_data (data);
     ret_buf->set_buf_pool (self);
 
@@ -218,6 +350,7 @@ BufferPool::stop ()
     {
         SmartLock lock (_mutex);
         _started = false;
+        ++_cache_generation;
     }
     _buf_list.pause_pop ();
 }
@@ -231,6 +364,7 @@ BufferPool::release (SmartPtr<BufferData> &data)
             return;
     }
     _buf_list.push (data);
+    update_metrics ();
 }
 
 bool
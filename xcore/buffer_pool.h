@@ -24,15 +24,32 @@
 #include "xcam_utils.h"
 #include "smartptr.h"
 #include "safe_list.h"
+#include "safe_ring.h"
 #include "video_buffer.h"
+#include "xcam_metrics.h"
+#include "xcam_mutex.h"
 
 namespace XCam {
 
 class BufferPool;
 
+/*
+ * objects bound to one BufferData, e.g. CL images imported from a bo.
+ * they live as long as the data, unless the pool of the data is
+ * stopped or changes video info, see BufferPool::get_buffer.
+ */
+class BufferDataCache {
+public:
+    explicit BufferDataCache () {}
+    virtual ~BufferDataCache () {}
+
+private:
+    XCAM_DEAD_COPY (BufferDataCache);
+};
+
 class BufferData {
 public:
-    explicit BufferData () {}
+    explicit BufferData ();
     virtual ~BufferData () {}
 
     virtual uint8_t *map () = 0;
@@ -41,8 +58,19 @@ public:
         return -1;
     }
 
+    SmartPtr<BufferDataCache> get_cache ();
+    // keeps an existing cache, returns the cache in use
+    SmartPtr<BufferDataCache> bind_cache (const SmartPtr<BufferDataCache> &cache);
+    // drops the cache bound in another @generation of the pool
+    void validate_cache (uint32_t generation);
+
 private:
     XCAM_DEAD_COPY (BufferData);
+
+private:
+    Mutex                      _cache_mutex;
+    SmartPtr<BufferDataCache>  _cache;
+    uint32_t                   _cache_generation;
 };
 
 class BufferProxy
@@ -59,12 +87,20 @@ public:
     void set_buf_pool (const SmartPtr<BufferPool> &pool) {
         _pool = pool;
     }
+    // data owned by a pool, kept alive after this buffer is released
+    bool is_pool_buffer () const {
+        return _pool.ptr () != NULL;
+    }
 
     // derived from VideoBuffer
     virtual uint8_t *map ();
     virtual bool unmap ();
     virtual int get_fd();
 
+    // cache of the underlying data, see BufferDataCache
+    SmartPtr<BufferDataCache> get_data_cache ();
+    SmartPtr<BufferDataCache> bind_data_cache (const SmartPtr<BufferDataCache> &cache);
+
     bool attach_buffer (const SmartPtr<VideoBuffer>& buf);
     bool detach_buffer (const SmartPtr<VideoBuffer>& buf);
     bool copy_attaches (const SmartPtr<BufferProxy>& buf);
@@ -110,6 +146,8 @@ public:
     explicit BufferPool ();
     virtual ~BufferPool ();
 
+    // metrics group name, set before reserve; default is format and size
+    bool set_name (const char *name);
     bool set_video_info (const VideoBufferInfo &info);
     bool reserve (uint32_t max_count = 4);
     SmartPtr<BufferProxy> get_buffer (const SmartPtr<BufferPool> &self);
@@ -139,15 +177,25 @@ protected:
 
 private:
     void release (SmartPtr<BufferData> &data);
+    void register_metrics_unsafe ();
+    void update_metrics ();
     XCAM_DEAD_COPY (BufferPool);
 
 private:
     Mutex                    _mutex;
+    char                    *_name;
     VideoBufferInfo          _buffer_info;
-    SafeList<BufferData>     _buf_list;
+    SafeRing<BufferData>     _buf_list;
     uint32_t                 _allocated_num;
     uint32_t                 _max_count;
     bool                     _started;
+    // bumped on stop and video info change, stale data caches are dropped
+    uint32_t                 _cache_generation;
+
+    SmartPtr<MetricsGroup>   _metrics;
+    SmartPtr<MetricGauge>    _in_use_gauge;
+    SmartPtr<MetricGauge>    _capacity_gauge;
+    SmartPtr<MetricCounter>  _get_failed_counter;
 };
 
 XCamVideoBuffer *convert_to_external_buffer (SmartPtr<BufferProxy> &buf);
@@ -23,6 +23,7 @@
 #include "xcam_thread.h"
 #include "x3a_image_process_center.h"
 #include "x3a_analyzer_manager.h"
+#include "xcam_trace.h"
 
 #define XCAM_FAILED_STOP(exp, msg, ...)                 \
     if ((exp) != XCAM_RETURN_NO_ERROR) {                \
@@ -78,6 +79,7 @@ DeviceManager::DeviceManager()
     , _is_running (false)
 {
     _3a_process_center = new X3aImageProcessCenter;
+    _latency_stats = new FrameLatencyStats ("device_manager");
     XCAM_LOG_DEBUG ("~DeviceManager construction");
 }
 
@@ -349,6 +351,11 @@ void
 DeviceManager::process_buffer_done (ImageProcessor *processor, const SmartPtr<VideoBuffer> &buf)
 {
     ImageProcessCallback::process_buffer_done (processor, buf);
+
+    buf->mark_stage (FrameStageOutput);
+    _latency_stats->record (*buf.ptr ());
+
+    TraceSpan span ("device_manager", "handle_buffer", buf->get_timestamp (), -1);
     handle_buffer (buf);
 }
 
@@ -368,7 +375,8 @@ void
 DeviceManager::post_message (XCamMessageType type, int64_t timestamp, const char *msg)
 {
     SmartPtr<XCamMessage> new_msg = new XCamMessage (type, timestamp, msg);
-    _msg_queue.push (new_msg);
+    if (!_msg_queue.push (new_msg))
+        XCAM_LOG_WARNING ("device manager message queue full, message(type:%d) dropped", type);
 }
 
 XCamReturn
@@ -31,6 +31,7 @@
 #include "image_processor.h"
 #include "poll_thread.h"
 #include "stats_callback_interface.h"
+#include "frame_latency.h"
 
 namespace XCam {
 
@@ -43,7 +44,9 @@ enum XCamMessageType {
     XCAM_MESSAGE_3A_RESULTS_ERROR,
 };
 
-struct XCamMessage {
+struct XCamMessage
+    : public RefObj
+{
     int64_t          timestamp;
     XCamMessageType  msg_id;
     char            *msg;
@@ -95,6 +98,11 @@ public:
         return _has_3a;
     }
 
+    // latency of frames from capture to handle_buffer
+    SmartPtr<FrameLatencyStats> &get_latency_stats () {
+        return _latency_stats;
+    }
+
     XCamReturn start ();
     XCamReturn stop ();
 
@@ -143,6 +151,8 @@ protected:
 
     /* smart analysis */
     SmartPtr<SmartAnalyzer>         _smart_analyzer;
+
+    SmartPtr<FrameLatencyStats>      _latency_stats;
 };
 
 };
@@ -20,6 +20,7 @@
 
 #include "xcam_utils.h"
 #include "dma_video_buffer.h"
+#include <unistd.h>
 
 namespace XCam {
 
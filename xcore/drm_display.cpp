@@ -537,6 +537,7 @@ DrmDisplay::convert_to_drm_bo_buf (SmartPtr<DrmDisplay> &self, SmartPtr<VideoBuf
     new_bo_buf = new DrmBoBuffer (video_info, bo_data);
     new_bo_buf->set_parent (buf_in);
     new_bo_buf->set_timestamp (buf_in->get_timestamp ());
+    new_bo_buf->copy_stage_times (*buf_in.ptr ());
     return new_bo_buf;
 }
 
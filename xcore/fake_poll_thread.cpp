@@ -19,7 +19,10 @@
  */
 
 #include "fake_poll_thread.h"
+#if HAVE_LIBDRM
 #include "drm_bo_buffer.h"
+#endif
+#include "host_mem_buffer.h"
 
 #define DEFAULT_FPT_BUF_COUNT 4
 
@@ -73,7 +76,7 @@ FakePollThread::stop ()
 }
 
 XCamReturn
-FakePollThread::read_buf (SmartPtr<DrmBoBuffer> &buf)
+FakePollThread::read_buf (SmartPtr<BufferProxy> &buf)
 {
     uint8_t *dst = buf->map ();
     const VideoBufferInfo info = buf->get_video_info ();
@@ -111,8 +114,7 @@ FakePollThread::poll_buffer_loop ()
     if (!_buf_pool.ptr () && init_buffer_pool () != XCAM_RETURN_NO_ERROR)
         return XCAM_RETURN_ERROR_MEM;
 
-    SmartPtr<DrmBoBuffer> buf =
-        _buf_pool->get_buffer (_buf_pool).dynamic_cast_ptr<DrmBoBuffer> ();
+    SmartPtr<BufferProxy> buf = _buf_pool->get_buffer (_buf_pool);
     if (!buf.ptr ()) {
         XCAM_LOG_WARNING ("FakePollThread get buffer failed");
         return XCAM_RETURN_ERROR_MEM;
@@ -146,11 +148,14 @@ FakePollThread::init_buffer_pool ()
 #if HAVE_LIBDRM
     SmartPtr<DrmDisplay> drm_disp = DrmDisplay::instance ();
     _buf_pool = new DrmBoBufferPool (drm_disp);
+#else
+    _buf_pool = new HostMemBufferPool;
+#endif
     XCAM_ASSERT (_buf_pool.ptr ());
+    _buf_pool->set_name ("fake_poll");
 
     if (_buf_pool->set_video_info (info) && _buf_pool->reserve (DEFAULT_FPT_BUF_COUNT))
         return XCAM_RETURN_NO_ERROR;
-#endif
 
     return XCAM_RETURN_ERROR_MEM;
 }
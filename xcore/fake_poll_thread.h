@@ -25,8 +25,7 @@
 
 namespace XCam {
 
-class DrmBoBufferPool;
-class DrmBoBuffer;
+class BufferPool;
 
 class FakePollThread
     : public PollThread
@@ -48,14 +47,12 @@ private:
         return XCAM_RETURN_ERROR_UNKNOWN;
     }
     XCamReturn init_buffer_pool ();
-    XCamReturn read_buf (SmartPtr<DrmBoBuffer> &buf);
+    XCamReturn read_buf (SmartPtr<BufferProxy> &buf);
 
 private:
     char                        *_raw_path;
     FILE                        *_raw;
-#if HAVE_LIBDRM
-    SmartPtr<DrmBoBufferPool>    _buf_pool;
-#endif
+    SmartPtr<BufferPool>         _buf_pool;
 };
 
 };
@@ -0,0 +1,77 @@
+/*
+ * frame_latency.cpp - frame latency accounting
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "frame_latency.h"
+
+namespace XCam {
+
+static const struct {
+    const char   *name;
+    FrameStage    from;
+    FrameStage    to;
+} latency_intervals [FrameLatencyTypeCount] = {
+    {"glass_to_glass", FrameStageCapture, FrameStageOutput},
+    {"dequeue_to_output", FrameStageDequeue, FrameStageOutput},
+    {"queue", FrameStageDequeue, FrameStageProcessStart},
+    {"process", FrameStageProcessStart, FrameStageProcessDone},
+    {"deliver", FrameStageProcessDone, FrameStageOutput},
+};
+
+FrameLatencyStats::FrameLatencyStats (const char *owner)
+{
+    _metrics = MetricsRegistry::instance ()->register_group ("latency", owner);
+    for (uint32_t i = 0; i < FrameLatencyTypeCount; ++i)
+        _latency[i] = _metrics->get_histogram (latency_intervals[i].name);
+    _frames = _metrics->get_counter ("frames");
+}
+
+FrameLatencyStats::~FrameLatencyStats ()
+{
+    MetricsRegistry::instance ()->unregister_group (_metrics);
+}
+
+void
+FrameLatencyStats::record (const VideoBuffer &buf)
+{
+    for (uint32_t i = 0; i < FrameLatencyTypeCount; ++i) {
+        int64_t from = buf.get_stage_time (latency_intervals[i].from);
+        int64_t to = buf.get_stage_time (latency_intervals[i].to);
+        if (!from || !to || to < from)
+            continue;
+        _latency[i]->record (to - from);
+    }
+    _frames->add ();
+}
+
+std::string
+FrameLatencyStats::to_json ()
+{
+    std::string json;
+    _metrics->to_json (json);
+    return json;
+}
+
+void
+FrameLatencyStats::reset ()
+{
+    _metrics->reset ();
+}
+
+};
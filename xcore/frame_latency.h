@@ -0,0 +1,84 @@
+/*
+ * frame_latency.h - frame latency accounting
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_FRAME_LATENCY_H
+#define XCAM_FRAME_LATENCY_H
+
+#include "xcam_utils.h"
+#include "smartptr.h"
+#include "video_buffer.h"
+#include "xcam_metrics.h"
+#include <string>
+
+namespace XCam {
+
+enum FrameLatencyType {
+    FrameLatencyGlassToGlass = 0,  // capture to output
+    FrameLatencyDequeueToOutput,   // dequeue to output
+    FrameLatencyQueue,             // dequeue to process start
+    FrameLatencyProcess,           // process start to process done
+    FrameLatencyDeliver,           // process done to output
+    FrameLatencyTypeCount,
+};
+
+/*
+ * latency distributions of frames reaching output, always recorded
+ * (metrics switch not needed), also listed in metrics snapshot as
+ * group "latency/<owner>"
+ */
+class FrameLatencyStats
+    : public RefObj
+{
+public:
+    explicit FrameLatencyStats (const char *owner);
+    ~FrameLatencyStats ();
+
+    // @buf reached output, intervals with missing stages are skipped
+    void record (const VideoBuffer &buf);
+
+    SmartPtr<MetricHistogram> &get_latency (FrameLatencyType type) {
+        XCAM_ASSERT (type < FrameLatencyTypeCount);
+        return _latency[type];
+    }
+    uint64_t get_frame_count () const {
+        return _frames->get ();
+    }
+
+    // microseconds, 0 if no frame recorded
+    int64_t get_percentile (FrameLatencyType type, double percent) const {
+        XCAM_ASSERT (type < FrameLatencyTypeCount);
+        return _latency[type]->get_percentile (percent);
+    }
+
+    std::string to_json ();
+    void reset ();
+
+private:
+    XCAM_DEAD_COPY (FrameLatencyStats);
+
+private:
+    SmartPtr<MetricsGroup>       _metrics;
+    SmartPtr<MetricHistogram>    _latency[FrameLatencyTypeCount];
+    SmartPtr<MetricCounter>      _frames;
+};
+
+};
+
+#endif //XCAM_FRAME_LATENCY_H
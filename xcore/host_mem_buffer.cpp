@@ -0,0 +1,119 @@
+/*
+ * host_mem_buffer.cpp - host memory buffer and buffer pool
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "host_mem_buffer.h"
+#include <sys/mman.h>
+
+namespace XCam {
+
+HostMemData::HostMemData (uint8_t *buf, uint32_t size)
+    : _buf (buf)
+    , _size (size)
+{
+    XCAM_ASSERT (buf);
+}
+
+HostMemData::~HostMemData ()
+{
+    if (_buf)
+        free (_buf);
+}
+
+SmartPtr<HostMemData>
+HostMemData::create (uint32_t size, bool huge_page)
+{
+    void *buf = NULL;
+    size_t alignment = XCAM_HOST_MEM_PAGE_SIZE;
+    size_t alloc_size = XCAM_ALIGN_UP (size, XCAM_HOST_MEM_PAGE_SIZE);
+
+    huge_page = huge_page && (alloc_size >= XCAM_HOST_MEM_HUGE_PAGE_SIZE);
+    if (huge_page) {
+        alignment = XCAM_HOST_MEM_HUGE_PAGE_SIZE;
+        alloc_size = XCAM_ALIGN_UP (alloc_size, XCAM_HOST_MEM_HUGE_PAGE_SIZE);
+    }
+
+    XCAM_FAIL_RETURN (
+        ERROR, posix_memalign (&buf, alignment, alloc_size) == 0 && buf, NULL,
+        "HostMemData allocate buffer(size:%d) failed", (uint32_t)alloc_size);
+
+#ifdef MADV_HUGEPAGE
+    if (huge_page && madvise (buf, alloc_size, MADV_HUGEPAGE) != 0) {
+        XCAM_LOG_DEBUG ("HostMemData madvise huge page failed, fallback to normal pages");
+    }
+#endif
+
+    return new HostMemData ((uint8_t *)buf, alloc_size);
+}
+
+uint8_t *
+HostMemData::map ()
+{
+    return _buf;
+}
+
+bool
+HostMemData::unmap ()
+{
+    return true;
+}
+
+HostMemBufferPool::HostMemBufferPool ()
+    : _huge_page (false)
+{
+    XCAM_LOG_DEBUG ("HostMemBufferPool constructed");
+}
+
+HostMemBufferPool::~HostMemBufferPool ()
+{
+    XCAM_LOG_DEBUG ("HostMemBufferPool destructed");
+}
+
+bool
+HostMemBufferPool::fixate_video_info (VideoBufferInfo &info)
+{
+    VideoBufferInfo out_info;
+    uint32_t aligned_width = XCAM_MAX (info.aligned_width, info.width);
+    uint32_t aligned_height = XCAM_MAX (info.aligned_height, info.height);
+
+    // strides of all formats are multiples of aligned_width
+    aligned_width = XCAM_ALIGN_UP (aligned_width, XCAM_HOST_MEM_CACHE_LINE_SIZE);
+    aligned_height = XCAM_ALIGN_UP (aligned_height, 2);
+
+    XCAM_FAIL_RETURN (
+        WARNING,
+        out_info.init (info.format, info.width, info.height, aligned_width, aligned_height),
+        false,
+        "HostMemBufferPool fixate video info failed, format:%s", xcam_fourcc_to_string (info.format));
+
+    out_info.size = XCAM_MAX (out_info.size, info.size);
+    out_info.size = XCAM_ALIGN_UP (out_info.size, XCAM_HOST_MEM_PAGE_SIZE);
+
+    info = out_info;
+    return true;
+}
+
+SmartPtr<BufferData>
+HostMemBufferPool::allocate_data (const VideoBufferInfo &buffer_info)
+{
+    SmartPtr<HostMemData> data = HostMemData::create (buffer_info.size, _huge_page);
+    return data;
+}
+
+};
@@ -0,0 +1,95 @@
+/*
+ * host_mem_buffer.h - host memory buffer and buffer pool
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_HOST_MEM_BUFFER_H
+#define XCAM_HOST_MEM_BUFFER_H
+
+#include "xcam_utils.h"
+#include "smartptr.h"
+#include "buffer_pool.h"
+
+#define XCAM_HOST_MEM_CACHE_LINE_SIZE  64
+#define XCAM_HOST_MEM_PAGE_SIZE        4096
+#define XCAM_HOST_MEM_HUGE_PAGE_SIZE   (2 * 1024 * 1024)
+
+namespace XCam {
+
+class HostMemData
+    : public BufferData
+{
+public:
+    explicit HostMemData (uint8_t *buf, uint32_t size);
+    ~HostMemData ();
+
+    static SmartPtr<HostMemData> create (uint32_t size, bool huge_page = false);
+
+    uint32_t get_size () const {
+        return _size;
+    }
+
+    //derived from BufferData
+    virtual uint8_t *map ();
+    virtual bool unmap ();
+
+private:
+    XCAM_DEAD_COPY (HostMemData);
+
+private:
+    uint8_t                  *_buf;
+    uint32_t                  _size;
+};
+
+/*
+ * Buffer pool backed by plain host memory, no libdrm needed.
+ * Every plane stride is padded to a cache line and each buffer
+ * starts on a page boundary, so rows can be processed by SIMD code
+ * without split loads. Large buffers can optionally be backed by
+ * transparent huge pages.
+ */
+class HostMemBufferPool
+    : public BufferPool
+{
+public:
+    explicit HostMemBufferPool ();
+    ~HostMemBufferPool ();
+
+    // **** MUST be set before set_video_info ****
+    void set_huge_page (bool enable) {
+        _huge_page = enable;
+    }
+    bool is_huge_page () const {
+        return _huge_page;
+    }
+
+protected:
+    // derived from BufferPool
+    virtual bool fixate_video_info (VideoBufferInfo &info);
+    virtual SmartPtr<BufferData> allocate_data (const VideoBufferInfo &buffer_info);
+
+private:
+    XCAM_DEAD_COPY (HostMemBufferPool);
+
+private:
+    bool                      _huge_page;
+};
+
+};
+
+#endif //XCAM_HOST_MEM_BUFFER_H
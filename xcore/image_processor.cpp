@@ -20,6 +20,7 @@
 
 #include "image_processor.h"
 #include "xcam_thread.h"
+#include "xcam_trace.h"
 
 namespace XCam {
 
@@ -138,16 +139,26 @@ bool X3aResultsProcessThread::loop ()
 ImageProcessor::ImageProcessor (const char* name)
     : _name (NULL)
     , _callback (NULL)
+    , _video_buf_queue (XCAM_SAFE_RING_DEFAULT_CAPACITY, VideoBufQueue::RingSPSC)
 {
     if (name)
         _name = strndup (name, XCAM_MAX_STR_SIZE);
 
     _processor_thread = new ImageProcessorThread (this);
     _results_thread = new X3aResultsProcessThread (this);
+
+    _metrics = MetricsRegistry::instance ()->register_group ("processor", _name);
+    _process_latency = _metrics->get_histogram ("process");
+    _frames_in = _metrics->get_counter ("frames_in");
+    _frames_done = _metrics->get_counter ("frames_done");
+    _frames_failed = _metrics->get_counter ("frames_failed");
+    _frames_dropped = _metrics->get_counter ("frames_dropped");
+    _input_queue_depth = _metrics->get_gauge ("input_queue");
 }
 
 ImageProcessor::~ImageProcessor ()
 {
+    MetricsRegistry::instance ()->unregister_group (_metrics);
     if (_name)
         xcam_free (_name);
 }
@@ -200,9 +211,17 @@ ImageProcessor::stop()
 XCamReturn
 ImageProcessor::push_buffer (SmartPtr<VideoBuffer> &buf)
 {
-    if (_video_buf_queue.push (buf))
+    TraceSpan span ("processor", "push_buffer", buf->get_timestamp (), -1);
+    if (_video_buf_queue.push (buf)) {
+        if (MetricsRegistry::is_enabled ()) {
+            _frames_in->add ();
+            _input_queue_depth->set (_video_buf_queue.size ());
+        }
         return XCAM_RETURN_NO_ERROR;
+    }
 
+    if (MetricsRegistry::is_enabled ())
+        _frames_dropped->add ();
     XCAM_LOG_DEBUG ("processor push buffer failed");
     return XCAM_RETURN_ERROR_UNKNOWN;
 }
@@ -308,6 +327,9 @@ ImageProcessor::filter_valid_results (X3aResultList &input, X3aResultList &valid
 void
 ImageProcessor::notify_process_buffer_done (const SmartPtr<VideoBuffer> &buf)
 {
+    buf->mark_stage (FrameStageProcessDone);
+    if (MetricsRegistry::is_enabled ())
+        _frames_done->add ();
     if (_callback)
         _callback->process_buffer_done (this, buf);
 }
@@ -315,6 +337,8 @@ ImageProcessor::notify_process_buffer_done (const SmartPtr<VideoBuffer> &buf)
 void
 ImageProcessor::notify_process_buffer_failed (const SmartPtr<VideoBuffer> &buf)
 {
+    if (MetricsRegistry::is_enabled ())
+        _frames_failed->add ();
     if (_callback)
         _callback->process_buffer_failed (this, buf);
 }
@@ -329,7 +353,17 @@ ImageProcessor::buffer_process_loop ()
     if (!buf.ptr())
         return XCAM_RETURN_ERROR_MEM;
 
-    ret = this->process_buffer (buf, new_buf);
+    if (MetricsRegistry::is_enabled ())
+        _input_queue_depth->set (_video_buf_queue.size ());
+
+    buf->mark_stage (FrameStageProcessStart, false);
+    TraceFrameScope trace_frame (buf->get_timestamp ());
+    MetricTimer timer (_process_latency);
+    {
+        TraceSpan span ("processor", get_name ());
+        ret = this->process_buffer (buf, new_buf);
+    }
+    timer.stop ();
     if (ret < XCAM_RETURN_NO_ERROR) {
         XCAM_LOG_DEBUG ("processing buffer failed");
         notify_process_buffer_failed (buf);
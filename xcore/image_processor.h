@@ -26,6 +26,8 @@
 #include "x3a_result.h"
 #include "smartptr.h"
 #include "safe_list.h"
+#include "safe_ring.h"
+#include "xcam_metrics.h"
 
 namespace XCam {
 
@@ -53,7 +55,7 @@ class ImageProcessor
     friend class ImageProcessorThread;
     friend class X3aResultsProcessThread;
 
-    typedef SafeList<VideoBuffer> VideoBufQueue;
+    typedef SafeRing<VideoBuffer> VideoBufQueue;
 
 public:
     explicit ImageProcessor (const char* name);
@@ -100,6 +102,14 @@ protected:
     SmartPtr<ImageProcessorThread>      _processor_thread;
     VideoBufQueue                       _video_buf_queue;
     SmartPtr<X3aResultsProcessThread>   _results_thread;
+
+    SmartPtr<MetricsGroup>              _metrics;
+    SmartPtr<MetricHistogram>           _process_latency;
+    SmartPtr<MetricCounter>             _frames_in;
+    SmartPtr<MetricCounter>             _frames_done;
+    SmartPtr<MetricCounter>             _frames_failed;
+    SmartPtr<MetricCounter>             _frames_dropped;
+    SmartPtr<MetricGauge>               _input_queue_depth;
 };
 
 };
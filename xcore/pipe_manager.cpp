@@ -34,6 +34,7 @@ PipeManager::PipeManager ()
     : _is_running (false)
 {
     _processor_center = new X3aImageProcessCenter;
+    _latency_stats = new FrameLatencyStats ("pipe_manager");
     XCAM_LOG_DEBUG ("PipeManager construction");
 }
 
@@ -117,6 +118,8 @@ PipeManager::push_buffer (SmartPtr<VideoBuffer> &buf)
 {
     // need to add sync mode later
 
+    // pipe entry, keep dequeue time if buffer comes from capture device
+    buf->mark_stage (FrameStageDequeue, false);
     if (_processor_center->put_buffer (buf) == false) {
         XCAM_LOG_WARNING ("push buffer failed");
         return XCAM_RETURN_ERROR_UNKNOWN;
@@ -163,6 +166,9 @@ void
 PipeManager::process_buffer_done (ImageProcessor *processor, const SmartPtr<VideoBuffer> &buf)
 {
     ImageProcessCallback::process_buffer_done (processor, buf);
+
+    buf->mark_stage (FrameStageOutput);
+    _latency_stats->record (*buf.ptr ());
     post_buffer (buf);
 }
 
@@ -27,6 +27,7 @@
 #include "smart_analyzer.h"
 #include "x3a_image_process_center.h"
 #include "stats_callback_interface.h"
+#include "frame_latency.h"
 
 namespace XCam {
 
@@ -51,6 +52,11 @@ public:
 
     virtual XCamReturn push_buffer (SmartPtr<VideoBuffer> &buf);
 
+    // latency of frames from push_buffer to post_buffer
+    SmartPtr<FrameLatencyStats> &get_latency_stats () {
+        return _latency_stats;
+    }
+
 protected:
     virtual void post_buffer (const SmartPtr<VideoBuffer> &buf) = 0;
 
@@ -73,6 +79,7 @@ protected:
     bool                             _is_running;
     SmartPtr<SmartAnalyzer>          _smart_analyzer;
     SmartPtr<X3aImageProcessCenter>  _processor_center;
+    SmartPtr<FrameLatencyStats>      _latency_stats;
 };
 
 };
@@ -20,6 +20,7 @@
 
 #include "poll_thread.h"
 #include "xcam_thread.h"
+#include "xcam_trace.h"
 #include <unistd.h>
 
 namespace XCam {
@@ -242,6 +243,7 @@ PollThread::poll_buffer_loop ()
         return XCAM_RETURN_ERROR_TIMEOUT;
     }
 
+    TraceSpan dequeue_span ("poll", "dequeue");
     ret = _capture_dev->dequeue_buffer (buf);
     if (ret != XCAM_RETURN_NO_ERROR) {
         XCAM_LOG_WARNING ("capture buffer failed");
@@ -251,7 +253,11 @@ PollThread::poll_buffer_loop ()
     XCAM_ASSERT (_poll_callback);
 
     SmartPtr<VideoBuffer> video_buf = new V4l2BufferProxy (buf, _capture_dev);
+    video_buf->mark_stage (FrameStageDequeue);
+    dequeue_span.set_frame (video_buf->get_timestamp ());
 
+    // stages called from here are traced with this frame
+    TraceFrameScope trace_frame (video_buf->get_timestamp ());
     if (_poll_callback)
         return _poll_callback->poll_buffer_ready (video_buf);
 
@@ -0,0 +1,353 @@
+/*
+ * safe_ring.h - bounded lock-free ring queue
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_SAFE_RING_H
+#define XCAM_SAFE_RING_H
+
+#include <base/xcam_defs.h>
+#include <base/xcam_common.h>
+#include <errno.h>
+#include <atomic>
+#include "smartptr.h"
+#include "xcam_mutex.h"
+
+#define XCAM_SAFE_RING_DEFAULT_CAPACITY    32
+#define XCAM_SAFE_RING_DEFAULT_SPIN_COUNT  128
+#define XCAM_SAFE_RING_CACHE_LINE_SIZE     64
+
+#if defined(__i386__) || defined(__x86_64__)
+#define XCAM_CPU_RELAX() __asm__ __volatile__ ("pause" ::: "memory")
+#elif defined(__aarch64__) || defined(__arm__)
+#define XCAM_CPU_RELAX() __asm__ __volatile__ ("yield" ::: "memory")
+#else
+#define XCAM_CPU_RELAX() std::atomic_signal_fence (std::memory_order_seq_cst)
+#endif
+
+namespace XCam {
+
+/*
+ * SafeRing, drop-in replacement of SafeList for hot hand-off paths.
+ * Bounded, no allocation on push/pop. Slots follow the sequence-number
+ * scheme (one counter per slot), so producers and consumers only touch
+ * their own index and the slot they own.
+ *
+ * RingMPMC, any number of producers and consumers.
+ * RingSPSC, exactly one producer thread and one consumer thread;
+ *           clear () counts as a consumer call.
+ *
+ * pop waits by spinning @spin_count times first, then blocks on a
+ * condition; producers only take the mutex when a consumer is blocked.
+ * push returns false when the ring is full.
+ */
+template<class OBj>
+class SafeRing {
+public:
+    typedef SmartPtr<OBj> ObjPtr;
+
+    enum RingMode {
+        RingMPMC = 0,
+        RingSPSC,
+    };
+
+    explicit SafeRing (
+        uint32_t capacity = XCAM_SAFE_RING_DEFAULT_CAPACITY,
+        RingMode mode = RingMPMC,
+        uint32_t spin_count = XCAM_SAFE_RING_DEFAULT_SPIN_COUNT);
+    ~SafeRing ();
+
+    /*
+     * timeout, -1,  wait until wakeup
+     *         >=0,  wait for @timeout microsseconds
+    */
+    inline ObjPtr pop (int32_t timeout = -1);
+    inline bool push (const ObjPtr &obj);
+
+    // not thread safe, only call it before ring is shared by threads
+    bool ensure_capacity (uint32_t capacity);
+
+    uint32_t get_capacity () const {
+        return _capacity;
+    }
+    RingMode get_mode () const {
+        return _mode;
+    }
+    uint32_t size () {
+        uint64_t tail = _tail.load (std::memory_order_acquire);
+        uint64_t head = _head.load (std::memory_order_acquire);
+        return (tail > head ? (uint32_t)(tail - head) : 0);
+    }
+    bool is_empty () {
+        return size () == 0;
+    }
+    void wakeup () {
+        SmartLock lock (_mutex);
+        ++_wakeup_count;
+        _new_obj_cond.broadcast ();
+    }
+    void pause_pop () {
+        _pop_paused.store (true, std::memory_order_release);
+        wakeup ();
+    }
+    void resume_pop () {
+        _pop_paused.store (false, std::memory_order_release);
+    }
+    inline void clear ();
+
+private:
+    struct Slot {
+        std::atomic<uint64_t>  seq;
+        ObjPtr                 obj;
+    };
+
+    inline bool try_push (const ObjPtr &obj);
+    inline bool try_pop (ObjPtr &obj);
+    bool is_pop_paused () const {
+        return _pop_paused.load (std::memory_order_acquire);
+    }
+    static Slot *create_slots (uint32_t capacity);
+
+    XCAM_DEAD_COPY (SafeRing);
+
+private:
+    Slot                   *_slots;
+    uint32_t                _capacity;
+    uint32_t                _mask;
+    RingMode                _mode;
+    uint32_t                _spin_count;
+    char                    _pad0 [XCAM_SAFE_RING_CACHE_LINE_SIZE];
+    std::atomic<uint64_t>   _tail;
+    char                    _pad1 [XCAM_SAFE_RING_CACHE_LINE_SIZE];
+    std::atomic<uint64_t>   _head;
+    char                    _pad2 [XCAM_SAFE_RING_CACHE_LINE_SIZE];
+    std::atomic<uint32_t>   _waiters;
+    std::atomic<bool>       _pop_paused;
+    uint32_t                _wakeup_count;
+    Mutex                   _mutex;
+    XCam::Cond              _new_obj_cond;
+};
+
+template<class OBj>
+SafeRing<OBj>::SafeRing (uint32_t capacity, RingMode mode, uint32_t spin_count)
+    : _slots (NULL)
+    , _capacity (0)
+    , _mask (0)
+    , _mode (mode)
+    , _spin_count (spin_count)
+    , _tail (0)
+    , _head (0)
+    , _waiters (0)
+    , _pop_paused (false)
+    , _wakeup_count (0)
+{
+    ensure_capacity (capacity);
+}
+
+template<class OBj>
+SafeRing<OBj>::~SafeRing ()
+{
+    delete [] _slots;
+}
+
+template<class OBj>
+typename SafeRing<OBj>::Slot *
+SafeRing<OBj>::create_slots (uint32_t capacity)
+{
+    Slot *slots = new Slot [capacity];
+    for (uint32_t i = 0; i < capacity; ++i)
+        slots[i].seq.store (i, std::memory_order_relaxed);
+    return slots;
+}
+
+template<class OBj>
+bool
+SafeRing<OBj>::ensure_capacity (uint32_t capacity)
+{
+    uint32_t new_capacity = 2;
+    while (new_capacity < capacity)
+        new_capacity <<= 1;
+
+    if (new_capacity <= _capacity)
+        return true;
+
+    Slot *new_slots = create_slots (new_capacity);
+    XCAM_FAIL_RETURN (
+        ERROR, new_slots, false,
+        "SafeRing allocate %d slots failed", new_capacity);
+
+    uint32_t count = 0;
+    ObjPtr obj;
+    while (_slots && try_pop (obj)) {
+        new_slots[count].obj = obj;
+        new_slots[count].seq.store (count + 1, std::memory_order_relaxed);
+        obj.release ();
+        ++count;
+    }
+
+    delete [] _slots;
+    _slots = new_slots;
+    _capacity = new_capacity;
+    _mask = new_capacity - 1;
+    _head.store (0, std::memory_order_relaxed);
+    _tail.store (count, std::memory_order_release);
+    return true;
+}
+
+template<class OBj>
+bool
+SafeRing<OBj>::try_push (const ObjPtr &obj)
+{
+    uint64_t pos = _tail.load (std::memory_order_relaxed);
+    Slot *slot = NULL;
+
+    while (true) {
+        slot = &_slots[pos & _mask];
+        uint64_t seq = slot->seq.load (std::memory_order_acquire);
+        int64_t diff = (int64_t)seq - (int64_t)pos;
+
+        if (diff == 0) {
+            if (_mode == RingSPSC) {
+                _tail.store (pos + 1, std::memory_order_relaxed);
+                break;
+            }
+            if (_tail.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return false; // full
+        } else
+            pos = _tail.load (std::memory_order_relaxed);
+    }
+
+    slot->obj = obj;
+    slot->seq.store (pos + 1, std::memory_order_release);
+    return true;
+}
+
+template<class OBj>
+bool
+SafeRing<OBj>::try_pop (ObjPtr &obj)
+{
+    uint64_t pos = _head.load (std::memory_order_relaxed);
+    Slot *slot = NULL;
+
+    while (true) {
+        slot = &_slots[pos & _mask];
+        uint64_t seq = slot->seq.load (std::memory_order_acquire);
+        int64_t diff = (int64_t)seq - (int64_t)(pos + 1);
+
+        if (diff == 0) {
+            if (_mode == RingSPSC) {
+                _head.store (pos + 1, std::memory_order_relaxed);
+                break;
+            }
+            if (_head.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return false; // empty
+        } else
+            pos = _head.load (std::memory_order_relaxed);
+    }
+
+    obj = slot->obj;
+    slot->obj.release ();
+    slot->seq.store (pos + _capacity, std::memory_order_release);
+    return true;
+}
+
+template<class OBj>
+typename SafeRing<OBj>::ObjPtr
+SafeRing<OBj>::pop (int32_t timeout)
+{
+    ObjPtr obj;
+    int code = 0;
+
+    if (is_pop_paused ())
+        return NULL;
+
+    for (uint32_t i = 0; ; ++i) {
+        if (try_pop (obj))
+            return obj;
+        if (i >= _spin_count || timeout == 0)
+            break;
+        if (is_pop_paused ())
+            return NULL;
+        XCAM_CPU_RELAX ();
+    }
+
+    if (timeout == 0)
+        return NULL;
+
+    SmartLock lock (_mutex);
+    uint32_t wakeup_count = _wakeup_count;
+    _waiters.fetch_add (1, std::memory_order_seq_cst);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+
+    // an item taken by a spinning consumer is not a wakeup, keep waiting
+    while (!is_pop_paused () && !try_pop (obj)) {
+        if (timeout > 0) {
+            code = _new_obj_cond.timedwait (_mutex, timeout);
+            if (!is_pop_paused ())
+                try_pop (obj);
+            break;
+        }
+        if (wakeup_count != _wakeup_count)
+            break;
+        code = _new_obj_cond.wait (_mutex);
+    }
+    _waiters.fetch_sub (1, std::memory_order_relaxed);
+
+    if (!obj.ptr ()) {
+        if (code == ETIMEDOUT) {
+            XCAM_LOG_DEBUG ("safe ring pop timeout");
+        } else {
+            XCAM_LOG_DEBUG ("safe ring pop failed");
+        }
+        return NULL;
+    }
+
+    return obj;
+}
+
+template<class OBj>
+bool
+SafeRing<OBj>::push (const ObjPtr &obj)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, try_push (obj), false,
+        "safe ring push failed, ring full(capacity:%d)", _capacity);
+
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+    if (_waiters.load (std::memory_order_relaxed) > 0) {
+        SmartLock lock (_mutex);
+        _new_obj_cond.signal ();
+    }
+    return true;
+}
+
+template<class OBj>
+void
+SafeRing<OBj>::clear ()
+{
+    ObjPtr obj;
+    while (try_pop (obj))
+        obj.release ();
+}
+
+};
+#endif //XCAM_SAFE_RING_H
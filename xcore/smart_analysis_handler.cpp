@@ -22,7 +22,6 @@
 #include "smart_analysis_handler.h"
 #include "smart_analyzer_loader.h"
 #include "smart_analyzer.h"
-#include "drm_bo_buffer.h"
 #include "buffer_pool.h"
 
 namespace XCam {
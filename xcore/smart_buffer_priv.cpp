@@ -20,7 +20,10 @@
 
 #include "xcam_utils.h"
 #include "base/xcam_buffer.h"
+#include "buffer_pool.h"
+#if HAVE_LIBDRM
 #include "drm_bo_buffer.h"
+#endif
 
 
 namespace XCam {
@@ -48,15 +51,14 @@ private:
 
 private:
     mutable RefCount       *_ref;
-    SmartPtr<DrmBoBuffer>   _buf_ptr;
+    SmartPtr<BufferProxy>   _buf_ptr;
 };
 
 SmartBufferPriv::SmartBufferPriv (SmartPtr<BufferProxy> buf)
     : _ref (NULL)
 {
     XCAM_ASSERT (buf.ptr ());
-    this->_buf_ptr = buf.dynamic_cast_ptr<DrmBoBuffer> ();
-    XCAM_ASSERT (this->_buf_ptr.ptr ());
+    this->_buf_ptr = buf;
 
     if (!buf.ptr ()) {
         return;
@@ -67,7 +69,11 @@ SmartBufferPriv::SmartBufferPriv (SmartPtr<BufferProxy> buf)
     const VideoBufferInfo& video_info = buf->get_video_info ();
 
     this->base.info = *((const XCamVideoBufferInfo*)&video_info);
-    this->base.mem_type = XCAM_MEM_TYPE_PRIVATE_BO;
+    this->base.mem_type = XCAM_MEM_TYPE_CPU;
+#if HAVE_LIBDRM
+    if (buf.dynamic_cast_ptr<DrmBoBuffer> ().ptr ())
+        this->base.mem_type = XCAM_MEM_TYPE_PRIVATE_BO;
+#endif
     this->base.timestamp = buf->get_timestamp ();
 
     this->base.ref = SmartBufferPriv::buf_ref;
@@ -133,7 +139,12 @@ SmartBufferPriv::buf_get_bo (XCamVideoBufferIntel *data)
 {
     SmartBufferPriv *buf = (SmartBufferPriv*) data;
     XCAM_ASSERT (buf->_buf_ptr.ptr ());
-    return buf->_buf_ptr->get_bo ();
+#if HAVE_LIBDRM
+    SmartPtr<DrmBoBuffer> bo_buf = buf->_buf_ptr.dynamic_cast_ptr<DrmBoBuffer> ();
+    if (bo_buf.ptr ())
+        return bo_buf->get_bo ();
+#endif
+    return NULL;
 }
 
 XCamVideoBuffer *
@@ -22,6 +22,8 @@
 
 #include <stdint.h>
 #include <atomic>
+#include <type_traits>
+#include <utility>
 #include <base/xcam_defs.h>
 
 namespace XCam {
@@ -29,31 +31,86 @@ namespace XCam {
 class RefCount {
 public:
     RefCount (): _ref_count(1) {}
-    void ref() {
+    virtual ~RefCount () {}
+    void ref() const {
         ++_ref_count;
     }
-    uint32_t unref() {
+    uint32_t unref() const {
         return --_ref_count;
     }
+    // called on last unref, separate count frees itself
+    virtual void destroy () {
+        delete this;
+    }
+
+protected:
+    explicit RefCount (uint32_t count)
+        : _ref_count (count) {}
+
 private:
     mutable std::atomic<uint32_t> _ref_count;
 };
 
+/*
+ * RefObj, opt-in intrusive reference count.
+ * Classes derived from RefObj keep the count inside the object, so
+ * SmartPtr needs no extra RefCount allocation, and wrapping the same
+ * raw pointer again shares the count.
+ * Objects must be allocated with new (or make_smart).
+ */
+class RefObj
+    : public RefCount
+{
+protected:
+    RefObj () : RefCount (0) {}
+    RefObj (const RefObj &) : RefCount (0) {}
+    RefObj &operator = (const RefObj &) {
+        return *this;
+    }
+    ~RefObj () {}
+
+    // count lives inside the object, freed with it
+    virtual void destroy () {}
+};
+
+template <typename Obj>
+class SmartPtr;
+
+template <typename Obj>
+inline RefCount *
+xcam_new_ref_count (Obj *obj, std::true_type)
+{
+    RefCount *ref = static_cast<RefObj *> (obj);
+    ref->ref ();
+    return ref;
+}
+
+template <typename Obj>
+inline RefCount *
+xcam_new_ref_count (Obj *obj, std::false_type)
+{
+    XCAM_UNUSED (obj);
+    return new RefCount ();
+}
+
+template <typename Obj>
+inline RefCount *
+xcam_new_ref_count (Obj *obj)
+{
+    if (!obj)
+        return NULL;
+    return xcam_new_ref_count (
+               obj, std::integral_constant<bool, std::is_base_of<RefObj, Obj>::value> ());
+}
 
 template <typename Obj>
 class SmartPtr {
 private:
     template<typename ObjDerive> friend class SmartPtr;
 public:
-    SmartPtr (Obj *obj = NULL) : _ptr (obj), _ref(NULL) {
-        if (_ptr)
-            _ref = new RefCount();
-    }
+    SmartPtr (Obj *obj = NULL) : _ptr (obj), _ref(xcam_new_ref_count (obj)) {}
     template <typename ObjDerive>
-    SmartPtr (ObjDerive *obj) : _ptr (obj), _ref(NULL) {
-        if (_ptr)
-            _ref = new RefCount();
-    }
+    SmartPtr (ObjDerive *obj) : _ptr (obj), _ref(xcam_new_ref_count (obj)) {}
 
     // copy from pointer
     SmartPtr (const SmartPtr<Obj> &obj)
@@ -67,6 +124,20 @@ public:
         if (_ptr)
             _ref->ref();
     }
+
+    // move from pointer, no reference change
+    SmartPtr (SmartPtr<Obj> &&obj)
+        : _ptr(obj._ptr), _ref(obj._ref)  {
+        obj._ptr = NULL;
+        obj._ref = NULL;
+    }
+    template <typename ObjDerive>
+    SmartPtr (SmartPtr<ObjDerive> &&obj)
+        : _ptr(obj._ptr), _ref(obj._ref)  {
+        obj._ptr = NULL;
+        obj._ref = NULL;
+    }
+
     ~SmartPtr () {
         release();
     }
@@ -74,24 +145,49 @@ public:
     /* operator = */
     SmartPtr<Obj> & operator = (Obj *obj) {
         release ();
-        new_pointer (obj, NULL);
+        new_pointer (obj, xcam_new_ref_count (obj));
         return *this;
     }
     template <typename ObjDerive>
     SmartPtr<Obj> & operator = (ObjDerive *obj) {
         release ();
-        new_pointer (obj, NULL);
+        new_pointer (obj, xcam_new_ref_count (obj));
         return *this;
     }
     SmartPtr<Obj> & operator = (const SmartPtr<Obj> &obj) {
+        Obj *ptr = obj._ptr;
+        RefCount *ref = obj._ref;
+        if (ref)
+            ref->ref ();
         release ();
-        new_pointer (obj._ptr, obj._ref);
+        new_pointer (ptr, ref);
         return *this;
     }
     template <typename ObjDerive>
     SmartPtr<Obj> & operator = (const SmartPtr<ObjDerive> &obj) {
+        Obj *ptr = obj._ptr;
+        RefCount *ref = obj._ref;
+        if (ref)
+            ref->ref ();
+        release ();
+        new_pointer (ptr, ref);
+        return *this;
+    }
+    SmartPtr<Obj> & operator = (SmartPtr<Obj> &&obj) {
+        if (this != &obj) {
+            release ();
+            new_pointer (obj._ptr, obj._ref);
+            obj._ptr = NULL;
+            obj._ref = NULL;
+        }
+        return *this;
+    }
+    template <typename ObjDerive>
+    SmartPtr<Obj> & operator = (SmartPtr<ObjDerive> &&obj) {
         release ();
         new_pointer (obj._ptr, obj._ref);
+        obj._ptr = NULL;
+        obj._ref = NULL;
         return *this;
     }
 
@@ -108,7 +204,7 @@ public:
             return;
         XCAM_ASSERT (_ref);
         if (!_ref->unref()) {
-            delete _ref;
+            _ref->destroy ();
             delete _ptr;
         }
         _ptr = NULL;
@@ -124,21 +220,20 @@ public:
         obj_derive = dynamic_cast<ObjDerive*>(_ptr);
         if (!obj_derive)
             return ret;
+        _ref->ref();
         ret.new_pointer (obj_derive, _ref);
         return ret;
     }
 private:
+    // take over one reference of @ref
     void new_pointer (Obj *obj, RefCount *ref) {
         if (!obj) {
             _ptr = NULL;
             _ref = NULL;
+            return;
         }
         _ptr = obj;
-        if (ref) {
-            _ref = ref;
-            _ref->ref();
-        } else
-            _ref = new RefCount();
+        _ref = ref;
     }
 
 private:
@@ -147,5 +242,12 @@ private:
     mutable RefCount *_ref;
 };
 
+template <typename Obj, typename... Args>
+inline SmartPtr<Obj>
+make_smart (Args&&... args)
+{
+    return SmartPtr<Obj> (new Obj (std::forward<Args> (args)...));
+}
+
 }; // end namespace
-#endif //XCAM_SMARTPTR_H
\ No newline at end of file
+#endif //XCAM_SMARTPTR_H
@@ -0,0 +1,429 @@
+/*
+ * thread_pool.cpp - process-wide work-stealing thread pool
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "thread_pool.h"
+#include "xcam_thread.h"
+#include <unistd.h>
+
+// idle workers re-check queues at least this often
+#define XCAM_THREAD_POOL_IDLE_TIMEOUT 10000  // 10ms
+
+namespace XCam {
+
+// index of pool worker running on current thread, -1 for other threads
+static thread_local ThreadPool *tls_pool = NULL;
+static thread_local int32_t tls_worker_index = -1;
+
+class PoolWorker
+    : public Thread
+{
+public:
+    PoolWorker (ThreadPool *pool, uint32_t index)
+        : Thread ("PoolWorker")
+        , _pool (pool)
+        , _index (index)
+    {}
+
+protected:
+    virtual bool started () {
+        tls_pool = _pool;
+        tls_worker_index = (int32_t)_index;
+        return true;
+    }
+    virtual bool loop () {
+        return _pool->worker_loop (_index);
+    }
+
+private:
+    ThreadPool       *_pool;
+    uint32_t          _index;
+};
+
+/*
+ * shared state of one parallel_for, workers may still hold it after
+ * the caller returned but never touch @func once all chunks are taken
+ */
+class ParallelJob
+    : public RefObj
+{
+public:
+    ParallelJob (ParallelFunc *func, uint32_t count, uint32_t grain)
+        : _func (func)
+        , _count (count)
+        , _grain (grain)
+        , _chunks ((count + grain - 1) / grain)
+        , _next_chunk (0)
+        , _done_chunks (0)
+        , _error (XCAM_RETURN_NO_ERROR)
+    {}
+
+    uint32_t get_chunks () const {
+        return _chunks;
+    }
+
+    // return when no chunk left to take
+    void work () {
+        uint32_t chunk = 0;
+        while ((chunk = _next_chunk.fetch_add (1, std::memory_order_relaxed)) < _chunks) {
+            uint32_t begin = chunk * _grain;
+            uint32_t end = XCAM_MIN (begin + _grain, _count);
+            XCamReturn ret = _func->work_range (begin, end);
+            if (ret != XCAM_RETURN_NO_ERROR) {
+                int32_t no_error = XCAM_RETURN_NO_ERROR;
+                _error.compare_exchange_strong (no_error, (int32_t)ret);
+            }
+
+            if (_done_chunks.fetch_add (1, std::memory_order_acq_rel) + 1 == _chunks) {
+                SmartLock locker (_mutex);
+                _done_cond.broadcast ();
+            }
+        }
+    }
+
+    XCamReturn wait () {
+        SmartLock locker (_mutex);
+        while (_done_chunks.load (std::memory_order_acquire) < _chunks)
+            _done_cond.wait (_mutex);
+        return (XCamReturn)_error.load ();
+    }
+
+private:
+    XCAM_DEAD_COPY (ParallelJob);
+
+private:
+    ParallelFunc            *_func;
+    uint32_t                 _count;
+    uint32_t                 _grain;
+    uint32_t                 _chunks;
+    std::atomic<uint32_t>    _next_chunk;
+    std::atomic<uint32_t>    _done_chunks;
+    std::atomic<int32_t>     _error;
+    Mutex                    _mutex;
+    Cond                     _done_cond;
+};
+
+class ParallelTask
+    : public PoolTask
+{
+public:
+    explicit ParallelTask (const SmartPtr<ParallelJob> &job)
+        : PoolTask ("ParallelTask", PoolTaskPriorityHigh)
+        , _job (job)
+    {}
+
+    virtual XCamReturn run () {
+        _job->work ();
+        return XCAM_RETURN_NO_ERROR;
+    }
+
+private:
+    SmartPtr<ParallelJob>   _job;
+};
+
+class TileRangeFunc
+    : public ParallelFunc
+{
+public:
+    TileRangeFunc (
+        TileFunc &func, uint32_t width, uint32_t height,
+        uint32_t tile_width, uint32_t tile_height)
+        : _func (func)
+        , _width (width)
+        , _height (height)
+        , _tile_width (tile_width)
+        , _tile_height (tile_height)
+        , _tiles_x ((width + tile_width - 1) / tile_width)
+    {}
+
+    uint32_t get_tile_count () const {
+        return _tiles_x * ((_height + _tile_height - 1) / _tile_height);
+    }
+
+    virtual XCamReturn work_range (uint32_t begin, uint32_t end) {
+        XCamReturn ret = XCAM_RETURN_NO_ERROR;
+        for (uint32_t i = begin; i < end && ret == XCAM_RETURN_NO_ERROR; ++i) {
+            ImageTile tile;
+            tile.x = (i % _tiles_x) * _tile_width;
+            tile.y = (i / _tiles_x) * _tile_height;
+            tile.width = XCAM_MIN (_tile_width, _width - tile.x);
+            tile.height = XCAM_MIN (_tile_height, _height - tile.y);
+            ret = _func.work_tile (tile);
+        }
+        return ret;
+    }
+
+private:
+    TileFunc          &_func;
+    uint32_t           _width;
+    uint32_t           _height;
+    uint32_t           _tile_width;
+    uint32_t           _tile_height;
+    uint32_t           _tiles_x;
+};
+
+PoolTask::PoolTask (const char *name, PoolTaskPriority priority)
+    : _name (NULL)
+    , _priority (priority)
+{
+    XCAM_ASSERT (priority < PoolTaskPriorityCount);
+    if (name)
+        _name = strndup (name, XCAM_MAX_STR_SIZE);
+}
+
+PoolTask::~PoolTask ()
+{
+    if (_name)
+        xcam_free (_name);
+}
+
+SmartPtr<ThreadPool> ThreadPool::_instance;
+Mutex ThreadPool::_instance_mutex;
+
+SmartPtr<ThreadPool>
+ThreadPool::instance ()
+{
+    SmartLock locker (_instance_mutex);
+    if (_instance.ptr ())
+        return _instance;
+
+    int32_t count = 0;
+    const char *env = getenv ("XCAM_THREAD_POOL_SIZE");
+    if (env)
+        count = atoi (env);
+    if (count <= 0)
+        count = (int32_t) sysconf (_SC_NPROCESSORS_ONLN);
+    count = XCAM_MAX (count, XCAM_THREAD_POOL_MIN_WORKERS);
+    count = XCAM_MIN (count, XCAM_THREAD_POOL_MAX_WORKERS);
+
+    SmartPtr<ThreadPool> pool = new ThreadPool ((uint32_t)count);
+    XCAM_FAIL_RETURN (
+        ERROR, pool->start (), NULL,
+        "ThreadPool start %d workers failed", count);
+
+    _instance = pool;
+    return _instance;
+}
+
+ThreadPool::ThreadPool (uint32_t worker_count)
+    : _worker_count (worker_count)
+    , _next_queue (0)
+    , _pending (0)
+    , _running (false)
+    , _sleepers (0)
+{
+    XCAM_ASSERT (worker_count > 0);
+    for (uint32_t i = 0; i < _worker_count; ++i)
+        _queues.push_back (new WorkerQueue);
+
+    XCAM_LOG_DEBUG ("ThreadPool constructed with %d workers", worker_count);
+}
+
+ThreadPool::~ThreadPool ()
+{
+    stop ();
+    for (uint32_t i = 0; i < _queues.size (); ++i)
+        delete _queues[i];
+
+    XCAM_LOG_DEBUG ("ThreadPool destructed");
+}
+
+bool
+ThreadPool::start ()
+{
+    _running.store (true);
+    for (uint32_t i = 0; i < _worker_count; ++i) {
+        SmartPtr<PoolWorker> worker = new PoolWorker (this, i);
+        _workers.push_back (worker);
+        if (!worker->start ()) {
+            stop ();
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+ThreadPool::stop ()
+{
+    {
+        SmartLock locker (_idle_mutex);
+        if (!_running.exchange (false))
+            return;
+        _idle_cond.broadcast ();
+    }
+
+    for (uint32_t i = 0; i < _workers.size (); ++i)
+        _workers[i]->stop ();
+    _workers.clear ();
+
+    for (uint32_t i = 0; i < _queues.size (); ++i) {
+        SmartLock locker (_queues[i]->mutex);
+        for (uint32_t pri = 0; pri < PoolTaskPriorityCount; ++pri)
+            _queues[i]->tasks[pri].clear ();
+    }
+    _pending.store (0);
+}
+
+bool
+ThreadPool::queue (const SmartPtr<PoolTask> &task)
+{
+    uint32_t index = 0;
+
+    XCAM_ASSERT (task.ptr ());
+    XCAM_FAIL_RETURN (
+        WARNING, _running.load (), false,
+        "ThreadPool queue task(%s) failed, pool stopped", XCAM_STR (task->get_name ()));
+
+    if (tls_pool == this && tls_worker_index >= 0)
+        index = (uint32_t)tls_worker_index;
+    else
+        index = _next_queue.fetch_add (1, std::memory_order_relaxed) % _worker_count;
+
+    {
+        SmartLock locker (_queues[index]->mutex);
+        _queues[index]->tasks[task->get_priority ()].push_back (task);
+    }
+    _pending.fetch_add (1, std::memory_order_seq_cst);
+
+    SmartLock locker (_idle_mutex);
+    if (_sleepers)
+        _idle_cond.signal ();
+    return true;
+}
+
+SmartPtr<PoolTask>
+ThreadPool::pop_own (uint32_t index, uint32_t priority)
+{
+    SmartPtr<PoolTask> task;
+    WorkerQueue *queue = _queues[index];
+
+    SmartLock locker (queue->mutex);
+    if (queue->tasks[priority].empty ())
+        return NULL;
+
+    // newest first, its data is most likely still in cache
+    task = queue->tasks[priority].back ();
+    queue->tasks[priority].pop_back ();
+    return task;
+}
+
+SmartPtr<PoolTask>
+ThreadPool::steal (uint32_t thief, uint32_t priority)
+{
+    SmartPtr<PoolTask> task;
+
+    for (uint32_t i = 1; i <= _worker_count; ++i) {
+        WorkerQueue *queue = _queues[(thief + i) % _worker_count];
+        SmartLock locker (queue->mutex);
+        if (queue->tasks[priority].empty ())
+            continue;
+
+        // oldest first, leave the hot end to the owner
+        task = queue->tasks[priority].front ();
+        queue->tasks[priority].pop_front ();
+        return task;
+    }
+    return NULL;
+}
+
+SmartPtr<PoolTask>
+ThreadPool::take_task (uint32_t index)
+{
+    SmartPtr<PoolTask> task;
+
+    if (!_pending.load (std::memory_order_acquire))
+        return NULL;
+
+    for (uint32_t pri = 0; pri < PoolTaskPriorityCount; ++pri) {
+        task = pop_own (index, pri);
+        if (!task.ptr ())
+            task = steal (index, pri);
+        if (task.ptr ()) {
+            _pending.fetch_sub (1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+    return NULL;
+}
+
+bool
+ThreadPool::worker_loop (uint32_t index)
+{
+    SmartPtr<PoolTask> task = take_task (index);
+
+    if (task.ptr ()) {
+        XCamReturn ret = task->run ();
+        if (ret != XCAM_RETURN_NO_ERROR && ret != XCAM_RETURN_BYPASS) {
+            XCAM_LOG_WARNING ("ThreadPool task(%s) failed, ret:%d", XCAM_STR (task->get_name ()), ret);
+        }
+        return true;
+    }
+
+    SmartLock locker (_idle_mutex);
+    if (!_running.load ())
+        return false;
+    if (_pending.load (std::memory_order_seq_cst))
+        return true;
+
+    ++_sleepers;
+    _idle_cond.timedwait (_idle_mutex, XCAM_THREAD_POOL_IDLE_TIMEOUT);
+    --_sleepers;
+    return _running.load ();
+}
+
+XCamReturn
+ThreadPool::parallel_for (uint32_t count, ParallelFunc &func, uint32_t grain)
+{
+    if (!count)
+        return XCAM_RETURN_NO_ERROR;
+    if (!grain)
+        grain = 1;
+
+    SmartPtr<ParallelJob> job = new ParallelJob (&func, count, grain);
+
+    // caller takes part, so one helper less
+    uint32_t helpers = XCAM_MIN (job->get_chunks (), _worker_count + 1) - 1;
+    for (uint32_t i = 0; i < helpers; ++i) {
+        if (!queue (new ParallelTask (job)))
+            break;
+    }
+
+    job->work ();
+    return job->wait ();
+}
+
+XCamReturn
+ThreadPool::parallel_for_tiles (
+    uint32_t width, uint32_t height,
+    uint32_t tile_width, uint32_t tile_height,
+    TileFunc &func)
+{
+    XCAM_FAIL_RETURN (
+        WARNING, tile_width && tile_height, XCAM_RETURN_ERROR_PARAM,
+        "ThreadPool parallel tiles with zero tile size(%dx%d)", tile_width, tile_height);
+
+    if (!width || !height)
+        return XCAM_RETURN_NO_ERROR;
+
+    TileRangeFunc range_func (func, width, height, tile_width, tile_height);
+    return parallel_for (range_func.get_tile_count (), range_func);
+}
+
+};
@@ -0,0 +1,159 @@
+/*
+ * thread_pool.h - process-wide work-stealing thread pool
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_THREAD_POOL_H
+#define XCAM_THREAD_POOL_H
+
+#include "xcam_utils.h"
+#include "smartptr.h"
+#include "xcam_mutex.h"
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#define XCAM_THREAD_POOL_MIN_WORKERS   2
+#define XCAM_THREAD_POOL_MAX_WORKERS   64
+
+namespace XCam {
+
+enum PoolTaskPriority {
+    PoolTaskPriorityHigh = 0,
+    PoolTaskPriorityNormal,
+    PoolTaskPriorityLow,
+    PoolTaskPriorityCount,
+};
+
+class PoolTask
+    : public RefObj
+{
+public:
+    explicit PoolTask (const char *name = NULL, PoolTaskPriority priority = PoolTaskPriorityNormal);
+    virtual ~PoolTask ();
+
+    const char *get_name () const {
+        return _name;
+    }
+    PoolTaskPriority get_priority () const {
+        return _priority;
+    }
+
+    // run once on one of the pool workers
+    virtual XCamReturn run () = 0;
+
+private:
+    XCAM_DEAD_COPY (PoolTask);
+
+private:
+    char                   *_name;
+    PoolTaskPriority        _priority;
+};
+
+struct ImageTile {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+class ParallelFunc {
+public:
+    virtual ~ParallelFunc () {}
+    // called concurrently on disjoint ranges [begin, end)
+    virtual XCamReturn work_range (uint32_t begin, uint32_t end) = 0;
+};
+
+class TileFunc {
+public:
+    virtual ~TileFunc () {}
+    // called concurrently on disjoint tiles, edge tiles may be smaller
+    virtual XCamReturn work_tile (const ImageTile &tile) = 0;
+};
+
+class PoolWorker;
+
+/*
+ * Work-stealing pool shared by the whole process.
+ * Each worker owns one deque per priority; it takes its own newest
+ * task first and steals the oldest task of other workers when idle.
+ * Higher priority tasks, own or stolen, always run first.
+ *
+ * Worker count: $XCAM_THREAD_POOL_SIZE or online cpu count,
+ * clamped to [XCAM_THREAD_POOL_MIN_WORKERS, XCAM_THREAD_POOL_MAX_WORKERS].
+ */
+class ThreadPool {
+    friend class PoolWorker;
+
+public:
+    static SmartPtr<ThreadPool> instance ();
+
+    explicit ThreadPool (uint32_t worker_count);
+    ~ThreadPool ();
+
+    uint32_t get_worker_count () const {
+        return _worker_count;
+    }
+
+    // task from a pool worker goes to that worker's own queue
+    bool queue (const SmartPtr<PoolTask> &task);
+
+    /*
+     * split [0, count) into chunks of @grain and wait until all done.
+     * calling thread also works on chunks, nested calls are allowed.
+     */
+    XCamReturn parallel_for (uint32_t count, ParallelFunc &func, uint32_t grain = 1);
+    XCamReturn parallel_for_tiles (
+        uint32_t width, uint32_t height,
+        uint32_t tile_width, uint32_t tile_height,
+        TileFunc &func);
+
+    void stop ();
+
+private:
+    struct WorkerQueue {
+        Mutex                               mutex;
+        std::deque<SmartPtr<PoolTask>>      tasks [PoolTaskPriorityCount];
+    };
+
+    bool start ();
+    bool worker_loop (uint32_t index);
+    SmartPtr<PoolTask> take_task (uint32_t index);
+    SmartPtr<PoolTask> pop_own (uint32_t index, uint32_t priority);
+    SmartPtr<PoolTask> steal (uint32_t thief, uint32_t priority);
+
+    XCAM_DEAD_COPY (ThreadPool);
+
+private:
+    static SmartPtr<ThreadPool>         _instance;
+    static Mutex                        _instance_mutex;
+
+    uint32_t                            _worker_count;
+    std::vector<WorkerQueue *>          _queues;
+    std::vector<SmartPtr<PoolWorker>>   _workers;
+    std::atomic<uint32_t>               _next_queue;
+    std::atomic<uint32_t>               _pending;
+    std::atomic<bool>                   _running;
+    uint32_t                            _sleepers;
+    Mutex                               _idle_mutex;
+    Cond                                _idle_cond;
+};
+
+};
+
+#endif //XCAM_THREAD_POOL_H
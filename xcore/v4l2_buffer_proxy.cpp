@@ -64,6 +64,10 @@ V4l2BufferProxy::V4l2BufferProxy (SmartPtr<V4l2Buffer> &buf, SmartPtr<V4l2Device
     v4l2_format_to_video_info (buf->get_format(), info);
     set_video_info (info);
     set_timestamp (XCAM_TIMEVAL_2_USEC (ts));
+
+    // comparable with stage times only if driver stamps on monotonic clock
+    if ((buf->get_buf().flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC)
+        set_stage_time (FrameStageCapture, XCAM_TIMEVAL_2_USEC (ts));
 }
 
 V4l2BufferProxy::~V4l2BufferProxy ()
@@ -19,6 +19,7 @@
  */
 
 #include "video_buffer.h"
+#include "xcam_metrics.h"
 #include <linux/videodev2.h>
 
 namespace XCam {
@@ -67,4 +68,21 @@ VideoBufferInfo::get_planar_info (
     return (xcam_video_buffer_get_planar_info (info, planar_info, index) == XCAM_RETURN_NO_ERROR);
 }
 
+void
+VideoBuffer::mark_stage (FrameStage stage, bool overwrite)
+{
+    XCAM_ASSERT (stage < FrameStageCount);
+    if (overwrite || !_stage_times[stage])
+        _stage_times[stage] = xcam_metrics_now_us ();
+}
+
+void
+VideoBuffer::copy_stage_times (const VideoBuffer &buf)
+{
+    for (uint32_t i = 0; i < FrameStageCount; ++i) {
+        if (!_stage_times[i])
+            _stage_times[i] = buf._stage_times[i];
+    }
+}
+
 };
@@ -50,15 +50,31 @@ struct VideoBufferInfo
         VideoBufferPlanarInfo &planar, const uint32_t index = 0) const;
 };
 
-class VideoBuffer {
+// stages of a frame for latency accounting, in pipeline order
+enum FrameStage {
+    FrameStageCapture = 0,    // sensor timestamp, only if on monotonic clock
+    FrameStageDequeue,        // dequeued from capture device
+    FrameStageProcessStart,   // entered first image processor
+    FrameStageProcessDone,    // left last image processor
+    FrameStageOutput,         // handed to application
+    FrameStageCount,
+};
+
+class VideoBuffer
+    : public RefObj
+{
 public:
     explicit VideoBuffer (int64_t timestamp = InvalidTimestamp)
         : _timestamp (timestamp)
-    {}
+    {
+        xcam_mem_clear (_stage_times);
+    }
     explicit VideoBuffer (const VideoBufferInfo &info, int64_t timestamp = InvalidTimestamp)
         : _videoinfo (info)
         , _timestamp (timestamp)
-    {}
+    {
+        xcam_mem_clear (_stage_times);
+    }
     virtual ~VideoBuffer () {}
 
     virtual uint8_t *map () = 0;
@@ -83,9 +99,25 @@ public:
     uint32_t get_size () const {
         return _videoinfo.size;
     }
+
+    // stage times in monotonic microseconds, 0 if stage not reached
+    int64_t get_stage_time (FrameStage stage) const {
+        XCAM_ASSERT (stage < FrameStageCount);
+        return _stage_times[stage];
+    }
+    void set_stage_time (FrameStage stage, int64_t time_us) {
+        XCAM_ASSERT (stage < FrameStageCount);
+        _stage_times[stage] = time_us;
+    }
+    // set to now, @overwrite false keeps the time of an earlier processor
+    void mark_stage (FrameStage stage, bool overwrite = true);
+    // take stages not reached yet from @buf, e.g. input to output of a handler
+    void copy_stage_times (const VideoBuffer &buf);
+
 private:
     VideoBufferInfo _videoinfo;
     int64_t         _timestamp; // in microseconds
+    int64_t         _stage_times[FrameStageCount];
 };
 
 };
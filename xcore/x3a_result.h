@@ -30,6 +30,7 @@
 namespace XCam {
 
 class X3aResult
+    : public RefObj
 {
 protected:
     explicit X3aResult (
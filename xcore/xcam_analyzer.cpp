@@ -22,12 +22,14 @@
 
 #include "xcam_analyzer.h"
 #include "x3a_stats_pool.h"
+#include "xcam_trace.h"
 
 namespace XCam {
 
 AnalyzerThread::AnalyzerThread (XAnalyzer *analyzer)
     : Thread ("AnalyzerThread")
     , _analyzer (analyzer)
+    , _stats_queue (XCAM_SAFE_RING_DEFAULT_CAPACITY, SafeRing<BufferProxy>::RingSPSC)
 {}
 
 AnalyzerThread::~AnalyzerThread ()
@@ -38,7 +40,11 @@ AnalyzerThread::~AnalyzerThread ()
 bool
 AnalyzerThread::push_stats (const SmartPtr<BufferProxy> &buffer)
 {
-    _stats_queue.push (buffer);
+    XCAM_FAIL_RETURN (
+        WARNING,
+        _stats_queue.push (buffer),
+        false,
+        "analyzer(%s) stats queue full, drop stats", XCAM_STR (_analyzer->get_name ()));
     return true;
 }
 
@@ -73,7 +79,7 @@ AnalyzerThread::loop ()
     //    XCAM_LOG_WARNING ("lost 3a stats since 3a analyzer too slow");
     //}
 
-    XCamReturn ret = _analyzer->analyze (stats);
+    XCamReturn ret = _analyzer->analyze_buffer (stats);
     if (ret == XCAM_RETURN_NO_ERROR || ret == XCAM_RETURN_BYPASS)
         return true;
 
@@ -119,10 +125,19 @@ XAnalyzer::XAnalyzer (const char *name)
         _name = strndup (name, XCAM_MAX_STR_SIZE);
 
     _analyzer_thread  = new AnalyzerThread (this);
+
+    _metrics = MetricsRegistry::instance ()->register_group ("analyzer", _name);
+    _analyze_latency = _metrics->get_histogram ("analyze");
+    _analyzed_counter = _metrics->get_counter ("analyzed");
+    _bypassed_counter = _metrics->get_counter ("bypassed");
+    _failed_counter = _metrics->get_counter ("failed");
+    _dropped_counter = _metrics->get_counter ("stats_dropped");
+    _stats_queue_depth = _metrics->get_gauge ("stats_queue");
 }
 
 XAnalyzer::~XAnalyzer()
 {
+    MetricsRegistry::instance ()->unregister_group (_metrics);
     if (_name)
         xcam_free (_name);
 }
@@ -234,19 +249,49 @@ XAnalyzer::push_buffer (const SmartPtr<BufferProxy> &buffer)
 
     if (get_sync_mode ()) {
         SmartPtr<BufferProxy> data = buffer;
-        ret = analyze (data);
+        ret = analyze_buffer (data);
     }
     else {
         if (!_analyzer_thread->is_running())
             return XCAM_RETURN_ERROR_THREAD;
 
-        if (!_analyzer_thread->push_stats (buffer))
-            return XCAM_RETURN_ERROR_THREAD;
+        if (!_analyzer_thread->push_stats (buffer)) {
+            if (MetricsRegistry::is_enabled ())
+                _dropped_counter->add ();
+            return XCAM_RETURN_ERROR_MEM;
+        }
+
+        if (MetricsRegistry::is_enabled ())
+            _stats_queue_depth->set (_analyzer_thread->get_stats_queue_size ());
     }
 
     return ret;
 }
 
+XCamReturn
+XAnalyzer::analyze_buffer (SmartPtr<BufferProxy> &buffer)
+{
+    TraceSpan span ("analyzer", get_name (), buffer->get_timestamp (), -1);
+
+    if (!MetricsRegistry::is_enabled ())
+        return analyze (buffer);
+
+    if (!_sync)
+        _stats_queue_depth->set (_analyzer_thread->get_stats_queue_size ());
+
+    MetricTimer timer (_analyze_latency);
+    XCamReturn ret = analyze (buffer);
+    timer.stop ();
+
+    if (ret == XCAM_RETURN_NO_ERROR)
+        _analyzed_counter->add ();
+    else if (ret == XCAM_RETURN_BYPASS)
+        _bypassed_counter->add ();
+    else
+        _failed_counter->add ();
+    return ret;
+}
+
 void
 XAnalyzer::set_results_timestamp (X3aResultList &results, int64_t timestamp)
 {
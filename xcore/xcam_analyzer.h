@@ -26,6 +26,7 @@
 #include "handler_interface.h"
 #include "xcam_thread.h"
 #include "buffer_pool.h"
+#include "xcam_metrics.h"
 
 namespace XCam {
 
@@ -42,6 +43,9 @@ public:
         _stats_queue.pause_pop ();
     }
     bool push_stats (const SmartPtr<BufferProxy> &buffer);
+    uint32_t get_stats_queue_size () {
+        return _stats_queue.size ();
+    }
 
 protected:
     virtual bool started ();
@@ -52,7 +56,7 @@ protected:
 
 private:
     XAnalyzer              *_analyzer;
-    SafeList<BufferProxy>   _stats_queue;
+    SafeRing<BufferProxy>   _stats_queue;
 };
 
 class AnalyzerCallback {
@@ -120,6 +124,7 @@ protected:
     void set_results_timestamp (X3aResultList &results, int64_t timestamp);
 
 private:
+    XCamReturn analyze_buffer (SmartPtr<BufferProxy> &buffer);
 
     XCAM_DEAD_COPY (XAnalyzer);
 
@@ -134,6 +139,14 @@ private:
     uint32_t                 _height;
     double                   _framerate;
     AnalyzerCallback        *_callback;
+
+    SmartPtr<MetricsGroup>       _metrics;
+    SmartPtr<MetricHistogram>    _analyze_latency;
+    SmartPtr<MetricCounter>      _analyzed_counter;
+    SmartPtr<MetricCounter>      _bypassed_counter;
+    SmartPtr<MetricCounter>      _failed_counter;
+    SmartPtr<MetricCounter>      _dropped_counter;
+    SmartPtr<MetricGauge>        _stats_queue_depth;
 };
 
 }
@@ -230,7 +230,6 @@ xcam_video_buffer_get_planar_info (
         break;
 
     case V4L2_PIX_FMT_GREY:
-    case V4L2_PIX_FMT_YUYV:
     case V4L2_PIX_FMT_RGB565:
     case V4L2_PIX_FMT_SBGGR8:
     case V4L2_PIX_FMT_SGBRG8:
@@ -249,6 +248,12 @@ xcam_video_buffer_get_planar_info (
         XCAM_ASSERT (index <= 0);
         break;
 
+    case V4L2_PIX_FMT_YUYV:
+        // 8 bits each, Y and one of U/V per pixel
+        XCAM_ASSERT (index <= 0);
+        planar_info->pixel_bytes = 2;
+        break;
+
     case V4L2_PIX_FMT_RGB24:
         XCAM_ASSERT (index <= 0);
         planar_info->pixel_bytes = 3;
@@ -0,0 +1,418 @@
+/*
+ * xcam_metrics.cpp - runtime metrics registry
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "xcam_metrics.h"
+#include <time.h>
+
+namespace XCam {
+
+int64_t
+xcam_metrics_now_us ()
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * INT64_C (1000000) + ts.tv_nsec / 1000;
+}
+
+static void
+json_append_escaped (std::string &json, const char *str)
+{
+    json += '"';
+    for (; *str; ++str) {
+        char c = *str;
+        if (c == '"' || c == '\\') {
+            json += '\\';
+            json += c;
+        } else if ((unsigned char)c < 0x20) {
+            char buf[8];
+            snprintf (buf, sizeof (buf), "\\u%04x", (unsigned char)c);
+            json += buf;
+        } else
+            json += c;
+    }
+    json += '"';
+}
+
+MetricHistogram::MetricHistogram ()
+    : _count (0)
+    , _sum (0)
+    , _max (0)
+{
+    for (uint32_t i = 0; i < XCAM_METRIC_HISTOGRAM_BUCKETS; ++i)
+        _buckets[i].store (0, std::memory_order_relaxed);
+}
+
+uint32_t
+MetricHistogram::bucket_index (uint64_t value)
+{
+    if (value < XCAM_METRIC_HISTOGRAM_LINEAR_MAX)
+        return (uint32_t)value;
+
+    uint32_t exp = 63 - __builtin_clzll (value);
+    uint32_t sub = (value >> (exp - XCAM_METRIC_HISTOGRAM_SUB_BITS)) & ((1 << XCAM_METRIC_HISTOGRAM_SUB_BITS) - 1);
+    uint32_t index = XCAM_METRIC_HISTOGRAM_LINEAR_MAX + ((exp - 4) << XCAM_METRIC_HISTOGRAM_SUB_BITS) + sub;
+    return XCAM_MIN (index, XCAM_METRIC_HISTOGRAM_BUCKETS - 1);
+}
+
+uint64_t
+MetricHistogram::bucket_upper (uint32_t index)
+{
+    if (index < XCAM_METRIC_HISTOGRAM_LINEAR_MAX)
+        return index;
+
+    index -= XCAM_METRIC_HISTOGRAM_LINEAR_MAX;
+    uint32_t exp = (index >> XCAM_METRIC_HISTOGRAM_SUB_BITS) + 4;
+    uint64_t sub = index & ((1 << XCAM_METRIC_HISTOGRAM_SUB_BITS) - 1);
+    uint64_t step = UINT64_C (1) << (exp - XCAM_METRIC_HISTOGRAM_SUB_BITS);
+    return (UINT64_C (1) << exp) + (sub + 1) * step - 1;
+}
+
+void
+MetricHistogram::record (int64_t value_us)
+{
+    if (value_us < 0)
+        value_us = 0;
+
+    _buckets[bucket_index ((uint64_t)value_us)].fetch_add (1, std::memory_order_relaxed);
+    _sum.fetch_add ((uint64_t)value_us, std::memory_order_relaxed);
+    _count.fetch_add (1, std::memory_order_relaxed);
+
+    int64_t cur = _max.load (std::memory_order_relaxed);
+    while (value_us > cur && !_max.compare_exchange_weak (cur, value_us, std::memory_order_relaxed));
+}
+
+double
+MetricHistogram::get_average () const
+{
+    uint64_t count = get_count ();
+    return count ? (double)_sum.load (std::memory_order_relaxed) / count : 0.0;
+}
+
+int64_t
+MetricHistogram::get_percentile (double percent) const
+{
+    uint64_t counts[XCAM_METRIC_HISTOGRAM_BUCKETS];
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < XCAM_METRIC_HISTOGRAM_BUCKETS; ++i) {
+        counts[i] = _buckets[i].load (std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (!total)
+        return 0;
+
+    uint64_t rank = (uint64_t)ceil (total * XCAM_MIN (XCAM_MAX (percent, 0.0), 100.0) / 100.0);
+    rank = XCAM_MAX (rank, (uint64_t)1);
+
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < XCAM_METRIC_HISTOGRAM_BUCKETS; ++i) {
+        acc += counts[i];
+        if (acc >= rank)
+            return XCAM_MIN ((int64_t)bucket_upper (i), get_max ());
+    }
+    return get_max ();
+}
+
+void
+MetricHistogram::reset ()
+{
+    for (uint32_t i = 0; i < XCAM_METRIC_HISTOGRAM_BUCKETS; ++i)
+        _buckets[i].store (0, std::memory_order_relaxed);
+    _count.store (0, std::memory_order_relaxed);
+    _sum.store (0, std::memory_order_relaxed);
+    _max.store (0, std::memory_order_relaxed);
+}
+
+MetricsGroup::MetricsGroup (const char *name)
+    : _name (name)
+{
+}
+
+SmartPtr<MetricHistogram>
+MetricsGroup::get_histogram (const char *name)
+{
+    SmartLock locker (_mutex);
+    SmartPtr<MetricHistogram> &metric = _histograms[name];
+    if (!metric.ptr ())
+        metric = new MetricHistogram;
+    return metric;
+}
+
+SmartPtr<MetricCounter>
+MetricsGroup::get_counter (const char *name)
+{
+    SmartLock locker (_mutex);
+    SmartPtr<MetricCounter> &metric = _counters[name];
+    if (!metric.ptr ())
+        metric = new MetricCounter;
+    return metric;
+}
+
+SmartPtr<MetricGauge>
+MetricsGroup::get_gauge (const char *name)
+{
+    SmartLock locker (_mutex);
+    SmartPtr<MetricGauge> &metric = _gauges[name];
+    if (!metric.ptr ())
+        metric = new MetricGauge;
+    return metric;
+}
+
+/*
+ * {"histograms":{"execute":{"count":n,"avg_us":x,"p50_us":n,"p99_us":n,"max_us":n}},
+ *  "counters":{"dropped":n}, "gauges":{"queue_depth":{"value":n,"max":n}}}
+ */
+void
+MetricsGroup::to_json (std::string &json)
+{
+    char buf[256];
+    bool first = true;
+    SmartLock locker (_mutex);
+
+    json += "{\"histograms\":{";
+    for (std::map<std::string, SmartPtr<MetricHistogram>>::iterator i = _histograms.begin ();
+            i != _histograms.end (); ++i) {
+        SmartPtr<MetricHistogram> &hist = i->second;
+        if (!first)
+            json += ',';
+        first = false;
+        json_append_escaped (json, i->first.c_str ());
+        snprintf (
+            buf, sizeof (buf),
+            ":{\"count\":%" PRIu64 ",\"avg_us\":%.1f,\"p50_us\":%" PRId64 ",\"p99_us\":%" PRId64 ",\"max_us\":%" PRId64 "}",
+            hist->get_count (), hist->get_average (),
+            hist->get_percentile (50.0), hist->get_percentile (99.0), hist->get_max ());
+        json += buf;
+    }
+
+    json += "},\"counters\":{";
+    first = true;
+    for (std::map<std::string, SmartPtr<MetricCounter>>::iterator i = _counters.begin ();
+            i != _counters.end (); ++i) {
+        if (!first)
+            json += ',';
+        first = false;
+        json_append_escaped (json, i->first.c_str ());
+        snprintf (buf, sizeof (buf), ":%" PRIu64, i->second->get ());
+        json += buf;
+    }
+
+    json += "},\"gauges\":{";
+    first = true;
+    for (std::map<std::string, SmartPtr<MetricGauge>>::iterator i = _gauges.begin ();
+            i != _gauges.end (); ++i) {
+        if (!first)
+            json += ',';
+        first = false;
+        json_append_escaped (json, i->first.c_str ());
+        snprintf (
+            buf, sizeof (buf), ":{\"value\":%" PRId64 ",\"max\":%" PRId64 "}",
+            i->second->get (), i->second->get_max ());
+        json += buf;
+    }
+    json += "}}";
+}
+
+void
+MetricsGroup::reset ()
+{
+    SmartLock locker (_mutex);
+    for (std::map<std::string, SmartPtr<MetricHistogram>>::iterator i = _histograms.begin ();
+            i != _histograms.end (); ++i)
+        i->second->reset ();
+    for (std::map<std::string, SmartPtr<MetricCounter>>::iterator i = _counters.begin ();
+            i != _counters.end (); ++i)
+        i->second->reset ();
+    for (std::map<std::string, SmartPtr<MetricGauge>>::iterator i = _gauges.begin ();
+            i != _gauges.end (); ++i)
+        i->second->reset ();
+}
+
+std::atomic<bool> MetricsRegistry::_enabled (false);
+
+MetricsRegistry *
+MetricsRegistry::instance ()
+{
+    // never destructed, objects may unregister during static destruction
+    static MetricsRegistry *registry = new MetricsRegistry;
+    return registry;
+}
+
+MetricsRegistry::MetricsRegistry ()
+    : _name_seq (0)
+{
+    const char *env = getenv ("XCAM_METRICS");
+    if (env && atoi (env) > 0)
+        set_enabled (true);
+}
+
+// read $XCAM_METRICS at load time, is_enabled never creates the instance
+static MetricsRegistry *metrics_registry_init = MetricsRegistry::instance ();
+
+SmartPtr<MetricsGroup>
+MetricsRegistry::register_group (const char *kind, const char *name)
+{
+    std::string group_name = std::string (XCAM_STR (kind)) + "/" + XCAM_STR (name);
+    SmartLock locker (_mutex);
+
+    for (std::list<SmartPtr<MetricsGroup>>::iterator i = _groups.begin ();
+            i != _groups.end (); ++i) {
+        if ((*i)->_name == group_name) {
+            char suffix[16];
+            snprintf (suffix, sizeof (suffix), "#%d", ++_name_seq);
+            group_name += suffix;
+            break;
+        }
+    }
+
+    SmartPtr<MetricsGroup> group = new MetricsGroup (group_name.c_str ());
+    _groups.push_back (group);
+    return group;
+}
+
+void
+MetricsRegistry::unregister_group (const SmartPtr<MetricsGroup> &group)
+{
+    SmartLock locker (_mutex);
+    for (std::list<SmartPtr<MetricsGroup>>::iterator i = _groups.begin ();
+            i != _groups.end (); ++i) {
+        if (i->ptr () == group.ptr ()) {
+            _groups.erase (i);
+            return;
+        }
+    }
+}
+
+std::string
+MetricsRegistry::snapshot_json ()
+{
+    std::string json;
+    char buf[64];
+    std::list<SmartPtr<MetricsGroup>> groups;
+
+    {
+        SmartLock locker (_mutex);
+        groups = _groups;
+    }
+
+    snprintf (
+        buf, sizeof (buf), "{\"enabled\":%s,\"timestamp_us\":%" PRId64 ",\"groups\":{",
+        is_enabled () ? "true" : "false", xcam_metrics_now_us ());
+    json = buf;
+
+    for (std::list<SmartPtr<MetricsGroup>>::iterator i = groups.begin ();
+            i != groups.end (); ++i) {
+        if (i != groups.begin ())
+            json += ',';
+        json_append_escaped (json, (*i)->get_name ());
+        json += ':';
+        (*i)->to_json (json);
+    }
+    json += "}}";
+    return json;
+}
+
+XCamReturn
+MetricsRegistry::dump_json (const char *file_path)
+{
+    XCAM_ASSERT (file_path);
+    std::string json = snapshot_json ();
+
+    FILE *fp = fopen (file_path, "wb");
+    XCAM_FAIL_RETURN (
+        WARNING, fp, XCAM_RETURN_ERROR_FILE,
+        "metrics dump open file(%s) failed", file_path);
+
+    size_t size = fwrite (json.c_str (), 1, json.size (), fp);
+    fclose (fp);
+    XCAM_FAIL_RETURN (
+        WARNING, size == json.size (), XCAM_RETURN_ERROR_FILE,
+        "metrics dump write file(%s) failed", file_path);
+
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+MetricsRegistry::reset ()
+{
+    SmartLock locker (_mutex);
+    for (std::list<SmartPtr<MetricsGroup>>::iterator i = _groups.begin ();
+            i != _groups.end (); ++i)
+        (*i)->reset ();
+}
+
+ObjProfiling::ObjProfiling ()
+    : _start_us (0)
+    , _times (0)
+    , _sum_duration (0.0)
+{
+}
+
+ObjProfiling::~ObjProfiling ()
+{
+    if (_group.ptr ())
+        MetricsRegistry::instance ()->unregister_group (_group);
+}
+
+void
+ObjProfiling::register_group (const char *name)
+{
+    _group = MetricsRegistry::instance ()->register_group ("profiling", name);
+    _duration = _group->get_histogram ("duration");
+}
+
+void
+ObjProfiling::start ()
+{
+#if ENABLE_PROFILING
+    _start_us = xcam_metrics_now_us ();
+#else
+    _start_us = MetricsRegistry::is_enabled () ? xcam_metrics_now_us () : 0;
+#endif
+}
+
+void
+ObjProfiling::end (const char *name, uint32_t times)
+{
+    if (!_start_us)
+        return;
+
+    int64_t duration = xcam_metrics_now_us () - _start_us;
+    _start_us = 0;
+
+    if (MetricsRegistry::is_enabled ()) {
+        std::call_once (_group_once, &ObjProfiling::register_group, this, name);
+        _duration->record (duration);
+    }
+
+#if ENABLE_PROFILING
+    _sum_duration += duration / 1000.0;
+    ++_times;
+    if (_times >= times) {
+        printf ("profiling %s,average duration:%.2fms\n", XCAM_STR (name), _sum_duration / times);
+        _times = 0;
+        _sum_duration = 0.0;
+    }
+#else
+    XCAM_UNUSED (times);
+#endif
+}
+
+};
@@ -0,0 +1,234 @@
+/*
+ * xcam_metrics.h - runtime metrics registry
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_METRICS_H
+#define XCAM_METRICS_H
+
+#include "xcam_utils.h"
+#include "smartptr.h"
+#include "xcam_mutex.h"
+#include <atomic>
+#include <list>
+#include <map>
+#include <string>
+
+// values below 16 have own bucket, then 8 buckets per power of 2
+#define XCAM_METRIC_HISTOGRAM_LINEAR_MAX   16
+#define XCAM_METRIC_HISTOGRAM_SUB_BITS     3
+#define XCAM_METRIC_HISTOGRAM_BUCKETS      320
+
+namespace XCam {
+
+// monotonic clock, microseconds
+int64_t xcam_metrics_now_us ();
+
+/*
+ * latency histogram in microseconds, log-linear buckets so
+ * percentiles are within 12.5% of the real value, max is exact
+ */
+class MetricHistogram
+    : public RefObj
+{
+public:
+    explicit MetricHistogram ();
+
+    void record (int64_t value_us);
+    uint64_t get_count () const {
+        return _count.load (std::memory_order_relaxed);
+    }
+    int64_t get_max () const {
+        return _max.load (std::memory_order_relaxed);
+    }
+    double get_average () const;
+    // @percent in [0, 100]
+    int64_t get_percentile (double percent) const;
+    void reset ();
+
+private:
+    static uint32_t bucket_index (uint64_t value);
+    static uint64_t bucket_upper (uint32_t index);
+
+    XCAM_DEAD_COPY (MetricHistogram);
+
+private:
+    std::atomic<uint64_t>    _buckets [XCAM_METRIC_HISTOGRAM_BUCKETS];
+    std::atomic<uint64_t>    _count;
+    std::atomic<uint64_t>    _sum;
+    std::atomic<int64_t>     _max;
+};
+
+class MetricCounter
+    : public RefObj
+{
+public:
+    explicit MetricCounter () : _value (0) {}
+
+    void add (uint64_t value = 1) {
+        _value.fetch_add (value, std::memory_order_relaxed);
+    }
+    uint64_t get () const {
+        return _value.load (std::memory_order_relaxed);
+    }
+    void reset () {
+        _value.store (0, std::memory_order_relaxed);
+    }
+
+private:
+    XCAM_DEAD_COPY (MetricCounter);
+
+private:
+    std::atomic<uint64_t>    _value;
+};
+
+// current value and its high-water mark, e.g. queue depth
+class MetricGauge
+    : public RefObj
+{
+public:
+    explicit MetricGauge () : _value (0), _max (0) {}
+
+    void set (int64_t value) {
+        _value.store (value, std::memory_order_relaxed);
+        update_max (value);
+    }
+    void add (int64_t delta) {
+        update_max (_value.fetch_add (delta, std::memory_order_relaxed) + delta);
+    }
+    int64_t get () const {
+        return _value.load (std::memory_order_relaxed);
+    }
+    int64_t get_max () const {
+        return _max.load (std::memory_order_relaxed);
+    }
+    void reset () {
+        _max.store (get (), std::memory_order_relaxed);
+    }
+
+private:
+    void update_max (int64_t value) {
+        int64_t cur = _max.load (std::memory_order_relaxed);
+        while (value > cur && !_max.compare_exchange_weak (cur, value, std::memory_order_relaxed));
+    }
+
+    XCAM_DEAD_COPY (MetricGauge);
+
+private:
+    std::atomic<int64_t>     _value;
+    std::atomic<int64_t>     _max;
+};
+
+/*
+ * metrics of one object, e.g. one handler or one buffer pool.
+ * metrics are created on first get and live as long as the group;
+ * keep the returned SmartPtr instead of looking up per frame.
+ */
+class MetricsGroup
+    : public RefObj
+{
+    friend class MetricsRegistry;
+
+public:
+    const char *get_name () const {
+        return _name.c_str ();
+    }
+
+    SmartPtr<MetricHistogram> get_histogram (const char *name);
+    SmartPtr<MetricCounter> get_counter (const char *name);
+    SmartPtr<MetricGauge> get_gauge (const char *name);
+
+    void to_json (std::string &json);
+    void reset ();
+
+private:
+    explicit MetricsGroup (const char *name);
+    XCAM_DEAD_COPY (MetricsGroup);
+
+private:
+    std::string                                        _name;
+    Mutex                                              _mutex;
+    std::map<std::string, SmartPtr<MetricHistogram>>   _histograms;
+    std::map<std::string, SmartPtr<MetricCounter>>     _counters;
+    std::map<std::string, SmartPtr<MetricGauge>>       _gauges;
+};
+
+/*
+ * process-wide registry, recording is off unless $XCAM_METRICS=1
+ * or set_enabled (true); groups register always so metrics can be
+ * switched on for a running stream.
+ */
+class MetricsRegistry {
+public:
+    static MetricsRegistry *instance ();
+
+    static bool is_enabled () {
+        return _enabled.load (std::memory_order_relaxed);
+    }
+    static void set_enabled (bool enable) {
+        _enabled.store (enable, std::memory_order_relaxed);
+    }
+
+    // group name is "<kind>/<name>", a suffix "#n" is added on conflicts
+    SmartPtr<MetricsGroup> register_group (const char *kind, const char *name);
+    void unregister_group (const SmartPtr<MetricsGroup> &group);
+
+    std::string snapshot_json ();
+    XCamReturn dump_json (const char *file_path);
+    void reset ();
+
+private:
+    explicit MetricsRegistry ();
+    XCAM_DEAD_COPY (MetricsRegistry);
+
+private:
+    static std::atomic<bool>             _enabled;
+
+    Mutex                                _mutex;
+    std::list<SmartPtr<MetricsGroup>>    _groups;
+    uint32_t                             _name_seq;
+};
+
+// measures start to stop into @histogram, nothing recorded when metrics disabled
+class MetricTimer {
+public:
+    explicit MetricTimer (const SmartPtr<MetricHistogram> &histogram)
+        : _histogram (histogram)
+        , _start (MetricsRegistry::is_enabled () && histogram.ptr () ? xcam_metrics_now_us () : 0)
+    {}
+    ~MetricTimer () {
+        stop ();
+    }
+    void stop () {
+        if (_start) {
+            _histogram->record (xcam_metrics_now_us () - _start);
+            _start = 0;
+        }
+    }
+
+private:
+    XCAM_DEAD_COPY (MetricTimer);
+
+private:
+    const SmartPtr<MetricHistogram>   &_histogram;
+    int64_t                            _start;
+};
+
+};
+
+#endif //XCAM_METRICS_H
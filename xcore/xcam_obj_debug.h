@@ -22,6 +22,8 @@
 #define XCAM_OBJ_DEBUG_H
 
 #include <stdio.h>
+#include <smartptr.h>
+#include <mutex>
 
 // default duration of frame numbers
 #define XCAM_OBJ_DUR_FRAME_NUM 30
@@ -72,40 +74,49 @@
         name##_sum_time = 0.0;                          \
     }
 
-#if ENABLE_PROFILING
-#define XCAM_OBJ_PROFILING_DEFINES          \
-    struct timeval   _profiling_start_time; \
-    uint32_t         _profiling_times;      \
-    double           _profiling_sum_duration
+namespace XCam {
 
-#define XCAM_OBJ_PROFILING_INIT             \
-    xcam_mem_clear (_profiling_start_time); \
-    _profiling_times = 0;                   \
-    _profiling_sum_duration = 0.0
+class MetricsGroup;
+class MetricHistogram;
+
+/*
+ * per-object duration profiling, recorded into metrics group
+ * "profiling/<name>" when metrics enabled, also printed every
+ * @times frames when configured with --enable-profiling
+ */
+class ObjProfiling {
+public:
+    explicit ObjProfiling ();
+    ~ObjProfiling ();
+
+    void start ();
+    void end (const char *name, uint32_t times);
+
+private:
+    void register_group (const char *name);
+    XCAM_DEAD_COPY (ObjProfiling);
+
+private:
+    int64_t                     _start_us;
+    uint32_t                    _times;
+    double                      _sum_duration;
+    // group named by first end (), registered once without a lock after
+    std::once_flag              _group_once;
+    SmartPtr<MetricsGroup>      _group;
+    SmartPtr<MetricHistogram>   _duration;
+};
+
+};
+
+#define XCAM_OBJ_PROFILING_DEFINES \
+    XCam::ObjProfiling _obj_profiling
+
+#define XCAM_OBJ_PROFILING_INIT
 
 #define XCAM_OBJ_PROFILING_START \
-    gettimeofday (&_profiling_start_time, NULL)
+    _obj_profiling.start ()
 
 #define XCAM_OBJ_PROFILING_END(name, times) \
-    struct timeval profiling_now;           \
-    gettimeofday (&profiling_now, NULL);    \
-    _profiling_sum_duration +=              \
-        (profiling_now.tv_sec - _profiling_start_time.tv_sec) * 1000.0f +  \
-        (profiling_now.tv_usec - _profiling_start_time.tv_usec) / 1000.0f; \
-    ++_profiling_times;                     \
-    if (_profiling_times >= times) {        \
-        char buf[1024];                     \
-        snprintf (buf, 1024, "profiling %s,average duration:%.2fms\n", \
-        (name), (_profiling_sum_duration/times)); \
-        printf ("%s", buf);                 \
-        _profiling_times = 0;               \
-        _profiling_sum_duration = 0.0;      \
-    }
-#else
-#define XCAM_OBJ_PROFILING_DEFINES
-#define XCAM_OBJ_PROFILING_INIT
-#define XCAM_OBJ_PROFILING_START
-#define XCAM_OBJ_PROFILING_END(name, times)
-#endif
+    _obj_profiling.end ((name), (times))
 
 #endif //XCAM_OBJ_DEBUG_H
@@ -24,11 +24,33 @@
 
 namespace XCam {
 
+class ThreadLoopTask
+    : public PoolTask
+{
+public:
+    ThreadLoopTask (Thread *thread, bool first)
+        : PoolTask (thread->_name, thread->_pool_priority)
+        , _thread (thread)
+        , _first (first)
+    {}
+
+    virtual XCamReturn run () {
+        _thread->run_pool_loop (_first);
+        return XCAM_RETURN_NO_ERROR;
+    }
+
+private:
+    Thread          *_thread;
+    bool             _first;
+};
+
 Thread::Thread (const char *name)
     : _name (NULL)
     , _thread_id (0)
     , _started (false)
     , _stopped (true)
+    , _pool_mode (false)
+    , _pool_priority (PoolTaskPriorityNormal)
 {
     if (name)
         _name = strndup (name, XCAM_MAX_STR_SIZE);
@@ -89,12 +111,81 @@ Thread::stopped ()
     XCAM_LOG_DEBUG ("Thread(%s) stopped", XCAM_STR(_name));
 }
 
+bool
+Thread::set_pool_mode (bool enable, PoolTaskPriority priority)
+{
+    SmartLock locker(_mutex);
+    XCAM_FAIL_RETURN (
+        WARNING, _stopped, false,
+        "Thread(%s) can't change pool mode while running", XCAM_STR(_name));
+
+    _pool_mode = enable;
+    _pool_priority = priority;
+    return true;
+}
+
+// one loop () per task, the thread object must outlive stop ()
+bool
+Thread::run_pool_loop (bool first)
+{
+    bool ret = true;
+
+    if (first)
+        ret = started ();
+
+    {
+        SmartLock locker(_mutex);
+        ret = ret && _started;
+    }
+    if (ret)
+        ret = loop ();
+
+    if (ret) {
+        SmartLock locker(_mutex);
+        ret = _started;
+    }
+    if (ret && ThreadPool::instance ()->queue (new ThreadLoopTask (this, false)))
+        return true;
+
+    {
+        SmartLock locker(_mutex);
+        _started = false;
+    }
+    stopped ();
+
+    SmartLock locker(_mutex);
+    _stopped = true;
+    _exit_cond.broadcast ();
+    return false;
+}
+
+bool
+Thread::start_in_pool ()
+{
+    SmartPtr<ThreadPool> pool = ThreadPool::instance ();
+    XCAM_FAIL_RETURN (
+        WARNING, pool.ptr (), false,
+        "Thread(%s) start in pool failed, no thread pool", XCAM_STR(_name));
+
+    _started = true;
+    _stopped = false;
+    if (!pool->queue (new ThreadLoopTask (this, true))) {
+        _started = false;
+        _stopped = true;
+        return false;
+    }
+    return true;
+}
+
 bool Thread::start ()
 {
     SmartLock locker(_mutex);
     if (_started)
         return true;
 
+    if (_pool_mode)
+        return start_in_pool ();
+
     if (pthread_create (&_thread_id, NULL, (void * (*)(void*))thread_func, this) != 0)
         return false;
     _started = true;
@@ -127,7 +218,7 @@ bool Thread::stop ()
     if (_started) {
         _started = false;
     }
-    if (!_stopped) {
+    while (!_stopped) {
         _exit_cond.wait(_mutex);
     }
     return true;
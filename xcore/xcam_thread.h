@@ -23,14 +23,31 @@
 
 #include "xcam_utils.h"
 #include "xcam_mutex.h"
+#include "thread_pool.h"
 
 namespace XCam {
 
+class ThreadLoopTask;
+
 class Thread {
+    friend class ThreadLoopTask;
+
 public:
     Thread (const char *name = NULL);
     virtual ~Thread ();
 
+    /*
+     * run loop () as tasks on the shared ThreadPool instead of a
+     * dedicated pthread, each loop () call is queued again after it
+     * returns. Only for loops which return in short time (timed waits),
+     * a loop blocking forever holds a pool worker forever.
+     * **** MUST be set before start ****
+     */
+    bool set_pool_mode (bool enable, PoolTaskPriority priority = PoolTaskPriorityNormal);
+    bool is_pool_mode () const {
+        return _pool_mode;
+    }
+
     bool start ();
     virtual bool emit_stop ();
     bool stop ();
@@ -48,6 +65,8 @@ private:
 
 private:
     static int thread_func (void *user_data);
+    bool start_in_pool ();
+    bool run_pool_loop (bool first);
 
 private:
     char           *_name;
@@ -56,6 +75,8 @@ private:
     XCam::Cond      _exit_cond;
     bool            _started;
     bool            _stopped;
+    bool            _pool_mode;
+    PoolTaskPriority _pool_priority;
 };
 
 };
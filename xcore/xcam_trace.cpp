@@ -0,0 +1,359 @@
+/*
+ * xcam_trace.cpp - per-frame trace in Chrome trace-event format
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#include "xcam_trace.h"
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <vector>
+
+namespace XCam {
+
+#define XCAM_TRACE_NAME_WORDS (XCAM_TRACE_NAME_SIZE / sizeof (uint64_t))
+
+/*
+ * seqlock slot, payload fields are relaxed atomics so a reader
+ * racing with the owner thread only sees a changed stamp
+ */
+struct TraceEvent {
+    // index + 1 once written, 0 while being written
+    std::atomic<uint64_t>     stamp;
+    std::atomic<const char *> category;
+    std::atomic<int64_t>      start_us;
+    std::atomic<int64_t>      duration_us;
+    std::atomic<int64_t>      timestamp;
+    std::atomic<int32_t>      seq;
+    std::atomic<int32_t>      tid;
+    std::atomic<uint64_t>     name [XCAM_TRACE_NAME_WORDS];
+};
+
+struct TraceEventData {
+    const char               *category;
+    int64_t                   start_us;
+    int64_t                   duration_us;
+    int64_t                   timestamp;
+    int32_t                   seq;
+    int32_t                   tid;
+    union {
+        uint64_t              words [XCAM_TRACE_NAME_WORDS];
+        char                  str [XCAM_TRACE_NAME_SIZE];
+    } name;
+};
+
+// written only by its owner thread, read by flush
+struct TraceRing {
+    TraceEvent               events [XCAM_TRACE_RING_SIZE];
+    std::atomic<uint64_t>    head;
+    int32_t                  tid;
+    bool                     in_use;
+
+    TraceRing () : head (0), tid (0), in_use (true) {
+        for (uint32_t i = 0; i < XCAM_TRACE_RING_SIZE; ++i)
+            events[i].stamp.store (0, std::memory_order_relaxed);
+    }
+};
+
+// gives the ring back for reuse when its thread exits
+struct TraceRingHolder {
+    TraceRing               *ring;
+
+    TraceRingHolder () : ring (NULL) {}
+    ~TraceRingHolder ();
+};
+
+static thread_local TraceRingHolder thread_ring_holder;
+static thread_local int64_t thread_frame_timestamp = InvalidTimestamp;
+static thread_local int32_t thread_frame_seq = -1;
+
+TraceRingHolder::~TraceRingHolder ()
+{
+    if (ring)
+        TraceRecorder::instance ()->release_ring (ring);
+}
+
+static void
+json_append_name (std::string &json, const char *str)
+{
+    json += '"';
+    for (; *str; ++str) {
+        char c = *str;
+        if (c == '"' || c == '\\')
+            json += '\\';
+        if ((unsigned char)c < 0x20)
+            c = ' ';
+        json += c;
+    }
+    json += '"';
+}
+
+std::atomic<bool> TraceRecorder::_enabled (false);
+
+TraceRecorder *
+TraceRecorder::instance ()
+{
+    // never destructed, threads may still trace during exit
+    static TraceRecorder *recorder = new TraceRecorder;
+    return recorder;
+}
+
+TraceRecorder::TraceRecorder ()
+{
+    const char *env = getenv ("XCAM_TRACE");
+    if (env && env[0]) {
+        _exit_file = env;
+        set_enabled (true);
+        atexit (TraceRecorder::flush_at_exit);
+    }
+}
+
+// read $XCAM_TRACE at load time, is_enabled never creates the instance
+static TraceRecorder *trace_recorder_init = TraceRecorder::instance ();
+
+void
+TraceRecorder::flush_at_exit ()
+{
+    TraceRecorder *recorder = instance ();
+    recorder->flush (recorder->_exit_file.c_str ());
+}
+
+TraceRing *
+TraceRecorder::get_thread_ring ()
+{
+    if (thread_ring_holder.ring)
+        return thread_ring_holder.ring;
+
+    int32_t tid = (int32_t) syscall (SYS_gettid);
+    char thread_name[16] = "";
+    pthread_getname_np (pthread_self (), thread_name, sizeof (thread_name));
+
+    TraceRing *ring = NULL;
+    SmartLock locker (_mutex);
+    for (std::list<TraceRing *>::iterator i = _rings.begin (); i != _rings.end (); ++i) {
+        if (!(*i)->in_use) {
+            ring = *i;
+            break;
+        }
+    }
+    if (!ring) {
+        ring = new TraceRing;
+        _rings.push_back (ring);
+    }
+    ring->in_use = true;
+    ring->tid = tid;
+    _thread_names[tid] = thread_name;
+
+    thread_ring_holder.ring = ring;
+    return ring;
+}
+
+void
+TraceRecorder::release_ring (TraceRing *ring)
+{
+    SmartLock locker (_mutex);
+    ring->in_use = false;
+}
+
+void
+TraceRecorder::record (
+    const char *category, const char *name,
+    int64_t start_us, int64_t end_us,
+    int64_t timestamp, int32_t seq)
+{
+    TraceRing *ring = get_thread_ring ();
+    uint64_t index = ring->head.load (std::memory_order_relaxed);
+    TraceEvent &event = ring->events[index % XCAM_TRACE_RING_SIZE];
+
+    event.stamp.store (0, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    TraceEventData data;
+    xcam_mem_clear (data.name);
+    strncpy (data.name.str, XCAM_STR (name), XCAM_TRACE_NAME_SIZE - 1);
+
+    event.category.store (category, std::memory_order_relaxed);
+    event.start_us.store (start_us, std::memory_order_relaxed);
+    event.duration_us.store (end_us - start_us, std::memory_order_relaxed);
+    event.timestamp.store (timestamp, std::memory_order_relaxed);
+    event.seq.store (seq, std::memory_order_relaxed);
+    event.tid.store (ring->tid, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < XCAM_TRACE_NAME_WORDS; ++i)
+        event.name[i].store (data.name.words[i], std::memory_order_relaxed);
+
+    event.stamp.store (index + 1, std::memory_order_release);
+    ring->head.store (index + 1, std::memory_order_release);
+}
+
+XCamReturn
+TraceRecorder::flush (const char *file_path)
+{
+    std::vector<TraceRing *> rings;
+    std::map<int32_t, std::string> thread_names;
+    std::string json;
+    char buf[256];
+    uint32_t count = 0;
+    int pid = getpid ();
+
+    XCAM_ASSERT (file_path);
+    {
+        SmartLock locker (_mutex);
+        rings.assign (_rings.begin (), _rings.end ());
+        thread_names = _thread_names;
+    }
+
+    json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (std::map<int32_t, std::string>::iterator i = thread_names.begin ();
+            i != thread_names.end (); ++i) {
+        if (count++)
+            json += ',';
+        snprintf (
+            buf, sizeof (buf),
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+            pid, i->first);
+        json += buf;
+        json_append_name (json, i->second.c_str ());
+        json += "}}";
+    }
+
+    for (size_t r = 0; r < rings.size (); ++r) {
+        TraceRing *ring = rings[r];
+        uint64_t head = ring->head.load (std::memory_order_acquire);
+        uint64_t begin = head > XCAM_TRACE_RING_SIZE ? head - XCAM_TRACE_RING_SIZE : 0;
+
+        for (uint64_t index = begin; index < head; ++index) {
+            TraceEvent &src = ring->events[index % XCAM_TRACE_RING_SIZE];
+            uint64_t stamp = src.stamp.load (std::memory_order_acquire);
+            if (stamp != index + 1)
+                continue;
+
+            TraceEventData event;
+            event.category = src.category.load (std::memory_order_relaxed);
+            event.start_us = src.start_us.load (std::memory_order_relaxed);
+            event.duration_us = src.duration_us.load (std::memory_order_relaxed);
+            event.timestamp = src.timestamp.load (std::memory_order_relaxed);
+            event.seq = src.seq.load (std::memory_order_relaxed);
+            event.tid = src.tid.load (std::memory_order_relaxed);
+            for (uint32_t i = 0; i < XCAM_TRACE_NAME_WORDS; ++i)
+                event.name.words[i] = src.name[i].load (std::memory_order_relaxed);
+            event.name.str[XCAM_TRACE_NAME_SIZE - 1] = '\0';
+
+            // overwritten by owner thread while copying
+            std::atomic_thread_fence (std::memory_order_acquire);
+            if (src.stamp.load (std::memory_order_relaxed) != stamp)
+                continue;
+
+            if (count++)
+                json += ',';
+            json += "{\"name\":";
+            json_append_name (json, event.name.str);
+            snprintf (
+                buf, sizeof (buf),
+                ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%" PRId64 ",\"dur\":%" PRId64 ",\"pid\":%d,\"tid\":%d,\"args\":{",
+                XCAM_STR (event.category), event.start_us, event.duration_us, pid, event.tid);
+            json += buf;
+            if (event.timestamp != InvalidTimestamp) {
+                snprintf (buf, sizeof (buf), "\"timestamp\":%" PRId64, event.timestamp);
+                json += buf;
+            }
+            if (event.seq >= 0) {
+                snprintf (
+                    buf, sizeof (buf), "%s\"seq\":%d",
+                    event.timestamp != InvalidTimestamp ? "," : "", event.seq);
+                json += buf;
+            }
+            json += "}}";
+        }
+    }
+    json += "]}\n";
+
+    FILE *fp = fopen (file_path, "wb");
+    XCAM_FAIL_RETURN (
+        WARNING, fp, XCAM_RETURN_ERROR_FILE,
+        "trace flush open file(%s) failed", file_path);
+
+    size_t size = fwrite (json.c_str (), 1, json.size (), fp);
+    fclose (fp);
+    XCAM_FAIL_RETURN (
+        WARNING, size == json.size (), XCAM_RETURN_ERROR_FILE,
+        "trace flush write file(%s) failed", file_path);
+
+    XCAM_LOG_INFO ("trace flushed %d events to %s", count, file_path);
+    return XCAM_RETURN_NO_ERROR;
+}
+
+void
+TraceRecorder::clear ()
+{
+    SmartLock locker (_mutex);
+    for (std::list<TraceRing *>::iterator i = _rings.begin (); i != _rings.end (); ++i) {
+        TraceRing *ring = *i;
+        uint64_t head = ring->head.load (std::memory_order_acquire);
+        // invalidate by stamp, head stays owned by the writer thread
+        for (uint32_t e = 0; e < XCAM_TRACE_RING_SIZE; ++e) {
+            uint64_t stamp = ring->events[e].stamp.load (std::memory_order_relaxed);
+            if (stamp && stamp <= head)
+                ring->events[e].stamp.compare_exchange_strong (stamp, 0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void
+TraceRecorder::set_thread_frame (int64_t timestamp, int32_t seq)
+{
+    thread_frame_timestamp = timestamp;
+    thread_frame_seq = seq;
+}
+
+void
+TraceRecorder::get_thread_frame (int64_t &timestamp, int32_t &seq)
+{
+    timestamp = thread_frame_timestamp;
+    seq = thread_frame_seq;
+}
+
+TraceSpan::TraceSpan (const char *category, const char *name)
+    : _category (category)
+    , _name (name)
+    , _start (TraceRecorder::is_enabled () ? xcam_metrics_now_us () : 0)
+    , _timestamp (InvalidTimestamp)
+    , _seq (-1)
+{
+}
+
+TraceSpan::TraceSpan (const char *category, const char *name, int64_t timestamp, int32_t seq)
+    : _category (category)
+    , _name (name)
+    , _start (TraceRecorder::is_enabled () ? xcam_metrics_now_us () : 0)
+    , _timestamp (timestamp)
+    , _seq (seq)
+{
+}
+
+TraceSpan::~TraceSpan ()
+{
+    if (!_start)
+        return;
+
+    if (_timestamp == InvalidTimestamp && _seq < 0)
+        TraceRecorder::get_thread_frame (_timestamp, _seq);
+
+    TraceRecorder::instance ()->record (
+        _category, _name, _start, xcam_metrics_now_us (), _timestamp, _seq);
+}
+
+};
@@ -0,0 +1,133 @@
+/*
+ * xcam_trace.h - per-frame trace in Chrome trace-event format
+ *
+ *  Copyright (c) 2026 agent
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Author: agent <agent@local>
+ */
+
+#ifndef XCAM_TRACE_H
+#define XCAM_TRACE_H
+
+#include "xcam_utils.h"
+#include "xcam_mutex.h"
+#include "xcam_metrics.h"
+#include <atomic>
+#include <list>
+#include <map>
+#include <string>
+
+#define XCAM_TRACE_RING_SIZE      8192
+#define XCAM_TRACE_NAME_SIZE      48
+
+namespace XCam {
+
+struct TraceRing;
+
+/*
+ * records spans into a ring per thread, writers never lock;
+ * old spans are overwritten when a ring is full.
+ * enabled by $XCAM_TRACE=<file>, which is also flushed at exit,
+ * or by set_enabled (true) and flush (file) on demand.
+ * output loads in chrome://tracing and ui.perfetto.dev.
+ */
+class TraceRecorder {
+    friend struct TraceRingHolder;
+
+public:
+    static TraceRecorder *instance ();
+
+    static bool is_enabled () {
+        return _enabled.load (std::memory_order_relaxed);
+    }
+    static void set_enabled (bool enable) {
+        _enabled.store (enable, std::memory_order_relaxed);
+    }
+
+    // @category must be a string literal, @name is copied
+    void record (
+        const char *category, const char *name,
+        int64_t start_us, int64_t end_us,
+        int64_t timestamp, int32_t seq);
+
+    XCamReturn flush (const char *file_path);
+    void clear ();
+
+    // frame of calling thread, used by spans created without frame
+    static void set_thread_frame (int64_t timestamp, int32_t seq);
+    static void get_thread_frame (int64_t &timestamp, int32_t &seq);
+
+private:
+    explicit TraceRecorder ();
+    TraceRing *get_thread_ring ();
+    void release_ring (TraceRing *ring);
+    static void flush_at_exit ();
+
+    XCAM_DEAD_COPY (TraceRecorder);
+
+private:
+    static std::atomic<bool>             _enabled;
+
+    Mutex                                _mutex;
+    std::list<TraceRing *>               _rings;
+    std::map<int32_t, std::string>       _thread_names;
+    std::string                          _exit_file;
+};
+
+// one complete span from construction to destruction
+class TraceSpan {
+public:
+    explicit TraceSpan (const char *category, const char *name);
+    explicit TraceSpan (const char *category, const char *name, int64_t timestamp, int32_t seq);
+    ~TraceSpan ();
+
+    void set_frame (int64_t timestamp, int32_t seq = -1) {
+        _timestamp = timestamp;
+        _seq = seq;
+    }
+
+private:
+    XCAM_DEAD_COPY (TraceSpan);
+
+private:
+    const char        *_category;
+    const char        *_name;
+    int64_t            _start;
+    int64_t            _timestamp;
+    int32_t            _seq;
+};
+
+// sets frame of calling thread, restores the previous one on leave
+class TraceFrameScope {
+public:
+    explicit TraceFrameScope (int64_t timestamp, int32_t seq = -1) {
+        TraceRecorder::get_thread_frame (_old_timestamp, _old_seq);
+        TraceRecorder::set_thread_frame (timestamp, seq);
+    }
+    ~TraceFrameScope () {
+        TraceRecorder::set_thread_frame (_old_timestamp, _old_seq);
+    }
+
+private:
+    XCAM_DEAD_COPY (TraceFrameScope);
+
+private:
+    int64_t            _old_timestamp;
+    int32_t            _old_seq;
+};
+
+};
+
+#endif //XCAM_TRACE_H
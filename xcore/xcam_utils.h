@@ -51,6 +51,89 @@ enum CLNV12PlaneIdx {
     CLNV12PlaneMax,
 };
 
+// input pixel position of a geometry map entry, shared by CL and CPU remap
+struct GeoPos {
+    double x;
+    double y;
+
+    GeoPos () : x(0), y(0) {}
+};
+
+// area of an image in pixels, shared by CL and CPU blenders
+struct Rect {
+    int32_t pos_x, pos_y;
+    int32_t width, height;
+
+    Rect () : pos_x (0), pos_y (0), width (0), height (0) {}
+};
+
+// fisheye lens of an input image, angles in degree, shared by CL and CPU unwrap
+struct FisheyeInfo {
+    float    center_x;
+    float    center_y;
+    float    wide_angle;
+    float    radius;
+    float    rotate_angle; // clockwise
+
+    FisheyeInfo ()
+        : center_x (0.0f)
+        , center_y (0.0f)
+        , wide_angle (0.0f)
+        , radius (0.0f)
+        , rotate_angle (0.0f)
+    {}
+    bool is_valid () const {
+        return wide_angle >= 1.0f && radius >= 1.0f;
+    }
+};
+
+enum ImageIdx {
+    ImageIdxMain,
+    ImageIdxSecondary,
+    ImageIdxCount,
+};
+
+struct ImageCropInfo {
+    uint32_t left;
+    uint32_t right;
+    uint32_t top;
+    uint32_t bottom;
+
+    ImageCropInfo () : left (0), right (0), top (0), bottom (0) {}
+};
+
+// dual fisheye 360 stitching, shared by CL and CPU stitchers
+struct StitchInfo {
+    uint32_t merge_width[ImageIdxCount];
+
+    ImageCropInfo crop[ImageIdxCount];
+    FisheyeInfo fisheye_info[ImageIdxCount];
+
+    StitchInfo () {
+        xcam_mem_clear (merge_width);
+    }
+};
+
+/*
+ * radii of @count stacked box filters approximating a gaussian of
+ * @sigma, widths are the two odd integers around the ideal one,
+ * mixed so the summed variance is closest to sigma^2 (Wells, Kovesi).
+ */
+inline void
+box_gauss_radii (float sigma, uint32_t count, uint32_t *radii)
+{
+    double variance = 12.0 * sigma * sigma;
+    int lower = (int)floor (sqrt (variance / count + 1.0));
+    if (lower % 2 == 0)
+        --lower;
+    int lower_count = (int)floor (
+                          (variance - count * lower * lower - 4.0 * count * lower - 3.0 * count) /
+                          (-4.0 * lower - 4.0) + 0.5);
+
+    for (uint32_t i = 0; i < count; ++i)
+        radii[i] = (((int)i < lower_count) ? lower : lower + 2) / 2;
+}
+
 inline double
 linear_interpolate_p2 (double value_start, double value_end,
                        double ref_start, double ref_end,